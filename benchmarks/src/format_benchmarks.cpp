@@ -0,0 +1,486 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_encoder.hpp>
+#include <jsoncons/json_pull_reader.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <jsoncons_ext/bson/bson.hpp>
+#include <jsoncons_ext/ubjson/ubjson.hpp>
+#include <jsoncons_ext/csv/csv.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#if defined(_MSC_VER)
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace jsoncons;
+
+// Count allocations made through the global operator new
+
+namespace {
+    std::atomic<size_t> allocation_count(0);
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocation_count;
+    void* p = std::malloc(size != 0 ? size : 1);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+    // Run from the tests directory
+    const char* const input_files[] =
+    {
+        "./input/address-book.json",
+        "./input/countries.json",
+        "./input/cyrillic.json",
+        "./input/employees.json",
+        "./input/members.json",
+        "./input/persons.json",
+        "./input/JSONPathTestSuite/document.json",
+        "./input/JSON_checker/pass1.json"
+    };
+
+    double min_seconds = 0.5;
+
+    struct corpus
+    {
+        std::string name;
+        std::string text;
+        bool tabular;
+    };
+
+    struct result
+    {
+        bool ok;
+        double rate;
+        double allocations;
+
+        result()
+            : ok(true), rate(0), allocations(0)
+        {
+        }
+    };
+
+    // Peak resident set size of the process in bytes
+
+    size_t peak_rss()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return counters.PeakWorkingSetSize;
+        }
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+        {
+            return 0;
+        }
+#if defined(__APPLE__)
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    // Returns the throughput in MB/s of f, processing bytes per call,
+    // and the number of allocations made by one call
+    result measure(size_t bytes, const std::function<void()>& f)
+    {
+        typedef std::chrono::high_resolution_clock clock_type;
+
+        result r;
+        try
+        {
+            size_t count = allocation_count;
+            f();
+            r.allocations = static_cast<double>(allocation_count - count);
+
+            size_t iterations = 0;
+            auto start = clock_type::now();
+            std::chrono::duration<double> elapsed(0);
+            do
+            {
+                f();
+                ++iterations;
+                elapsed = clock_type::now() - start;
+            }
+            while (elapsed.count() < min_seconds);
+
+            r.rate = static_cast<double>(bytes) * iterations / (1024.0*1024.0) / elapsed.count();
+        }
+        catch (const std::exception&)
+        {
+            r.ok = false;
+        }
+        return r;
+    }
+
+    // Synthetic corpora, generated from fixed seeds
+
+    std::string make_numbers(size_t count)
+    {
+        std::mt19937_64 gen(1);
+        std::uniform_int_distribution<int64_t> integers(-1000000000, 1000000000);
+        std::uniform_real_distribution<double> reals(-1000.0, 1000.0);
+
+        json a = json::array();
+        a.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            json row;
+            row["id"] = i;
+            row["count"] = integers(gen);
+            row["x"] = reals(gen);
+            row["y"] = reals(gen);
+            row["z"] = reals(gen)*1.0e-6;
+            a.push_back(std::move(row));
+        }
+        return a.to_string();
+    }
+
+    std::string make_strings(size_t count)
+    {
+        static const char* const words[] = {"alpha","beta","gamma","delta","epsilon","\\\"quoted\\\"","tab\\tbed",
+                                            "Stra\\u00dfe","\\u041c\\u043e\\u0441\\u043a\\u0432\\u0430","line\\nbreak"};
+        std::mt19937 gen(2);
+        std::uniform_int_distribution<size_t> word(0, sizeof(words)/sizeof(words[0]) - 1);
+        std::uniform_int_distribution<size_t> length(1, 40);
+
+        std::string s = "[";
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i > 0)
+            {
+                s.push_back(',');
+            }
+            s.push_back('"');
+            size_t n = length(gen);
+            for (size_t j = 0; j < n; ++j)
+            {
+                if (j > 0)
+                {
+                    s.push_back(' ');
+                }
+                s.append(words[word(gen)]);
+            }
+            s.push_back('"');
+        }
+        s.push_back(']');
+        return s;
+    }
+
+    std::string make_deep(size_t count, size_t depth)
+    {
+        std::string s = "[";
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i > 0)
+            {
+                s.push_back(',');
+            }
+            for (size_t j = 0; j < depth; ++j)
+            {
+                s.append(j % 2 == 0 ? "{\"a\":" : "[");
+            }
+            s.append(std::to_string(i));
+            for (size_t j = depth; j-- > 0;)
+            {
+                s.append(j % 2 == 0 ? "}" : "]");
+            }
+        }
+        s.push_back(']');
+        return s;
+    }
+
+    std::string make_wide(size_t count)
+    {
+        std::mt19937 gen(3);
+        std::uniform_int_distribution<int> values(0, 1000000);
+
+        std::string s = "{";
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (i > 0)
+            {
+                s.push_back(',');
+            }
+            s.append("\"member" + std::to_string(i) + "\":" + std::to_string(values(gen)));
+        }
+        s.push_back('}');
+        return s;
+    }
+
+    bool read_file(const std::string& path, std::string& content)
+    {
+        std::ifstream is(path, std::ios::binary);
+        if (!is)
+        {
+            return false;
+        }
+        std::ostringstream os;
+        os << is.rdbuf();
+        content = os.str();
+        return true;
+    }
+
+    void print_result(const std::string& operation, size_t bytes, const result& r)
+    {
+        std::cout << "  " << std::left << std::setw(28) << operation
+                  << std::right << std::setw(12) << bytes;
+        if (r.ok)
+        {
+            std::cout << std::fixed << std::setprecision(1)
+                      << std::setw(12) << r.rate
+                      << std::setprecision(0)
+                      << std::setw(14) << r.allocations << std::endl;
+        }
+        else
+        {
+            std::cout << std::setw(12) << "n/a" << std::setw(14) << "n/a" << std::endl;
+        }
+    }
+
+    // Measures decode, a decoder that does not reproduce expected is reported as n/a
+    template <class Decode>
+    result measure_decode(size_t bytes, const json& expected, Decode decode)
+    {
+        result r;
+        try
+        {
+            if (decode() != expected)
+            {
+                r.ok = false;
+                return r;
+            }
+        }
+        catch (const std::exception&)
+        {
+            r.ok = false;
+            return r;
+        }
+        return measure(bytes, [&](){json k = decode();});
+    }
+
+    void run(const corpus& c)
+    {
+        const std::string& text = c.text;
+
+        std::cout << c.name << std::endl;
+
+        json j;
+        try
+        {
+            j = json::parse(text);
+        }
+        catch (const std::exception& e)
+        {
+            std::cout << "  " << e.what() << std::endl;
+            return;
+        }
+
+        // JSON
+
+        print_result("parse json", text.size(), measure(text.size(), [&](){
+            json j = json::parse(text);
+        }));
+        print_result("parse ojson", text.size(), measure(text.size(), [&](){
+            ojson j = ojson::parse(text);
+        }));
+        print_result("pull parse", text.size(), measure(text.size(), [&](){
+            json_pull_reader reader(text);
+            for (; !reader.done(); reader.next())
+            {
+            }
+        }));
+
+        std::string pretty;
+        {
+            json_string_encoder encoder(pretty);
+            j.dump(encoder);
+        }
+        print_result("json_encoder", pretty.size(), measure(pretty.size(), [&](){
+            std::string s;
+            json_string_encoder encoder(s);
+            j.dump(encoder);
+        }));
+        std::string compressed;
+        {
+            json_compressed_string_encoder encoder(compressed);
+            j.dump(encoder);
+        }
+        print_result("json_compressed_encoder", compressed.size(), measure(compressed.size(), [&](){
+            std::string s;
+            json_compressed_string_encoder encoder(s);
+            j.dump(encoder);
+        }));
+
+        // Binary formats
+
+        std::vector<uint8_t> v;
+        cbor::encode_cbor(j, v);
+        print_result("cbor encode", v.size(), measure(v.size(), [&](){
+            std::vector<uint8_t> u;
+            cbor::encode_cbor(j, u);
+        }));
+        print_result("cbor decode", v.size(), measure_decode(v.size(), j, [&](){
+            return cbor::decode_cbor<json>(v);
+        }));
+
+        v.clear();
+        msgpack::encode_msgpack(j, v);
+        print_result("msgpack encode", v.size(), measure(v.size(), [&](){
+            std::vector<uint8_t> u;
+            msgpack::encode_msgpack(j, u);
+        }));
+        print_result("msgpack decode", v.size(), measure_decode(v.size(), j, [&](){
+            return msgpack::decode_msgpack<json>(v);
+        }));
+
+        // A BSON document is an object
+        json doc;
+        if (j.is_object())
+        {
+            doc = j;
+        }
+        else
+        {
+            doc["data"] = j;
+        }
+        v.clear();
+        bson::encode_bson(doc, v);
+        print_result("bson encode", v.size(), measure(v.size(), [&](){
+            std::vector<uint8_t> u;
+            bson::encode_bson(doc, u);
+        }));
+        print_result("bson decode", v.size(), measure_decode(v.size(), doc, [&](){
+            return bson::decode_bson<json>(v);
+        }));
+
+        v.clear();
+        ubjson::encode_ubjson(j, v);
+        print_result("ubjson encode", v.size(), measure(v.size(), [&](){
+            std::vector<uint8_t> u;
+            ubjson::encode_ubjson(j, u);
+        }));
+        print_result("ubjson decode", v.size(), measure_decode(v.size(), j, [&](){
+            return ubjson::decode_ubjson<json>(v);
+        }));
+
+        // CSV, for an array of flat objects
+
+        if (c.tabular)
+        {
+            csv::csv_options options;
+            options.assume_header(true);
+
+            std::string s;
+            csv::encode_csv(j, s);
+            print_result("csv encode", s.size(), measure(s.size(), [&](){
+                std::string t;
+                csv::encode_csv(j, t);
+            }));
+            print_result("csv decode", s.size(), measure_decode(s.size(), j, [&](){
+                return csv::decode_csv<json>(s, options);
+            }));
+        }
+
+        std::cout << "  peak RSS " << (peak_rss() / 1024) << " KB" << std::endl;
+    }
+}
+
+// Usage: format_benchmarks [min_seconds] [file...]
+int main(int argc, char** argv)
+{
+    std::vector<corpus> corpora;
+
+    int i = 1;
+    if (i < argc)
+    {
+        double seconds = std::atof(argv[i]);
+        if (seconds > 0)
+        {
+            min_seconds = seconds;
+            ++i;
+        }
+    }
+    if (i < argc)
+    {
+        for (; i < argc; ++i)
+        {
+            corpus c;
+            c.name = argv[i];
+            c.tabular = false;
+            if (!read_file(argv[i], c.text))
+            {
+                std::cerr << "Cannot open " << argv[i] << std::endl;
+                continue;
+            }
+            corpora.push_back(std::move(c));
+        }
+    }
+    else
+    {
+        corpora.push_back(corpus{"numbers (synthetic)", make_numbers(20000), true});
+        corpora.push_back(corpus{"strings (synthetic)", make_strings(20000), false});
+        corpora.push_back(corpus{"deep nesting (synthetic)", make_deep(1000, 100), false});
+        corpora.push_back(corpus{"wide object (synthetic)", make_wide(50000), false});
+        for (auto path : input_files)
+        {
+            corpus c;
+            c.name = path;
+            c.tabular = false;
+            if (!read_file(path, c.text))
+            {
+                std::cerr << "Cannot open " << path << std::endl;
+                continue;
+            }
+            corpora.push_back(std::move(c));
+        }
+    }
+
+    std::cout << "  " << std::left << std::setw(28) << "operation"
+              << std::right << std::setw(12) << "bytes"
+              << std::setw(12) << "MB/s"
+              << std::setw(14) << "allocs/doc" << std::endl;
+
+    for (const auto& c : corpora)
+    {
+        run(c);
+    }
+    return 0;
+}
@@ -0,0 +1,179 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace {
+
+    // An unbuffered stream buffer over a file, each call that reaches it is
+    // one write to the file, each flush with nothing to write is counted too
+    class counting_file_buf : public std::streambuf
+    {
+        std::FILE* fp_;
+    public:
+        size_t writes;
+        size_t flushes;
+
+        counting_file_buf(const char* path)
+            : fp_(std::fopen(path, "wb")), writes(0), flushes(0)
+        {
+            std::setvbuf(fp_, nullptr, _IONBF, 0);
+        }
+
+        ~counting_file_buf()
+        {
+            std::fclose(fp_);
+        }
+    protected:
+        std::streamsize xsputn(const char* s, std::streamsize n) override
+        {
+            ++writes;
+            return static_cast<std::streamsize>(std::fwrite(s, 1, static_cast<size_t>(n), fp_));
+        }
+
+        int_type overflow(int_type ch) override
+        {
+            if (!traits_type::eq_int_type(ch, traits_type::eof()))
+            {
+                ++writes;
+                char c = traits_type::to_char_type(ch);
+                return std::fwrite(&c, 1, 1, fp_) == 1 ? ch : traits_type::eof();
+            }
+            return traits_type::not_eof(ch);
+        }
+
+        int sync() override
+        {
+            ++flushes;
+            return 0;
+        }
+    };
+
+    // Returns the mean time in microseconds of one call of f
+    double measure(const std::function<void()>& f)
+    {
+        typedef std::chrono::high_resolution_clock clock_type;
+
+        size_t iterations = 0;
+        auto start = clock_type::now();
+        std::chrono::duration<double,std::micro> elapsed(0);
+        do
+        {
+            f();
+            ++iterations;
+            elapsed = clock_type::now() - start;
+        }
+        while (elapsed.count() < 500000);
+        return elapsed.count() / iterations;
+    }
+
+    template <class T>
+    void run(const std::string& name, const T& val)
+    {
+        const char* path = "json_conversion_traits_benchmarks.json";
+
+        size_t writes = 0;
+        size_t flushes = 0;
+        {
+            counting_file_buf buf(path);
+            std::ostream os(&buf);
+            encode_json(val, os);
+            writes = buf.writes;
+            flushes = buf.flushes;
+        }
+
+        std::ofstream os(path);
+        double time = measure([&]() {os.seekp(0); encode_json(val, os);});
+
+        std::cout << std::left << std::setw(28) << name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << time
+                  << std::setw(10) << writes
+                  << std::setw(10) << flushes << std::endl;
+        std::remove(path);
+    }
+
+    template <class T>
+    void run_decode(const std::string& name, const T& val)
+    {
+        std::string s;
+        encode_json(val, s);
+
+        T result;
+        double time = measure([&]() {result = decode_json<T>(s);});
+
+        std::cout << std::left << std::setw(28) << name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << time
+                  << std::setw(12) << (s.size()/time) << std::endl;
+    }
+}
+
+int main()
+{
+    std::cout << std::left << std::setw(28) << "ofstream"
+              << std::right << std::setw(12) << "us"
+              << std::setw(10) << "writes"
+              << std::setw(10) << "flushes" << std::endl;
+
+    std::vector<std::vector<double>> matrix(10000, std::vector<double>(8));
+    for (size_t i = 0; i < matrix.size(); ++i)
+    {
+        for (size_t j = 0; j < matrix[i].size(); ++j)
+        {
+            matrix[i][j] = static_cast<double>(i) + static_cast<double>(j) / 8;
+        }
+    }
+    run("vector<vector<double>>", matrix);
+
+    std::map<std::string,std::vector<int>> index;
+    for (int i = 0; i < 10000; ++i)
+    {
+        index["key" + std::to_string(i)] = {i, i + 1, i + 2};
+    }
+    run("map<string,vector<int>>", index);
+
+    std::vector<std::map<std::string,std::string>> rows(10000);
+    for (size_t i = 0; i < rows.size(); ++i)
+    {
+        rows[i]["id"] = std::to_string(i);
+        rows[i]["name"] = "row";
+    }
+    run("vector<map<string,string>>", rows);
+
+    std::cout << std::endl << std::left << std::setw(28) << "decode_json"
+              << std::right << std::setw(12) << "us"
+              << std::setw(12) << "MB/s" << std::endl;
+
+    std::vector<double> numbers(1000000);
+    for (size_t i = 0; i < numbers.size(); ++i)
+    {
+        numbers[i] = static_cast<double>(i) / 8;
+    }
+    run_decode("vector<double>", numbers);
+    run_decode("vector<vector<double>>", matrix);
+    run_decode("map<string,vector<int>>", index);
+
+    std::unordered_map<std::string,int64_t> counts;
+    for (int64_t i = 0; i < 100000; ++i)
+    {
+        counts["key" + std::to_string(i)] = i;
+    }
+    run_decode("unordered_map<string,int64_t>", counts);
+    run_decode("vector<map<string,string>>", rows);
+
+    return 0;
+}
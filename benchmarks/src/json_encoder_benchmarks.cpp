@@ -0,0 +1,153 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_encoder.hpp>
+#include <jsoncons/result.hpp>
+#include <jsoncons/fd_result.hpp>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace jsoncons;
+
+namespace {
+
+    // An array of strings of the given mean length, mostly plain ASCII,
+    // with an occasional character that needs escaping
+    json make_strings(size_t count, size_t length, bool non_ascii)
+    {
+        static const char* const words[] = {"alpha","beta","gamma","delta","epsilon","zeta","eta","theta",
+                                            "path/to/file","\"quoted\"","tab\tbed","line\nbreak"};
+        std::mt19937 gen(1);
+        std::uniform_int_distribution<size_t> word(0, sizeof(words)/sizeof(words[0]) - 1);
+
+        json a = json::array();
+        a.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            std::string s;
+            while (s.size() < length)
+            {
+                size_t k = word(gen);
+                // Escapes in about one word in ten
+                s.append(words[k < 8 || gen() % 4 == 0 ? k : k % 8]);
+                s.push_back(' ');
+                if (non_ascii && gen() % 8 == 0)
+                {
+                    s.append("Stra\xc3\x9f" "e ");
+                }
+            }
+            a.push_back(std::move(s));
+        }
+        return a;
+    }
+
+    // Returns the throughput in MB/s of encoding doc with options
+    double measure(const json& doc, const json_options& options, indenting line_indent)
+    {
+        typedef std::chrono::high_resolution_clock clock_type;
+
+        std::string s;
+        size_t bytes = 0;
+        size_t iterations = 0;
+        auto start = clock_type::now();
+        std::chrono::duration<double> elapsed(0);
+        do
+        {
+            s.clear();
+            doc.dump(s, options, line_indent);
+            bytes += s.size();
+            ++iterations;
+            elapsed = clock_type::now() - start;
+        }
+        while (elapsed.count() < 0.5);
+
+        return static_cast<double>(bytes) / (1024.0*1024.0) / elapsed.count();
+    }
+
+    // Returns the throughput in MB/s of f, writing bytes per call
+    double measure(size_t bytes, const std::function<void()>& f)
+    {
+        typedef std::chrono::high_resolution_clock clock_type;
+
+        size_t iterations = 0;
+        auto start = clock_type::now();
+        std::chrono::duration<double> elapsed(0);
+        do
+        {
+            f();
+            ++iterations;
+            elapsed = clock_type::now() - start;
+        }
+        while (elapsed.count() < 0.5);
+
+        return static_cast<double>(bytes) * iterations / (1024.0*1024.0) / elapsed.count();
+    }
+
+    void run(const std::string& name, const json& doc)
+    {
+        json_options defaults;
+        json_options non_ascii;
+        non_ascii.escape_all_non_ascii(true);
+        json_options solidus;
+        solidus.escape_solidus(true);
+
+        std::cout << std::left << std::setw(24) << name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << measure(doc, defaults, indenting::no_indent)
+                  << std::setw(14) << measure(doc, defaults, indenting::indent)
+                  << std::setw(14) << measure(doc, non_ascii, indenting::no_indent)
+                  << std::setw(14) << measure(doc, solidus, indenting::no_indent) << std::endl;
+    }
+}
+
+int main()
+{
+    std::cout << std::left << std::setw(24) << "strings (MB/s)"
+              << std::right << std::setw(14) << "compressed"
+              << std::setw(14) << "pretty"
+              << std::setw(14) << "non-ascii"
+              << std::setw(14) << "solidus" << std::endl;
+
+    run("short ascii", make_strings(100000, 16, false));
+    run("long ascii", make_strings(10000, 1000, false));
+    run("long utf-8", make_strings(10000, 1000, true));
+
+    // The same document written through each result type
+    {
+        json doc = make_strings(100000, 16, false);
+        size_t bytes = doc.to_string().size();
+
+        std::cout << std::endl << std::left << std::setw(24) << "result (MB/s)"
+                  << std::right << std::setw(14) << "compressed" << std::endl;
+
+        std::string s;
+        std::cout << std::left << std::setw(24) << "string_result" << std::right << std::setw(14)
+                  << measure(bytes, [&]() {s.clear(); json_compressed_string_encoder encoder(s); doc.dump(encoder);}) << std::endl;
+
+        output_buffer buf;
+        std::cout << std::left << std::setw(24) << "buffer_result" << std::right << std::setw(14)
+                  << measure(bytes, [&]() {buf.clear(); basic_json_compressed_encoder<char,buffer_result<char>> encoder(buf); doc.dump(encoder);}) << std::endl;
+
+#if !defined(_WIN32)
+        std::ofstream os("/dev/null");
+        std::cout << std::left << std::setw(24) << "stream_result" << std::right << std::setw(14)
+                  << measure(bytes, [&]() {json_compressed_encoder encoder(os); doc.dump(encoder);}) << std::endl;
+
+        int fd = ::open("/dev/null", O_WRONLY);
+        std::cout << std::left << std::setw(24) << "fd_result" << std::right << std::setw(14)
+                  << measure(bytes, [&]() {basic_json_compressed_encoder<char,fd_result> encoder(fd); doc.dump(encoder);}) << std::endl;
+        ::close(fd);
+#endif
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+typedef basic_json<char,hash_index_policy,std::allocator<char>> hash_index_json;
+
+namespace {
+
+    const size_t sizes[] = {10, 100, 1000, 10000, 100000, 1000000};
+
+    // Inserting into json and ojson objects costs O(n) per member,
+    // they are skipped at larger sizes
+    const size_t max_linear_insert_size = 100000;
+
+    std::vector<std::string> make_keys(size_t n)
+    {
+        std::vector<std::string> keys;
+        keys.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            keys.push_back("member" + std::to_string(i));
+        }
+        std::mt19937 gen(1234);
+        std::shuffle(keys.begin(), keys.end(), gen);
+        return keys;
+    }
+
+    // Returns the mean time in ns of one call of f(j, key), repeating over
+    // all keys until at least a million operations have been performed
+    template <class Json, class F>
+    double measure(Json& j, const std::vector<std::string>& keys, F f)
+    {
+        typedef std::chrono::high_resolution_clock clock_type;
+
+        size_t rounds = 1 + 1000000 / keys.size();
+        auto start = clock_type::now();
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            for (const auto& key : keys)
+            {
+                f(j, key);
+            }
+        }
+        std::chrono::duration<double,std::nano> elapsed = clock_type::now() - start;
+        return elapsed.count() / (rounds * keys.size());
+    }
+
+    template <class Json>
+    void run(const char* name, const std::vector<std::string>& keys)
+    {
+        Json j;
+        // The first round inserts, later rounds assign
+        double insert_time = measure(j, keys, [](Json& j, const std::string& key)
+        {
+            j.insert_or_assign(key, 1);
+        });
+
+        Json j2;
+        double emplace_time = measure(j2, keys, [](Json& j, const std::string& key)
+        {
+            j.try_emplace(key, 1);
+        });
+
+        size_t found = 0;
+        double find_time = measure(j, keys, [&found](Json& j, const std::string& key)
+        {
+            if (j.find(key) != j.object_range().end())
+            {
+                ++found;
+            }
+        });
+        if (found == 0)
+        {
+            std::cerr << "No members found" << std::endl;
+        }
+
+        std::cout << std::left << std::setw(20) << name
+                  << std::right << std::setw(10) << keys.size()
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(20) << insert_time
+                  << std::setw(20) << emplace_time
+                  << std::setw(20) << find_time << std::endl;
+    }
+}
+
+int main()
+{
+    std::cout << std::left << std::setw(20) << "json type"
+              << std::right << std::setw(10) << "members"
+              << std::setw(20) << "insert_or_assign ns"
+              << std::setw(20) << "try_emplace ns"
+              << std::setw(20) << "find ns" << std::endl;
+
+    for (size_t n : sizes)
+    {
+        std::vector<std::string> keys = make_keys(n);
+
+        if (n <= max_linear_insert_size)
+        {
+            run<json>("json", keys);
+            run<ojson>("ojson", keys);
+        }
+        run<hash_index_json>("hash_index_json", keys);
+    }
+    return 0;
+}
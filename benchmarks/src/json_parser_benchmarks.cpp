@@ -0,0 +1,125 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace {
+
+    // Run from the tests directory
+    const char* const default_input_files[] =
+    {
+        "./input/address-book.json",
+        "./input/countries.json",
+        "./input/cyrillic.json",
+        "./input/employees.json",
+        "./input/json-multiline-comment.json",
+        "./input/locations.json",
+        "./input/members.json",
+        "./input/persons.json",
+        "./input/JSONPathTestSuite/document.json",
+        "./input/JSON_checker/pass1.json"
+    };
+
+    const double min_seconds = 0.5;
+
+    bool read_file(const std::string& path, std::string& content)
+    {
+        std::ifstream is(path, std::ios::binary);
+        if (!is)
+        {
+            return false;
+        }
+        std::ostringstream os;
+        os << is.rdbuf();
+        content = os.str();
+        return true;
+    }
+
+    // Returns the throughput in MB/s of f applied repeatedly to input
+    template <class F>
+    double measure(const std::string& input, F f)
+    {
+        typedef std::chrono::high_resolution_clock clock_type;
+
+        size_t iterations = 0;
+        auto start = clock_type::now();
+        std::chrono::duration<double> elapsed(0);
+        do
+        {
+            for (size_t i = 0; i < 16; ++i)
+            {
+                f(input);
+            }
+            iterations += 16;
+            elapsed = clock_type::now() - start;
+        }
+        while (elapsed.count() < min_seconds);
+
+        double bytes = static_cast<double>(input.size()) * iterations;
+        return bytes / (1024.0*1024.0) / elapsed.count();
+    }
+
+    void parse_to_null_handler(const std::string& input)
+    {
+        null_json_content_handler handler;
+        json_parser parser;
+        parser.update(input.data(), input.size());
+        parser.finish_parse(handler);
+    }
+
+    void parse_to_json(const std::string& input)
+    {
+        json j = json::parse(input);
+        (void)j;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        paths.push_back(argv[i]);
+    }
+    if (paths.empty())
+    {
+        for (auto path : default_input_files)
+        {
+            paths.push_back(path);
+        }
+    }
+
+    std::cout << std::left << std::setw(48) << "file"
+              << std::right << std::setw(12) << "bytes"
+              << std::setw(16) << "parser MB/s"
+              << std::setw(16) << "json MB/s" << std::endl;
+
+    for (const auto& path : paths)
+    {
+        std::string input;
+        if (!read_file(path, input))
+        {
+            std::cerr << "Cannot open " << path << std::endl;
+            continue;
+        }
+        double parser_rate = measure(input, parse_to_null_handler);
+        double json_rate = measure(input, parse_to_json);
+
+        std::cout << std::left << std::setw(48) << path
+                  << std::right << std::setw(12) << input.size()
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(16) << parser_rate
+                  << std::setw(16) << json_rate << std::endl;
+    }
+    return 0;
+}
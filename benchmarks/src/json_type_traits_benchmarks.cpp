@@ -0,0 +1,166 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+// Count allocations made through the global operator new
+
+namespace {
+    std::atomic<size_t> allocation_count(0);
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocation_count;
+    void* p = std::malloc(size != 0 ? size : 1);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+namespace ns {
+
+    struct position
+    {
+        double latitude;
+        double longitude;
+    };
+
+    struct trade
+    {
+        std::string symbol;
+        int64_t quantity;
+        double price;
+        bool buy;
+        std::vector<std::string> venues;
+        position origin;
+    };
+
+    struct message
+    {
+        uint64_t sequence;
+        std::string account;
+        std::vector<trade> trades;
+    };
+
+    // Reads the header fields of a message and skips the trades
+    struct header
+    {
+        uint64_t sequence;
+        std::string account;
+    };
+
+} // namespace ns
+
+JSONCONS_MEMBER_TRAITS_DECL(ns::position, latitude, longitude)
+JSONCONS_MEMBER_TRAITS_DECL(ns::trade, symbol, quantity, price, buy, venues, origin)
+JSONCONS_MEMBER_TRAITS_DECL(ns::message, sequence, account, trades)
+JSONCONS_MEMBER_TRAITS_DECL(ns::header, sequence, account)
+
+namespace {
+
+    ns::message make_message(size_t trades)
+    {
+        ns::message msg;
+        msg.sequence = 123456789;
+        msg.account = "ACCT-0042";
+        for (size_t i = 0; i < trades; ++i)
+        {
+            ns::trade t;
+            t.symbol = "SYM" + std::to_string(i % 50);
+            t.quantity = static_cast<int64_t>(100 * (i + 1));
+            t.price = 101.25 + static_cast<double>(i) / 8;
+            t.buy = (i % 2) == 0;
+            t.venues = {"XNYS", "XNAS"};
+            t.origin = ns::position{40.7128, -74.0060};
+            msg.trades.push_back(std::move(t));
+        }
+        return msg;
+    }
+
+    // Returns the mean time in microseconds of one call of f, and the number
+    // of allocations it makes
+    double measure(const std::function<void()>& f, size_t& allocations)
+    {
+        typedef std::chrono::high_resolution_clock clock_type;
+
+        size_t count = allocation_count;
+        f();
+        allocations = allocation_count - count;
+
+        size_t iterations = 0;
+        auto start = clock_type::now();
+        std::chrono::duration<double,std::micro> elapsed(0);
+        do
+        {
+            f();
+            ++iterations;
+            elapsed = clock_type::now() - start;
+        }
+        while (elapsed.count() < 500000);
+        return elapsed.count() / iterations;
+    }
+
+    void report(const std::string& name, const std::function<void()>& f)
+    {
+        size_t allocations = 0;
+        double time = measure(f, allocations);
+        std::cout << std::left << std::setw(32) << name
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(14) << time
+                  << std::setw(14) << allocations << std::endl;
+    }
+}
+
+int main()
+{
+    std::cout << std::left << std::setw(32) << ""
+              << std::right << std::setw(14) << "us"
+              << std::setw(14) << "allocations" << std::endl;
+
+    for (size_t trades : {1, 10, 100})
+    {
+        ns::message msg = make_message(trades);
+        std::string s;
+        encode_json(msg, s);
+
+        std::cout << std::endl << trades << " trades, " << s.size() << " bytes" << std::endl;
+
+        std::string out;
+        out.reserve(s.size());
+        report("encode through json", [&]() {out.clear(); json(msg).dump(out);});
+        report("encode_json", [&]() {out.clear(); encode_json(msg, out);});
+
+        ns::message result;
+        report("decode through json", [&]() {result = json::parse(s).as<ns::message>();});
+        report("decode_json", [&]() {result = decode_json<ns::message>(s);});
+
+        ns::header h;
+        report("decode_json header only", [&]() {h = decode_json<ns::header>(s);});
+
+        std::vector<uint8_t> v;
+        cbor::encode_cbor(msg, v);
+        report("decode cbor through json", [&]() {result = cbor::decode_cbor<json>(v).as<ns::message>();});
+        report("decode_cbor", [&]() {result = cbor::decode_cbor<ns::message>(v);});
+    }
+    return 0;
+}
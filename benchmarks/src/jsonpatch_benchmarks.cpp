@@ -0,0 +1,180 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpatch/jsonpatch.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace {
+
+    const size_t sizes[] = {1000, 10000, 100000, 500000};
+
+    json make_record(size_t id)
+    {
+        json record;
+        record["id"] = id;
+        record["name"] = "service-" + std::to_string(id);
+        record["enabled"] = (id % 3) != 0;
+        json ports = json::array();
+        ports.push_back(8000 + id % 100);
+        ports.push_back(9000 + id % 100);
+        record["ports"] = std::move(ports);
+        return record;
+    }
+
+    json make_config(size_t count)
+    {
+        json records = json::array();
+        records.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            records.push_back(make_record(i));
+        }
+        json config;
+        config["version"] = 1;
+        config["records"] = std::move(records);
+        return config;
+    }
+
+    // Changes about one record in a hundred: edits, insertions, removals and moves
+    json mutate(const json& config, std::mt19937& gen)
+    {
+        json result = config;
+        result["version"] = 2;
+        json& records = result.at("records");
+        size_t changes = 1 + records.size() / 100;
+        for (size_t k = 0; k < changes; ++k)
+        {
+            size_t i = gen() % records.size();
+            switch (k % 4)
+            {
+                case 0:
+                    records[i]["enabled"] = !records[i]["enabled"].as<bool>();
+                    break;
+                case 1:
+                    records.insert(records.array_range().begin() + i, make_record(1000000 + k));
+                    break;
+                case 2:
+                    records.erase(records.array_range().begin() + i);
+                    break;
+                case 3:
+                {
+                    json moved = records[i];
+                    records.erase(records.array_range().begin() + i);
+                    records.insert(records.array_range().begin() + gen() % records.size(), std::move(moved));
+                    break;
+                }
+            }
+        }
+        return result;
+    }
+}
+
+int main()
+{
+    typedef std::chrono::high_resolution_clock clock_type;
+
+    std::cout << std::left << std::setw(10) << "records"
+              << std::right << std::setw(16) << "from_diff ms"
+              << std::setw(12) << "ops"
+              << std::setw(16) << "patch bytes"
+              << std::setw(16) << "apply ms"
+              << std::setw(16) << "compiled ms" << std::endl;
+
+    std::mt19937 gen(1234);
+    for (size_t n : sizes)
+    {
+        json source = make_config(n);
+        json target = mutate(source, gen);
+
+        auto start = clock_type::now();
+        json patch = jsonpatch::from_diff(source, target);
+        std::chrono::duration<double,std::milli> diff_time = clock_type::now() - start;
+
+        std::string text;
+        patch.dump(text);
+
+        json doc = source;
+        start = clock_type::now();
+        jsonpatch::apply_patch(doc, patch);
+        std::chrono::duration<double,std::milli> apply_time = clock_type::now() - start;
+        if (doc != target)
+        {
+            std::cerr << "Patch does not produce the target" << std::endl;
+        }
+
+        // Compiled once, applied without an undo log
+        auto expr = jsonpatch::jsonpatch_expression<json>::compile(patch);
+        doc = source;
+        start = clock_type::now();
+        expr.apply(doc, jsonpatch::jsonpatch_options().rollback(false));
+        std::chrono::duration<double,std::milli> compiled_time = clock_type::now() - start;
+        if (doc != target)
+        {
+            std::cerr << "Compiled patch does not produce the target" << std::endl;
+        }
+
+        std::cout << std::left << std::setw(10) << n
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(16) << diff_time.count()
+                  << std::setw(12) << patch.size()
+                  << std::setw(16) << text.size()
+                  << std::setw(16) << apply_time.count()
+                  << std::setw(16) << compiled_time.count() << std::endl;
+    }
+
+    // Many small patches to one large document
+    {
+        const size_t count = 10000;
+        json doc = make_config(100000);
+        std::vector<json> patches;
+        for (size_t k = 0; k < count; ++k)
+        {
+            std::string path = "/records/" + std::to_string(gen() % 100000);
+            json patch = json::array();
+            json op;
+            op["op"] = "replace";
+            op["path"] = path + "/enabled";
+            op["value"] = (k % 2) == 0;
+            patch.push_back(std::move(op));
+            op = json();
+            op["op"] = "add";
+            op["path"] = path + "/ports/-";
+            op["value"] = k;
+            patch.push_back(std::move(op));
+            patches.push_back(std::move(patch));
+        }
+
+        auto start = clock_type::now();
+        for (const auto& patch : patches)
+        {
+            jsonpatch::apply_patch(doc, patch);
+        }
+        std::chrono::duration<double,std::milli> apply_time = clock_type::now() - start;
+
+        std::vector<jsonpatch::jsonpatch_expression<json>> exprs;
+        for (const auto& patch : patches)
+        {
+            exprs.push_back(jsonpatch::jsonpatch_expression<json>::compile(patch));
+        }
+        start = clock_type::now();
+        for (const auto& expr : exprs)
+        {
+            expr.apply(doc, jsonpatch::jsonpatch_options().rollback(false));
+        }
+        std::chrono::duration<double,std::milli> compiled_time = clock_type::now() - start;
+
+        std::cout << std::endl << count << " patches of 2 operations to 100000 records: " 
+                  << std::fixed << std::setprecision(1)
+                  << "apply_patch " << apply_time.count() << " ms, "
+                  << "compiled without rollback " << compiled_time.count() << " ms" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,107 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace {
+
+    const size_t sizes[] = {10, 100, 1000, 10000, 100000};
+
+    // An array of n objects, each with a nested array, so that the values
+    // selected are subtrees that are expensive to compare
+    json make_array(size_t n)
+    {
+        json a = json::array();
+        a.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            json item;
+            item["id"] = i % 10;
+            item["name"] = "item";
+            json tags = json::array();
+            for (size_t k = 0; k < 8; ++k)
+            {
+                tags.push_back(k);
+            }
+            item["tags"] = std::move(tags);
+            a.push_back(std::move(item));
+        }
+        return a;
+    }
+
+    // Returns the mean time in ms of one evaluation of path, repeating
+    // until at least a million values have been selected
+    double measure(const json& root, const std::string& path, jsonpath::result_type result_t, 
+                   const jsonpath::jsonpath_options& options, size_t& count)
+    {
+        typedef std::chrono::high_resolution_clock clock_type;
+
+        auto expr = jsonpath::jsonpath_expression<json>::compile(path);
+        count = expr.evaluate(root, result_t, options).size();
+
+        size_t rounds = 1 + 1000000 / (count + 1);
+        auto start = clock_type::now();
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            if (expr.evaluate(root, result_t, options).size() != count)
+            {
+                std::cerr << "Unexpected result for " << path << std::endl;
+            }
+        }
+        std::chrono::duration<double,std::milli> elapsed = clock_type::now() - start;
+        return elapsed.count() / rounds;
+    }
+
+    void run(const json& root, const std::string& path)
+    {
+        jsonpath::jsonpath_options parallel;
+        parallel.num_threads(0);
+
+        size_t count = 0;
+        double value_time = measure(root, path, jsonpath::result_type::value, jsonpath::jsonpath_options(), count);
+        double path_time = measure(root, path, jsonpath::result_type::path, jsonpath::jsonpath_options(), count);
+        double parallel_time = measure(root, path, jsonpath::result_type::value, parallel, count);
+
+        std::cout << std::left << std::setw(32) << path
+                  << std::right << std::setw(10) << root.size()
+                  << std::setw(10) << count
+                  << std::fixed << std::setprecision(3)
+                  << std::setw(16) << value_time
+                  << std::setw(16) << path_time
+                  << std::setw(16) << parallel_time << std::endl;
+    }
+}
+
+int main()
+{
+    std::cout << std::left << std::setw(32) << "path"
+              << std::right << std::setw(10) << "elements"
+              << std::setw(10) << "selected"
+              << std::setw(16) << "values ms"
+              << std::setw(16) << "paths ms"
+              << std::setw(16) << "parallel ms" << std::endl;
+
+    for (size_t n : sizes)
+    {
+        json root = make_array(n);
+
+        // A slice on its own is not de-duplicated, it is the baseline
+        // for the unions below
+        run(root, "$[0:]");
+        // Overlapping slices, every element is selected twice
+        run(root, "$[0:,0:]");
+        run(root, "$[*].tags[0:4,2:8]");
+        run(root, "$..['id','name']");
+        // Visits every node, selects few
+        run(root, "$..[?(@.id == 1)].name");
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace {
+
+    json make_document()
+    {
+        json doc;
+        json accounts = json::array();
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            json account;
+            account["id"] = i;
+            account["limits/daily"] = 100 * i;
+            json owner;
+            owner["name"] = "owner-" + std::to_string(i);
+            owner["tier"] = i % 3;
+            account["owner"] = std::move(owner);
+            accounts.push_back(std::move(account));
+        }
+        doc["accounts"] = std::move(accounts);
+        return doc;
+    }
+
+    template <class F>
+    double measure(size_t rounds, F f)
+    {
+        typedef std::chrono::high_resolution_clock clock_type;
+        auto start = clock_type::now();
+        for (size_t r = 0; r < rounds; ++r)
+        {
+            f(r);
+        }
+        std::chrono::duration<double,std::nano> elapsed = clock_type::now() - start;
+        return elapsed.count() / rounds;
+    }
+}
+
+int main()
+{
+    const size_t rounds = 1000000;
+    json doc = make_document();
+
+    // The pointers a rules engine evaluates over and over
+    std::vector<std::string> paths = {"/accounts/17/owner/tier", "/accounts/999/limits~1daily", "/accounts/500/owner/name"};
+    std::vector<jsonpointer::address> addresses;
+    for (const auto& path : paths)
+    {
+        addresses.emplace_back(path);
+    }
+
+    std::cout << std::left << std::setw(32) << "pointer"
+              << std::right << std::setw(16) << "string ns"
+              << std::setw(16) << "address ns" << std::endl;
+
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        size_t found = 0;
+        double string_time = measure(rounds, [&](size_t)
+        {
+            found += jsonpointer::get(doc, paths[i]).is_null() ? 0 : 1;
+        });
+        double address_time = measure(rounds, [&](size_t)
+        {
+            found += jsonpointer::get(doc, addresses[i]).is_null() ? 0 : 1;
+        });
+        if (found != 2*rounds)
+        {
+            std::cerr << "Unexpected result for " << paths[i] << std::endl;
+        }
+
+        std::cout << std::left << std::setw(32) << paths[i]
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(16) << string_time
+                  << std::setw(16) << address_time << std::endl;
+    }
+
+    jsonpointer::address tier("/accounts/17/owner/tier");
+    double replace_time = measure(rounds, [&](size_t r)
+    {
+        jsonpointer::replace(doc, tier, json(r % 3));
+    });
+    std::cout << std::left << std::setw(32) << "replace with address"
+              << std::right << std::setw(32) << replace_time << std::endl;
+    return 0;
+}
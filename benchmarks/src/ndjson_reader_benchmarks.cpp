@@ -0,0 +1,87 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/ndjson_reader.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace {
+
+    const size_t line_count = 200000;
+
+    std::string make_ndjson(size_t count)
+    {
+        std::string s;
+        for (size_t i = 0; i < count; ++i)
+        {
+            s += "{\"id\":" + std::to_string(i)
+               + ",\"name\":\"customer" + std::to_string(i) + "\""
+               + ",\"active\":" + (i % 3 == 0 ? "true" : "false")
+               + ",\"balance\":" + std::to_string(i * 1.25)
+               + ",\"tags\":[\"alpha\",\"beta\",\"gamma\"]"
+               + ",\"address\":{\"street\":\"" + std::to_string(i % 1000) + " Queen St W\",\"city\":\"Toronto\"}}\n";
+        }
+        return s;
+    }
+
+    // Returns the throughput in MB/s
+    double measure(const std::string& input, size_t num_threads, bool ordered)
+    {
+        typedef std::chrono::high_resolution_clock clock_type;
+
+        size_t count = 0;
+        auto start = clock_type::now();
+        ndjson_reader reader(input, ndjson_options().num_threads(num_threads).ordered(ordered));
+        reader.read_documents([&count](json&&){++count;});
+        std::chrono::duration<double> elapsed = clock_type::now() - start;
+
+        if (count != line_count)
+        {
+            std::cerr << "Expected " << line_count << " documents, read " << count << std::endl;
+        }
+        return static_cast<double>(input.size()) / (1024.0*1024.0) / elapsed.count();
+    }
+}
+
+// Usage: ndjson_reader_benchmarks [max_threads]
+int main(int argc, char** argv)
+{
+    size_t max_threads = argc > 1 ? static_cast<size_t>(std::atoi(argv[1])) : std::thread::hardware_concurrency();
+    if (max_threads == 0)
+    {
+        max_threads = 1;
+    }
+
+    std::string input = make_ndjson(line_count);
+    std::cout << "input: " << line_count << " lines, " << input.size() << " bytes" << std::endl;
+
+    std::cout << std::right << std::setw(10) << "threads"
+              << std::setw(16) << "ordered MB/s"
+              << std::setw(16) << "unordered MB/s" << std::endl;
+
+    std::vector<size_t> thread_counts;
+    for (size_t n = 1; n < max_threads; n *= 2)
+    {
+        thread_counts.push_back(n);
+    }
+    thread_counts.push_back(max_threads);
+
+    for (size_t n : thread_counts)
+    {
+        double ordered_rate = measure(input, n, true);
+        double unordered_rate = measure(input, n, false);
+        std::cout << std::setw(10) << n
+                  << std::fixed << std::setprecision(1)
+                  << std::setw(16) << ordered_rate
+                  << std::setw(16) << unordered_rate << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,282 @@
+// Copyright 2019 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_ARENA_HPP
+#define JSONCONS_ARENA_HPP
+
+#include <cstddef> // std::size_t, std::max_align_t
+#include <cstdint> // uintptr_t
+#include <new> // std::bad_alloc, ::operator new
+#include <memory> // std::allocator
+#include <utility> // std::swap
+#include <type_traits> // std::true_type
+#include <jsoncons/config/jsoncons_config.hpp>
+#include <jsoncons/detail/type_traits.hpp>
+
+namespace jsoncons {
+
+// arena
+
+// A chunked bump-pointer arena. Memory is handed out from the current chunk
+// and is only returned wholesale, by reset() (which keeps the chunks for reuse)
+// or release(), so destroying values that live in the arena performs no
+// per-node frees.
+
+class arena
+{
+    struct chunk
+    {
+        chunk* next_;
+        size_t size_;
+    };
+
+    static const size_t default_chunk_size = 65536;
+
+    size_t chunk_size_;
+    chunk* head_;
+    chunk* current_;
+    char* ptr_;
+    char* end_;
+    size_t bytes_allocated_;
+
+    // Noncopyable
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+public:
+    arena()
+        : arena(default_chunk_size)
+    {
+    }
+
+    explicit arena(size_t chunk_size)
+        : chunk_size_(chunk_size > 0 ? chunk_size : default_chunk_size),
+          head_(nullptr), current_(nullptr), ptr_(nullptr), end_(nullptr),
+          bytes_allocated_(0)
+    {
+    }
+
+    arena(arena&& other)
+        : chunk_size_(other.chunk_size_),
+          head_(nullptr), current_(nullptr), ptr_(nullptr), end_(nullptr),
+          bytes_allocated_(0)
+    {
+        swap(other);
+    }
+
+    ~arena()
+    {
+        release();
+    }
+
+    arena& operator=(arena&& other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    void swap(arena& other)
+    {
+        std::swap(chunk_size_, other.chunk_size_);
+        std::swap(head_, other.head_);
+        std::swap(current_, other.current_);
+        std::swap(ptr_, other.ptr_);
+        std::swap(end_, other.end_);
+        std::swap(bytes_allocated_, other.bytes_allocated_);
+    }
+
+    void* allocate(size_t n, size_t alignment = alignof(std::max_align_t))
+    {
+        char* p = align_up(ptr_, alignment);
+        // Aligning up can move p past the end of the chunk, compare the
+        // pointers before taking the distance
+        if (p == nullptr || p > end_ || n > static_cast<size_t>(end_ - p))
+        {
+            p = next_chunk(n, alignment);
+        }
+        ptr_ = p + n;
+        bytes_allocated_ += n;
+        return p;
+    }
+
+    // Individual deallocation is a no-op, memory is reclaimed by reset() or release()
+    void deallocate(void*, size_t)
+    {
+    }
+
+    // Makes all chunks available for reuse. Values allocated in the arena
+    // must no longer be used.
+    void reset()
+    {
+        current_ = head_;
+        ptr_ = current_ != nullptr ? chunk_begin(current_) : nullptr;
+        end_ = current_ != nullptr ? chunk_end(current_) : nullptr;
+        bytes_allocated_ = 0;
+    }
+
+    // Returns all chunks to the heap. Values allocated in the arena
+    // must no longer be used.
+    void release()
+    {
+        while (head_ != nullptr)
+        {
+            chunk* next = head_->next_;
+            ::operator delete(head_);
+            head_ = next;
+        }
+        current_ = nullptr;
+        ptr_ = nullptr;
+        end_ = nullptr;
+        bytes_allocated_ = 0;
+    }
+
+    size_t bytes_allocated() const
+    {
+        return bytes_allocated_;
+    }
+
+    size_t chunk_size() const
+    {
+        return chunk_size_;
+    }
+private:
+    static char* align_up(char* p, size_t alignment)
+    {
+        uintptr_t u = reinterpret_cast<uintptr_t>(p);
+        return reinterpret_cast<char*>((u + (alignment - 1)) & ~static_cast<uintptr_t>(alignment - 1));
+    }
+
+    static char* chunk_begin(chunk* c)
+    {
+        return reinterpret_cast<char*>(c) + sizeof(chunk);
+    }
+
+    static char* chunk_end(chunk* c)
+    {
+        return chunk_begin(c) + c->size_;
+    }
+
+    char* next_chunk(size_t n, size_t alignment)
+    {
+        // Reuse chunks retained by reset() when they are large enough
+        while (current_ != nullptr && current_->next_ != nullptr)
+        {
+            current_ = current_->next_;
+            char* p = align_up(chunk_begin(current_), alignment);
+            if (p <= chunk_end(current_) && n <= static_cast<size_t>(chunk_end(current_) - p))
+            {
+                end_ = chunk_end(current_);
+                return p;
+            }
+        }
+
+        size_t size = n + alignment > chunk_size_ ? n + alignment : chunk_size_;
+        chunk* c = static_cast<chunk*>(::operator new(sizeof(chunk) + size));
+        c->next_ = nullptr;
+        c->size_ = size;
+        if (current_ == nullptr)
+        {
+            head_ = c;
+        }
+        else
+        {
+            current_->next_ = c;
+        }
+        current_ = c;
+        end_ = chunk_end(c);
+        return align_up(chunk_begin(c), alignment);
+    }
+};
+
+// arena_allocator
+
+// A stateful allocator that allocates from an arena. A default constructed
+// arena_allocator is not bound to an arena and uses the global heap.
+
+template <class T>
+class arena_allocator
+{
+    template <class U> friend class arena_allocator;
+
+    arena* arena_;
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    template <class U>
+    struct rebind
+    {
+        typedef arena_allocator<U> other;
+    };
+
+    arena_allocator() noexcept
+        : arena_(nullptr)
+    {
+    }
+
+    arena_allocator(arena& a) noexcept
+        : arena_(std::addressof(a))
+    {
+    }
+
+    arena_allocator(const arena_allocator&) noexcept = default;
+
+    template <class U>
+    arena_allocator(const arena_allocator<U>& other) noexcept
+        : arena_(other.arena_)
+    {
+    }
+
+    arena_allocator& operator=(const arena_allocator&) noexcept = default;
+
+    arena* get_arena() const noexcept
+    {
+        return arena_;
+    }
+
+    T* allocate(size_type n)
+    {
+        if (arena_ == nullptr)
+        {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(arena_->allocate(n*sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_type n) noexcept
+    {
+        if (arena_ == nullptr)
+        {
+            std::allocator<T>().deallocate(p, n);
+        }
+    }
+
+    friend bool operator==(const arena_allocator& lhs, const arena_allocator& rhs) noexcept
+    {
+        return lhs.arena_ == rhs.arena_;
+    }
+
+    friend bool operator!=(const arena_allocator& lhs, const arena_allocator& rhs) noexcept
+    {
+        return lhs.arena_ != rhs.arena_;
+    }
+};
+
+// An empty object in an arena document is created implicitly with a
+// default constructed arena_allocator, which allocates from the heap
+template <class T>
+struct is_default_constructible_allocator<arena_allocator<T>> : public std::true_type
+{};
+
+}
+
+#endif
@@ -58,6 +58,17 @@ struct preserve_order_policy : public sorted_policy
     static constexpr bool preserve_order = true;
 };
 
+// Preserves insertion order, and looks members up through a hash index
+// once an object has HashIndexThreshold or more members
+
+template <size_t HashIndexThreshold = 32>
+struct basic_hash_index_policy : public preserve_order_policy
+{
+    static constexpr size_t hash_index_threshold = HashIndexThreshold;
+};
+
+typedef basic_hash_index_policy<> hash_index_policy;
+
 template <typename IteratorT>
 class range 
 {
@@ -1825,13 +1836,13 @@ public:
             return evaluate().as_bignum();
         }
 
-        template <class SAllocator=std::allocator<CharT>>
+        template <class SAllocator=char_allocator_type>
         string_type as_string() const 
         {
             return evaluate().as_string();
         }
 
-        template <class SAllocator=std::allocator<CharT>>
+        template <class SAllocator=char_allocator_type>
         string_type as_string(const SAllocator& allocator) const 
         {
             return evaluate().as_string(allocator);
@@ -1843,13 +1854,13 @@ public:
             return evaluate().template as_byte_string<BAllocator>();
         }
 
-        template <class SAllocator=std::allocator<CharT>>
+        template <class SAllocator=char_allocator_type>
         string_type as_string(const basic_json_options<char_type>& options) const
         {
             return evaluate().as_string(options);
         }
 
-        template <class SAllocator=std::allocator<CharT>>
+        template <class SAllocator=char_allocator_type>
         string_type as_string(const basic_json_options<char_type>& options,
                               const SAllocator& allocator) const
         {
@@ -3374,7 +3385,7 @@ public:
     template<class U=Allocator>
     void create_object_implicitly()
     {
-        static_assert(is_stateless<U>::value, "Cannot create object implicitly - allocator is stateful.");
+        static_assert(is_default_constructible_allocator<U>::value, "Cannot create object implicitly - allocator is stateful.");
         var_ = variant(object(Allocator()), semantic_tag::none);
     }
 
@@ -3587,25 +3598,25 @@ public:
         return var_.as_bignum();
     }
 
-    template <class SAllocator=std::allocator<CharT>>
+    template <class SAllocator=char_allocator_type>
     string_type as_string() const 
     {
         return as_string(basic_json_options<char_type>(),SAllocator());
     }
 
-    template <class SAllocator=std::allocator<CharT>>
+    template <class SAllocator=char_allocator_type>
     string_type as_string(const SAllocator& allocator) const 
     {
         return as_string(basic_json_options<char_type>(),allocator);
     }
 
-    template <class SAllocator=std::allocator<CharT>>
+    template <class SAllocator=char_allocator_type>
     string_type as_string(const basic_json_options<char_type>& options) const 
     {
         return as_string(options,SAllocator());
     }
 
-    template <class SAllocator=std::allocator<CharT>>
+    template <class SAllocator=char_allocator_type>
     string_type as_string(const basic_json_options<char_type>& options,
                           const SAllocator& allocator) const 
     {
@@ -488,10 +488,11 @@ public:
                     sumLo = sumHi;
                     sumHi = carry;
                     carry = 0;
-                    for ( jA=0; jA < x.length(); jA++ )
+                    // jA <= i, so jB = i - jA does not wrap
+                    for ( jA=0; jA < x.length() && jA <= i; jA++ )
                     {
                         jB = i - jA;
-                        if ( jB >= 0 && jB < y.length() )
+                        if ( jB < y.length() )
                         {
                             DDproduct( x.data_[jA], y.data_[jB], hi, lo );
                             sumLo_old = sumLo;
@@ -539,7 +540,7 @@ public:
         if ( k )  // 0 < k < basic_type_bits:
         {
             uint64_t k1 = basic_type_bits - k;
-            uint64_t mask = (1 << k) - 1;
+            uint64_t mask = (uint64_t(1) << k) - 1;
             incr_length( length() + 1 );
             for (size_t i = length(); i-- > 0; )
             {
@@ -574,7 +575,7 @@ public:
 
         size_t n = (size_t)(length() - 1);
         int64_t k1 = basic_type_bits - k;
-        uint64_t mask = (1 << k) - 1;
+        uint64_t mask = (uint64_t(1) << k) - 1;
         for (size_t i = 0; i <= n; i++)
         {
             data_[i] >>= k;
@@ -1415,7 +1416,7 @@ private:
             {
                 std::memcpy( data_, data_old, len_old*sizeof(uint64_t) );
             }
-            if ( dynamic_ )
+            if ( data_old != values_ ) // not values_, tested by address so that GCC can see values_ is never freed
             {
                 allocator().deallocate(data_old,capacity_);
             }
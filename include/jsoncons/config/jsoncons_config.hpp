@@ -85,6 +85,20 @@
 #define JSONCONS_HAS_FOPEN_S
 #endif
 
+// Define JSONCONS_NO_SIMD to disable the vectorized character scanning paths
+
+#if !defined(JSONCONS_NO_SIMD)
+#  if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define JSONCONS_HAS_SSE2 1
+#  endif
+#  if defined(__AVX2__)
+#    define JSONCONS_HAS_AVX2 1
+#  elif defined(JSONCONS_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__)) && !defined(__INTEL_COMPILER)
+     // AVX2 code paths are compiled with target attributes and selected at runtime
+#    define JSONCONS_HAS_AVX2_DISPATCH 1
+#  endif
+#endif
+
 #if !defined(JSONCONS_HAS_STRING_VIEW)
 #include <jsoncons/detail/string_view.hpp>
 namespace jsoncons {
@@ -15,6 +15,7 @@
 #include <exception>
 #include <jsoncons/config/jsoncons_config.hpp>
 #include <jsoncons/json_options.hpp>
+#include <jsoncons/bignum.hpp>
 #include <jsoncons/detail/grisu3.hpp>
 #include <jsoncons/detail/parse_number.hpp>
 
@@ -77,75 +78,440 @@ size_t print_uinteger(uint64_t value, Result& result)
 
 // print_double
 
-template <class Result>
-void dump_buffer(const char* buffer, size_t length, char decimal_point, Result& result)
+// Decomposes a positive finite value as v = significand*2^exponent, with the
+// exponent no less than that of the smallest subnormal
+
+inline void decompose_double(double v, uint64_t& significand, int& exponent)
+{
+    const int digits = std::numeric_limits<double>::digits;
+    const int min_exponent = std::numeric_limits<double>::min_exponent - digits;
+
+    int e;
+    double f = std::frexp(v, &e);
+    significand = static_cast<uint64_t>(std::ldexp(f, digits));
+    exponent = e - digits;
+    if (exponent < min_exponent)
+    {
+        significand >>= (min_exponent - exponent);
+        exponent = min_exponent;
+    }
+}
+
+// dragon4
+
+// Exact shortest digit generation (Steele & White, Burger & Dybvig), 
+// v = buffer*10^K, same contract as grisu3 but never gives up
+
+inline bool dragon4(double v, char* buffer, int* length, int* K)
+{
+    const int digits = std::numeric_limits<double>::digits;
+    const int min_exponent = std::numeric_limits<double>::min_exponent - digits;
+
+    uint64_t f;
+    int e;
+    decompose_double(v, f, e);
+
+    // The boundaries round to v when the significand is even
+    const bool even = (f & 1) == 0;
+    // The gap below a power of two is half the gap above
+    const bool unequal_gaps = f == (uint64_t(1) << (digits - 1)) && e > min_exponent;
+    const uint64_t gap_shift = unequal_gaps ? 2 : 1;
+
+    // r/s = v, m_minus/s and m_plus/s are the distances to the boundaries, all scaled by 2 (or 4)
+    bignum r(f);
+    bignum s(1);
+    bignum m_minus(1);
+    if (e >= 0)
+    {
+        r <<= static_cast<uint64_t>(e);
+        m_minus <<= static_cast<uint64_t>(e);
+    }
+    else
+    {
+        s <<= static_cast<uint64_t>(-e);
+    }
+    r <<= gap_shift;
+    s <<= gap_shift;
+    bignum m_plus = m_minus;
+    if (unequal_gaps)
+    {
+        m_plus <<= 1;
+    }
+
+    // Estimate k = ceil(log10(v)), may be one too small
+    int k = static_cast<int>(std::ceil(std::log10(v) - 1e-10));
+    if (k >= 0)
+    {
+        s *= power(bignum(10), static_cast<unsigned>(k));
+    }
+    else
+    {
+        bignum scale = power(bignum(10), static_cast<unsigned>(-k));
+        r *= scale;
+        m_minus *= scale;
+        m_plus *= scale;
+    }
+    int cmp = (r + m_plus).compare(s);
+    if (even ? cmp >= 0 : cmp > 0)
+    {
+        s *= uint64_t(10);
+        ++k;
+    }
+
+    // Generate digits of 0.d1d2...*10^k until the remainder falls within the boundaries
+    int n = 0;
+    for (;;)
+    {
+        r *= uint64_t(10);
+        m_minus *= uint64_t(10);
+        m_plus *= uint64_t(10);
+        int d = 0;
+        while (r >= s)
+        {
+            r -= s;
+            ++d;
+        }
+        int low_cmp = r.compare(m_minus);
+        int high_cmp = (r + m_plus).compare(s);
+        bool low = even ? low_cmp <= 0 : low_cmp < 0;
+        bool high = even ? high_cmp >= 0 : high_cmp > 0;
+        if (!low && !high)
+        {
+            buffer[n++] = static_cast<char>('0' + d);
+            continue;
+        }
+        if (low && high)
+        {
+            // Both neighbours are within the boundaries, take the nearest, ties to even
+            int half_cmp = (r + r).compare(s);
+            high = half_cmp > 0 || (half_cmp == 0 && (d & 1) != 0);
+        }
+        buffer[n++] = static_cast<char>('0' + (high ? d + 1 : d));
+        break;
+    }
+    *length = n;
+    *K = k - n;
+    return true;
+}
+
+// Returns the decimal digits of v*10^exp10 rounded to the nearest integer, ties to even,
+// v positive and finite
+
+inline void round_scaled_double(double v, int exp10, std::string& digits)
 {
-    const char* sbeg = buffer;
-    const char* send = sbeg + length;
+    uint64_t f;
+    int e;
+    decompose_double(v, f, e);
 
-    if (sbeg != send)
+    // Fast path: f*5^exp10 fits in 128 bits and the rounded result in 64 bits
+    if (exp10 >= 0 && exp10 <= 27)
     {
-        bool needs_dot = true;
-        for (const char* q = sbeg; q < send; ++q)
+        uint64_t pow5 = 1;
+        for (int i = 0; i < exp10; ++i)
         {
-            switch (*q)
+            pow5 *= 5;
+        }
+        uint128_parts p = full_multiplication(f, pow5);
+        // v*10^exp10 = p*2^-shift
+        int shift = -(e + exp10);
+        bool fits = false;
+        uint64_t q = 0;
+        if (shift <= 0)
+        {
+            int left = -shift;
+            if (p.high == 0 && (left == 0 || (left < 64 && (p.low >> (64 - left)) == 0)))
             {
-                case '-':case '0':case '1':case '2':case '3':case '4':case '5':case '6':case '7':case '8':case '9':case '+':
-                    result.push_back(*q);
-                    break;
-                case 'e':
-                case 'E':
-                    result.push_back('e');
-                    needs_dot = false;
-                    break;
-                default:
-                    if (*q == decimal_point)
-                    {
-                        needs_dot = false;
-                        result.push_back('.');
-                    }
-                    break;
+                q = p.low << left;
+                fits = true;
             }
         }
-        if (needs_dot)
+        else if (shift >= 128)
         {
-            result.push_back('.');
-            result.push_back('0');
-            needs_dot = true;
+            // p < 2^116, less than half
+            fits = true;
+        }
+        else if (shift < 64 ? (p.high >> shift) == 0 : true)
+        {
+            q = shift < 64 ? (p.low >> shift) | (p.high << (64 - shift)) : p.high >> (shift - 64);
+            int i = shift - 1; // the rounding bit
+            bool round_bit;
+            bool sticky;
+            if (i < 64)
+            {
+                round_bit = ((p.low >> i) & 1) != 0;
+                sticky = (p.low & ((uint64_t(1) << i) - 1)) != 0;
+            }
+            else
+            {
+                round_bit = ((p.high >> (i - 64)) & 1) != 0;
+                sticky = p.low != 0 || (p.high & ((uint64_t(1) << (i - 64)) - 1)) != 0;
+            }
+            if (round_bit && (sticky || (q & 1) != 0))
+            {
+                fits = q != (std::numeric_limits<uint64_t>::max)();
+                ++q;
+            }
+            else
+            {
+                fits = true;
+            }
+        }
+        if (fits)
+        {
+            digits.clear();
+            print_uinteger(q, digits);
+            return;
+        }
+    }
+
+    bignum r(f);
+    bignum s(1);
+    if (e >= 0)
+    {
+        r <<= static_cast<uint64_t>(e);
+    }
+    else
+    {
+        s <<= static_cast<uint64_t>(-e);
+    }
+    if (exp10 >= 0)
+    {
+        r *= power(bignum(10), static_cast<unsigned>(exp10));
+    }
+    else
+    {
+        s *= power(bignum(10), static_cast<unsigned>(-exp10));
+    }
+    bignum q = r;
+    q /= s;
+    r -= q*s;
+    int cmp = (r + r).compare(s);
+    if (cmp > 0 || (cmp == 0 && (q % bignum(2)) != 0))
+    {
+        q += bignum(1);
+    }
+    digits.clear();
+    q.dump(digits);
+}
+
+// Returns precision significant digits of v rounded to nearest, ties to even,
+// and the decimal exponent of the first, v positive and finite
+
+inline int round_significant_digits(double v, int precision, std::string& digits)
+{
+    int exp10 = static_cast<int>(std::floor(std::log10(v)));
+    for (;;)
+    {
+        round_scaled_double(v, precision - 1 - exp10, digits);
+        int length = static_cast<int>(digits.size());
+        if (length == precision)
+        {
+            // An estimate one too high can also round up to 10^precision, 
+            // 1 followed by zeros, at the lower exponent it has precision digits too
+            if (digits[0] == '1' && digits.find_first_not_of('0', 1) == std::string::npos)
+            {
+                std::string lower;
+                round_scaled_double(v, precision - exp10, lower);
+                if (static_cast<int>(lower.size()) == precision)
+                {
+                    digits.swap(lower);
+                    return exp10 - 1;
+                }
+            }
+            return exp10;
         }
+        exp10 += length > precision ? 1 : -1;
     }
 }
 
 template <class Result>
-bool dtoa(double val, char decimal_point, Result& result, std::false_type)
+void dump_exponent(int exp10, Result& result)
 {
+    result.push_back('e');
+    if (exp10 < 0)
+    {
+        result.push_back('-');
+        exp10 = -exp10;
+    }
+    else
+    {
+        result.push_back('+');
+    }
+    if (exp10 < 10)
+    {
+        result.push_back('0');
+    }
+    print_uinteger(static_cast<uint64_t>(exp10), result);
+}
+
+// As printf %.*f
+template <class Result>
+void dump_fixed(double val, int decimal_places, Result& result)
+{
+    if (std::signbit(val))
+    {
+        result.push_back('-');
+        val = -val;
+    }
+    std::string digits;
     if (val == 0)
+    {
+        digits.push_back('0');
+    }
+    else
+    {
+        round_scaled_double(val, decimal_places, digits);
+    }
+    if (digits.size() <= static_cast<size_t>(decimal_places))
+    {
+        digits.insert(0, static_cast<size_t>(decimal_places) + 1 - digits.size(), '0');
+    }
+    size_t int_length = digits.size() - static_cast<size_t>(decimal_places);
+    for (size_t i = 0; i < int_length; ++i)
+    {
+        result.push_back(digits[i]);
+    }
+    result.push_back('.');
+    if (decimal_places == 0)
     {
         result.push_back('0');
+    }
+    for (size_t i = int_length; i < digits.size(); ++i)
+    {
+        result.push_back(digits[i]);
+    }
+}
+
+// As printf %.*e
+template <class Result>
+void dump_scientific(double val, int decimal_places, Result& result)
+{
+    if (std::signbit(val))
+    {
+        result.push_back('-');
+        val = -val;
+    }
+    std::string digits;
+    int exp10 = 0;
+    if (val == 0)
+    {
+        digits.assign(static_cast<size_t>(decimal_places) + 1, '0');
+    }
+    else
+    {
+        exp10 = round_significant_digits(val, decimal_places + 1, digits);
+    }
+    result.push_back(digits[0]);
+    if (digits.size() > 1)
+    {
         result.push_back('.');
-        result.push_back('0');
-        return true;
+        for (size_t i = 1; i < digits.size(); ++i)
+        {
+            result.push_back(digits[i]);
+        }
     }
+    dump_exponent(exp10, result);
+}
 
-    jsoncons::detail::string_to_double to_double_;
+// As printf %.*g
+template <class Result>
+void dump_general(double val, int precision, Result& result)
+{
+    if (precision == 0)
+    {
+        precision = 1;
+    }
+    if (std::signbit(val))
+    {
+        result.push_back('-');
+        val = -val;
+    }
+    std::string digits;
+    int exp10 = 0;
+    if (val == 0)
+    {
+        digits.push_back('0');
+    }
+    else
+    {
+        exp10 = round_significant_digits(val, precision, digits);
+        while (digits.size() > 1 && digits.back() == '0')
+        {
+            digits.pop_back();
+        }
+    }
+    int length = static_cast<int>(digits.size());
 
-    char buffer[100];
-    int precision = std::numeric_limits<double>::digits10;
-    int length = snprintf(buffer, sizeof(buffer), "%1.*g", precision, val);
-    if (length < 0)
+    if (exp10 >= -4 && exp10 < precision)
     {
-        return false;
+        if (exp10 < 0)
+        {
+            result.push_back('0');
+            result.push_back('.');
+            for (int i = exp10 + 1; i < 0; ++i)
+            {
+                result.push_back('0');
+            }
+            for (int i = 0; i < length; ++i)
+            {
+                result.push_back(digits[i]);
+            }
+        }
+        else
+        {
+            for (int i = 0; i <= exp10; ++i)
+            {
+                result.push_back(i < length ? digits[i] : '0');
+            }
+            result.push_back('.');
+            if (length <= exp10 + 1)
+            {
+                result.push_back('0');
+            }
+            for (int i = exp10 + 1; i < length; ++i)
+            {
+                result.push_back(digits[i]);
+            }
+        }
     }
-    if (to_double_(buffer,sizeof(buffer)) != val)
+    else
     {
-        const int precision2 = std::numeric_limits<double>::max_digits10;
-        length = snprintf(buffer, sizeof(buffer), "%1.*g", precision2, val);
-        if (length < 0)
+        result.push_back(digits[0]);
+        if (length > 1)
         {
-            return false;
+            result.push_back('.');
+            for (int i = 1; i < length; ++i)
+            {
+                result.push_back(digits[i]);
+            }
         }
+        dump_exponent(exp10, result);
+    }
+}
+
+template <class Result>
+bool dtoa(double v, char, Result& result, std::false_type)
+{
+    if (v == 0)
+    {
+        result.push_back('0');
+        result.push_back('.');
+        result.push_back('0');
+        return true;
     }
-    dump_buffer(buffer, length, decimal_point, result);
+
+    int length = 0;
+    int k;
+
+    char buffer[100];
+
+    double u = std::signbit(v) ? -v : v;
+    jsoncons::detail::dragon4(u, buffer, &length, &k);
+    if (std::signbit(v))
+    {
+        result.push_back('-');
+    }
+    jsoncons::detail::prettify_string(buffer, length, k, -4, std::numeric_limits<double>::max_digits10, result);
     return true;
 }
 
@@ -192,24 +558,11 @@ bool dtoa(double v, char decimal_point, Result& result)
 class print_double
 {
 private:
-    string_to_double to_double_;
     floating_point_options override_;
-    char decimal_point_;
 public:
     print_double(const floating_point_options& options)
         : override_(options)
     {
-#if !defined(JSONCONS_NO_LOCALECONV)
-        struct lconv * lc = localeconv();
-        if (lc != nullptr && lc->decimal_point[0] != 0)
-        {
-            decimal_point_ = lc->decimal_point[0];    
-        }
-        else
-#endif
-        {
-            decimal_point_ = '.'; 
-        }
     }
 
     template <class Result>
@@ -230,49 +583,23 @@ public:
             decimal_places = 0;
         }             
 
-        char number_buffer[200]; 
-        int length = 0;
-
         switch (format)
         {
         case chars_format::fixed:
-            {
-                length = snprintf(number_buffer, sizeof(number_buffer), "%1.*f", decimal_places, val);
-                if (length < 0)
-                {
-                    JSONCONS_THROW(json_runtime_error<std::invalid_argument>("print_double failed."));
-                }
-                dump_buffer(number_buffer, length, decimal_point_, result);
-            }
+            dump_fixed(val, decimal_places, result);
             break;
         case chars_format::scientific:
-            {
-                length = snprintf(number_buffer, sizeof(number_buffer), "%1.*e", decimal_places, val);
-                if (length < 0)
-                {
-                    JSONCONS_THROW(json_runtime_error<std::invalid_argument>("print_double failed."));
-                }
-                dump_buffer(number_buffer, length, decimal_point_, result);
-            }
+            dump_scientific(val, decimal_places, result);
             break;
         case chars_format::general:
             {
                 if (override_.precision() != 0)
                 {
-                    int precision = override_.precision();
-                    length = snprintf(number_buffer, sizeof(number_buffer), "%1.*g", precision, val);
-                    if (length < 0)
-                    {
-                        JSONCONS_THROW(json_runtime_error<std::invalid_argument>("print_double failed."));
-                    }
-                    dump_buffer(number_buffer, length, decimal_point_, result);
+                    dump_general(val, override_.precision(), result);
                 }
                 else
                 {
-                    if (!dtoa(val, decimal_point_, result))
-                    {
-                        JSONCONS_THROW(json_runtime_error<std::invalid_argument>("print_double failed."));
-                    }
+                    dtoa(val, '.', result);
                 }             
                 break;
             }
@@ -0,0 +1,335 @@
+// Copyright 2019 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_SCAN_CHARS_HPP
+#define JSONCONS_DETAIL_SCAN_CHARS_HPP
+
+#include <cstdint>
+#include <type_traits> // std::make_unsigned
+#include <jsoncons/config/jsoncons_config.hpp>
+
+#if defined(JSONCONS_HAS_SSE2)
+#include <emmintrin.h>
+#endif
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_AVX2_DISPATCH)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Character scanning primitives used by the parser's and encoder's hot loops. 
+// The char overloads examine 16 (SSE2) or 32 (AVX2) bytes at a time, the AVX2 
+// path being selected at runtime when the library is not compiled with -mavx2.
+// All other character types use the scalar loops.
+
+namespace jsoncons { namespace detail {
+
+#if defined(JSONCONS_HAS_AVX2_DISPATCH)
+#define JSONCONS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define JSONCONS_TARGET_AVX2
+#endif
+
+inline
+unsigned count_trailing_zeros(uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    unsigned n = 0;
+    while ((mask & 1) == 0)
+    {
+        mask >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+inline
+bool cpu_has_avx2()
+{
+#if defined(JSONCONS_HAS_AVX2)
+    return true;
+#elif defined(JSONCONS_HAS_AVX2_DISPATCH)
+    static const bool value = []() -> bool
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return value;
+#else
+    return false;
+#endif
+}
+
+template <class CharT>
+bool is_blank_char(CharT c)
+{
+    return c == ' ' || c == '\t';
+}
+
+// A character that ends a run of plain string content:
+// a quotation mark, a reverse solidus, or a control character
+
+template <class CharT>
+bool is_string_special_char(CharT c)
+{
+    typedef typename std::make_unsigned<CharT>::type uchar_type;
+    return static_cast<uchar_type>(c) < 0x20 || c == '\"' || c == '\\';
+}
+
+// A character that the encoder must escape: a quotation mark, a reverse solidus,
+// a control character or delete, and optionally a solidus or a non-ASCII character
+
+template <class CharT>
+bool is_escape_char(CharT c, bool escape_all_non_ascii, bool escape_solidus)
+{
+    typedef typename std::make_unsigned<CharT>::type uchar_type;
+    const uchar_type u = static_cast<uchar_type>(c);
+    return u < 0x20 || u == 0x7f || c == '\"' || c == '\\' 
+           || (escape_solidus && c == '/') || (escape_all_non_ascii && u >= 0x80);
+}
+
+// skip_blanks
+
+template <class CharT>
+const CharT* skip_blanks(const CharT* first, const CharT* last)
+{
+    while (first != last && is_blank_char(*first))
+    {
+        ++first;
+    }
+    return first;
+}
+
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_AVX2_DISPATCH)
+
+// Returns a pointer to the first non blank character, or to the start of
+// the last partial block of 32 characters
+
+JSONCONS_TARGET_AVX2 inline
+const char* skip_blanks_avx2(const char* first, const char* last)
+{
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    while (last - first >= 32)
+    {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        __m256i blanks = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space), _mm256_cmpeq_epi8(chunk, tab));
+        uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(blanks));
+        if (mask != 0)
+        {
+            return first + count_trailing_zeros(mask);
+        }
+        first += 32;
+    }
+    return first;
+}
+
+JSONCONS_TARGET_AVX2 inline
+const char* find_string_special_avx2(const char* first, const char* last)
+{
+    const __m256i quote = _mm256_set1_epi8('\"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i max_control = _mm256_set1_epi8(0x1f);
+    while (last - first >= 32)
+    {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        // unsigned chunk <= 0x1f
+        __m256i controls = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, max_control), chunk);
+        __m256i specials = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote),
+                                                           _mm256_cmpeq_epi8(chunk, backslash)),
+                                           controls);
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(specials));
+        if (mask != 0)
+        {
+            return first + count_trailing_zeros(mask);
+        }
+        first += 32;
+    }
+    return first;
+}
+
+JSONCONS_TARGET_AVX2 inline
+const char* find_escape_char_avx2(const char* first, const char* last, 
+                                  bool escape_all_non_ascii, bool escape_solidus)
+{
+    const __m256i quote = _mm256_set1_epi8('\"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i del = _mm256_set1_epi8(0x7f);
+    // Compares with the quotation mark again when solidus is not escaped
+    const __m256i solidus = _mm256_set1_epi8(escape_solidus ? '/' : '\"');
+    const __m256i max_control = _mm256_set1_epi8(0x1f);
+    const uint32_t non_ascii = escape_all_non_ascii ? 0xffffffff : 0;
+    while (last - first >= 32)
+    {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+        __m256i controls = _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, max_control), chunk);
+        __m256i specials = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote),
+                                                           _mm256_cmpeq_epi8(chunk, backslash)),
+                                           _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, del),
+                                                                           _mm256_cmpeq_epi8(chunk, solidus)),
+                                                           controls));
+        // The high bit of each byte is set for non-ASCII characters
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(specials)) 
+                        | (static_cast<uint32_t>(_mm256_movemask_epi8(chunk)) & non_ascii);
+        if (mask != 0)
+        {
+            return first + count_trailing_zeros(mask);
+        }
+        first += 32;
+    }
+    return first;
+}
+
+#endif
+
+inline
+const char* skip_blanks(const char* first, const char* last)
+{
+    if (first == last || !is_blank_char(*first))
+    {
+        return first;
+    }
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_AVX2_DISPATCH)
+    if (last - first >= 32 && cpu_has_avx2())
+    {
+        first = skip_blanks_avx2(first, last);
+    }
+#endif
+#if defined(JSONCONS_HAS_SSE2)
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    while (last - first >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        __m128i blanks = _mm_or_si128(_mm_cmpeq_epi8(chunk, space), _mm_cmpeq_epi8(chunk, tab));
+        uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_epi8(blanks)) & 0xffff;
+        if (mask != 0)
+        {
+            return first + count_trailing_zeros(mask);
+        }
+        first += 16;
+    }
+#endif
+    while (first != last && is_blank_char(*first))
+    {
+        ++first;
+    }
+    return first;
+}
+
+// find_string_special
+
+template <class CharT>
+const CharT* find_string_special(const CharT* first, const CharT* last)
+{
+    while (first != last && !is_string_special_char(*first))
+    {
+        ++first;
+    }
+    return first;
+}
+
+inline
+const char* find_string_special(const char* first, const char* last)
+{
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_AVX2_DISPATCH)
+    if (last - first >= 32 && cpu_has_avx2())
+    {
+        first = find_string_special_avx2(first, last);
+    }
+#endif
+#if defined(JSONCONS_HAS_SSE2)
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i max_control = _mm_set1_epi8(0x1f);
+    while (last - first >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        __m128i controls = _mm_cmpeq_epi8(_mm_min_epu8(chunk, max_control), chunk);
+        __m128i specials = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                     _mm_cmpeq_epi8(chunk, backslash)),
+                                        controls);
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(specials));
+        if (mask != 0)
+        {
+            return first + count_trailing_zeros(mask);
+        }
+        first += 16;
+    }
+#endif
+    while (first != last && !is_string_special_char(*first))
+    {
+        ++first;
+    }
+    return first;
+}
+
+// find_escape_char
+
+template <class CharT>
+const CharT* find_escape_char(const CharT* first, const CharT* last, 
+                              bool escape_all_non_ascii, bool escape_solidus)
+{
+    while (first != last && !is_escape_char(*first, escape_all_non_ascii, escape_solidus))
+    {
+        ++first;
+    }
+    return first;
+}
+
+inline
+const char* find_escape_char(const char* first, const char* last, 
+                             bool escape_all_non_ascii, bool escape_solidus)
+{
+#if defined(JSONCONS_HAS_AVX2) || defined(JSONCONS_HAS_AVX2_DISPATCH)
+    if (last - first >= 32 && cpu_has_avx2())
+    {
+        first = find_escape_char_avx2(first, last, escape_all_non_ascii, escape_solidus);
+    }
+#endif
+#if defined(JSONCONS_HAS_SSE2)
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i del = _mm_set1_epi8(0x7f);
+    const __m128i solidus = _mm_set1_epi8(escape_solidus ? '/' : '\"');
+    const __m128i max_control = _mm_set1_epi8(0x1f);
+    const uint32_t non_ascii = escape_all_non_ascii ? 0xffff : 0;
+    while (last - first >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+        __m128i controls = _mm_cmpeq_epi8(_mm_min_epu8(chunk, max_control), chunk);
+        __m128i specials = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                     _mm_cmpeq_epi8(chunk, backslash)),
+                                        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, del),
+                                                                  _mm_cmpeq_epi8(chunk, solidus)),
+                                                     controls));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(specials)) 
+                        | (static_cast<uint32_t>(_mm_movemask_epi8(chunk)) & non_ascii);
+        if (mask != 0)
+        {
+            return first + count_trailing_zeros(mask);
+        }
+        first += 16;
+    }
+#endif
+    while (first != last && !is_escape_char(*first, escape_all_non_ascii, escape_solidus))
+    {
+        ++first;
+    }
+    return first;
+}
+
+}}
+
+#endif
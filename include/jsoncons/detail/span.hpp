@@ -0,0 +1,86 @@
+// Copyright 2019 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_SPAN_HPP
+#define JSONCONS_DETAIL_SPAN_HPP
+
+#include <cstddef>
+
+namespace jsoncons { namespace detail {
+
+// A non-owning view of a contiguous sequence of objects
+
+template <class T>
+class span
+{
+public:
+    typedef T element_type;
+    typedef std::size_t size_type;
+    typedef T* pointer;
+    typedef T& reference;
+    typedef T* iterator;
+private:
+    pointer data_;
+    size_type size_;
+public:
+    span()
+        : data_(nullptr), size_(0)
+    {
+    }
+
+    span(pointer data, size_type size)
+        : data_(data), size_(size)
+    {
+    }
+
+    span(const span&) = default;
+
+    span& operator=(const span&) = default;
+
+    pointer data() const
+    {
+        return data_;
+    }
+
+    size_type size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    reference operator[](size_type index) const
+    {
+        return data_[index];
+    }
+
+    iterator begin() const
+    {
+        return data_;
+    }
+
+    iterator end() const
+    {
+        return data_ + size_;
+    }
+
+    span first(size_type count) const
+    {
+        return span(data_, count);
+    }
+
+    span subspan(size_type offset) const
+    {
+        return span(data_ + offset, size_ - offset);
+    }
+};
+
+}}
+
+#endif
@@ -15,6 +15,7 @@
 #include <iterator> // std::iterator_traits
 #include <exception>
 #include <array>
+#include <utility> // std::declval
 #include <jsoncons/config/jsoncons_config.hpp>
 #include <jsoncons/json_exception.hpp>
 
@@ -108,6 +109,14 @@ struct is_stateless
       std::is_empty<T>::value)>
 {};
 
+// A stateful allocator whose default constructed value is still usable,
+// for example one that falls back to the heap, specializes this to allow
+// basic_json to create objects implicitly
+template <typename T>
+struct is_default_constructible_allocator
+ : public is_stateless<T>
+{};
+
 // type traits extensions
 
 
@@ -221,6 +230,17 @@ struct is_vector_like<T,
 >::type> 
     : std::true_type {};
 
+// has_reserve
+
+template <class T, class Enable=void>
+struct has_reserve : std::false_type {};
+
+template <class T>
+struct has_reserve<T, 
+                   typename std::enable_if<std::is_void<decltype(std::declval<T&>().reserve(size_t()))>::value
+>::type> 
+    : std::true_type {};
+
 }
 
 }
@@ -0,0 +1,105 @@
+// Copyright 2019 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_WORKER_POOL_HPP
+#define JSONCONS_DETAIL_WORKER_POOL_HPP
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <utility> // std::move
+
+namespace jsoncons { namespace detail {
+
+// A fixed set of threads that run submitted tasks in submission order.
+// The destructor runs all tasks still queued before joining the threads.
+
+class worker_pool
+{
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stop_;
+
+    // noncopyable and nonmoveable
+    worker_pool(const worker_pool&) = delete;
+    worker_pool& operator=(const worker_pool&) = delete;
+public:
+    explicit worker_pool(size_t num_threads)
+        : stop_(false)
+    {
+        if (num_threads == 0)
+        {
+            num_threads = default_num_threads();
+        }
+        threads_.reserve(num_threads);
+        for (size_t i = 0; i < num_threads; ++i)
+        {
+            threads_.emplace_back([this](){run();});
+        }
+    }
+
+    ~worker_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        for (auto& t : threads_)
+        {
+            t.join();
+        }
+    }
+
+    static size_t default_num_threads()
+    {
+        size_t n = std::thread::hardware_concurrency();
+        return n > 0 ? n : 1;
+    }
+
+    size_t size() const
+    {
+        return threads_.size();
+    }
+
+    void submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        cv_.notify_one();
+    }
+private:
+    void run()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this](){return stop_ || !tasks_.empty();});
+                if (tasks_.empty())
+                {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+            task();
+        }
+    }
+};
+
+}}
+
+#endif
@@ -63,6 +63,32 @@ decode_json(std::basic_istream<CharT>& is,
     return val;
 }
 
+// Builds the whole document with the supplied allocator, e.g. an arena_allocator
+
+template <class T, class CharT>
+typename std::enable_if<is_basic_json_class<T>::value,T>::type
+decode_json(const std::basic_string<CharT>& s,
+            const typename T::allocator_type& allocator,
+            const basic_json_decode_options<CharT>& options = basic_json_options<CharT>::default_options())
+{
+    jsoncons::json_decoder<T> decoder(allocator);
+    basic_json_reader<CharT, string_source<CharT>> reader(s, decoder, options);
+    reader.read();
+    return decoder.get_result();
+}
+
+template <class T, class CharT>
+typename std::enable_if<is_basic_json_class<T>::value,T>::type
+decode_json(std::basic_istream<CharT>& is,
+            const typename T::allocator_type& allocator,
+            const basic_json_decode_options<CharT>& options = basic_json_options<CharT>::default_options())
+{
+    jsoncons::json_decoder<T> decoder(allocator);
+    basic_json_reader<CharT, stream_source<CharT>> reader(is, decoder, options);
+    reader.read();
+    return decoder.get_result();
+}
+
 template <class T, class CharT, class ImplementationPolicy, class Allocator>
 T decode_json(const basic_json<CharT,ImplementationPolicy,Allocator>& j,
               const std::basic_string<CharT>& s,
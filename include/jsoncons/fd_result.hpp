@@ -0,0 +1,254 @@
+// Copyright 2019 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_FD_RESULT_HPP
+#define JSONCONS_FD_RESULT_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring> // std::memcpy
+#include <system_error>
+#include <utility> // std::swap
+#include <vector>
+#include <jsoncons/config/jsoncons_config.hpp>
+
+#if defined(_WIN32)
+#  include <io.h>
+#else
+#  include <sys/uio.h>
+#  include <unistd.h>
+#endif
+
+namespace jsoncons {
+
+// basic_fd_result
+
+// Buffers output and writes it to a file descriptor, without going through
+// a std::basic_ostream. The descriptor is not owned, it is not closed when
+// the result is destroyed.
+
+template <class CharT>
+class basic_fd_result
+{
+public:
+    typedef CharT value_type;
+    typedef int output_type;
+private:
+    static const size_t default_buffer_length = 16384;
+
+    int fd_;
+    bool use_writev_;
+    std::vector<CharT> buffer_;
+    CharT* begin_buffer_;
+    const CharT* end_buffer_;
+    CharT* p_;
+
+    // Noncopyable
+    basic_fd_result(const basic_fd_result&) = delete;
+    basic_fd_result& operator=(const basic_fd_result&) = delete;
+public:
+    basic_fd_result(int fd)
+        : basic_fd_result(fd, default_buffer_length, true)
+    {
+    }
+
+    basic_fd_result(int fd, size_t buflen)
+        : basic_fd_result(fd, buflen, true)
+    {
+    }
+
+    basic_fd_result(int fd, size_t buflen, bool use_writev)
+        : fd_(fd), use_writev_(use_writev), buffer_(buflen > 0 ? buflen : 1),
+          begin_buffer_(buffer_.data()), end_buffer_(begin_buffer_+buffer_.size()), p_(begin_buffer_)
+    {
+    }
+
+    basic_fd_result(basic_fd_result&& other)
+        : fd_(-1), use_writev_(true), buffer_(), begin_buffer_(nullptr), end_buffer_(nullptr), p_(nullptr)
+    {
+        swap(other);
+    }
+
+    ~basic_fd_result()
+    {
+        if (p_ != begin_buffer_)
+        {
+            std::error_code ec;
+            write_all(begin_buffer_, buffer_length(), ec);
+        }
+    }
+
+    basic_fd_result& operator=(basic_fd_result&& other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    void flush()
+    {
+        write_all(begin_buffer_, buffer_length());
+        p_ = begin_buffer_;
+    }
+
+    void append(const CharT* s, size_t length)
+    {
+        size_t diff = end_buffer_ - p_;
+        if (diff >= length)
+        {
+            std::memcpy(p_, s, length*sizeof(CharT));
+            p_ += length;
+        }
+        else if (length <= buffer_.size())
+        {
+            // Top up the buffer and write it whole
+            std::memcpy(p_, s, diff*sizeof(CharT));
+            write_all(begin_buffer_, buffer_.size());
+            std::memcpy(begin_buffer_, s + diff, (length - diff)*sizeof(CharT));
+            p_ = begin_buffer_ + (length - diff);
+        }
+        else
+        {
+            // Longer than the buffer, write both without copying
+            write_all(begin_buffer_, buffer_length(), s, length);
+            p_ = begin_buffer_;
+        }
+    }
+
+    void push_back(CharT ch)
+    {
+        if (p_ == end_buffer_)
+        {
+            write_all(begin_buffer_, buffer_length());
+            p_ = begin_buffer_;
+        }
+        *p_++ = ch;
+    }
+private:
+    size_t buffer_length() const
+    {
+        return p_ - begin_buffer_;
+    }
+
+    void swap(basic_fd_result& other)
+    {
+        std::swap(fd_, other.fd_);
+        std::swap(use_writev_, other.use_writev_);
+        buffer_.swap(other.buffer_);
+        std::swap(begin_buffer_, other.begin_buffer_);
+        std::swap(end_buffer_, other.end_buffer_);
+        std::swap(p_, other.p_);
+    }
+
+    void write_all(const CharT* data, size_t length)
+    {
+        std::error_code ec;
+        write_all(data, length, ec);
+        if (ec)
+        {
+            JSONCONS_THROW(std::system_error(ec));
+        }
+    }
+
+    void write_all(const CharT* data1, size_t length1, const CharT* data2, size_t length2)
+    {
+        std::error_code ec;
+#if defined(_WIN32)
+        write_all(data1, length1, ec);
+        if (!ec)
+        {
+            write_all(data2, length2, ec);
+        }
+#else
+        if (use_writev_ && length1 > 0)
+        {
+            // One system call for the buffered output and the long piece,
+            // falling back to plain writes to finish a partial write
+            struct iovec iov[2];
+            iov[0].iov_base = const_cast<CharT*>(data1);
+            iov[0].iov_len = length1*sizeof(CharT);
+            iov[1].iov_base = const_cast<CharT*>(data2);
+            iov[1].iov_len = length2*sizeof(CharT);
+            ssize_t n;
+            do
+            {
+                n = ::writev(fd_, iov, 2);
+            }
+            while (n < 0 && errno == EINTR);
+            if (n < 0)
+            {
+                ec = std::error_code(errno, std::system_category());
+            }
+            else
+            {
+                size_t written = static_cast<size_t>(n);
+                if (written < iov[0].iov_len)
+                {
+                    write_bytes(reinterpret_cast<const char*>(data1) + written, iov[0].iov_len - written, ec);
+                    written = 0;
+                }
+                else
+                {
+                    written -= iov[0].iov_len;
+                }
+                if (!ec)
+                {
+                    write_bytes(reinterpret_cast<const char*>(data2) + written, iov[1].iov_len - written, ec);
+                }
+            }
+        }
+        else
+        {
+            write_all(data1, length1, ec);
+            if (!ec)
+            {
+                write_all(data2, length2, ec);
+            }
+        }
+#endif
+        if (ec)
+        {
+            JSONCONS_THROW(std::system_error(ec));
+        }
+    }
+
+    void write_all(const CharT* data, size_t length, std::error_code& ec)
+    {
+        write_bytes(reinterpret_cast<const char*>(data), length*sizeof(CharT), ec);
+    }
+
+    void write_bytes(const char* data, size_t length, std::error_code& ec)
+    {
+        while (length > 0)
+        {
+#if defined(_WIN32)
+            int n = ::_write(fd_, data, static_cast<unsigned int>(length > 0x40000000 ? 0x40000000 : length));
+#else
+            ssize_t n = ::write(fd_, data, length);
+#endif
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                ec = std::error_code(errno, std::system_category());
+                return;
+            }
+            data += n;
+            length -= static_cast<size_t>(n);
+        }
+    }
+};
+
+template <class CharT>
+const size_t basic_fd_result<CharT>::default_buffer_length;
+
+typedef basic_fd_result<char> fd_result;
+typedef basic_fd_result<uint8_t> binary_fd_result;
+
+}
+
+#endif
@@ -19,6 +19,7 @@
 #include <memory> // std::allocator
 #include <utility> // std::move
 #include <type_traits> // std::enable_if
+#include <cstdint> // uint64_t
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_type_traits.hpp>
 
@@ -473,6 +474,16 @@ struct sorted_unique_range_tag
 {
 };
 
+// has_hash_index
+
+template <class ImplementationPolicy, class Enable = void>
+struct has_hash_index : std::false_type {};
+
+template <class ImplementationPolicy>
+struct has_hash_index<ImplementationPolicy, 
+                      typename std::enable_if<std::is_integral<decltype(ImplementationPolicy::hash_index_threshold)>::value>::type> 
+    : std::true_type {};
+
 // json_object
 
 template <class KeyT,class Json,class Enable = void>
@@ -1164,7 +1175,8 @@ private:
 
 // Preserve order
 template <class KeyT,class Json>
-class json_object<KeyT,Json,typename std::enable_if<Json::implementation_policy::preserve_order>::type> :
+class json_object<KeyT,Json,typename std::enable_if<Json::implementation_policy::preserve_order && 
+                                                    !has_hash_index<typename Json::implementation_policy>::value>::type> :
     public container_base<typename Json::allocator_type>
 {
 public:
@@ -1957,6 +1969,676 @@ private:
     json_object& operator=(const json_object&) = delete;
 };
 
+// Preserve order, hash index
+// Members are kept in insertion order. Objects with fewer than
+// hash_index_threshold members are searched linearly, larger objects
+// through an open addressing (linear probing) table of member positions.
+template <class KeyT,class Json>
+class json_object<KeyT,Json,typename std::enable_if<Json::implementation_policy::preserve_order &&
+                                                    has_hash_index<typename Json::implementation_policy>::value>::type> :
+    public container_base<typename Json::allocator_type>
+{
+public:
+    typedef typename Json::allocator_type allocator_type;
+    typedef typename Json::char_type char_type;
+    typedef KeyT key_type;
+    typedef typename Json::string_view_type string_view_type;
+    typedef key_value<KeyT,Json> key_value_type;
+private:
+    typedef typename Json::implementation_policy implementation_policy;
+    typedef typename std::allocator_traits<allocator_type>:: template rebind_alloc<key_value_type> key_value_allocator_type;
+    using key_value_container_type = typename implementation_policy::template sequence_container_type<key_value_type,key_value_allocator_type>;
+    typedef typename std::allocator_traits<allocator_type>:: template rebind_alloc<size_t> index_allocator_type;
+    using index_container_type = typename implementation_policy::template sequence_container_type<size_t,index_allocator_type>;
+
+    static const size_t min_index_capacity = 8;
+
+    key_value_container_type members_;
+    // Empty while the object is below the threshold, otherwise a power of two
+    // number of slots, each holding 0 (empty) or a member position plus one
+    index_container_type index_;
+public:
+    typedef typename key_value_container_type::iterator iterator;
+    typedef typename key_value_container_type::const_iterator const_iterator;
+
+    using container_base<allocator_type>::get_allocator;
+
+    json_object()
+    {
+    }
+    json_object(const allocator_type& allocator)
+        : container_base<allocator_type>(allocator),
+          members_(key_value_allocator_type(allocator)),
+          index_(index_allocator_type(allocator))
+    {
+    }
+
+    json_object(const json_object& val)
+        : container_base<allocator_type>(val.get_allocator()),
+          members_(val.members_),
+          index_(val.index_)
+    {
+    }
+
+    json_object(json_object&& val)
+        : container_base<allocator_type>(val.get_allocator()),
+          members_(std::move(val.members_)),
+          index_(std::move(val.index_))
+    {
+    }
+
+    json_object(const json_object& val, const allocator_type& allocator)
+        : container_base<allocator_type>(allocator),
+          members_(val.members_,key_value_allocator_type(allocator)),
+          index_(val.index_,index_allocator_type(allocator))
+    {
+    }
+
+    json_object(json_object&& val,const allocator_type& allocator)
+        : container_base<allocator_type>(allocator),
+          members_(std::move(val.members_),key_value_allocator_type(allocator)),
+          index_(std::move(val.index_),index_allocator_type(allocator))
+    {
+    }
+
+    template<class InputIt>
+    json_object(InputIt first, InputIt last)
+    {
+        insert(first, last, get_key_value<KeyT,Json>());
+    }
+
+    template<class InputIt>
+    json_object(InputIt first, InputIt last,
+                const allocator_type& allocator)
+        : container_base<allocator_type>(allocator),
+          members_(key_value_allocator_type(allocator)),
+          index_(index_allocator_type(allocator))
+    {
+        insert(first, last, get_key_value<KeyT,Json>());
+    }
+
+    json_object(std::initializer_list<typename Json::array> init)
+    {
+        for (const auto& element : init)
+        {
+            if (element.size() != 2 || !element[0].is_string())
+            {
+                JSONCONS_THROW(json_runtime_error<std::runtime_error>("Cannot create object from initializer list"));
+                break;
+            }
+        }
+        for (auto& element : init)
+        {
+            insert_or_assign(element[0].as_string_view(), std::move(element[1]));
+        }
+    }
+
+    json_object(std::initializer_list<typename Json::array> init,
+                const allocator_type& allocator)
+        : container_base<allocator_type>(allocator),
+          members_(key_value_allocator_type(allocator)),
+          index_(index_allocator_type(allocator))
+    {
+        for (const auto& element : init)
+        {
+            if (element.size() != 2 || !element[0].is_string())
+            {
+                JSONCONS_THROW(json_runtime_error<std::runtime_error>("Cannot create object from initializer list"));
+                break;
+            }
+        }
+        for (auto& element : init)
+        {
+            insert_or_assign(element[0].as_string_view(), std::move(element[1]));
+        }
+    }
+
+    void swap(json_object& val)
+    {
+        members_.swap(val.members_);
+        index_.swap(val.index_);
+    }
+
+    iterator begin()
+    {
+        return members_.begin();
+    }
+
+    iterator end()
+    {
+        return members_.end();
+    }
+
+    const_iterator begin() const
+    {
+        return members_.begin();
+    }
+
+    const_iterator end() const
+    {
+        return members_.end();
+    }
+
+    size_t size() const {return members_.size();}
+
+    size_t capacity() const {return members_.capacity();}
+
+    void clear()
+    {
+        members_.clear();
+        index_.clear();
+    }
+
+    void shrink_to_fit()
+    {
+        for (size_t i = 0; i < members_.size(); ++i)
+        {
+            members_[i].shrink_to_fit();
+        }
+        members_.shrink_to_fit();
+        index_.shrink_to_fit();
+    }
+
+    void reserve(size_t n) {members_.reserve(n);}
+
+    Json& at(size_t i)
+    {
+        if (i >= members_.size())
+        {
+            JSONCONS_THROW(json_runtime_error<std::out_of_range>("Invalid array subscript"));
+        }
+        return members_[i].value();
+    }
+
+    const Json& at(size_t i) const
+    {
+        if (i >= members_.size())
+        {
+            JSONCONS_THROW(json_runtime_error<std::out_of_range>("Invalid array subscript"));
+        }
+        return members_[i].value();
+    }
+
+    iterator find(const string_view_type& name)
+    {
+        return members_.begin() + find_position(name, members_.size());
+    }
+
+    const_iterator find(const string_view_type& name) const
+    {
+        return members_.begin() + find_position(name, members_.size());
+    }
+
+    void erase(const_iterator first, const_iterator last)
+    {
+        size_t pos1 = first == members_.end() ? members_.size() : first - members_.begin();
+        size_t pos2 = last == members_.end() ? members_.size() : last - members_.begin();
+
+        if (pos1 < members_.size() && pos2 <= members_.size())
+        {
+#if defined(JSONCONS_NO_ERASE_TAKING_CONST_ITERATOR)
+            iterator it1 = members_.begin() + (first - members_.begin());
+            iterator it2 = members_.begin() + (last - members_.begin());
+            members_.erase(it1,it2);
+#else
+            members_.erase(first,last);
+#endif
+            build_index();
+        }
+    }
+
+    void erase(const string_view_type& name)
+    {
+        size_t pos = find_position(name, members_.size());
+        if (pos != members_.size())
+        {
+            members_.erase(members_.begin() + pos);
+            build_index();
+        }
+    }
+
+    template<class InputIt, class Convert>
+    void insert(InputIt first, InputIt last, Convert convert)
+    {
+        size_t count = std::distance(first,last);
+        members_.reserve(members_.size() + count);
+        for (auto s = first; s != last; ++s)
+        {
+            members_.emplace_back(convert(*s));
+            // The first occurrence of a duplicate name is kept
+            size_t pos = members_.size() - 1;
+            if (find_position(members_.back().key(), pos) != pos)
+            {
+                members_.pop_back();
+            }
+            else
+            {
+                insert_index_entry(pos);
+            }
+        }
+    }
+
+    template<class InputIt, class Convert>
+    void insert(sorted_unique_range_tag, InputIt first, InputIt last, Convert convert)
+    {
+        size_t count = std::distance(first,last);
+
+        members_.reserve(members_.size() + count);
+        for (auto s = first; s != last; ++s)
+        {
+            members_.emplace_back(convert(*s));
+            insert_index_entry(members_.size() - 1);
+        }
+    }
+
+    template <class T, class A=allocator_type>
+    typename std::enable_if<is_stateless<A>::value,std::pair<iterator,bool>>::type
+    insert_or_assign(const string_view_type& name, T&& value)
+    {
+        size_t pos = find_position(name, members_.size());
+        if (pos == members_.size())
+        {
+            members_.emplace_back(key_type(name.begin(), name.end()), std::forward<T>(value));
+            insert_index_entry(pos);
+            return std::make_pair(members_.begin() + pos,true);
+        }
+        else
+        {
+            auto it = members_.begin() + pos;
+            it->value(Json(std::forward<T>(value)));
+            return std::make_pair(it,false);
+        }
+    }
+
+    template <class T, class A=allocator_type>
+    typename std::enable_if<!is_stateless<A>::value,std::pair<iterator,bool>>::type
+    insert_or_assign(const string_view_type& name, T&& value)
+    {
+        size_t pos = find_position(name, members_.size());
+        if (pos == members_.size())
+        {
+            members_.emplace_back(key_type(name.begin(),name.end(),get_allocator()),
+                                  std::forward<T>(value),get_allocator());
+            insert_index_entry(pos);
+            return std::make_pair(members_.begin() + pos,true);
+        }
+        else
+        {
+            auto it = members_.begin() + pos;
+            it->value(Json(std::forward<T>(value),get_allocator()));
+            return std::make_pair(it,false);
+        }
+    }
+
+    template <class A=allocator_type, class T>
+    typename std::enable_if<is_stateless<A>::value,iterator>::type
+    insert_or_assign(iterator hint, const string_view_type& key, T&& value)
+    {
+        if (hint == members_.end())
+        {
+            auto result = insert_or_assign(key, std::forward<T>(value));
+            return result.first;
+        }
+        else
+        {
+            size_t pos = find_position(key, members_.size());
+            if (pos == members_.size())
+            {
+                auto it = members_.emplace(hint, key_type(key.begin(), key.end()), std::forward<T>(value));
+                build_index();
+                return it;
+            }
+            else
+            {
+                auto it = members_.begin() + pos;
+                it->value(Json(std::forward<T>(value)));
+                return it;
+            }
+        }
+    }
+
+    template <class A=allocator_type, class T>
+    typename std::enable_if<!is_stateless<A>::value,iterator>::type
+    insert_or_assign(iterator hint, const string_view_type& key, T&& value)
+    {
+        if (hint == members_.end())
+        {
+            auto result = insert_or_assign(key, std::forward<T>(value));
+            return result.first;
+        }
+        else
+        {
+            size_t pos = find_position(key, members_.size());
+            if (pos == members_.size())
+            {
+                auto it = members_.emplace(hint,
+                                           key_type(key.begin(),key.end(),get_allocator()),
+                                           std::forward<T>(value),get_allocator());
+                build_index();
+                return it;
+            }
+            else
+            {
+                auto it = members_.begin() + pos;
+                it->value(Json(std::forward<T>(value),get_allocator()));
+                return it;
+            }
+        }
+    }
+
+    // merge
+
+    void merge(const json_object& source)
+    {
+        for (auto it = source.begin(); it != source.end(); ++it)
+        {
+            try_emplace(it->key(),it->value());
+        }
+    }
+
+    void merge(json_object&& source)
+    {
+        auto it = std::make_move_iterator(source.begin());
+        auto end = std::make_move_iterator(source.end());
+        for (; it != end; ++it)
+        {
+            try_emplace(it->key(),std::move(it->value()));
+        }
+    }
+
+    void merge(iterator hint, const json_object& source)
+    {
+        size_t pos = hint - members_.begin();
+        for (auto it = source.begin(); it != source.end(); ++it)
+        {
+            hint = try_emplace(hint, it->key(),it->value());
+            size_t newpos = hint - members_.begin();
+            if (newpos == pos)
+            {
+                ++hint;
+                pos = hint - members_.begin();
+            }
+            else
+            {
+                hint = members_.begin() + pos;
+            }
+        }
+    }
+
+    void merge(iterator hint, json_object&& source)
+    {
+        size_t pos = hint - members_.begin();
+
+        auto it = std::make_move_iterator(source.begin());
+        auto end = std::make_move_iterator(source.end());
+        for (; it != end; ++it)
+        {
+            hint = try_emplace(hint, it->key(), std::move(it->value()));
+            size_t newpos = hint - members_.begin();
+            if (newpos == pos)
+            {
+                ++hint;
+                pos = hint - members_.begin();
+            }
+            else
+            {
+                hint = members_.begin() + pos;
+            }
+        }
+    }
+
+    // merge_or_update
+
+    void merge_or_update(const json_object& source)
+    {
+        for (auto it = source.begin(); it != source.end(); ++it)
+        {
+            insert_or_assign(it->key(),it->value());
+        }
+    }
+
+    void merge_or_update(json_object&& source)
+    {
+        auto it = std::make_move_iterator(source.begin());
+        auto end = std::make_move_iterator(source.end());
+        for (; it != end; ++it)
+        {
+            insert_or_assign(it->key(),std::move(it->value()));
+        }
+    }
+
+    void merge_or_update(iterator hint, const json_object& source)
+    {
+        size_t pos = hint - members_.begin();
+        for (auto it = source.begin(); it != source.end(); ++it)
+        {
+            hint = insert_or_assign(hint, it->key(),it->value());
+            size_t newpos = hint - members_.begin();
+            if (newpos == pos)
+            {
+                ++hint;
+                pos = hint - members_.begin();
+            }
+            else
+            {
+                hint = members_.begin() + pos;
+            }
+        }
+    }
+
+    void merge_or_update(iterator hint, json_object&& source)
+    {
+        size_t pos = hint - members_.begin();
+        auto it = std::make_move_iterator(source.begin());
+        auto end = std::make_move_iterator(source.end());
+        for (; it != end; ++it)
+        {
+            hint = insert_or_assign(hint, it->key(),std::move(it->value()));
+            size_t newpos = hint - members_.begin();
+            if (newpos == pos)
+            {
+                ++hint;
+                pos = hint - members_.begin();
+            }
+            else
+            {
+                hint = members_.begin() + pos;
+            }
+        }
+    }
+
+    // try_emplace
+
+    template <class A=allocator_type, class... Args>
+    typename std::enable_if<is_stateless<A>::value,std::pair<iterator,bool>>::type
+    try_emplace(const string_view_type& name, Args&&... args)
+    {
+        size_t pos = find_position(name, members_.size());
+        if (pos == members_.size())
+        {
+            members_.emplace_back(key_type(name.begin(), name.end()), std::forward<Args>(args)...);
+            insert_index_entry(pos);
+            return std::make_pair(members_.begin() + pos,true);
+        }
+        else
+        {
+            return std::make_pair(members_.begin() + pos,false);
+        }
+    }
+
+    template <class A=allocator_type, class... Args>
+    typename std::enable_if<!is_stateless<A>::value,std::pair<iterator,bool>>::type
+    try_emplace(const string_view_type& key, Args&&... args)
+    {
+        size_t pos = find_position(key, members_.size());
+        if (pos == members_.size())
+        {
+            members_.emplace_back(key_type(key.begin(),key.end(), get_allocator()),
+                                  std::forward<Args>(args)...);
+            insert_index_entry(pos);
+            return std::make_pair(members_.begin() + pos,true);
+        }
+        else
+        {
+            return std::make_pair(members_.begin() + pos,false);
+        }
+    }
+
+    template <class A=allocator_type, class ... Args>
+    typename std::enable_if<is_stateless<A>::value,iterator>::type
+    try_emplace(iterator hint, const string_view_type& key, Args&&... args)
+    {
+        if (hint == members_.end())
+        {
+            auto result = try_emplace(key, std::forward<Args>(args)...);
+            return result.first;
+        }
+        else
+        {
+            size_t pos = find_position(key, members_.size());
+            if (pos == members_.size())
+            {
+                auto it = members_.emplace(hint, key_type(key.begin(), key.end()), std::forward<Args>(args)...);
+                build_index();
+                return it;
+            }
+            else
+            {
+                return members_.begin() + pos;
+            }
+        }
+    }
+
+    template <class A=allocator_type, class ... Args>
+    typename std::enable_if<!is_stateless<A>::value,iterator>::type
+    try_emplace(iterator hint, const string_view_type& key, Args&&... args)
+    {
+        if (hint == members_.end())
+        {
+            auto result = try_emplace(key, std::forward<Args>(args)...);
+            return result.first;
+        }
+        else
+        {
+            size_t pos = find_position(key, members_.size());
+            if (pos == members_.size())
+            {
+                auto it = members_.emplace(hint,
+                                           key_type(key.begin(),key.end(), get_allocator()),
+                                           std::forward<Args>(args)...);
+                build_index();
+                return it;
+            }
+            else
+            {
+                return members_.begin() + pos;
+            }
+        }
+    }
+
+    bool operator==(const json_object& rhs) const
+    {
+        return members_ == rhs.members_;
+    }
+
+    bool operator<(const json_object& rhs) const
+    {
+        return members_ < rhs.members_;
+    }
+private:
+
+    // FNV-1a
+    static size_t hash_key(const string_view_type& key)
+    {
+        typedef typename std::make_unsigned<char_type>::type uchar_type;
+
+        uint64_t h = 14695981039346656037ULL;
+        for (auto c : key)
+        {
+            h ^= static_cast<uint64_t>(static_cast<uchar_type>(c));
+            h *= 1099511628211ULL;
+        }
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+
+    // Returns the position of the member named key among the first count
+    // members, or count if there is none. Members at or beyond count must
+    // not yet be indexed.
+    size_t find_position(const string_view_type& key, size_t count) const
+    {
+        if (index_.empty())
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (members_[i].key() == key)
+                {
+                    return i;
+                }
+            }
+            return count;
+        }
+
+        size_t mask = index_.size() - 1;
+        for (size_t slot = hash_key(key) & mask; index_[slot] != 0; slot = (slot + 1) & mask)
+        {
+            size_t pos = index_[slot] - 1;
+            if (members_[pos].key() == key)
+            {
+                return pos;
+            }
+        }
+        return count;
+    }
+
+    // Indexes the member at pos, which must be the last member
+    void insert_index_entry(size_t pos)
+    {
+        if (index_.empty() ? members_.size() >= implementation_policy::hash_index_threshold
+                           : members_.size()*2 > index_.size())
+        {
+            build_index();
+        }
+        else if (!index_.empty())
+        {
+            insert_slot(pos);
+        }
+    }
+
+    void insert_slot(size_t pos)
+    {
+        size_t mask = index_.size() - 1;
+        size_t slot = hash_key(members_[pos].key()) & mask;
+        while (index_[slot] != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        index_[slot] = pos + 1;
+    }
+
+    // Rebuilds the table with a load factor of at most one quarter,
+    // so that it is grown again only after the object has doubled in size
+    void build_index()
+    {
+        index_.clear();
+        if (members_.size() < implementation_policy::hash_index_threshold)
+        {
+            return;
+        }
+        size_t capacity = min_index_capacity;
+        while (capacity < members_.size()*4)
+        {
+            capacity *= 2;
+        }
+        index_.resize(capacity, 0);
+        for (size_t i = 0; i < members_.size(); ++i)
+        {
+            insert_slot(i);
+        }
+    }
+
+    json_object& operator=(const json_object&) = delete;
+};
+
 }
 
 #endif
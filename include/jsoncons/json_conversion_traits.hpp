@@ -11,12 +11,15 @@
 #include <tuple>
 #include <array>
 #include <memory>
+#include <iterator> // std::distance
 #include <type_traits> // std::enable_if
+#include <utility> // std::move
 #include <jsoncons/json_content_handler.hpp>
 #include <jsoncons/json_decoder.hpp>
 #include <jsoncons/basic_json.hpp>
 #include <jsoncons/json_options.hpp>
 #include <jsoncons/json_encoder.hpp>
+#include <jsoncons/json_filter.hpp>
 #include <jsoncons/json_type_traits.hpp>
 #include <jsoncons/staj_reader.hpp>
 
@@ -45,6 +48,88 @@ void write_to(const T&val, basic_json_content_handler<CharT>& receiver);
 
 namespace jsoncons {
 
+namespace detail {
+
+    // Forwards all events but flush, so that a value encoded as part of a
+    // larger one does not flush the output before the top level is done
+
+    template <class CharT>
+    class noflush_filter : public basic_json_filter<CharT>
+    {
+    public:
+        noflush_filter(basic_json_content_handler<CharT>& handler)
+            : basic_json_filter<CharT>(handler)
+        {
+        }
+    private:
+        void do_flush() override
+        {
+        }
+    };
+
+    // Reserves room for the number of elements declared in the input, up to
+    // a limit, so that a bad length cannot force a huge allocation
+
+    template <class Container>
+    typename std::enable_if<has_reserve<Container>::value>::type
+    reserve_storage(Container& c, size_t length)
+    {
+        const size_t max_length = (size_t(1) << 24) / sizeof(typename Container::value_type);
+        c.reserve(length < max_length ? length : max_length);
+    }
+
+    template <class Container>
+    typename std::enable_if<!has_reserve<Container>::value>::type
+    reserve_storage(Container&, size_t)
+    {
+    }
+
+    // Reads the value that starts at the current event into a Json and converts 
+    // it with as<T>, leaving the reader on the value's last event. Used when the
+    // events do not have the shape T expects, so that the value is consumed and
+    // converted, or rejected, the same way as through json_type_traits
+
+    template <class T, class Json, class CharT>
+    T decode_through_json(basic_staj_reader<CharT>& reader, std::error_code& ec)
+    {
+        json_decoder<Json> decoder;
+        size_t level = 0;
+        for (;;)
+        {
+            switch (reader.current().event_type())
+            {
+                case staj_event_type::begin_array:
+                case staj_event_type::begin_object:
+                    ++level;
+                    break;
+                case staj_event_type::end_array:
+                case staj_event_type::end_object:
+                    --level;
+                    break;
+                default:
+                    break;
+            }
+            send_staj_event(reader.current(), decoder, reader.context());
+            if (level == 0)
+            {
+                break;
+            }
+            reader.next(ec);
+            if (ec)
+            {
+                return T();
+            }
+            if (reader.done())
+            {
+                ec = json_errc::unexpected_eof;
+                return T();
+            }
+        }
+        return decoder.get_result().template as<T>();
+    }
+
+} // namespace detail
+
 template <class T, class Enable = void>
 struct json_conversion_traits
 {
@@ -60,12 +145,92 @@ struct json_conversion_traits
     static void encode(const T& val, basic_json_content_handler<CharT>& receiver)
     {
         auto j = json_type_traits<Json, T>::to_json(val);
-        j.dump(receiver);
+        jsoncons::detail::noflush_filter<CharT> filter(receiver);
+        j.dump(filter);
     }
 };
 
 // specializations
 
+// primitives, read from and written to events directly
+
+template <class T>
+struct json_conversion_traits<T,
+    typename std::enable_if<!is_json_type_traits_declared<T>::value && 
+                            (jsoncons::detail::is_integer_like<T>::value || std::is_same<T,bool>::value ||
+                             jsoncons::detail::is_uinteger_like<T>::value || 
+                             jsoncons::detail::is_floating_point_like<T>::value)
+>::type>
+{
+    template <class CharT, class Json>
+    static T decode(basic_staj_reader<CharT>& reader, std::error_code& ec)
+    {
+        if (reader.current().event_type() == staj_event_type::begin_array ||
+            reader.current().event_type() == staj_event_type::begin_object)
+        {
+            return jsoncons::detail::decode_through_json<T,Json>(reader, ec);
+        }
+        return reader.current().template as<T>();
+    }
+
+    template <class CharT, class Json>
+    static void encode(T val, basic_json_content_handler<CharT>& receiver)
+    {
+        write(val, receiver);
+    }
+private:
+    template <class CharT, class U = T>
+    static typename std::enable_if<std::is_same<U,bool>::value>::type
+    write(U val, basic_json_content_handler<CharT>& receiver)
+    {
+        receiver.bool_value(val);
+    }
+
+    template <class CharT, class U = T>
+    static typename std::enable_if<jsoncons::detail::is_integer_like<U>::value>::type
+    write(U val, basic_json_content_handler<CharT>& receiver)
+    {
+        receiver.int64_value(static_cast<int64_t>(val));
+    }
+
+    template <class CharT, class U = T>
+    static typename std::enable_if<jsoncons::detail::is_uinteger_like<U>::value>::type
+    write(U val, basic_json_content_handler<CharT>& receiver)
+    {
+        receiver.uint64_value(static_cast<uint64_t>(val));
+    }
+
+    template <class CharT, class U = T>
+    static typename std::enable_if<jsoncons::detail::is_floating_point_like<U>::value>::type
+    write(U val, basic_json_content_handler<CharT>& receiver)
+    {
+        receiver.double_value(static_cast<double>(val));
+    }
+};
+
+template <class T>
+struct json_conversion_traits<T,
+    typename std::enable_if<!is_json_type_traits_declared<T>::value && jsoncons::detail::is_string_like<T>::value
+>::type>
+{
+    template <class CharT, class Json>
+    static T decode(basic_staj_reader<CharT>& reader, std::error_code& ec)
+    {
+        if (reader.current().event_type() == staj_event_type::begin_array ||
+            reader.current().event_type() == staj_event_type::begin_object)
+        {
+            return jsoncons::detail::decode_through_json<T,Json>(reader, ec);
+        }
+        return reader.current().template as<T>();
+    }
+
+    template <class CharT, class Json>
+    static void encode(const T& val, basic_json_content_handler<CharT>& receiver)
+    {
+        receiver.string_value(basic_string_view<CharT>(val.data(), val.length()));
+    }
+};
+
 // vector like
 
 template <class T>
@@ -79,13 +244,26 @@ struct json_conversion_traits<T,
     static T decode(basic_staj_reader<CharT>& reader, std::error_code& ec)
     {
         T v;
-        basic_staj_array_iterator<value_type,CharT,Json> end;
-        basic_staj_array_iterator<value_type,CharT,Json> it(reader, ec);
+        if (reader.current().event_type() == staj_event_type::byte_string_value)
+        {
+            return from_byte_string<value_type>(reader.current());
+        }
+        if (reader.current().event_type() != staj_event_type::begin_array)
+        {
+            return jsoncons::detail::decode_through_json<T,Json>(reader, ec);
+        }
+        jsoncons::detail::reserve_storage(v, reader.current().size());
 
-        while (it != end && !ec)
+        reader.next(ec);
+        while (!ec && !reader.done() && reader.current().event_type() != staj_event_type::end_array)
         {
-            v.push_back(*it);
-            it.increment(ec);
+            value_type val = json_conversion_traits<value_type>::template decode<CharT,Json>(reader, ec);
+            if (ec)
+            {
+                break;
+            }
+            v.push_back(std::move(val));
+            reader.next(ec);
         }
         return v;
     }
@@ -93,13 +271,28 @@ struct json_conversion_traits<T,
     template <class CharT, class Json>
     static void encode(const T& val, basic_json_content_handler<CharT>& receiver)
     {
-        receiver.begin_array();
+        receiver.begin_array(static_cast<size_t>(std::distance(std::begin(val), std::end(val))));
         for (auto it = std::begin(val); it != std::end(val); ++it)
         {
             json_conversion_traits<value_type>::template encode<CharT,Json>(*it,receiver);
         }
         receiver.end_array();
-        receiver.flush();
+    }
+private:
+    // A byte string from a binary format reads into a vector of integers
+    template <class Ty, class CharT>
+    static typename std::enable_if<std::is_integral<Ty>::value && !std::is_same<Ty,bool>::value,T>::type
+    from_byte_string(const basic_staj_event<CharT>& event)
+    {
+        auto bs = event.template as<byte_string_view>();
+        return T(bs.begin(), bs.end());
+    }
+
+    template <class Ty, class CharT>
+    static typename std::enable_if<!(std::is_integral<Ty>::value && !std::is_same<Ty,bool>::value),T>::type
+    from_byte_string(const basic_staj_event<CharT>&)
+    {
+        return T();
     }
 };
 // std::array
@@ -114,13 +307,29 @@ struct json_conversion_traits<std::array<T,N>>
     {
         std::array<T,N> v;
         v.fill(T{});
-        basic_staj_array_iterator<value_type,CharT,Json> end;
-        basic_staj_array_iterator<value_type,CharT,Json> it(reader, ec);
+        if (reader.current().event_type() != staj_event_type::begin_array)
+        {
+            return jsoncons::detail::decode_through_json<std::array<T,N>,Json>(reader, ec);
+        }
 
-        for (size_t i = 0; it != end && i < N && !ec; ++i)
+        // Elements past N are skipped, so that the reader ends up at the 
+        // end of the array
+        reader.next(ec);
+        for (size_t i = 0; !ec && !reader.done() && reader.current().event_type() != staj_event_type::end_array; ++i)
         {
-            v[i] = *it;
-            it.increment(ec);
+            if (i < N)
+            {
+                v[i] = json_conversion_traits<value_type>::template decode<CharT,Json>(reader, ec);
+            }
+            else
+            {
+                reader.skip(ec);
+            }
+            if (ec)
+            {
+                break;
+            }
+            reader.next(ec);
         }
         return v;
     }
@@ -128,13 +337,12 @@ struct json_conversion_traits<std::array<T,N>>
     template <class CharT, class Json>
     static void encode(const std::array<T, N>& val, basic_json_content_handler<CharT>& receiver)
     {
-        receiver.begin_array();
+        receiver.begin_array(N);
         for (auto it = std::begin(val); it != std::end(val); ++it)
         {
             json_conversion_traits<value_type>::template encode<CharT,Json>(*it,receiver);
         }
         receiver.end_array();
-        receiver.flush();
     }
 };
 
@@ -153,13 +361,29 @@ struct json_conversion_traits<T,
     static T decode(basic_staj_reader<CharT>& reader, std::error_code& ec)
     {
         T m;
-        basic_staj_object_iterator<mapped_type,CharT,Json> end;
-        basic_staj_object_iterator<mapped_type,CharT,Json> it(reader, ec);
+        if (reader.current().event_type() != staj_event_type::begin_object)
+        {
+            return jsoncons::detail::decode_through_json<T,Json>(reader, ec);
+        }
+        jsoncons::detail::reserve_storage(m, reader.current().size());
 
-        while (it != end && !ec)
+        reader.next(ec);
+        while (!ec && !reader.done() && reader.current().event_type() != staj_event_type::end_object)
         {
-            m.emplace(it->first,it->second);
-            it.increment(ec);
+            JSONCONS_ASSERT(reader.current().event_type() == staj_event_type::name);
+            auto key = reader.current().template as<std::basic_string<CharT>>();
+            reader.next(ec);
+            if (ec || reader.done())
+            {
+                break;
+            }
+            mapped_type val = json_conversion_traits<mapped_type>::template decode<CharT,Json>(reader, ec);
+            if (ec)
+            {
+                break;
+            }
+            m.emplace(std::move(key), std::move(val));
+            reader.next(ec);
         }
         return m;
     }
@@ -167,14 +391,13 @@ struct json_conversion_traits<T,
     template <class CharT, class Json>
     static void encode(const T& val, basic_json_content_handler<CharT>& receiver)
     {
-        receiver.begin_object();
+        receiver.begin_object(val.size());
         for (auto it = std::begin(val); it != std::end(val); ++it)
         {
             receiver.name(it->first);
             json_conversion_traits<mapped_type>::template encode<CharT,Json>(it->second,receiver);
         }
         receiver.end_object();
-        receiver.flush();
     }
 };
 
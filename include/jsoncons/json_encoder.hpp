@@ -22,6 +22,7 @@
 #include <jsoncons/json_content_handler.hpp>
 #include <jsoncons/result.hpp>
 #include <jsoncons/detail/print_number.hpp>
+#include <jsoncons/detail/scan_chars.hpp>
 
 namespace jsoncons { namespace detail {
 template <class CharT, class Result>
@@ -34,6 +35,18 @@ size_t escape_string(const CharT* s, size_t length,
     const CharT* end = s + length;
     for (const CharT* it = begin; it != end; ++it)
     {
+        // Append the run of characters that need no escaping at once
+        const CharT* run_end = find_escape_char(it, end, escape_all_non_ascii, escape_solidus);
+        if (run_end != it)
+        {
+            result.append(it, run_end - it);
+            count += (run_end - it);
+            it = run_end;
+            if (it == end)
+            {
+                break;
+            }
+        }
         CharT c = *it;
         switch (c)
         {
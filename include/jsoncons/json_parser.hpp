@@ -20,6 +20,7 @@
 #include <jsoncons/parse_error_handler.hpp>
 #include <jsoncons/json_error.hpp>
 #include <jsoncons/detail/parse_number.hpp>
+#include <jsoncons/detail/scan_chars.hpp>
 
 #define JSONCONS_ILLEGAL_CONTROL_CHARACTER \
         case 0x00:case 0x01:case 0x02:case 0x03:case 0x04:case 0x05:case 0x06:case 0x07:case 0x08:case 0x0b: \
@@ -177,6 +178,8 @@ class basic_json_parser : public ser_context
     json_parse_state state_;
     bool continue_;
     bool done_;
+    size_t skip_depth_;
+    json_parse_state skip_state_;
 
     std::basic_string<CharT,std::char_traits<CharT>,char_allocator_type> string_buffer_;
     jsoncons::detail::string_to_double to_double_;
@@ -219,7 +222,9 @@ public:
          input_ptr_(nullptr),
          state_(json_parse_state::start),
          continue_(true),
-         done_(false)
+         done_(false),
+         skip_depth_(0),
+         skip_state_(json_parse_state::expect_value)
     {
         string_buffer_.reserve(initial_string_buffer_capacity_);
 
@@ -282,9 +287,12 @@ public:
             {
                 case ' ':
                 case '\t':
-                    ++input_ptr_;
-                    ++column_;                     
+                {
+                    const CharT* p = jsoncons::detail::skip_blanks(input_ptr_ + 1, local_input_end);
+                    column_ += (p - input_ptr_);
+                    input_ptr_ = p;
                     break;
+                }
                 case '\r': 
                     push_state(state_);
                     ++input_ptr_;
@@ -464,6 +472,8 @@ public:
         line_ = 1;
         column_ = 1;
         nesting_depth_ = 0;
+        skip_depth_ = 0;
+        skip_state_ = json_parse_state::expect_value;
     }
 
     void restart()
@@ -471,6 +481,158 @@ public:
         continue_ = true;
     }
 
+    // Fast-forwards over the members or elements of the object or array just begun,
+    // counting brackets and passing over strings and comments without tokenizing, 
+    // unescaping or converting anything. Returns true when the parser is left at the 
+    // closing bracket, so that parsing resumes with the end event, or false if the input 
+    // ran out first, in which case it picks up where it left off after the next update,
+    // or if a comment is not allowed, in which case ec is set. The skipped text is not 
+    // otherwise validated.
+    bool skip_nested(std::error_code& ec)
+    {
+        if (skip_depth_ == 0)
+        {
+            JSONCONS_ASSERT(state_ == json_parse_state::expect_member_name_or_end || 
+                            state_ == json_parse_state::expect_value_or_end);
+            skip_depth_ = 1;
+            skip_state_ = json_parse_state::expect_value;
+        }
+
+        const CharT* local_input_end = input_end_;
+        const CharT* line_begin = input_ptr_;
+        while (input_ptr_ != local_input_end)
+        {
+            switch (skip_state_)
+            {
+                case json_parse_state::string:
+                    // Only a quote or a backslash can change the state inside a string
+                    input_ptr_ = jsoncons::detail::find_string_special(input_ptr_, local_input_end);
+                    if (input_ptr_ != local_input_end)
+                    {
+                        if (*input_ptr_ == '\"')
+                        {
+                            skip_state_ = json_parse_state::expect_value;
+                        }
+                        else if (*input_ptr_ == '\\')
+                        {
+                            skip_state_ = json_parse_state::escape;
+                        }
+                        ++input_ptr_;
+                    }
+                    break;
+                case json_parse_state::escape:
+                    skip_state_ = json_parse_state::string;
+                    ++input_ptr_;
+                    break;
+                case json_parse_state::slash:
+                {
+                    column_ += (input_ptr_ - line_begin);
+                    line_begin = input_ptr_;
+                    json_errc err = json_errc::illegal_comment;
+                    switch (*input_ptr_)
+                    {
+                        case '*':
+                            skip_state_ = json_parse_state::slash_star;
+                            break;
+                        case '/':
+                            skip_state_ = json_parse_state::slash_slash;
+                            break;
+                        default:
+                            skip_state_ = json_parse_state::expect_value;
+                            err = json_errc::invalid_json_text;
+                            break;
+                    }
+                    continue_ = err_handler_.error(err, *this);
+                    if (!continue_)
+                    {
+                        ec = err;
+                        return false;
+                    }
+                    if (skip_state_ != json_parse_state::expect_value)
+                    {
+                        ++input_ptr_;
+                    }
+                    break;
+                }
+                case json_parse_state::slash_slash:
+                    // The newline is counted once the comment has ended
+                    if (*input_ptr_ == '\n')
+                    {
+                        skip_state_ = json_parse_state::expect_value;
+                    }
+                    else
+                    {
+                        ++input_ptr_;
+                    }
+                    break;
+                case json_parse_state::slash_star:
+                    switch (*input_ptr_)
+                    {
+                        case '*':
+                            skip_state_ = json_parse_state::slash_star_star;
+                            break;
+                        case '\n':
+                            ++line_;
+                            column_ = 1;
+                            line_begin = input_ptr_ + 1;
+                            break;
+                        default:
+                            break;
+                    }
+                    ++input_ptr_;
+                    break;
+                case json_parse_state::slash_star_star:
+                    switch (*input_ptr_)
+                    {
+                        case '/':
+                            skip_state_ = json_parse_state::expect_value;
+                            ++input_ptr_;
+                            break;
+                        case '*':
+                            ++input_ptr_;
+                            break;
+                        default:
+                            skip_state_ = json_parse_state::slash_star;
+                            break;
+                    }
+                    break;
+                default:
+                    switch (*input_ptr_)
+                    {
+                        case '\"':
+                            skip_state_ = json_parse_state::string;
+                            break;
+                        case '/':
+                            skip_state_ = json_parse_state::slash;
+                            break;
+                        case '{':
+                        case '[':
+                            ++skip_depth_;
+                            break;
+                        case '}':
+                        case ']':
+                            if (--skip_depth_ == 0)
+                            {
+                                column_ += (input_ptr_ - line_begin);
+                                return true;
+                            }
+                            break;
+                        case '\n':
+                            ++line_;
+                            column_ = 1;
+                            line_begin = input_ptr_ + 1;
+                            break;
+                        default:
+                            break;
+                    }
+                    ++input_ptr_;
+                    break;
+            }
+        }
+        column_ += (input_ptr_ - line_begin);
+        return false;
+    }
+
     void check_done()
     {
         std::error_code ec;
@@ -2140,6 +2302,11 @@ exp3:
 string_u1:
         while (input_ptr_ < local_input_end)
         {
+            input_ptr_ = jsoncons::detail::find_string_special(input_ptr_, local_input_end);
+            if (input_ptr_ == local_input_end)
+            {
+                break;
+            }
             switch (*input_ptr_)
             {
                 JSONCONS_ILLEGAL_CONTROL_CHARACTER:
@@ -48,9 +48,15 @@ public:
     }
 private:
 
-    bool do_begin_object(semantic_tag, const ser_context&) override
+    bool do_begin_object(semantic_tag tag, const ser_context&) override
     {
-        event_ = basic_staj_event<CharT>(staj_event_type::begin_object);
+        event_ = basic_staj_event<CharT>(staj_event_type::begin_object, tag);
+        return false;
+    }
+
+    bool do_begin_object(size_t length, semantic_tag tag, const ser_context&) override
+    {
+        event_ = basic_staj_event<CharT>(staj_event_type::begin_object, length, tag);
         return false;
     }
 
@@ -60,9 +66,15 @@ private:
         return false;
     }
 
-    bool do_begin_array(semantic_tag, const ser_context&) override
+    bool do_begin_array(semantic_tag tag, const ser_context&) override
     {
-        event_ = basic_staj_event<CharT>(staj_event_type::begin_array);
+        event_ = basic_staj_event<CharT>(staj_event_type::begin_array, tag);
+        return false;
+    }
+
+    bool do_begin_array(size_t length, semantic_tag tag, const ser_context&) override
+    {
+        event_ = basic_staj_event<CharT>(staj_event_type::begin_array, length, tag);
         return false;
     }
 
@@ -78,9 +90,9 @@ private:
         return false;
     }
 
-    bool do_null_value(semantic_tag, const ser_context&) override
+    bool do_null_value(semantic_tag tag, const ser_context&) override
     {
-        event_ = basic_staj_event<CharT>(staj_event_type::null_value);
+        event_ = basic_staj_event<CharT>(staj_event_type::null_value, tag);
         return false;
     }
 
@@ -96,11 +108,12 @@ private:
         return false;
     }
 
-    bool do_byte_string_value(const byte_string_view&, 
-                              semantic_tag,
+    bool do_byte_string_value(const byte_string_view& s, 
+                              semantic_tag tag,
                               const ser_context&) override
     {
-        JSONCONS_UNREACHABLE();
+        event_ = basic_staj_event<CharT>(s, tag);
+        return false;
     }
 
     bool do_int64_value(int64_t value, 
@@ -553,6 +566,49 @@ public:
         while (!ec && !done() && !filter_.accept(event_handler_.event(), *this));
     }
 
+    void skip() override
+    {
+        std::error_code ec;
+        skip(ec);
+        if (ec)
+        {
+            throw ser_error(ec,parser_.line(),parser_.column());
+        }
+    }
+
+    // The members or elements of an object or array are passed over by the
+    // parser without producing events, the filter sees only the end event.
+    // If it rejects that, the reader moves on as next() does
+    void skip(std::error_code& ec) override
+    {
+        staj_event_type event_type = event_handler_.event().event_type();
+        if (event_type != staj_event_type::begin_object && event_type != staj_event_type::begin_array)
+        {
+            return;
+        }
+        while (!parser_.skip_nested(ec))
+        {
+            if (ec) return;
+            if (is_.eof())
+            {
+                ec = json_errc::unexpected_eof;
+                return;
+            }
+            if (is_.fail())
+            {
+                ec = json_errc::source_error;
+                return;
+            }
+            read_buffer(ec);
+            if (ec) return;
+        }
+        read_next(ec);
+        if (!ec && !done() && !filter_.accept(event_handler_.event(), *this))
+        {
+            next(ec);
+        }
+    }
+
     void read_buffer(std::error_code& ec)
     {
         buffer_.clear();
@@ -14,6 +14,7 @@
 #include <system_error>
 #include <ios>
 #include <utility> // std::move
+#include <limits> // std::numeric_limits
 #include <jsoncons/source.hpp>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_content_handler.hpp>
@@ -243,7 +244,10 @@ public:
          buffer_length_(default_max_buffer_length),
          begin_(true)
     {
-        buffer_.reserve(buffer_length_);
+        if (!is_contiguous_source<Source>::value)
+        {
+            buffer_.reserve(buffer_length_);
+        }
     }
 
     size_t buffer_length() const
@@ -441,7 +445,40 @@ public:
 
 private:
 
-    void read_buffer(std::error_code& ec)
+    // Contiguous sources are parsed in place, so that strings without escapes
+    // reach the handler as views into the caller's input
+
+    template <class S = Source>
+    typename std::enable_if<is_contiguous_source<S>::value>::type
+    read_buffer(std::error_code& ec)
+    {
+        const CharT* data = nullptr;
+        size_t count = source_.read_in_place(data, (std::numeric_limits<size_t>::max)());
+        if (count == 0)
+        {
+            eof_ = true;
+        }
+        else if (begin_)
+        {
+            auto result = unicons::skip_bom(data, data+count);
+            if (result.ec != unicons::encoding_errc())
+            {
+                ec = result.ec;
+                return;
+            }
+            size_t offset = result.it - data;
+            parser_.update(data+offset,count-offset);
+            begin_ = false;
+        }
+        else
+        {
+            parser_.update(data,count);
+        }
+    }
+
+    template <class S = Source>
+    typename std::enable_if<!is_contiguous_source<S>::value>::type
+    read_buffer(std::error_code& ec)
     {
         buffer_.clear();
         buffer_.resize(buffer_length_);
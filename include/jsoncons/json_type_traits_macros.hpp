@@ -14,12 +14,13 @@
 #include <exception>
 #include <cstring>
 #include <utility>
-#include <algorithm> // std::swap
+#include <algorithm> // std::swap, std::stable_sort
 #include <limits> // std::numeric_limits
 #include <type_traits> // std::enable_if
 #include <iterator> // std::iterator_traits, std::input_iterator_tag
 #include <jsoncons/bignum.hpp>
 #include <jsoncons/json_content_handler.hpp>
+#include <jsoncons/staj_reader.hpp>
 #include <jsoncons/detail/type_traits.hpp>
 #include <string>
 #include <tuple>
@@ -27,6 +28,125 @@
 #include <functional>
 #include <memory>
 
+namespace jsoncons {
+
+template <class T, class Enable>
+struct json_conversion_traits;
+
+namespace detail {
+
+    // Encodes and decodes the members of a type declared with JSONCONS_MEMBER_TRAITS_DECL
+    // directly, with content handler calls and pull reader events, without going through
+    // an intermediate Json value. Members are encoded in the order a Json object would 
+    // hold them, sorted by name unless the Json type preserves insertion order.
+
+    template <class T, class CharT>
+    class member_codec
+    {
+    public:
+        typedef void (*encode_function)(const T&, basic_json_content_handler<CharT>&);
+        typedef void (*decode_function)(T&, basic_staj_reader<CharT>&, std::error_code&);
+
+        struct member
+        {
+            const char* name;
+            encode_function encode;
+            decode_function decode;
+        };
+    private:
+        struct entry
+        {
+            std::basic_string<CharT> name;
+            encode_function encode;
+            decode_function decode;
+        };
+
+        std::vector<entry> members_;
+    public:
+        member_codec(const member* first, size_t count, bool preserve_order)
+        {
+            members_.reserve(count);
+            for (const member* p = first; p != first + count; ++p)
+            {
+                entry e;
+                e.name.assign(p->name, p->name + std::strlen(p->name));
+                e.encode = p->encode;
+                e.decode = p->decode;
+                members_.push_back(std::move(e));
+            }
+            if (!preserve_order)
+            {
+                std::stable_sort(members_.begin(), members_.end(),
+                                 [](const entry& a, const entry& b){return a.name < b.name;});
+            }
+        }
+
+        void encode(const T& val, basic_json_content_handler<CharT>& receiver) const
+        {
+            receiver.begin_object(members_.size());
+            for (const auto& m : members_)
+            {
+                receiver.name(basic_string_view<CharT>(m.name.data(), m.name.length()));
+                m.encode(val, receiver);
+            }
+            receiver.end_object();
+        }
+
+        // Members that are absent keep their value, names that are not members are skipped
+        void decode(T& val, basic_staj_reader<CharT>& reader, std::error_code& ec) const
+        {
+            if (reader.current().event_type() != staj_event_type::begin_object)
+            {
+                reader.skip(ec);
+                return;
+            }
+            // Members usually arrive in the order they were encoded, so the search 
+            // for the next name starts after the last one found
+            size_t hint = 0;
+            reader.next(ec);
+            while (!ec && reader.current().event_type() != staj_event_type::end_object && !reader.done())
+            {
+                auto name = reader.current().template as<basic_string_view<CharT>>();
+                size_t index = find(name, hint);
+                reader.next(ec);
+                if (ec)
+                {
+                    return;
+                }
+                if (index < members_.size())
+                {
+                    members_[index].decode(val, reader, ec);
+                    hint = index + 1;
+                }
+                else
+                {
+                    reader.skip(ec);
+                }
+                if (!ec)
+                {
+                    reader.next(ec);
+                }
+            }
+        }
+    private:
+        size_t find(const basic_string_view<CharT>& name, size_t hint) const
+        {
+            for (size_t i = 0; i < members_.size(); ++i)
+            {
+                size_t index = (hint + i) % members_.size();
+                const auto& m = members_[index].name;
+                if (m.length() == name.length() && std::char_traits<CharT>::compare(m.data(), name.data(), name.length()) == 0)
+                {
+                    return index;
+                }
+            }
+            return members_.size();
+        }
+    };
+
+} // namespace detail
+} // namespace jsoncons
+
 // This follows https://github.com/Loki-Astari/ThorsSerializer/blob/master/src/Serialize/Traits.h
 
 #define JSONCONS_EXPAND(X) X    
@@ -103,6 +223,14 @@
 #define JSONCONS_AS(TC, JVal, TVal, Member) if ((JVal).contains(JSONCONS_QUOTE(Member))) {val.Member = (JVal).at(JSONCONS_QUOTE(Member)).template as<decltype(TVal.Member)>();}
 #define JSONCONS_AS_LAST(TC, JVal, TVal, Member) if ((JVal).contains(JSONCONS_QUOTE(Member))) {val.Member = (JVal).at(JSONCONS_QUOTE(Member)).template as<decltype(TVal.Member)>();}
 
+#define JSONCONS_MEMBER_CODEC(TC, JVal, TVal, Member) JSONCONS_MEMBER_CODEC_LAST(TC, JVal, TVal, Member),
+#define JSONCONS_MEMBER_CODEC_LAST(TC, JVal, TVal, Member) \
+    {JSONCONS_QUOTE(Member), \
+     [](const value_type& val, basic_json_content_handler<CharT>& receiver) \
+     {json_conversion_traits<typename std::decay<decltype(val.Member)>::type,void>::template encode<CharT,Json>(val.Member, receiver);}, \
+     [](value_type& val, basic_staj_reader<CharT>& reader, std::error_code& ec) \
+     {val.Member = json_conversion_traits<typename std::decay<decltype(val.Member)>::type,void>::template decode<CharT,Json>(reader, ec);}}
+
 #define JSONCONS_MEMBER_TRAITS_DECL(ValueType, ...)  \
 namespace jsoncons \
 { \
@@ -130,6 +258,32 @@ namespace jsoncons \
             return j; \
         } \
     }; \
+    template <> \
+    struct json_conversion_traits<ValueType,void> \
+    { \
+        typedef ValueType value_type; \
+        template <class CharT, class Json> \
+        static const jsoncons::detail::member_codec<value_type,CharT>& codec() \
+        { \
+            typedef typename jsoncons::detail::member_codec<value_type,CharT>::member member; \
+            static const member members[] = {JSONCONS_REP_N(JSONCONS_MEMBER_CODEC, 0, void(), void(), __VA_ARGS__)}; \
+            static const jsoncons::detail::member_codec<value_type,CharT> codec(members, sizeof(members)/sizeof(members[0]), \
+                                                                                  Json::implementation_policy::preserve_order); \
+            return codec; \
+        } \
+        template <class CharT, class Json> \
+        static value_type decode(basic_staj_reader<CharT>& reader, std::error_code& ec) \
+        { \
+            value_type val{}; \
+            codec<CharT,Json>().decode(val, reader, ec); \
+            return val; \
+        } \
+        template <class CharT, class Json> \
+        static void encode(const value_type& val, basic_json_content_handler<CharT>& receiver) \
+        { \
+            codec<CharT,Json>().encode(val, receiver); \
+        } \
+    }; \
 } \
   /**/
  
@@ -172,7 +326,9 @@ namespace jsoncons \
 
 #define JSONCONS_TYPE_TRAITS_FRIEND \
     template <class JSON,class T,class Enable> \
-    friend struct jsoncons::json_type_traits
+    friend struct jsoncons::json_type_traits; \
+    template <class T,class Enable> \
+    friend struct jsoncons::json_conversion_traits
 
 #if !defined(JSONCONS_NO_DEPRECATED)
 #define JSONCONS_TYPE_TRAITS_DECL JSONCONS_MEMBER_TRAITS_DECL
@@ -0,0 +1,422 @@
+// Copyright 2019 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_MMAP_SOURCE_HPP
+#define JSONCONS_MMAP_SOURCE_HPP
+
+#include <string>
+#include <cstring> // std::memcpy
+#include <cstdint>
+#include <system_error>
+#include <type_traits> // std::conditional
+#include <utility> // std::swap
+#include <jsoncons/config/jsoncons_config.hpp>
+#include <jsoncons/byte_string.hpp> // jsoncons::byte_traits
+#include <jsoncons/detail/span.hpp>
+
+#if defined(_WIN32)
+#  if !defined(WIN32_LEAN_AND_MEAN)
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  if !defined(NOMINMAX)
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <cerrno>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace jsoncons {
+
+namespace detail {
+
+// mapped_file
+
+// A read-only mapping of a whole file. The file handles are closed once
+// the view is mapped, the view stays valid until the mapped_file is destroyed.
+
+class mapped_file
+{
+    const uint8_t* data_;
+    size_t size_;
+
+    // Noncopyable
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+public:
+    mapped_file()
+        : data_(nullptr), size_(0)
+    {
+    }
+
+    mapped_file(mapped_file&& other)
+        : data_(nullptr), size_(0)
+    {
+        swap(other);
+    }
+
+    ~mapped_file()
+    {
+        unmap();
+    }
+
+    mapped_file& operator=(mapped_file&& other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    void swap(mapped_file& other)
+    {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+    }
+
+    const uint8_t* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+#if defined(_WIN32)
+    void map(const std::string& path, std::error_code& ec)
+    {
+        unmap();
+        HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            ec = std::error_code(static_cast<int>(::GetLastError()), std::system_category());
+            return;
+        }
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(file, &size))
+        {
+            ec = std::error_code(static_cast<int>(::GetLastError()), std::system_category());
+            ::CloseHandle(file);
+            return;
+        }
+        if (size.QuadPart == 0)
+        {
+            ::CloseHandle(file);
+            return;
+        }
+        HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            ec = std::error_code(static_cast<int>(::GetLastError()), std::system_category());
+            ::CloseHandle(file);
+            return;
+        }
+        const void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr)
+        {
+            ec = std::error_code(static_cast<int>(::GetLastError()), std::system_category());
+        }
+        else
+        {
+            data_ = static_cast<const uint8_t*>(view);
+            size_ = static_cast<size_t>(size.QuadPart);
+        }
+        ::CloseHandle(mapping);
+        ::CloseHandle(file);
+    }
+
+    void unmap()
+    {
+        if (data_ != nullptr)
+        {
+            ::UnmapViewOfFile(data_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+#else
+    void map(const std::string& path, std::error_code& ec)
+    {
+        unmap();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            ec = std::error_code(errno, std::system_category());
+            return;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) == -1)
+        {
+            ec = std::error_code(errno, std::system_category());
+            ::close(fd);
+            return;
+        }
+        if (st.st_size == 0)
+        {
+            ::close(fd);
+            return;
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+        void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED)
+        {
+            ec = std::error_code(errno, std::system_category());
+        }
+        else
+        {
+            // The readers make a single forward pass over the input
+            ::madvise(view, size, MADV_SEQUENTIAL);
+            data_ = static_cast<const uint8_t*>(view);
+            size_ = size;
+        }
+        ::close(fd);
+    }
+
+    void unmap()
+    {
+        if (data_ != nullptr)
+        {
+            ::munmap(const_cast<uint8_t*>(data_), size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+    }
+#endif
+};
+
+}
+
+// basic_mmap_source
+
+// A source over a read-only memory mapping of a file. It is contiguous,
+// so the JSON and CSV readers parse the mapped characters in place, and the
+// binary readers decode directly from the mapped bytes through peek(n) and consume(n).
+
+template <class CharT>
+class basic_mmap_source
+{
+public:
+    typedef CharT value_type;
+    typedef typename std::conditional<std::is_same<CharT,uint8_t>::value,byte_traits,std::char_traits<CharT>>::type traits_type;
+private:
+    detail::mapped_file file_;
+    const value_type* data_;
+    const value_type* input_ptr_;
+    const value_type* input_end_;
+    bool eof_;
+    bool is_error_;
+
+    // Noncopyable
+    basic_mmap_source(const basic_mmap_source&) = delete;
+    basic_mmap_source& operator=(const basic_mmap_source&) = delete;
+public:
+    basic_mmap_source(basic_mmap_source&& other)
+        : data_(nullptr), input_ptr_(nullptr), input_end_(nullptr), eof_(true), is_error_(false)
+    {
+        swap(other);
+    }
+
+    // Throws std::system_error if the file cannot be mapped
+    explicit basic_mmap_source(const std::string& path)
+        : data_(nullptr), input_ptr_(nullptr), input_end_(nullptr), eof_(true), is_error_(false)
+    {
+        std::error_code ec;
+        open(path, ec);
+        if (ec)
+        {
+            JSONCONS_THROW(std::system_error(ec, "Cannot map " + path));
+        }
+    }
+
+    // If the file cannot be mapped, sets ec and is_error() is true
+    basic_mmap_source(const std::string& path, std::error_code& ec)
+        : data_(nullptr), input_ptr_(nullptr), input_end_(nullptr), eof_(true), is_error_(false)
+    {
+        open(path, ec);
+    }
+
+    basic_mmap_source& operator=(basic_mmap_source&& other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    void swap(basic_mmap_source& other)
+    {
+        file_.swap(other.file_);
+        std::swap(data_,other.data_);
+        std::swap(input_ptr_,other.input_ptr_);
+        std::swap(input_end_,other.input_end_);
+        std::swap(eof_,other.eof_);
+        std::swap(is_error_,other.is_error_);
+    }
+
+    const value_type* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return input_end_ - data_;
+    }
+
+    bool eof() const
+    {
+        return eof_;
+    }
+
+    bool is_error() const
+    {
+        return is_error_;
+    }
+
+    size_t position() const
+    {
+        return (input_ptr_ - data_) + 1;
+    }
+
+    size_t get(value_type& c)
+    {
+        if (input_ptr_ < input_end_)
+        {
+            c = *input_ptr_++;
+            return 1;
+        }
+        else
+        {
+            eof_ = true;
+            return 0;
+        }
+    }
+
+    int get()
+    {
+        if (input_ptr_ < input_end_)
+        {
+            return *input_ptr_++;
+        }
+        else
+        {
+            eof_ = true;
+            return traits_type::eof();
+        }
+    }
+
+    void ignore(size_t count)
+    {
+        size_t len;
+        if ((size_t)(input_end_ - input_ptr_) < count)
+        {
+            len = input_end_ - input_ptr_;
+            eof_ = true;
+        }
+        else
+        {
+            len = count;
+        }
+        input_ptr_ += len;
+    }
+
+    int peek()
+    {
+        return input_ptr_ < input_end_ ? *input_ptr_ : traits_type::eof();
+    }
+
+    size_t read(value_type* p, size_t length)
+    {
+        size_t len;
+        if ((size_t)(input_end_ - input_ptr_) < length)
+        {
+            len = input_end_ - input_ptr_;
+            eof_ = true;
+        }
+        else
+        {
+            len = length;
+        }
+        std::memcpy(p, input_ptr_, len*sizeof(value_type));
+        input_ptr_  += len;
+        return len;
+    }
+
+    template <class OutputIt>
+    typename std::enable_if<!std::is_same<OutputIt,value_type*>::value,size_t>::type
+    read(OutputIt d_first, size_t count)
+    {
+        size_t len;
+        if ((size_t)(input_end_ - input_ptr_) < count)
+        {
+            len = input_end_ - input_ptr_;
+            eof_ = true;
+        }
+        else
+        {
+            len = count;
+        }
+        for (size_t i = 0; i < len; ++i)
+        {
+            *d_first++ = *input_ptr_++;
+        }
+        return len;
+    }
+
+    detail::span<const value_type> peek(size_t length)
+    {
+        size_t available = input_end_ - input_ptr_;
+        return detail::span<const value_type>(input_ptr_, available < length ? available : length);
+    }
+
+    void consume(size_t count)
+    {
+        input_ptr_ += count;
+    }
+
+    // Points data at the next length (or fewer) characters and advances past them
+
+    size_t read_in_place(const value_type*& data, size_t length)
+    {
+        size_t len;
+        if ((size_t)(input_end_ - input_ptr_) <= length)
+        {
+            len = input_end_ - input_ptr_;
+            eof_ = true;
+        }
+        else
+        {
+            len = length;
+        }
+        data = input_ptr_;
+        input_ptr_ += len;
+        return len;
+    }
+private:
+    void open(const std::string& path, std::error_code& ec)
+    {
+        file_.map(path, ec);
+        if (ec)
+        {
+            is_error_ = true;
+            return;
+        }
+        data_ = reinterpret_cast<const value_type*>(file_.data());
+        input_ptr_ = data_;
+        input_end_ = data_ + file_.size()/sizeof(value_type);
+        eof_ = input_ptr_ == input_end_;
+    }
+};
+
+typedef basic_mmap_source<char> mmap_source;
+typedef basic_mmap_source<uint8_t> binary_mmap_source;
+
+}
+
+#endif
@@ -0,0 +1,435 @@
+// Copyright 2019 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_NDJSON_READER_HPP
+#define JSONCONS_NDJSON_READER_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory> // std::unique_ptr
+#include <istream>
+#include <system_error>
+#include <exception> // std::exception_ptr
+#include <algorithm> // std::find, std::count, std::find_if
+#include <mutex>
+#include <condition_variable>
+#include <utility> // std::move
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_options.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/detail/worker_pool.hpp>
+
+namespace jsoncons {
+
+// ndjson_options
+
+class ndjson_options
+{
+    size_t num_threads_;
+    bool ordered_;
+    size_t chunk_size_;
+public:
+    static const size_t default_chunk_size = 1024*1024;
+
+    ndjson_options()
+        : num_threads_(0), ordered_(true), chunk_size_(default_chunk_size)
+    {
+    }
+
+    // The number of parsing threads, 0 for one per hardware thread
+    size_t num_threads() const
+    {
+        return num_threads_;
+    }
+
+    ndjson_options& num_threads(size_t value)
+    {
+        num_threads_ = value;
+        return *this;
+    }
+
+    // Whether documents are delivered in input order, or as soon as the
+    // chunk containing them has been parsed
+    bool ordered() const
+    {
+        return ordered_;
+    }
+
+    ndjson_options& ordered(bool value)
+    {
+        ordered_ = value;
+        return *this;
+    }
+
+    // The approximate number of characters parsed by one task
+    size_t chunk_size() const
+    {
+        return chunk_size_;
+    }
+
+    ndjson_options& chunk_size(size_t value)
+    {
+        chunk_size_ = value > 0 ? value : default_chunk_size;
+        return *this;
+    }
+};
+
+// basic_ndjson_reader
+
+// Reads newline delimited JSON, one document per line. The input is split
+// at line boundaries into chunks that are parsed by a pool of worker threads,
+// each with its own parser and decoder. String input is parsed in place and
+// must outlive the reader.
+
+template <class Json>
+class basic_ndjson_reader : public ser_context
+{
+public:
+    typedef Json value_type;
+    typedef typename Json::char_type char_type;
+    typedef basic_string_view<char_type> string_view_type;
+private:
+    struct chunk
+    {
+        std::basic_string<char_type> buffer_;
+        const char_type* data_;
+        size_t length_;
+        size_t first_line_;
+        std::vector<Json> documents_;
+        std::error_code ec_;
+        size_t line_;
+        size_t column_;
+        std::exception_ptr exception_;
+        bool done_;
+
+        chunk()
+            : data_(nullptr), length_(0), first_line_(1), line_(0), column_(0), done_(false)
+        {
+        }
+    };
+
+    ndjson_options options_;
+    const basic_json_decode_options<char_type>& decode_options_;
+    std::basic_istream<char_type>* is_;
+    string_view_type input_;
+    size_t position_;
+    std::basic_string<char_type> carry_;
+    bool eof_;
+    size_t line_count_;
+    size_t line_;
+    size_t column_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+
+    // noncopyable and nonmoveable
+    basic_ndjson_reader(const basic_ndjson_reader&) = delete;
+    basic_ndjson_reader& operator=(const basic_ndjson_reader&) = delete;
+public:
+    explicit basic_ndjson_reader(std::basic_istream<char_type>& is,
+                                 const ndjson_options& options = ndjson_options(),
+                                 const basic_json_decode_options<char_type>& decode_options = basic_json_options<char_type>::default_options())
+        : options_(options),
+          decode_options_(decode_options),
+          is_(std::addressof(is)),
+          position_(0),
+          eof_(false),
+          line_count_(0),
+          line_(0),
+          column_(0)
+    {
+    }
+
+    explicit basic_ndjson_reader(const string_view_type& input,
+                                 const ndjson_options& options = ndjson_options(),
+                                 const basic_json_decode_options<char_type>& decode_options = basic_json_options<char_type>::default_options())
+        : options_(options),
+          decode_options_(decode_options),
+          is_(nullptr),
+          input_(input),
+          position_(0),
+          eof_(false),
+          line_count_(0),
+          line_(0),
+          column_(0)
+    {
+    }
+
+    // Calls f(Json&&) for each document
+    template <class F>
+    void read_documents(F f)
+    {
+        std::error_code ec;
+        read_documents(f, ec);
+        if (ec)
+        {
+            throw ser_error(ec,line_,column_);
+        }
+    }
+
+    template <class F>
+    void read_documents(F f, std::error_code& ec)
+    {
+        size_t num_threads = options_.num_threads() > 0 ? options_.num_threads() : detail::worker_pool::default_num_threads();
+        if (num_threads == 1)
+        {
+            read_serially(f, ec);
+        }
+        else
+        {
+            read_in_parallel(f, num_threads, ec);
+        }
+    }
+
+    // Replays each document as events to handler
+    void read(basic_json_content_handler<char_type>& handler)
+    {
+        read_documents([&handler](Json&& val){val.dump(handler);});
+    }
+
+    void read(basic_json_content_handler<char_type>& handler, std::error_code& ec)
+    {
+        read_documents([&handler](Json&& val){val.dump(handler);}, ec);
+    }
+
+    // The position of the last error
+    size_t line() const override
+    {
+        return line_;
+    }
+
+    size_t column() const override
+    {
+        return column_;
+    }
+private:
+    template <class F>
+    void read_serially(F& f, std::error_code& ec)
+    {
+        chunk c;
+        while (next_chunk(c))
+        {
+            parse_chunk(c);
+            if (!deliver(c, f, ec))
+            {
+                return;
+            }
+            c.documents_.clear();
+        }
+    }
+
+    template <class F>
+    void read_in_parallel(F& f, size_t num_threads, std::error_code& ec)
+    {
+        const size_t max_pending = 2*num_threads;
+
+        // Destroyed after the pool has finished any tasks that refer to them
+        std::deque<std::unique_ptr<chunk>> pending;
+        detail::worker_pool pool(num_threads);
+
+        while (true)
+        {
+            while (pending.size() < max_pending)
+            {
+                std::unique_ptr<chunk> c(new chunk());
+                if (!next_chunk(*c))
+                {
+                    break;
+                }
+                chunk* p = c.get();
+                pending.push_back(std::move(c));
+                pool.submit([this,p]()
+                {
+                    parse_chunk(*p);
+                    {
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        p->done_ = true;
+                    }
+                    cv_.notify_all();
+                });
+            }
+            if (pending.empty())
+            {
+                break;
+            }
+
+            std::unique_ptr<chunk> c;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                if (options_.ordered())
+                {
+                    cv_.wait(lock, [&pending](){return pending.front()->done_;});
+                    c = std::move(pending.front());
+                    pending.pop_front();
+                }
+                else
+                {
+                    auto it = pending.end();
+                    cv_.wait(lock, [&pending,&it]()
+                    {
+                        it = std::find_if(pending.begin(), pending.end(),
+                                          [](const std::unique_ptr<chunk>& p){return p->done_;});
+                        return it != pending.end();
+                    });
+                    c = std::move(*it);
+                    pending.erase(it);
+                }
+            }
+            if (!deliver(*c, f, ec))
+            {
+                return;
+            }
+        }
+    }
+
+    // Returns false if the chunk ended with an error
+    template <class F>
+    bool deliver(chunk& c, F& f, std::error_code& ec)
+    {
+        for (auto& val : c.documents_)
+        {
+            f(std::move(val));
+        }
+        if (c.exception_)
+        {
+            std::rethrow_exception(c.exception_);
+        }
+        if (c.ec_)
+        {
+            ec = c.ec_;
+            line_ = c.line_;
+            column_ = c.column_;
+            return false;
+        }
+        return true;
+    }
+
+    bool next_chunk(chunk& c)
+    {
+        c.first_line_ = line_count_ + 1;
+        if (is_ == nullptr)
+        {
+            if (position_ >= input_.size())
+            {
+                return false;
+            }
+            size_t end = position_ + options_.chunk_size();
+            if (end >= input_.size())
+            {
+                end = input_.size();
+            }
+            else
+            {
+                // Extend to the end of the line
+                const char_type* nl = std::find(input_.data() + end, input_.data() + input_.size(), '\n');
+                end = nl == input_.data() + input_.size() ? input_.size() : (nl - input_.data()) + 1;
+            }
+            c.data_ = input_.data() + position_;
+            c.length_ = end - position_;
+            position_ = end;
+        }
+        else
+        {
+            c.buffer_.swap(carry_);
+            carry_.clear();
+            while (!eof_)
+            {
+                size_t old_size = c.buffer_.size();
+                c.buffer_.resize(old_size + options_.chunk_size());
+                is_->read(&c.buffer_[old_size], options_.chunk_size());
+                size_t n = static_cast<size_t>(is_->gcount());
+                c.buffer_.resize(old_size + n);
+                if (n < options_.chunk_size())
+                {
+                    eof_ = true;
+                    break;
+                }
+                // Move any partial last line to the next chunk
+                size_t pos = c.buffer_.size();
+                while (pos > old_size && c.buffer_[pos-1] != '\n')
+                {
+                    --pos;
+                }
+                if (pos > old_size)
+                {
+                    carry_.assign(c.buffer_, pos, c.buffer_.size() - pos);
+                    c.buffer_.resize(pos);
+                    break;
+                }
+            }
+            if (c.buffer_.empty())
+            {
+                return false;
+            }
+            c.data_ = c.buffer_.data();
+            c.length_ = c.buffer_.size();
+        }
+        line_count_ += std::count(c.data_, c.data_ + c.length_, '\n');
+        return true;
+    }
+
+    void parse_chunk(chunk& c)
+    {
+        try
+        {
+            json_decoder<Json> decoder;
+            basic_json_parser<char_type> parser(decode_options_);
+
+            const char_type* p = c.data_;
+            const char_type* end = c.data_ + c.length_;
+            size_t line = c.first_line_;
+            while (p != end)
+            {
+                const char_type* nl = std::find(p, end, '\n');
+                if (!is_blank_line(p, nl))
+                {
+                    parser.reset();
+                    parser.update(p, nl - p);
+                    parser.finish_parse(decoder, c.ec_);
+                    if (!c.ec_)
+                    {
+                        parser.check_done(c.ec_);
+                    }
+                    if (c.ec_)
+                    {
+                        c.line_ = line;
+                        c.column_ = parser.column();
+                        return;
+                    }
+                    c.documents_.push_back(decoder.get_result());
+                }
+                p = nl == end ? end : nl + 1;
+                ++line;
+            }
+        }
+        catch (...)
+        {
+            c.exception_ = std::current_exception();
+        }
+    }
+
+    static bool is_blank_line(const char_type* first, const char_type* last)
+    {
+        for (; first != last; ++first)
+        {
+            if (*first != ' ' && *first != '\t' && *first != '\r')
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+typedef basic_ndjson_reader<json> ndjson_reader;
+typedef basic_ndjson_reader<ojson> ondjson_reader;
+
+}
+
+#endif
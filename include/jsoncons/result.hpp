@@ -15,6 +15,8 @@
 #include <exception>
 #include <memory> // std::addressof
 #include <cstring> // std::memcpy
+#include <cstdint>
+#include <utility> // std::swap
 #include <jsoncons/config/jsoncons_config.hpp>
 #include <jsoncons/detail/type_traits.hpp>
 
@@ -76,6 +78,15 @@ public:
             std::memcpy(p_, s, length*sizeof(CharT));
             p_ += length;
         }
+        else if (length <= buffer_.size())
+        {
+            // Top up the buffer and write it whole, rather than writing
+            // a part filled buffer and a short piece separately
+            std::memcpy(p_, s, diff*sizeof(CharT));
+            os_->write(begin_buffer_, buffer_.size());
+            std::memcpy(begin_buffer_, s + diff, (length - diff)*sizeof(CharT));
+            p_ = begin_buffer_ + (length - diff);
+        }
         else
         {
             os_->write(begin_buffer_, buffer_length());
@@ -166,6 +177,13 @@ public:
             std::memcpy(p_, s, length*sizeof(uint8_t));
             p_ += length;
         }
+        else if (length <= buffer_.size())
+        {
+            std::memcpy(p_, s, diff*sizeof(uint8_t));
+            os_->write((char*)begin_buffer_, buffer_.size());
+            std::memcpy(begin_buffer_, s + diff, (length - diff)*sizeof(uint8_t));
+            p_ = begin_buffer_ + (length - diff);
+        }
         else
         {
             os_->write((char*)begin_buffer_, buffer_length());
@@ -279,6 +297,196 @@ public:
     }
 };
 
+// basic_output_buffer
+
+// A growable contiguous buffer of characters or bytes. Unlike std::vector,
+// growing it does not value initialize the new capacity, and appending is
+// a bounds check and a memcpy.
+
+template <class CharT, class Allocator=std::allocator<CharT>>
+class basic_output_buffer
+{
+public:
+    typedef CharT value_type;
+    typedef Allocator allocator_type;
+    typedef const CharT* const_iterator;
+private:
+    typedef std::allocator_traits<Allocator> allocator_traits_type;
+
+    static const size_t default_capacity = 256;
+
+    Allocator alloc_;
+    CharT* data_;
+    size_t size_;
+    size_t capacity_;
+
+    // Noncopyable
+    basic_output_buffer(const basic_output_buffer&) = delete;
+    basic_output_buffer& operator=(const basic_output_buffer&) = delete;
+public:
+    explicit basic_output_buffer(const Allocator& alloc = Allocator())
+        : alloc_(alloc), data_(nullptr), size_(0), capacity_(0)
+    {
+    }
+
+    basic_output_buffer(basic_output_buffer&& other)
+        : alloc_(other.alloc_), data_(other.data_), size_(other.size_), capacity_(other.capacity_)
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.capacity_ = 0;
+    }
+
+    ~basic_output_buffer()
+    {
+        if (data_ != nullptr)
+        {
+            allocator_traits_type::deallocate(alloc_, data_, capacity_);
+        }
+    }
+
+    basic_output_buffer& operator=(basic_output_buffer&& other)
+    {
+        std::swap(alloc_, other.alloc_);
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        return *this;
+    }
+
+    const CharT* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    const_iterator begin() const
+    {
+        return data_;
+    }
+
+    const_iterator end() const
+    {
+        return data_ + size_;
+    }
+
+    // Keeps the capacity, so that the buffer may be reused without reallocating
+    void clear()
+    {
+        size_ = 0;
+    }
+
+    void reserve(size_t n)
+    {
+        if (n > capacity_)
+        {
+            CharT* p = allocator_traits_type::allocate(alloc_, n);
+            if (data_ != nullptr)
+            {
+                std::memcpy(p, data_, size_*sizeof(CharT));
+                allocator_traits_type::deallocate(alloc_, data_, capacity_);
+            }
+            data_ = p;
+            capacity_ = n;
+        }
+    }
+
+    void append(const CharT* s, size_t length)
+    {
+        if (capacity_ - size_ < length)
+        {
+            grow(length);
+        }
+        std::memcpy(data_ + size_, s, length*sizeof(CharT));
+        size_ += length;
+    }
+
+    void push_back(CharT ch)
+    {
+        if (size_ == capacity_)
+        {
+            grow(1);
+        }
+        data_[size_++] = ch;
+    }
+private:
+    void grow(size_t length)
+    {
+        size_t n = capacity_ == 0 ? default_capacity : 2*capacity_;
+        reserve(n - size_ >= length ? n : size_ + length);
+    }
+};
+
+template <class CharT, class Allocator>
+const size_t basic_output_buffer<CharT,Allocator>::default_capacity;
+
+typedef basic_output_buffer<char> output_buffer;
+typedef basic_output_buffer<wchar_t> woutput_buffer;
+typedef basic_output_buffer<uint8_t> binary_output_buffer;
+
+// buffer_result
+
+template <class CharT, class Allocator=std::allocator<CharT>>
+class buffer_result 
+{
+public:
+    typedef CharT value_type;
+    typedef basic_output_buffer<CharT,Allocator> output_type;
+private:
+    output_type* buf_;
+
+    // Noncopyable
+    buffer_result(const buffer_result&) = delete;
+    buffer_result& operator=(const buffer_result&) = delete;
+public:
+    buffer_result(buffer_result&& other)
+        : buf_(nullptr)
+    {
+        std::swap(buf_, other.buf_);
+    }
+
+    buffer_result(output_type& buf)
+        : buf_(std::addressof(buf))
+    {
+    }
+
+    buffer_result& operator=(buffer_result&& other)
+    {
+        std::swap(buf_, other.buf_);
+        return *this;
+    }
+
+    void flush()
+    {
+    }
+
+    void append(const value_type* s, size_t length)
+    {
+        buf_->append(s, length);
+    }
+
+    void push_back(value_type ch)
+    {
+        buf_->push_back(ch);
+    }
+};
+
+typedef buffer_result<uint8_t> binary_buffer_result;
+
 }
 
 #endif
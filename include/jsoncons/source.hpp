@@ -14,12 +14,31 @@
 #include <memory> // std::addressof
 #include <cstring> // std::memcpy
 #include <exception>
+#include <algorithm> // std::copy
+#include <iterator> // std::back_inserter
 #include <type_traits> // std::enable_if
+#include <utility> // std::declval
 #include <jsoncons/config/jsoncons_config.hpp>
+#include <jsoncons/config/binary_detail.hpp>
 #include <jsoncons/byte_string.hpp> // jsoncons::byte_traits
+#include <jsoncons/detail/span.hpp>
 
 namespace jsoncons { 
 
+// is_contiguous_source
+
+// A contiguous source holds all of its input in memory and can hand it 
+// out in place through read_in_place, so readers can parse it without
+// copying it into an intermediate buffer
+
+template <class Source, class Enable=void>
+struct is_contiguous_source : std::false_type {};
+
+template <class Source>
+struct is_contiguous_source<Source, 
+                            typename std::enable_if<std::is_same<decltype(std::declval<Source&>().read_in_place(std::declval<const typename Source::value_type*&>(),size_t())),size_t>::value
+>::type> : std::true_type {};
+
 // text sources
 
 template <class CharT>
@@ -338,6 +357,25 @@ public:
         return len;
     }
 
+    // Points data at the next length (or fewer) characters and advances past them
+
+    size_t read_in_place(const value_type*& data, size_t length)
+    {
+        size_t len;
+        if ((size_t)(input_end_ - input_ptr_) <= length)
+        {
+            len = input_end_ - input_ptr_;
+            eof_ = true;
+        }
+        else
+        {
+            len = length;
+        }
+        data = input_ptr_;
+        input_ptr_ += len;
+        return len;
+    }
+
     template <class OutputIt>
     typename std::enable_if<!std::is_same<OutputIt,value_type*>::value,size_t>::type
     read(OutputIt d_first, size_t count)
@@ -362,32 +400,77 @@ public:
 
 // binary sources
 
+// binary_stream_source reads the stream through an internal buffer that is 
+// refilled with sgetn, rather than calling sbumpc per byte. The next bytes
+// can be examined in place with peek(n) and skipped with consume(n).
+// On destruction, bytes read ahead but not consumed are returned to the
+// stream, if the stream buffer supports seeking.
+
 class binary_stream_source 
 {
 public:
     typedef uint8_t value_type;
     typedef byte_traits traits_type;
+    static const size_t default_buffer_length = 16384;
 private:
     std::istream* is_;
     std::streambuf* sbuf_;
+    std::vector<value_type> buffer_;
+    const value_type* input_ptr_;
+    const value_type* input_end_;
     size_t position_;
+    bool seekable_;
 
     // Noncopyable 
     binary_stream_source(const binary_stream_source&) = delete;
     binary_stream_source& operator=(const binary_stream_source&) = delete;
 public:
-    binary_stream_source(binary_stream_source&&) = default;
+    binary_stream_source(binary_stream_source&& other)
+        : is_(nullptr), sbuf_(nullptr), input_ptr_(nullptr), input_end_(nullptr), position_(0), seekable_(false)
+    {
+        swap(other);
+    }
 
     binary_stream_source(std::istream& is)
-        : is_(std::addressof(is)), sbuf_(is.rdbuf()), position_(0)
+        : is_(std::addressof(is)), sbuf_(is.rdbuf()), input_ptr_(nullptr), input_end_(nullptr), position_(0), 
+          seekable_(is_seekable(sbuf_))
     {
     }
 
     ~binary_stream_source()
     {
+        if (sbuf_ != nullptr && input_ptr_ < input_end_)
+        {
+            // Only a seekable stream buffer is read ahead
+            try
+            {
+                if (sbuf_->pubseekoff(-static_cast<std::streamoff>(input_end_ - input_ptr_), std::ios::cur, std::ios::in) == std::streampos(std::streamoff(-1)))
+                {
+                    is_->clear(is_->rdstate() | std::ios::failbit);
+                }
+            }
+            catch (const std::exception&)
+            {
+            }
+        }
     }
 
-    binary_stream_source& operator=(binary_stream_source&&) = default;
+    binary_stream_source& operator=(binary_stream_source&& other)
+    {
+        swap(other);
+        return *this;
+    }
+
+    void swap(binary_stream_source& other)
+    {
+        std::swap(is_,other.is_);
+        std::swap(sbuf_,other.sbuf_);
+        buffer_.swap(other.buffer_);
+        std::swap(input_ptr_,other.input_ptr_);
+        std::swap(input_end_,other.input_end_);
+        std::swap(position_,other.position_);
+        std::swap(seekable_,other.seekable_);
+    }
 
     bool eof() const
     {
@@ -406,88 +489,63 @@ public:
 
     size_t get(value_type& c)
     {
-        try
+        if (input_ptr_ < input_end_ || fill(1) > 0)
         {
-            int val = sbuf_->sbumpc();
-            if (!(val == traits_type::eof()))
-            {
-                c = (value_type)val;
-                ++position_;
-                return 1;
-            }
-            else
-            {
-                is_->clear(is_->rdstate() | std::ios::eofbit);
-                return 0;
-            }
+            c = *input_ptr_++;
+            ++position_;
+            return 1;
         }
-        catch (const std::exception&)
+        else
         {
-            is_->clear(is_->rdstate() | std::ios::badbit | std::ios::eofbit);
+            is_->clear(is_->rdstate() | std::ios::eofbit);
             return 0;
         }
     }
 
     int get()
     {
-        try
+        if (input_ptr_ < input_end_ || fill(1) > 0)
         {
-            int c = sbuf_->sbumpc();
-            if (c == traits_type::eof())
-            {
-                is_->clear(is_->rdstate() | std::ios::eofbit);
-            }
-            else
-            {
-                ++position_;
-            }
-            return c;
+            ++position_;
+            return *input_ptr_++;
         }
-        catch (const std::exception&)
+        else
         {
-            is_->clear(is_->rdstate() | std::ios::badbit | std::ios::eofbit);
+            is_->clear(is_->rdstate() | std::ios::eofbit);
             return traits_type::eof();
         }
     }
 
     void ignore(size_t count)
     {
-        try
+        while (count > 0)
         {
-            for (size_t i = 0; i < count; ++i)
+            size_t available = input_end_ - input_ptr_;
+            if (available == 0)
             {
-                int c = sbuf_->sbumpc();
-                if (c == traits_type::eof())
+                available = fill(1);
+                if (available == 0)
                 {
                     is_->clear(is_->rdstate() | std::ios::eofbit);
                     return;
                 }
-                else
-                {
-                    ++position_;
-                }
             }
-        }
-        catch (const std::exception&)
-        {
-            is_->clear(is_->rdstate() | std::ios::badbit | std::ios::eofbit);
+            size_t len = count < available ? count : available;
+            input_ptr_ += len;
+            position_ += len;
+            count -= len;
         }
     }
 
     int peek() 
     {
-        try
+        if (input_ptr_ < input_end_ || fill(1) > 0)
         {
-            int c = sbuf_->sgetc();
-            if (c == traits_type::eof())
-            {
-                is_->clear(is_->rdstate() | std::ios::eofbit);
-            }
-            return c;
+            return *input_ptr_;
         }
-        catch (const std::exception&)
+        else
         {
-            is_->clear(is_->rdstate() | std::ios::badbit);
+            is_->clear(is_->rdstate() | std::ios::eofbit);
             return traits_type::eof();
         }
     }
@@ -496,29 +554,108 @@ public:
     size_t read(OutputIt p, size_t length)
     {
         size_t count = 0;
-        try
+        while (count < length)
         {
-            for (count = 0; count < length; ++count)
+            size_t available = input_end_ - input_ptr_;
+            if (available == 0)
             {
-                int c = sbuf_->sbumpc();
-                if (c == traits_type::eof())
+                available = fill(1);
+                if (available == 0)
                 {
                     is_->clear(is_->rdstate() | std::ios::eofbit);
                     return count;
                 }
-                else
+            }
+            size_t len = (length - count) < available ? (length - count) : available;
+            p = std::copy(input_ptr_, input_ptr_ + len, p);
+            input_ptr_ += len;
+            position_ += len;
+            count += len;
+        }
+        return count;
+    }
+
+    // Returns a span over the next length bytes, or over the bytes that 
+    // remain if the input ends first, without consuming them. The span is 
+    // valid until the next call other than consume.
+
+    detail::span<const value_type> peek(size_t length)
+    {
+        size_t available = input_end_ - input_ptr_;
+        if (available < length)
+        {
+            available = fill(length);
+        }
+        return detail::span<const value_type>(input_ptr_, available < length ? available : length);
+    }
+
+    // Consumes count bytes of the last span returned by peek
+
+    void consume(size_t count)
+    {
+        input_ptr_ += count;
+        position_ += count;
+    }
+private:
+    static bool is_seekable(std::streambuf* sbuf)
+    {
+        try
+        {
+            return sbuf->pubseekoff(0, std::ios::cur, std::ios::in) != std::streampos(std::streamoff(-1));
+        }
+        catch (const std::exception&)
+        {
+            return false;
+        }
+    }
+
+    // Buffers at least length bytes, unless the input ends first, and
+    // returns the number of bytes buffered. Bytes read ahead are returned 
+    // to the stream on destruction, which needs a seekable stream buffer,
+    // otherwise no more than length bytes are buffered.
+    size_t fill(size_t length)
+    {
+        // Never negative, which also lets the compiler bound the copies below
+        size_t available = input_ptr_ < input_end_ ? static_cast<size_t>(input_end_ - input_ptr_) : 0;
+        size_t capacity = default_buffer_length;
+        if (capacity < length)
+        {
+            capacity = length;
+        }
+        if (buffer_.size() < capacity)
+        {
+            std::vector<value_type> buffer(capacity);
+            if (available > 0)
+            {
+                std::memcpy(buffer.data(), input_ptr_, available);
+            }
+            buffer_.swap(buffer);
+        }
+        else if (available > 0 && input_ptr_ != buffer_.data())
+        {
+            std::memmove(buffer_.data(), input_ptr_, available);
+        }
+        const size_t limit = seekable_ ? buffer_.size() : length;
+        try
+        {
+            while (available < length)
+            {
+                std::streamsize n = sbuf_->sgetn(reinterpret_cast<char*>(buffer_.data() + available), 
+                                                 static_cast<std::streamsize>(limit - available));
+                if (n <= 0)
                 {
-                    ++position_;
+                    break;
                 }
-                *p++ = (value_type)c;
+                available += static_cast<size_t>(n);
             }
-            return count;
         }
         catch (const std::exception&)
         {
             is_->clear(is_->rdstate() | std::ios::badbit | std::ios::eofbit);
-            return count;
         }
+        input_ptr_ = buffer_.data();
+        input_end_ = buffer_.data() + available;
+        return available;
     }
 };
 
@@ -666,6 +803,163 @@ public:
         }
         return len;
     }
+
+    detail::span<const value_type> peek(size_t length)
+    {
+        size_t available = input_end_ - input_ptr_;
+        return detail::span<const value_type>(input_ptr_, available < length ? available : length);
+    }
+
+    void consume(size_t count)
+    {
+        input_ptr_ += count;
+    }
+
+    size_t read_in_place(const value_type*& data, size_t length)
+    {
+        size_t len;
+        if ((size_t)(input_end_ - input_ptr_) <= length)
+        {
+            len = input_end_ - input_ptr_;
+            eof_ = true;
+        }
+        else
+        {
+            len = length;
+        }
+        data = input_ptr_;
+        input_ptr_ += len;
+        return len;
+    }
+};
+
+// is_span_source
+
+// A span source hands out its next bytes in place through peek(n), which
+// returns a span over the next n bytes (fewer only at the end of input), 
+// and consume(n), which advances past them 
+
+template <class Source, class Enable=void>
+struct is_span_source : std::false_type {};
+
+template <class Source>
+struct is_span_source<Source, 
+                      typename std::enable_if<std::is_same<decltype(std::declval<Source&>().peek(size_t())),detail::span<const typename Source::value_type>>::value &&
+                                              std::is_same<decltype(std::declval<Source&>().consume(size_t())),void>::value
+>::type> : std::true_type {};
+
+// source_reader
+
+// Reads fixed width values and payloads from binary sources, from spans
+// where the source supports them, otherwise through read
+
+template <class Source, class Enable=void>
+struct source_reader
+{
+    typedef typename Source::value_type value_type;
+
+    // Reads a big endian value, returns false if the input ends first
+    template <class T>
+    static bool read_big_endian(Source& source, T& val)
+    {
+        value_type buf[sizeof(T)];
+        if (source.read(buf, sizeof(T)) != sizeof(T))
+        {
+            return false;
+        }
+        const uint8_t* endp;
+        val = jsoncons::detail::from_big_endian<T>(buf, buf+sizeof(T), &endp);
+        return true;
+    }
+
+    // Appends the next length bytes to buffer, returns the number of bytes appended
+    template <class Container>
+    static size_t read(Source& source, Container& buffer, size_t length)
+    {
+        return source.read(std::back_inserter(buffer), length);
+    }
+
+    // Points data at the next length bytes, copied into buffer, returns 
+    // the number of bytes available at data
+    template <class Container>
+    static size_t read_in_place(Source& source, Container& buffer, size_t length, const value_type*& data)
+    {
+        buffer.clear();
+        size_t n = source.read(std::back_inserter(buffer), length);
+        data = reinterpret_cast<const value_type*>(buffer.data());
+        return n;
+    }
+};
+
+template <class Source>
+struct source_reader<Source,typename std::enable_if<is_span_source<Source>::value>::type>
+{
+    typedef typename Source::value_type value_type;
+
+    // Payloads longer than this are copied from a buffered source in chunks,
+    // so that a corrupt length does not force a matching allocation
+    static const size_t max_chunk_length = 16384;
+
+    template <class T>
+    static bool read_big_endian(Source& source, T& val)
+    {
+        auto s = source.peek(sizeof(T));
+        if (s.size() < sizeof(T))
+        {
+            // Consumes what remains and sets eof
+            value_type buf[sizeof(T)];
+            source.read(buf, sizeof(T));
+            return false;
+        }
+        const uint8_t* endp;
+        val = jsoncons::detail::from_big_endian<T>(s.data(), s.data()+sizeof(T), &endp);
+        source.consume(sizeof(T));
+        return true;
+    }
+
+    template <class Container>
+    static size_t read(Source& source, Container& buffer, size_t length)
+    {
+        size_t count = 0;
+        while (count < length)
+        {
+            size_t n = length - count;
+            if (n > max_chunk_length)
+            {
+                n = max_chunk_length;
+            }
+            auto s = source.peek(n);
+            buffer.insert(buffer.end(), s.begin(), s.end());
+            source.consume(s.size());
+            count += s.size();
+            if (s.size() < n)
+            {
+                // Sets eof
+                source.ignore(1);
+                break;
+            }
+        }
+        return count;
+    }
+
+    template <class Container>
+    static size_t read_in_place(Source& source, Container& buffer, size_t length, const value_type*& data)
+    {
+        if (length <= max_chunk_length || is_contiguous_source<Source>::value)
+        {
+            auto s = source.peek(length);
+            if (s.size() == length)
+            {
+                source.consume(length);
+                data = s.data();
+                return length;
+            }
+        }
+        buffer.clear();
+        size_t n = read(source, buffer, length);
+        data = reinterpret_cast<const value_type*>(buffer.data());
+        return n;
+    }
 };
 
 }
@@ -26,6 +26,7 @@ class basic_staj_array_iterator
 
     basic_staj_reader<char_type>* reader_;
     T value_;
+    bool done_;
 public:
     typedef T value_type;
     typedef std::ptrdiff_t difference_type;
@@ -34,12 +35,12 @@ public:
     typedef std::input_iterator_tag iterator_category;
 
     basic_staj_array_iterator() noexcept
-        : reader_(nullptr)
+        : reader_(nullptr), done_(true)
     {
     }
 
     basic_staj_array_iterator(basic_staj_reader<char_type>& reader)
-        : reader_(std::addressof(reader))
+        : reader_(std::addressof(reader)), done_(false)
     {
         if (reader_->current().event_type() == staj_event_type::begin_array)
         {
@@ -53,7 +54,7 @@ public:
 
     basic_staj_array_iterator(basic_staj_reader<char_type>& reader,
                         std::error_code& ec)
-        : reader_(std::addressof(reader))
+        : reader_(std::addressof(reader)), done_(false)
     {
         if (reader_->current().event_type() == staj_event_type::begin_array)
         {
@@ -105,8 +106,8 @@ public:
     friend bool operator==(const basic_staj_array_iterator<T,CharT,Json>& a, const basic_staj_array_iterator<T,CharT,Json>& b)
     {
         return (!a.reader_ && !b.reader_)
-            || (!a.reader_ && b.done())
-            || (!b.reader_ && a.done());
+            || (!a.reader_ && b.done_)
+            || (!b.reader_ && a.done_);
     }
 
     friend bool operator!=(const basic_staj_array_iterator<T,CharT,Json>& a, const basic_staj_array_iterator<T,CharT,Json>& b)
@@ -116,7 +117,10 @@ public:
 
 private:
 
-    bool done() const
+    // Whether the reader is at the end of the array. Checked only after advancing to 
+    // the next element, once an element has been read the reader may be at the last
+    // event of that element.
+    bool at_end() const
     {
         return reader_->done() || reader_->current().event_type() == staj_event_type::end_array;
     }
@@ -153,15 +157,16 @@ public:
 private:
     basic_staj_reader<char_type>* reader_;
     value_type kv_;
+    bool done_;
 public:
 
     basic_staj_object_iterator() noexcept
-        : reader_(nullptr)
+        : reader_(nullptr), done_(true)
     {
     }
 
     basic_staj_object_iterator(basic_staj_reader<char_type>& reader)
-        : reader_(std::addressof(reader))
+        : reader_(std::addressof(reader)), done_(false)
     {
         if (reader_->current().event_type() == staj_event_type::begin_object)
         {
@@ -175,7 +180,7 @@ public:
 
     basic_staj_object_iterator(basic_staj_reader<char_type>& reader, 
                          std::error_code& ec)
-        : reader_(std::addressof(reader))
+        : reader_(std::addressof(reader)), done_(false)
     {
         if (reader_->current().event_type() == staj_event_type::begin_object)
         {
@@ -227,8 +232,8 @@ public:
     friend bool operator==(const basic_staj_object_iterator<T,CharT,Json>& a, const basic_staj_object_iterator<T,CharT,Json>& b)
     {
         return (!a.reader_ && !b.reader_)
-               || (!a.reader_ && b.done())
-               || (!b.reader_ && a.done());
+               || (!a.reader_ && b.done_)
+               || (!b.reader_ && a.done_);
     }
 
     friend bool operator!=(const basic_staj_object_iterator<T,CharT,Json>& a, const basic_staj_object_iterator<T,CharT,Json>& b)
@@ -238,7 +243,7 @@ public:
 
 private:
 
-    bool done() const
+    bool at_end() const
     {
         return reader_->done() || reader_->current().event_type() == staj_event_type::end_object;
     }
@@ -281,10 +286,11 @@ namespace jsoncons {
 template <class T, class CharT, class Json>
 void basic_staj_array_iterator<T,CharT,Json>::next()
 {
-    if (!done())
+    if (!done_)
     {
         reader_->next();
-        if (!done())
+        done_ = at_end();
+        if (!done_)
         {
             read_from(Json(), *reader_, value_);
         }
@@ -294,14 +300,15 @@ void basic_staj_array_iterator<T,CharT,Json>::next()
 template<class T, class CharT, class Json>
 void basic_staj_array_iterator<T,CharT,Json>::next(std::error_code& ec)
 {
-    if (!done())
+    if (!done_)
     {
         reader_->next(ec);
         if (ec)
         {
             return;
         }
-        if (!done())
+        done_ = at_end();
+        if (!done_)
         {
             read_from(Json(), *reader_, value_, ec);
         }
@@ -312,12 +319,13 @@ template<class T, class CharT, class Json>
 void basic_staj_object_iterator<T,CharT,Json>::next()
 {
     reader_->next();
-    if (!done())
+    done_ = at_end();
+    if (!done_)
     {
         JSONCONS_ASSERT(reader_->current().event_type() == staj_event_type::name);
         kv_.first =reader_->current(). template as<key_type>();
         reader_->next();
-        if (!done())
+        if (!reader_->done())
         {
             read_from(Json(), *reader_, kv_.second);
         }
@@ -332,7 +340,8 @@ void basic_staj_object_iterator<T,CharT,Json>::next(std::error_code& ec)
     {
         return;
     }
-    if (!done())
+    done_ = at_end();
+    if (!done_)
     {
         JSONCONS_ASSERT(reader_->current().event_type() == staj_event_type::name);
         kv_.first =reader_->current(). template as<key_type>();
@@ -341,7 +350,7 @@ void basic_staj_object_iterator<T,CharT,Json>::next(std::error_code& ec)
         {
             return;
         }
-        if (!done())
+        if (!reader_->done())
         {
              read_from(Json(), *reader_, kv_.second, ec);
         }
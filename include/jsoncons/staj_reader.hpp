@@ -17,6 +17,7 @@
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_content_handler.hpp>
 #include <jsoncons/bignum.hpp>
+#include <jsoncons/byte_string.hpp>
 #include <jsoncons/parse_error_handler.hpp>
 #include <jsoncons/ser_context.hpp>
 #include <jsoncons/result.hpp>
@@ -77,6 +78,11 @@ public:
     {
     }
 
+    basic_staj_event(staj_event_type event_type, size_t length, semantic_tag semantic_tag = semantic_tag::none)
+        : event_type_(event_type), semantic_tag_(semantic_tag), length_(length)
+    {
+    }
+
     basic_staj_event(null_type)
         : event_type_(staj_event_type::null_value), semantic_tag_(semantic_tag::none), length_(0)
     {
@@ -114,6 +120,12 @@ public:
         value_.string_data_ = data;
     }
 
+    basic_staj_event(const byte_string_view& s, semantic_tag semantic_tag)
+        : event_type_(staj_event_type::byte_string_value), semantic_tag_(semantic_tag), length_(s.size())
+    {
+        value_.byte_string_data_ = s.data();
+    }
+
     template<class T, class CharT_ = CharT>
     typename std::enable_if<jsoncons::detail::is_string_like<T>::value && std::is_same<typename T::value_type, CharT_>::value, T>::type
         as() const
@@ -163,6 +175,23 @@ public:
             result.append(null_k().data(),null_k().size());
             break;
         }
+        case staj_event_type::byte_string_value:
+        {
+            const uint8_t* first = value_.byte_string_data_;
+            switch (semantic_tag_)
+            {
+                case semantic_tag::base64:
+                    encode_base64(first, first + length_, s);
+                    break;
+                case semantic_tag::base16:
+                    encode_base16(first, first + length_, s);
+                    break;
+                default:
+                    encode_base64url(first, first + length_, s);
+                    break;
+            }
+            break;
+        }
         default:
             JSONCONS_THROW(json_runtime_error<std::runtime_error>("Not a string"));
         }
@@ -221,9 +250,32 @@ public:
         return as_bool();
     }
 
+    template<class T>
+    typename std::enable_if<std::is_same<T, byte_string_view>::value, T>::type
+        as() const
+    {
+        if (event_type_ != staj_event_type::byte_string_value)
+        {
+            JSONCONS_THROW(json_runtime_error<std::runtime_error>("Not a byte string"));
+        }
+        return T(value_.byte_string_data_, length_);
+    }
+
+    template<class T, class UserAllocator = std::allocator<uint8_t>>
+    typename std::enable_if<std::is_same<T, basic_byte_string<UserAllocator>>::value, T>::type
+        as() const
+    {
+        auto bs = as<byte_string_view>();
+        return T(bs.data(), bs.size());
+    }
+
     staj_event_type event_type() const noexcept { return event_type_; }
 
     semantic_tag get_semantic_tag() const noexcept { return semantic_tag_; }
+
+    // The length of a name, string or byte string, or the number of elements
+    // declared for an array or object, 0 if none was declared
+    size_t size() const noexcept { return length_; }
 private:
 
     int64_t as_int64() const
@@ -373,6 +425,50 @@ private:
 
 };
 
+namespace detail {
+
+    // Sends an event on to a content handler, returns false if the handler 
+    // does not want more events
+    template <class CharT>
+    bool send_staj_event(const basic_staj_event<CharT>& event, 
+                         basic_json_content_handler<CharT>& handler,
+                         const ser_context& context)
+    {
+        switch (event.event_type())
+        {
+            case staj_event_type::begin_array:
+                return event.size() > 0 ? handler.begin_array(event.size(), event.get_semantic_tag(), context)
+                                        : handler.begin_array(event.get_semantic_tag(), context);
+            case staj_event_type::end_array:
+                return handler.end_array(context);
+            case staj_event_type::begin_object:
+                return event.size() > 0 ? handler.begin_object(event.size(), event.get_semantic_tag(), context)
+                                        : handler.begin_object(event.get_semantic_tag(), context);
+            case staj_event_type::end_object:
+                return handler.end_object(context);
+            case staj_event_type::name:
+                return handler.name(event.template as<jsoncons::basic_string_view<CharT>>(), context);
+            case staj_event_type::string_value:
+                return handler.string_value(event.template as<jsoncons::basic_string_view<CharT>>(), event.get_semantic_tag(), context);
+            case staj_event_type::byte_string_value:
+                return handler.byte_string_value(event.template as<byte_string_view>(), event.get_semantic_tag(), context);
+            case staj_event_type::null_value:
+                return handler.null_value(event.get_semantic_tag(), context);
+            case staj_event_type::bool_value:
+                return handler.bool_value(event.template as<bool>(), event.get_semantic_tag(), context);
+            case staj_event_type::int64_value:
+                return handler.int64_value(event.template as<int64_t>(), event.get_semantic_tag(), context);
+            case staj_event_type::uint64_value:
+                return handler.uint64_value(event.template as<uint64_t>(), event.get_semantic_tag(), context);
+            case staj_event_type::double_value:
+                return handler.double_value(event.template as<double>(), event.get_semantic_tag(), context);
+            default:
+                return true;
+        }
+    }
+
+} // namespace detail
+
 template<class CharT>
 class basic_staj_reader
 {
@@ -393,6 +489,50 @@ public:
     virtual void next(std::error_code& ec) = 0;
 
     virtual const ser_context& context() const = 0;
+
+    virtual void skip()
+    {
+        std::error_code ec;
+        skip(ec);
+        if (ec)
+        {
+            throw ser_error(ec,context().line(),context().column());
+        }
+    }
+
+    // Advances to the last event of the value at the current event, the matching
+    // end_object or end_array for a begin_object or begin_array, and stays put 
+    // otherwise. Readers that can skip without producing the inner events override this.
+    virtual void skip(std::error_code& ec)
+    {
+        staj_event_type event_type = current().event_type();
+        if (event_type != staj_event_type::begin_object && event_type != staj_event_type::begin_array)
+        {
+            return;
+        }
+        size_t depth = 1;
+        while (depth > 0 && !done())
+        {
+            next(ec);
+            if (ec)
+            {
+                return;
+            }
+            switch (current().event_type())
+            {
+                case staj_event_type::begin_object:
+                case staj_event_type::begin_array:
+                    ++depth;
+                    break;
+                case staj_event_type::end_object:
+                case staj_event_type::end_array:
+                    --depth;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
 };
 
 template<class CharT>
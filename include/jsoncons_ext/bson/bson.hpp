@@ -16,6 +16,7 @@
 #include <jsoncons/config/binary_detail.hpp>
 #include <jsoncons_ext/bson/bson_encoder.hpp>
 #include <jsoncons_ext/bson/bson_reader.hpp>
+#include <jsoncons_ext/bson/bson_pull_reader.hpp>
 
 namespace jsoncons { namespace bson {
 
@@ -37,6 +38,7 @@ encode_bson(const T& val, std::vector<uint8_t>& v)
 {
     bson_bytes_encoder encoder(v);
     write_to(json(), val, encoder);
+    encoder.flush();
 }
 
 template<class T>
@@ -55,6 +57,7 @@ encode_bson(const T& val, std::ostream& os)
 {
     bson_encoder encoder(os);
     write_to(json(), val, encoder);
+    encoder.flush();
 }
 
 // decode_bson
@@ -74,10 +77,10 @@ template<class T>
 typename std::enable_if<!is_basic_json_class<T>::value,T>::type 
 decode_bson(const std::vector<uint8_t>& v)
 {
-    jsoncons::json_decoder<json> decoder;
-    basic_bson_reader<jsoncons::bytes_source> reader(v, decoder);
-    reader.read();
-    return decoder.get_result().template as<T>();
+    bson_bytes_pull_reader reader(v);
+    T val;
+    read_from(json(), reader, val);
+    return val;
 }
 
 template<class T>
@@ -95,10 +98,10 @@ template<class T>
 typename std::enable_if<!is_basic_json_class<T>::value,T>::type 
 decode_bson(std::istream& is)
 {
-    jsoncons::json_decoder<json> decoder;
-    bson_reader reader(is, decoder);
-    reader.read();
-    return decoder.get_result();
+    bson_pull_reader reader(is);
+    T val;
+    read_from(json(), reader, val);
+    return val;
 }
   
 }}
@@ -20,18 +20,40 @@
 
 namespace jsoncons { namespace bson {
 
+enum class parse_mode {root,before_done,document,document_value,array};
+
+struct parse_state 
+{
+    parse_mode mode; 
+    uint8_t type;
+
+    parse_state(parse_mode mode)
+        : mode(mode), type(0)
+    {
+    }
+
+    parse_state(const parse_state&) = default;
+    parse_state(parse_state&&) = default;
+};
+
 template <class Source>
 class basic_bson_reader : public ser_context
 {
     Source source_;
     json_content_handler& handler_;
-    size_t nesting_depth_;
+    bool more_;
+    bool done_;
+    std::string text_buffer_;
+    std::vector<uint8_t> bytes_buffer_;
+    std::vector<parse_state> state_stack_;
 public:
     basic_bson_reader(Source source, json_content_handler& handler)
        : source_(std::move(source)),
          handler_(handler), 
-         nesting_depth_(0)
+         more_(true),
+         done_(false)
     {
+        state_stack_.emplace_back(parse_mode::root);
     }
 
     void read()
@@ -44,29 +66,37 @@ public:
         }
     }
 
+    // Reads a whole document, each call reads the next one
     void read(std::error_code& ec)
     {
-        try
+        if (done_)
         {
-            if (source_.is_error())
-            {
-                ec = bson_errc::source_error;
-                return;
-            }   
-            uint8_t buf[sizeof(int32_t)]; 
-            if (source_.read(buf, sizeof(int32_t)) != sizeof(int32_t))
+            state_stack_.emplace_back(parse_mode::root);
+            done_ = false;
+        }
+        while (!done_)
+        {
+            restart();
+            read_some(ec);
+            if (ec)
             {
-                ec = bson_errc::unexpected_eof;
                 return;
             }
-            const uint8_t* endp;
-            /* auto len = */jsoncons::detail::from_little_endian<int32_t>(buf, buf+sizeof(int32_t),&endp);
-
-            handler_.begin_object(semantic_tag::none, *this);
-            ++nesting_depth_;
-            read_e_list(jsoncons::bson::detail::bson_container_type::document, ec);
-            handler_.end_object(*this);
-            --nesting_depth_;
+        }
+    }
+
+    // Reads until the handler returns false or the document is done,
+    // so that a pull reader can read one event at a time
+    void read_some(std::error_code& ec)
+    {
+        if (source_.is_error())
+        {
+            ec = bson_errc::source_error;
+            return;
+        }   
+        try
+        {
+            read_internal(ec);
         }
         catch (const ser_error& e)
         {
@@ -74,6 +104,21 @@ public:
         }
     }
 
+    void restart()
+    {
+        more_ = true;
+    }
+
+    bool stopped() const
+    {
+        return !more_;
+    }
+
+    bool done() const
+    {
+        return done_;
+    }
+
     size_t line() const override
     {
         return 0;
@@ -85,33 +130,109 @@ public:
     }
 private:
 
-    void read_e_list(jsoncons::bson::detail::bson_container_type type, std::error_code& ec)
+    void read_internal(std::error_code& ec)
     {
-        uint8_t t{};
-        while (source_.get(t) > 0 && t != 0x00)
+        while (!done_ && more_)
         {
-            std::basic_string<char> s;
-            uint8_t c{};
-            while (source_.get(c) > 0 && c != 0)
+            switch (state_stack_.back().mode)
             {
-                s.push_back(c);
-            }
-
-            if (type == jsoncons::bson::detail::bson_container_type::document)
-            {
-                auto result = unicons::validate(s.begin(),s.end());
-                if (result.ec != unicons::conv_errc())
+                case parse_mode::document:
                 {
-                    ec = bson_errc::invalid_utf8_text_string;
-                    return;
+                    uint8_t t{};
+                    if (source_.get(t) == 0 || t == 0x00)
+                    {
+                        more_ = handler_.end_object(*this);
+                        state_stack_.pop_back();
+                        break;
+                    }
+                    read_e_name();
+                    auto result = unicons::validate(text_buffer_.begin(),text_buffer_.end());
+                    if (result.ec != unicons::conv_errc())
+                    {
+                        ec = bson_errc::invalid_utf8_text_string;
+                        return;
+                    }
+                    state_stack_.back().mode = parse_mode::document_value;
+                    state_stack_.back().type = t;
+                    more_ = handler_.name(basic_string_view<char>(text_buffer_.data(),text_buffer_.length()), *this);
+                    break;
+                }
+                case parse_mode::document_value:
+                {
+                    state_stack_.back().mode = parse_mode::document;
+                    read_value(state_stack_.back().type, ec);
+                    if (ec)
+                    {
+                        return;
+                    }
+                    break;
+                }
+                case parse_mode::array:
+                {
+                    uint8_t t{};
+                    if (source_.get(t) == 0 || t == 0x00)
+                    {
+                        more_ = handler_.end_array(*this);
+                        state_stack_.pop_back();
+                        break;
+                    }
+                    read_e_name();
+                    read_value(t, ec);
+                    if (ec)
+                    {
+                        return;
+                    }
+                    break;
+                }
+                case parse_mode::root:
+                {
+                    state_stack_.back().mode = parse_mode::before_done;
+                    begin_document(ec);
+                    if (ec)
+                    {
+                        return;
+                    }
+                    break;
+                }
+                case parse_mode::before_done:
+                {
+                    JSONCONS_ASSERT(state_stack_.size() == 1);
+                    state_stack_.clear();
+                    done_ = true;
+                    break;
                 }
-                handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
             }
-            read_internal(t, ec);
         }
     }
 
-    void read_internal(uint8_t type, std::error_code& ec)
+    void begin_document(std::error_code& ec)
+    {
+        uint8_t buf[sizeof(int32_t)]; 
+        if (source_.read(buf, sizeof(int32_t)) != sizeof(int32_t))
+        {
+            ec = bson_errc::unexpected_eof;
+            return;
+        }
+        const uint8_t* endp;
+        /* auto len = */jsoncons::detail::from_little_endian<int32_t>(buf, buf+sizeof(int32_t),&endp);
+
+        state_stack_.emplace_back(parse_mode::document);
+        more_ = handler_.begin_object(semantic_tag::none, *this);
+    }
+
+    // Reads an element name into text_buffer_, array element names are 
+    // read and dropped by the caller
+    void read_e_name()
+    {
+        text_buffer_.clear();
+        uint8_t c{};
+        while (source_.get(c) > 0 && c != 0)
+        {
+            text_buffer_.push_back(c);
+        }
+    }
+
+    void read_value(uint8_t type, std::error_code& ec)
     {
         switch (type)
         {
@@ -125,7 +246,7 @@ private:
                 }
                 const uint8_t* endp;
                 double res = jsoncons::detail::from_little_endian<double>(buf,buf+sizeof(buf),&endp);
-                handler_.double_value(res, semantic_tag::none, *this);
+                more_ = handler_.double_value(res, semantic_tag::none, *this);
                 break;
             }
             case jsoncons::bson::detail::bson_format::string_cd:
@@ -139,27 +260,27 @@ private:
                 const uint8_t* endp;
                 auto len = jsoncons::detail::from_little_endian<int32_t>(buf, buf+sizeof(buf),&endp);
 
-                std::basic_string<char> s;
-                s.reserve(len - 1);
-                if ((int32_t)source_.read(std::back_inserter(s), len-1) != len-1)
+                text_buffer_.clear();
+                text_buffer_.reserve(len - 1);
+                if ((int32_t)source_.read(std::back_inserter(text_buffer_), len-1) != len-1)
                 {
                     ec = bson_errc::unexpected_eof;
                     return;
                 }
                 uint8_t c{};
                 source_.get(c); // discard 0
-                auto result = unicons::validate(s.begin(),s.end());
+                auto result = unicons::validate(text_buffer_.begin(),text_buffer_.end());
                 if (result.ec != unicons::conv_errc())
                 {
                     ec = bson_errc::invalid_utf8_text_string;
                     return;
                 }
-                handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::none, *this);
+                more_ = handler_.string_value(basic_string_view<char>(text_buffer_.data(),text_buffer_.length()), semantic_tag::none, *this);
                 break;
             }
             case jsoncons::bson::detail::bson_format::document_cd: 
             {
-                read(ec);
+                begin_document(ec);
                 if (ec)
                 {
                     return;
@@ -178,16 +299,13 @@ private:
                 const uint8_t* endp;
                 /* auto len = */ jsoncons::detail::from_little_endian<int32_t>(buf, buf+sizeof(int32_t),&endp);
 
-                handler_.begin_array(semantic_tag::none, *this);
-                ++nesting_depth_;
-                read_e_list(jsoncons::bson::detail::bson_container_type::document, ec);
-                handler_.end_array(*this);
-                --nesting_depth_;
+                state_stack_.emplace_back(parse_mode::array);
+                more_ = handler_.begin_array(semantic_tag::none, *this);
                 break;
             }
             case jsoncons::bson::detail::bson_format::null_cd: 
             {
-                handler_.null_value(semantic_tag::none, *this);
+                more_ = handler_.null_value(semantic_tag::none, *this);
                 break;
             }
             case jsoncons::bson::detail::bson_format::bool_cd:
@@ -198,7 +316,7 @@ private:
                     ec = bson_errc::unexpected_eof;
                     return;
                 }
-                handler_.bool_value(val != 0, semantic_tag::none, *this);
+                more_ = handler_.bool_value(val != 0, semantic_tag::none, *this);
                 break;
             }
             case jsoncons::bson::detail::bson_format::int32_cd: 
@@ -211,7 +329,7 @@ private:
                 }
                 const uint8_t* endp;
                 auto val = jsoncons::detail::from_little_endian<int32_t>(buf, buf+sizeof(int32_t),&endp);
-                handler_.int64_value(val, semantic_tag::none, *this);
+                more_ = handler_.int64_value(val, semantic_tag::none, *this);
                 break;
             }
 
@@ -225,7 +343,7 @@ private:
                 }
                 const uint8_t* endp;
                 auto val = jsoncons::detail::from_little_endian<uint64_t>(buf, buf+sizeof(uint64_t),&endp);
-                handler_.uint64_value(val, semantic_tag::timestamp, *this);
+                more_ = handler_.uint64_value(val, semantic_tag::timestamp, *this);
                 break;
             }
 
@@ -239,7 +357,7 @@ private:
                 }
                 const uint8_t* endp;
                 auto val = jsoncons::detail::from_little_endian<int64_t>(buf, buf+sizeof(int64_t),&endp);
-                handler_.int64_value(val, semantic_tag::none, *this);
+                more_ = handler_.int64_value(val, semantic_tag::none, *this);
                 break;
             }
 
@@ -253,7 +371,7 @@ private:
                 }
                 const uint8_t* endp;
                 auto val = jsoncons::detail::from_little_endian<int64_t>(buf, buf+sizeof(int64_t),&endp);
-                handler_.int64_value(val, semantic_tag::timestamp, *this);
+                more_ = handler_.int64_value(val, semantic_tag::timestamp, *this);
                 break;
             }
             case jsoncons::bson::detail::bson_format::binary_cd: 
@@ -267,14 +385,14 @@ private:
                 const uint8_t* endp;
                 const auto len = jsoncons::detail::from_little_endian<int32_t>(buf, buf+sizeof(int32_t),&endp);
 
-                std::vector<uint8_t> v(len, 0);
-                if (source_.read(v.data(), v.size()) != v.size())
+                bytes_buffer_.assign(len, 0);
+                if (source_.read(bytes_buffer_.data(), bytes_buffer_.size()) != bytes_buffer_.size())
                 {
                     ec = bson_errc::unexpected_eof;
                     return;
                 }
 
-                handler_.byte_string_value(byte_string_view(v.data(),v.size()), 
+                more_ = handler_.byte_string_value(byte_string_view(bytes_buffer_.data(),bytes_buffer_.size()), 
                                            semantic_tag::none, 
                                            *this);
                 break;
@@ -16,6 +16,7 @@
 #include <jsoncons/json_filter.hpp>
 #include <jsoncons/config/binary_detail.hpp>
 #include <jsoncons_ext/cbor/cbor_reader.hpp>
+#include <jsoncons_ext/cbor/cbor_pull_reader.hpp>
 #include <jsoncons_ext/cbor/cbor_encoder.hpp>
 
 namespace jsoncons { namespace cbor {
@@ -50,6 +51,7 @@ encode_cbor(const T& val, std::vector<uint8_t>& v, const cbor_encode_options& op
 {
     cbor_bytes_encoder encoder(v, options);
     write_to(json(), val, encoder);
+    encoder.flush();
 }
 
 template<class T>
@@ -68,6 +70,7 @@ encode_cbor(const T& val, std::ostream& os, const cbor_encode_options& options)
 {
     cbor_encoder encoder(os, options);
     write_to(json(), val, encoder);
+    encoder.flush();
 }
 
 // decode_cbor
@@ -87,10 +90,10 @@ template<class T>
 typename std::enable_if<!is_basic_json_class<T>::value,T>::type 
 decode_cbor(const std::vector<uint8_t>& v)
 {
-    jsoncons::json_decoder<json> decoder;
-    basic_cbor_reader<jsoncons::bytes_source> reader(v, decoder);
-    reader.read();
-    return decoder.get_result().template as<T>();
+    cbor_bytes_pull_reader reader(v);
+    T val;
+    read_from(json(), reader, val);
+    return val;
 }
 
 template<class T>
@@ -108,10 +111,10 @@ template<class T>
 typename std::enable_if<!is_basic_json_class<T>::value,T>::type 
 decode_cbor(std::istream& is)
 {
-    jsoncons::json_decoder<json> decoder;
-    cbor_reader reader(is, decoder);
-    reader.read();
-    return decoder.get_result().template as<T>();
+    cbor_pull_reader reader(is);
+    T val;
+    read_from(json(), reader, val);
+    return val;
 }
 
   
@@ -21,7 +21,7 @@
 
 namespace jsoncons { namespace cbor {
 
-enum class parse_mode {root,array,indefinite_array,map,indefinite_map};
+enum class parse_mode {root,before_done,array,indefinite_array,map_key,map_value,indefinite_map_key,indefinite_map_value};
 
 struct mapped_string
 {
@@ -86,14 +86,21 @@ class basic_cbor_reader : public ser_context
 {
     Source source_;
     json_content_handler& handler_;
+    bool more_;
+    bool done_;
     std::string buffer_;
+    std::string text_buffer_;
+    std::vector<uint8_t> bytes_buffer_;
     std::vector<uint64_t> tags_; 
     std::vector<parse_state> state_stack_;
 public:
     basic_cbor_reader(Source source, json_content_handler& handler)
        : source_(std::move(source)),
-         handler_(handler)
+         handler_(handler),
+         more_(true),
+         done_(false)
     {
+        state_stack_.emplace_back(parse_mode::root,0);
     }
 
     void read()
@@ -106,7 +113,28 @@ public:
         }
     }
 
+    // Reads a whole data item, each call reads the next one
     void read(std::error_code& ec)
+    {
+        if (done_)
+        {
+            state_stack_.emplace_back(parse_mode::root,0);
+            done_ = false;
+        }
+        while (!done_)
+        {
+            restart();
+            read_some(ec);
+            if (ec)
+            {
+                return;
+            }
+        }
+    }
+
+    // Reads until the handler returns false or the data item is done,
+    // so that a pull reader can read one event at a time
+    void read_some(std::error_code& ec)
     {
         if (source_.is_error())
         {
@@ -115,12 +143,7 @@ public:
         }   
         try
         {
-            state_stack_.emplace_back(parse_mode::root,0);
             read_internal(ec);
-            if (ec)
-            {
-                return;
-            }
         }
         catch (const ser_error& e)
         {
@@ -128,6 +151,21 @@ public:
         }
     }
 
+    void restart()
+    {
+        more_ = true;
+    }
+
+    bool stopped() const
+    {
+        return !more_;
+    }
+
+    bool done() const
+    {
+        return done_;
+    }
+
     size_t line() const override
     {
         return 0;
@@ -141,7 +179,7 @@ private:
 
     void read_internal(std::error_code& ec)
     {
-        while (!state_stack_.empty())
+        while (!done_ && more_)
         {
             switch (state_stack_.back().mode)
             {
@@ -187,21 +225,17 @@ private:
                     }
                     break;
                 }
-                case parse_mode::map:
+                case parse_mode::map_key:
                 {
                     if (state_stack_.back().index < state_stack_.back().length)
                     {
                         ++state_stack_.back().index;
+                        state_stack_.back().mode = parse_mode::map_value;
                         read_name(ec);
                         if (ec)
                         {
                             return;
                         }
-                        read_item(ec);
-                        if (ec)
-                        {
-                            return;
-                        }
                     }
                     else
                     {
@@ -209,7 +243,17 @@ private:
                     }
                     break;
                 }
-                case parse_mode::indefinite_map:
+                case parse_mode::map_value:
+                {
+                    state_stack_.back().mode = parse_mode::map_key;
+                    read_item(ec);
+                    if (ec)
+                    {
+                        return;
+                    }
+                    break;
+                }
+                case parse_mode::indefinite_map_key:
                 {
                     int c = source_.peek();
                     switch (c)
@@ -225,36 +269,44 @@ private:
                             }
                             break;
                         default:
+                            state_stack_.back().mode = parse_mode::indefinite_map_value;
                             read_name(ec);
                             if (ec)
                             {
                                 return;
                             }
-                            read_item(ec);
-                            if (ec)
-                            {
-                                return;
-                            }
                             break;
                     }
                     break;
                 }
+                case parse_mode::indefinite_map_value:
+                {
+                    state_stack_.back().mode = parse_mode::indefinite_map_key;
+                    read_item(ec);
+                    if (ec)
+                    {
+                        return;
+                    }
+                    break;
+                }
                 case parse_mode::root:
                 {
+                    state_stack_.back().mode = parse_mode::before_done;
                     read_item(ec);
                     if (ec)
                     {
                         return;
                     }
+                    break;
+                }
+                case parse_mode::before_done:
+                {
+                    JSONCONS_ASSERT(state_stack_.size() == 1);
+                    state_stack_.clear();
+                    done_ = true;
+                    handler_.flush();
+                    break;
                 }
-                break;
-            }
-
-            JSONCONS_ASSERT(!state_stack_.empty());
-            if (state_stack_.back().mode == parse_mode::root)
-            {
-                state_stack_.pop_back();
-                handler_.flush();
             }
         }
     }
@@ -335,7 +387,7 @@ private:
                         }
                         tags_.clear();
                     }
-                    handler_.uint64_value(val, tag, *this);
+                    more_ = handler_.uint64_value(val, tag, *this);
                 }
                 break;
             }
@@ -355,17 +407,17 @@ private:
                     }
                     tags_.clear();
                 }
-                handler_.int64_value(val, tag, *this);
+                more_ = handler_.int64_value(val, tag, *this);
                 break;
             }
             case jsoncons::cbor::detail::cbor_major_type::byte_string:
             {
-                std::vector<uint8_t> v = get_byte_string(ec);
+                bytes_buffer_ = get_byte_string(ec);
                 if (ec)
                 {
                     return;
                 }
-                handle_byte_string(byte_string_view(v.data(), v.size()), ec);
+                handle_byte_string(byte_string_view(bytes_buffer_.data(), bytes_buffer_.size()), ec);
                 if (ec)
                 {
                     return;
@@ -374,14 +426,18 @@ private:
             }
             case jsoncons::cbor::detail::cbor_major_type::text_string:
             {
-                std::string s = get_text_string(ec);
-                auto result = unicons::validate(s.begin(),s.end());
+                text_buffer_ = get_text_string(ec);
+                if (ec)
+                {
+                    return;
+                }
+                auto result = unicons::validate(text_buffer_.begin(),text_buffer_.end());
                 if (result.ec != unicons::conv_errc())
                 {
                     ec = cbor_errc::invalid_utf8_text_string;
                     return;
                 }
-                handle_string(basic_string_view<char>(s.data(),s.length()),ec);
+                handle_string(basic_string_view<char>(text_buffer_.data(),text_buffer_.length()),ec);
                 if (ec)
                 {
                     return;
@@ -398,19 +454,19 @@ private:
                 switch (info)
                 {
                     case 0x14:
-                        handler_.bool_value(false, semantic_tag::none, *this);
+                        more_ = handler_.bool_value(false, semantic_tag::none, *this);
                         source_.ignore(1);
                         break;
                     case 0x15:
-                        handler_.bool_value(true, semantic_tag::none, *this);
+                        more_ = handler_.bool_value(true, semantic_tag::none, *this);
                         source_.ignore(1);
                         break;
                     case 0x16:
-                        handler_.null_value(semantic_tag::none, *this);
+                        more_ = handler_.null_value(semantic_tag::none, *this);
                         source_.ignore(1);
                         break;
                     case 0x17:
-                        handler_.null_value(semantic_tag::undefined, *this);
+                        more_ = handler_.null_value(semantic_tag::undefined, *this);
                         source_.ignore(1);
                         break;
                     case 0x19: // Half-Precision Float (two-byte IEEE 754)
@@ -430,7 +486,7 @@ private:
                             }
                             tags_.clear();
                         }
-                        handler_.double_value(val, tag, *this);
+                        more_ = handler_.double_value(val, tag, *this);
                         break;
                 }
                 break;
@@ -439,12 +495,12 @@ private:
             {
                 if (!tags_.empty() && tags_.back() == 0x04)
                 {
-                    std::string s = get_array_as_decimal_string(ec);
+                    text_buffer_ = get_array_as_decimal_string(ec);
                     if (ec)
                     {
                         return;
                     }
-                    handler_.string_value(s, semantic_tag::big_decimal);
+                    more_ = handler_.string_value(text_buffer_, semantic_tag::big_decimal, *this);
                     tags_.pop_back();
                 }
                 else
@@ -488,7 +544,7 @@ private:
             case jsoncons::cbor::detail::additional_info::indefinite_length:
             {
                 state_stack_.push_back(parse_state(parse_mode::indefinite_array,0,stringref_map));
-                handler_.begin_array(tag, *this);
+                more_ = handler_.begin_array(tag, *this);
                 source_.ignore(1);
                 break;
             }
@@ -500,7 +556,7 @@ private:
                     return;
                 }
                 state_stack_.push_back(parse_state(parse_mode::array,len,stringref_map));
-                handler_.begin_array(len, tag, *this);
+                more_ = handler_.begin_array(len, tag, *this);
                 break;
             }
         }
@@ -518,7 +574,7 @@ private:
             default:
                 break;
         }
-        handler_.end_array(*this);
+        more_ = handler_.end_array(*this);
         state_stack_.pop_back();
     }
 
@@ -541,8 +597,8 @@ private:
         {
             case jsoncons::cbor::detail::additional_info::indefinite_length: 
             {
-                state_stack_.push_back(parse_state(parse_mode::indefinite_map,0,stringref_map));
-                handler_.begin_object(semantic_tag::none, *this);
+                state_stack_.push_back(parse_state(parse_mode::indefinite_map_key,0,stringref_map));
+                more_ = handler_.begin_object(semantic_tag::none, *this);
                 source_.ignore(1);
                 break;
             }
@@ -553,8 +609,8 @@ private:
                 {
                     return;
                 }
-                state_stack_.push_back(parse_state(parse_mode::map,len,stringref_map));
-                handler_.begin_object(len, semantic_tag::none, *this);
+                state_stack_.push_back(parse_state(parse_mode::map_key,len,stringref_map));
+                more_ = handler_.begin_object(len, semantic_tag::none, *this);
                 break;
             }
         }
@@ -564,7 +620,7 @@ private:
     {
         switch (state_stack_.back().mode)
         {
-            case parse_mode::indefinite_map: 
+            case parse_mode::indefinite_map_key: 
             {
                 source_.ignore(1);
                 break;
@@ -572,7 +628,7 @@ private:
             default:
                 break;
         }
-        handler_.end_object(*this);
+        more_ = handler_.end_object(*this);
         state_stack_.pop_back();
     }
 
@@ -598,30 +654,30 @@ private:
         {
             case jsoncons::cbor::detail::cbor_major_type::text_string:
             {
-                std::string s = get_text_string(ec);
+                text_buffer_ = get_text_string(ec);
                 if (ec)
                 {
                     return;
                 }
-                auto result = unicons::validate(s.begin(),s.end());
+                auto result = unicons::validate(text_buffer_.begin(),text_buffer_.end());
                 if (result.ec != unicons::conv_errc())
                 {
                     ec = cbor_errc::invalid_utf8_text_string;
                     return;
                 }
-                handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
+                more_ = handler_.name(basic_string_view<char>(text_buffer_.data(),text_buffer_.length()), *this);
                 break;
             }
             case jsoncons::cbor::detail::cbor_major_type::byte_string:
             {
-                std::vector<uint8_t> v = get_byte_string(ec);
+                bytes_buffer_ = get_byte_string(ec);
                 if (ec)
                 {
                     return;
                 }
-                std::string s;
-                encode_base64url(v.begin(),v.end(),s);
-                handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
+                text_buffer_.clear();
+                encode_base64url(bytes_buffer_.begin(),bytes_buffer_.end(),text_buffer_);
+                more_ = handler_.name(basic_string_view<char>(text_buffer_.data(),text_buffer_.length()), *this);
                 break;
             }
             case jsoncons::cbor::detail::cbor_major_type::unsigned_integer:
@@ -650,14 +706,14 @@ private:
                     {
                         case jsoncons::cbor::detail::cbor_major_type::text_string:
                         {
-                            handler_.name(basic_string_view<char>(val.s.data(),val.s.length()), *this);
+                            more_ = handler_.name(basic_string_view<char>(val.s.data(),val.s.length()), *this);
                             break;
                         }
                         case jsoncons::cbor::detail::cbor_major_type::byte_string:
                         {
-                            std::string s;
-                            encode_base64url(val.bs.begin(),val.bs.end(),s);
-                            handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
+                            text_buffer_.clear();
+                            encode_base64url(val.bs.begin(),val.bs.end(),text_buffer_);
+                            more_ = handler_.name(basic_string_view<char>(text_buffer_.data(),text_buffer_.length()), *this);
                             break;
                         }
                         default:
@@ -671,18 +727,18 @@ private:
                 JSONCONS_FALLTHROUGH;
             default:
             {
-                std::string s;
-                json_string_encoder encoder(s);
+                text_buffer_.clear();
+                json_string_encoder encoder(text_buffer_);
                 basic_cbor_reader<Source> reader(std::move(source_), encoder);
                 reader.read(ec);
                 source_ = std::move(reader.source_);
-                auto result = unicons::validate(s.begin(),s.end());
+                auto result = unicons::validate(text_buffer_.begin(),text_buffer_.end());
                 if (result.ec != unicons::conv_errc())
                 {
                     ec = cbor_errc::invalid_utf8_text_string;
                     return;
                 }
-                handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
+                more_ = handler_.name(basic_string_view<char>(text_buffer_.data(),text_buffer_.length()), *this);
             }
         }
     }
@@ -705,11 +761,9 @@ private:
                 break;
         }
         JSONCONS_ASSERT(major_type == jsoncons::cbor::detail::cbor_major_type::text_string);
-        auto func = [&s](Source& source_, size_t length, std::error_code& ec)
+        auto func = [&s](Source& source, size_t length, std::error_code& ec)
         {
-            s.reserve(s.size()+length);
-            source_.read(std::back_inserter(s), length);
-            if (source_.eof())
+            if (source_reader<Source>::read(source, s, length) != length)
             {
                 ec = cbor_errc::unexpected_eof;
                 return;
@@ -771,11 +825,9 @@ private:
                 break;
         }
         JSONCONS_ASSERT(major_type == jsoncons::cbor::detail::cbor_major_type::byte_string);
-        auto func = [&v](Source& source_, size_t length, std::error_code& ec)
+        auto func = [&v](Source& source, size_t length, std::error_code& ec)
         {
-            v.reserve(v.size()+length);
-            source_.read(std::back_inserter(v), length);
-            if (source_.eof())
+            if (source_reader<Source>::read(source, v, length) != length)
             {
                 ec = cbor_errc::unexpected_eof;
                 return;
@@ -861,8 +913,6 @@ private:
             ec = cbor_errc::unexpected_eof;
             return val;
         }
-        const uint8_t* endp = nullptr;
-
         uint8_t type{};
         if (source.get(type) == 0)
         {
@@ -893,25 +943,37 @@ private:
 
             case 0x19: // Unsigned integer (two-byte uint16_t follows)
             {
-                uint8_t buf[sizeof(uint16_t)];
-                source.read(buf, sizeof(uint16_t));
-                val = jsoncons::detail::from_big_endian<uint16_t>(buf,buf+sizeof(buf),&endp);
+                uint16_t x{};
+                if (!source_reader<Source>::read_big_endian(source, x))
+                {
+                    ec = cbor_errc::unexpected_eof;
+                    return 0;
+                }
+                val = x;
                 break;
             }
 
             case 0x1a: // Unsigned integer (four-byte uint32_t follows)
             {
-                uint8_t buf[sizeof(uint32_t)];
-                source.read(buf, sizeof(uint32_t));
-                val = jsoncons::detail::from_big_endian<uint32_t>(buf,buf+sizeof(buf),&endp);
+                uint32_t x{};
+                if (!source_reader<Source>::read_big_endian(source, x))
+                {
+                    ec = cbor_errc::unexpected_eof;
+                    return 0;
+                }
+                val = x;
                 break;
             }
 
             case 0x1b: // Unsigned integer (eight-byte uint64_t follows)
             {
-                uint8_t buf[sizeof(uint64_t)];
-                source.read(buf, sizeof(uint64_t));
-                val = jsoncons::detail::from_big_endian<uint64_t>(buf,buf+sizeof(buf),&endp);
+                uint64_t x{};
+                if (!source_reader<Source>::read_big_endian(source, x))
+                {
+                    ec = cbor_errc::unexpected_eof;
+                    return 0;
+                }
+                val = x;
                 break;
             }
             default:
@@ -928,8 +990,6 @@ private:
             ec = cbor_errc::unexpected_eof;
             return val;
         }
-        const uint8_t* endp = nullptr;
-
         uint8_t info = get_additional_information_value((uint8_t)source.peek());
         switch (get_major_type((uint8_t)source.peek()))
         {
@@ -957,36 +1017,36 @@ private:
 
                     case 0x19: // Negative integer -1-n (two-byte uint16_t follows)
                         {
-                            uint8_t buf[sizeof(uint16_t)];
-                            if (source.read(buf, sizeof(uint16_t)) != sizeof(uint16_t))
+                            uint16_t x{};
+                            if (!source_reader<Source>::read_big_endian(source, x))
                             {
+                                ec = cbor_errc::unexpected_eof;
                                 return val;
                             }
-                            auto x = jsoncons::detail::from_big_endian<uint16_t>(buf,buf+sizeof(buf),&endp);
                             val = static_cast<int64_t>(-1)- x;
                             break;
                         }
 
                     case 0x1a: // Negative integer -1-n (four-byte uint32_t follows)
                         {
-                            uint8_t buf[sizeof(uint32_t)];
-                            if (source.read(buf, sizeof(uint32_t)) != sizeof(uint32_t))
+                            uint32_t x{};
+                            if (!source_reader<Source>::read_big_endian(source, x))
                             {
+                                ec = cbor_errc::unexpected_eof;
                                 return val;
                             }
-                            auto x = jsoncons::detail::from_big_endian<uint32_t>(buf,buf+sizeof(buf),&endp);
                             val = static_cast<int64_t>(-1)- x;
                             break;
                         }
 
                     case 0x1b: // Negative integer -1-n (eight-byte uint64_t follows)
                         {
-                            uint8_t buf[sizeof(uint64_t)];
-                            if (source.read(buf, sizeof(uint64_t)) != sizeof(uint64_t))
+                            uint64_t x{};
+                            if (!source_reader<Source>::read_big_endian(source, x))
                             {
+                                ec = cbor_errc::unexpected_eof;
                                 return val;
                             }
-                            auto x = jsoncons::detail::from_big_endian<uint64_t>(buf,buf+sizeof(buf),&endp);
                             val = static_cast<int64_t>(-1)- static_cast<int64_t>(x);
                             break;
                         }
@@ -1027,8 +1087,6 @@ private:
             ec = cbor_errc::unexpected_eof;
             return val;
         }
-        const uint8_t* endp = nullptr;
-
         uint8_t type{};
         if (source.get(type) == 0)
         {
@@ -1040,14 +1098,12 @@ private:
         {
         case 0x19: // Half-Precision Float (two-byte IEEE 754)
             {
-                uint8_t buf[sizeof(uint16_t)];
-                source.read(buf, sizeof(uint16_t));
-                if (source.eof())
+                uint16_t x{};
+                if (!source_reader<Source>::read_big_endian(source, x))
                 {
                     ec = cbor_errc::unexpected_eof;
                     return 0;
                 }
-                uint16_t x = jsoncons::detail::from_big_endian<uint16_t>(buf,buf+sizeof(buf),&endp);
                 val = jsoncons::detail::decode_half(x);
                 break;
             }
@@ -1055,27 +1111,25 @@ private:
 
         case 0x1a: // Single-Precision Float (four-byte IEEE 754)
             {
-                uint8_t buf[sizeof(float)];
-                source.read(buf, sizeof(float));
-                if (source.eof())
+                float x{};
+                if (!source_reader<Source>::read_big_endian(source, x))
                 {
                     ec = cbor_errc::unexpected_eof;
                     return 0;
                 }
-                val = jsoncons::detail::from_big_endian<float>(buf,buf+sizeof(buf),&endp);
+                val = x;
                 break;
             }
 
         case 0x1b: //  Double-Precision Float (eight-byte IEEE 754)
             {
-                uint8_t buf[sizeof(double)];
-                source.read(buf, sizeof(double));
-                if (source.eof())
+                double x{};
+                if (!source_reader<Source>::read_big_endian(source, x))
                 {
                     ec = cbor_errc::unexpected_eof;
                     return 0;
                 }
-                val = jsoncons::detail::from_big_endian<double>(buf,buf+sizeof(buf),&endp);
+                val = x;
                 break;
             }
             default:
@@ -1280,7 +1334,7 @@ private:
             }
             tags_.clear();
         }
-        handler_.string_value(v, tag, *this);
+        more_ = handler_.string_value(v, tag, *this);
     }
 
     void handle_byte_string(const byte_string_view& v, std::error_code&)
@@ -1294,7 +1348,7 @@ private:
                         bignum n(1, v.data(), v.size());
                         buffer_.clear();
                         n.dump(buffer_);
-                        handler_.big_integer_value(buffer_, *this);
+                        more_ = handler_.big_integer_value(buffer_, *this);
                         break;
                     }
                 case 0x3:
@@ -1302,33 +1356,33 @@ private:
                         bignum n(-1, v.data(), v.size());
                         buffer_.clear();
                         n.dump(buffer_);
-                        handler_.big_integer_value(buffer_, *this);
+                        more_ = handler_.big_integer_value(buffer_, *this);
                         break;
                     }
                 case 0x15:
                     {
-                        handler_.byte_string_value(byte_string_view(v.data(), v.size()), semantic_tag::base64url, *this);
+                        more_ = handler_.byte_string_value(byte_string_view(v.data(), v.size()), semantic_tag::base64url, *this);
                         break;
                     }
                 case 0x16:
                     {
-                        handler_.byte_string_value(byte_string_view(v.data(), v.size()), semantic_tag::base64, *this);
+                        more_ = handler_.byte_string_value(byte_string_view(v.data(), v.size()), semantic_tag::base64, *this);
                         break;
                     }
                 case 0x17:
                     {
-                        handler_.byte_string_value(byte_string_view(v.data(), v.size()), semantic_tag::base16, *this);
+                        more_ = handler_.byte_string_value(byte_string_view(v.data(), v.size()), semantic_tag::base16, *this);
                         break;
                     }
                 default:
-                    handler_.byte_string_value(byte_string_view(v.data(), v.size()), semantic_tag::none, *this);
+                    more_ = handler_.byte_string_value(byte_string_view(v.data(), v.size()), semantic_tag::none, *this);
                     break;
             }
             tags_.clear();
         }
         else
         {
-            handler_.byte_string_value(byte_string_view(v.data(), v.size()), semantic_tag::none, *this);
+            more_ = handler_.byte_string_value(byte_string_view(v.data(), v.size()), semantic_tag::none, *this);
         }
     }
 
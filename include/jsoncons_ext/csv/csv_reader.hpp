@@ -13,6 +13,7 @@
 #include <memory> // std::allocator
 #include <utility> // std::move
 #include <istream> // std::basic_istream
+#include <limits> // std::numeric_limits
 #include <jsoncons/source.hpp>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_content_handler.hpp>
@@ -105,7 +106,10 @@ public:
          eof_(false),
          begin_(true)
     {
-        buffer_.reserve(buffer_length_);
+        if (!is_contiguous_source<Source>::value)
+        {
+            buffer_.reserve(buffer_length_);
+        }
     }
 
     ~basic_csv_reader()
@@ -208,7 +212,40 @@ private:
             if (ec) return;
         }
     }
-    void read_buffer(std::error_code& ec)
+
+    // A contiguous source is parsed in place, without copying into buffer_
+
+    template <class S = Source>
+    typename std::enable_if<is_contiguous_source<S>::value>::type
+    read_buffer(std::error_code& ec)
+    {
+        const CharT* data = nullptr;
+        size_t count = source_.read_in_place(data, (std::numeric_limits<size_t>::max)());
+        if (count == 0)
+        {
+            eof_ = true;
+        }
+        else if (begin_)
+        {
+            auto result = unicons::skip_bom(data, data+count);
+            if (result.ec != unicons::encoding_errc())
+            {
+                ec = result.ec;
+                return;
+            }
+            size_t offset = result.it - data;
+            parser_.update(data+offset,count-offset);
+            begin_ = false;
+        }
+        else
+        {
+            parser_.update(data,count);
+        }
+    }
+
+    template <class S = Source>
+    typename std::enable_if<!is_contiguous_source<S>::value>::type
+    read_buffer(std::error_code& ec)
     {
         buffer_.clear();
         buffer_.resize(buffer_length_);
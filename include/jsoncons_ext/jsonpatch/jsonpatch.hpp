@@ -8,11 +8,15 @@
 #define JSONCONS_JSONPOINTER_JSONPATCH_HPP
 
 #include <string>
-#include <sstream>
 #include <vector> 
 #include <memory>
 #include <algorithm> // std::min
 #include <utility> // std::move
+#include <cstring> // std::memcpy
+#include <cstdint> // uint64_t
+#include <unordered_map>
+#include <unordered_set>
+#include <limits> // std::numeric_limits
 #include <jsoncons/json.hpp>
 #include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
 #include <jsoncons_ext/jsonpatch/jsonpatch_error.hpp>
@@ -32,448 +36,1506 @@ namespace detail {
     JSONCONS_STRING_LITERAL(from,'f','r','o','m')
     JSONCONS_STRING_LITERAL(value,'v','a','l','u','e')
 
-    enum class op_type {add,remove,replace};
-    enum class state_type {begin,abort,commit};
+    enum class op_kind {test,add,remove,replace,move,copy};
+
+    // Whether the tokens of lhs begin the tokens of rhs
+    template <class CharT>
+    bool is_prefix_of(const jsonpointer::basic_address<CharT>& lhs, const jsonpointer::basic_address<CharT>& rhs)
+    {
+        if (lhs.tokens().size() > rhs.tokens().size())
+        {
+            return false;
+        }
+        for (size_t i = 0; i < lhs.tokens().size(); ++i)
+        {
+            if (lhs.tokens()[i].name != rhs.tokens()[i].name)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class Json>
+    struct operation
+    {
+        op_kind kind;
+        // invalid_patch if the operation is malformed, otherwise the error 
+        // for the operation failing
+        jsonpatch_errc failure;
+        bool valid;
+        jsonpointer::basic_address<typename Json::char_type> path;
+        jsonpointer::basic_address<typename Json::char_type> from;
+        const Json* value;
+    };
 
     template <class Json>
-    struct operation_unwinder
+    void compile_operation(const Json& entry, operation<Json>& op)
     {
+        typedef typename Json::char_type char_type;
         typedef typename Json::string_type string_type;
         typedef typename Json::string_view_type string_view_type;
 
-        struct entry
+        op.kind = op_kind::test;
+        op.failure = jsonpatch_errc::invalid_patch;
+        op.valid = false;
+        op.value = nullptr;
+
+        if (!entry.is_object() || entry.count(op_literal<char_type>()) != 1 || entry.count(path_literal<char_type>()) != 1)
+        {
+            return;
+        }
+        const Json& name = entry.at(op_literal<char_type>());
+        const Json& path = entry.at(path_literal<char_type>());
+        if (!name.is_string() || !path.is_string())
+        {
+            return;
+        }
+
+        string_view_type s = name.as_string_view();
+        bool has_value = false;
+        bool has_from = false;
+        if (s == test_literal<char_type>())
+        {
+            op.kind = op_kind::test;
+            has_value = true;
+        }
+        else if (s == add_literal<char_type>())
+        {
+            op.kind = op_kind::add;
+            has_value = true;
+        }
+        else if (s == remove_literal<char_type>())
+        {
+            op.kind = op_kind::remove;
+        }
+        else if (s == replace_literal<char_type>())
+        {
+            op.kind = op_kind::replace;
+            has_value = true;
+        }
+        else if (s == move_literal<char_type>())
+        {
+            op.kind = op_kind::move;
+            has_from = true;
+        }
+        else if (s == copy_literal<char_type>())
+        {
+            op.kind = op_kind::copy;
+            has_from = true;
+        }
+        else
+        {
+            return;
+        }
+
+        if (has_value)
+        {
+            if (entry.count(value_literal<char_type>()) != 1)
+            {
+                return;
+            }
+            op.value = &entry.at(value_literal<char_type>());
+        }
+        if (has_from)
+        {
+            if (entry.count(from_literal<char_type>()) != 1 || !entry.at(from_literal<char_type>()).is_string())
+            {
+                return;
+            }
+        }
+
+        switch (op.kind)
+        {
+            case op_kind::test:
+                op.failure = jsonpatch_errc::test_failed;
+                break;
+            case op_kind::add:
+                op.failure = jsonpatch_errc::add_failed;
+                break;
+            case op_kind::remove:
+                op.failure = jsonpatch_errc::remove_failed;
+                break;
+            case op_kind::replace:
+                op.failure = jsonpatch_errc::replace_failed;
+                break;
+            case op_kind::move:
+                op.failure = jsonpatch_errc::move_failed;
+                break;
+            case op_kind::copy:
+                op.failure = jsonpatch_errc::copy_failed;
+                break;
+        }
+        op.path = jsonpointer::basic_address<char_type>(string_type(path.as_string_view()));
+        if (!op.path.valid())
+        {
+            return;
+        }
+        if (has_from)
+        {
+            op.from = jsonpointer::basic_address<char_type>(string_type(entry.at(from_literal<char_type>()).as_string_view()));
+            if (!op.from.valid())
+            {
+                return;
+            }
+        }
+        op.valid = true;
+    }
+
+    // Returns false if patch is not an array
+    template <class Json>
+    bool compile_operations(const Json& patch, std::vector<operation<Json>>& operations)
+    {
+        if (!patch.is_array())
+        {
+            return false;
+        }
+        operations.resize(patch.size());
+        size_t i = 0;
+        for (const auto& entry : patch.array_range())
+        {
+            compile_operation(entry, operations[i++]);
+        }
+        return true;
+    }
+
+    // Applies compiled operations. The values that an operation replaces or removes are 
+    // moved into an undo log, not copied, and moved back if a later operation fails.
+    template <class Json>
+    class operation_applier
+    {
+        typedef jsonpointer::basic_address<typename Json::char_type> pointer_type;
+        typedef typename pointer_type::token_type token_type;
+
+        enum class undo_kind {remove,restore,insert,unmove};
+
+        struct undo_entry
+        {
+            undo_kind kind;
+            const operation<Json>* op;
+            Json value;
+            size_t index;
+            size_t from_index;
+            bool replaced;
+        };
+
+        static const size_t npos = (std::numeric_limits<size_t>::max)();
+
+        Json& root_;
+        bool rollback_;
+        std::vector<undo_entry> log_;
+    public:
+        operation_applier(Json& root, bool rollback)
+            : root_(root), rollback_(rollback)
+        {
+        }
+
+        void apply(const std::vector<operation<Json>>& operations, std::error_code& ec)
+        {
+            if (rollback_)
+            {
+                log_.reserve(operations.size());
+            }
+            for (const auto& op : operations)
+            {
+                if (!op.valid || !apply(op))
+                {
+                    ec = op.failure;
+                    if (rollback_)
+                    {
+                        undo();
+                    }
+                    return;
+                }
+            }
+        }
+
+    private:
+        bool apply(const operation<Json>& op)
+        {
+            switch (op.kind)
+            {
+                case op_kind::test:
+                {
+                    const Json* val = find(op.path);
+                    return val != nullptr && *val == *op.value;
+                }
+                case op_kind::add:
+                {
+                    Json val(*op.value);
+                    return add(op, std::move(val));
+                }
+                case op_kind::remove:
+                {
+                    Json val;
+                    size_t index = npos;
+                    if (!remove(op.path, npos, val, index))
+                    {
+                        return false;
+                    }
+                    log(undo_kind::insert, op, std::move(val), index, npos, false);
+                    return true;
+                }
+                case op_kind::replace:
+                {
+                    Json* target = find(op.path);
+                    if (target == nullptr)
+                    {
+                        return false;
+                    }
+                    Json val(*op.value);
+                    std::swap(*target, val);
+                    log(undo_kind::restore, op, std::move(val), npos, npos, true);
+                    return true;
+                }
+                case op_kind::move:
+                {
+                    if (op.from == op.path)
+                    {
+                        return find(op.from) != nullptr;
+                    }
+                    if (is_prefix_of(op.from, op.path))
+                    {
+                        return false; // a value cannot be moved into one of its children
+                    }
+                    Json val;
+                    size_t from_index = npos;
+                    if (!remove(op.from, npos, val, from_index))
+                    {
+                        return false;
+                    }
+                    bool replaced = false;
+                    size_t index = npos;
+                    if (!insert(op.path, npos, val, replaced, index))
+                    {
+                        insert(op.from, from_index, val, replaced, index);
+                        return false;
+                    }
+                    log(undo_kind::unmove, op, std::move(val), index, from_index, replaced);
+                    return true;
+                }
+                case op_kind::copy:
+                {
+                    const Json* source = find(op.from);
+                    if (source == nullptr)
+                    {
+                        return false;
+                    }
+                    Json val(*source);
+                    return add(op, std::move(val));
+                }
+            }
+            return false;
+        }
+
+        bool add(const operation<Json>& op, Json&& val)
+        {
+            bool replaced = false;
+            size_t index = npos;
+            if (!insert(op.path, npos, val, replaced, index))
+            {
+                return false;
+            }
+            if (replaced)
+            {
+                log(undo_kind::restore, op, std::move(val), npos, npos, true);
+            }
+            else
+            {
+                log(undo_kind::remove, op, Json(), index, npos, false);
+            }
+            return true;
+        }
+
+        void log(undo_kind kind, const operation<Json>& op, Json&& val, size_t index, size_t from_index, bool replaced)
+        {
+            if (rollback_)
+            {
+                log_.push_back(undo_entry{kind, &op, std::move(val), index, from_index, replaced});
+            }
+        }
+
+        // Undoes the logged operations in reverse order, so that each sees 
+        // the document as it was after that operation was applied
+        void undo()
+        {
+            for (auto it = log_.rbegin(); it != log_.rend(); ++it)
+            {
+                const operation<Json>& op = *(it->op);
+                bool replaced = false;
+                size_t index = npos;
+                switch (it->kind)
+                {
+                    case undo_kind::remove:
+                    {
+                        Json val;
+                        remove(op.path, it->index, val, index);
+                        break;
+                    }
+                    case undo_kind::restore:
+                        std::swap(*find(op.path), it->value);
+                        break;
+                    case undo_kind::insert:
+                        insert(op.path, it->index, it->value, replaced, index);
+                        break;
+                    case undo_kind::unmove:
+                    {
+                        Json val;
+                        if (it->replaced)
+                        {
+                            Json* target = find(op.path);
+                            val = std::move(*target);
+                            *target = std::move(it->value);
+                        }
+                        else
+                        {
+                            remove(op.path, it->index, val, index);
+                        }
+                        insert(op.from, it->from_index, val, replaced, index);
+                        break;
+                    }
+                }
+            }
+            log_.clear();
+        }
+
+        Json* find_parent(const pointer_type& path)
+        {
+            Json* current = &root_;
+            for (size_t i = 0; current != nullptr && i + 1 < path.tokens().size(); ++i)
+            {
+                current = find_child(*current, path.tokens()[i]);
+            }
+            return current;
+        }
+
+        Json* find(const pointer_type& path)
+        {
+            Json* parent = find_parent(path);
+            if (parent == nullptr || path.tokens().empty())
+            {
+                return parent;
+            }
+            return find_child(*parent, path.tokens().back());
+        }
+
+        static Json* find_child(Json& parent, const token_type& t)
+        {
+            std::error_code ec;
+            return jsonpointer::detail::find_child(std::addressof(parent), t, ec);
+        }
+
+        // Adds val at path, or at array index at if it is not npos. If a member is 
+        // replaced, its value is swapped into val, otherwise val is moved from.
+        bool insert(const pointer_type& path, size_t at, Json& val, bool& replaced, size_t& index)
+        {
+            replaced = false;
+            if (path.tokens().empty())
+            {
+                std::swap(root_, val);
+                replaced = true;
+                return true;
+            }
+            Json* parent = find_parent(path);
+            if (parent == nullptr)
+            {
+                return false;
+            }
+            const token_type& t = path.tokens().back();
+            if (parent->is_array())
+            {
+                if (at != npos)
+                {
+                    index = at;
+                }
+                else if (t.is_append())
+                {
+                    index = parent->size();
+                }
+                else if (t.is_index && t.index <= parent->size())
+                {
+                    index = t.index;
+                }
+                else
+                {
+                    return false;
+                }
+                parent->insert(parent->array_range().begin() + index, std::move(val));
+                return true;
+            }
+            else if (parent->is_object())
+            {
+                auto it = parent->find(t.name);
+                if (it != parent->object_range().end())
+                {
+                    std::swap(it->value(), val);
+                    replaced = true;
+                }
+                else
+                {
+                    parent->insert_or_assign(t.name, std::move(val));
+                }
+                return true;
+            }
+            return false;
+        }
+
+        // Moves the value at path, or at array index at if it is not npos, into val 
+        // and erases it
+        bool remove(const pointer_type& path, size_t at, Json& val, size_t& index)
+        {
+            Json* parent = path.tokens().empty() ? nullptr : find_parent(path);
+            if (parent == nullptr)
+            {
+                return false;
+            }
+            const token_type& t = path.tokens().back();
+            if (parent->is_array())
+            {
+                if (at != npos)
+                {
+                    index = at;
+                }
+                else if (t.is_index && t.index < parent->size())
+                {
+                    index = t.index;
+                }
+                else
+                {
+                    return false;
+                }
+                val = std::move(parent->at(index));
+                parent->erase(parent->array_range().begin() + index);
+                return true;
+            }
+            else if (parent->is_object())
+            {
+                auto it = parent->find(t.name);
+                if (it == parent->object_range().end())
+                {
+                    return false;
+                }
+                val = std::move(it->value());
+                parent->erase(t.name);
+                return true;
+            }
+            return false;
+        }
+    };
+
+    template <class Json>
+    const size_t operation_applier<Json>::npos;
+
+    // Counts of present items at keys [0,size), with the first present key
+    class fenwick_tree
+    {
+        std::vector<size_t> tree_;
+    public:
+        explicit fenwick_tree(size_t size)
+            : tree_(size+1, 0)
+        {
+        }
+
+        void add(size_t key, ptrdiff_t delta)
+        {
+            for (size_t i = key + 1; i < tree_.size(); i += i & (0-i))
+            {
+                tree_[i] = static_cast<size_t>(static_cast<ptrdiff_t>(tree_[i]) + delta);
+            }
+        }
+
+        // The number of items at keys less than key
+        size_t count_less(size_t key) const
+        {
+            size_t count = 0;
+            for (size_t i = key; i > 0; i -= i & (0-i))
+            {
+                count += tree_[i];
+            }
+            return count;
+        }
+
+        // The smallest key with an item, there must be one
+        size_t first() const
+        {
+            size_t pos = 0;
+            size_t step = 1;
+            while (step*2 < tree_.size())
+            {
+                step *= 2;
+            }
+            for (; step > 0; step /= 2)
+            {
+                if (pos + step < tree_.size() && tree_[pos + step] == 0)
+                {
+                    pos += step;
+                }
+            }
+            return pos;
+        }
+    };
+
+    // Builds a JSON Patch from the differences between two values.
+    //
+    // Subtree hashes are memoized, so a subtree that differs is recognized 
+    // without comparing it, and one that is equal is compared once. Array 
+    // elements are aligned on their hashes with Myers' algorithm, after 
+    // trimming the common prefix and suffix. Elements removed in one place 
+    // and added in another become moves, as do members that change name, 
+    // and an element removed where another is added is diffed in place.
+    template <class Json>
+    class diff_engine
+    {
+    public:
+        typedef typename Json::char_type char_type;
+        typedef typename Json::string_type string_type;
+        typedef typename Json::string_view_type string_view_type;
+    private:
+        // Beyond this many insertions and removals in the middle of an array,
+        // its elements are paired index by index
+        static const size_t max_edit_distance = 1024;
+
+        static const size_t npos = (size_t)-1;
+
+        enum class edit_kind {keep, remove, insert};
+
+        struct edit
+        {
+            edit_kind kind;
+            size_t index;
+        };
+
+        enum class element_kind {insert, keep, move};
+
+        std::unordered_map<const Json*,uint64_t> hashes_;
+        string_type path_;
+        Json result_;
+    public:
+        diff_engine()
+            : result_(typename Json::array())
+        {
+        }
+
+        Json diff(const Json& source, const Json& target)
+        {
+            diff_value(source, target);
+            Json result = typename Json::array();
+            result.swap(result_);
+            hashes_.clear();
+            return result;
+        }
+    private:
+        static uint64_t combine(uint64_t h, uint64_t v)
+        {
+            h ^= v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            return h;
+        }
+
+        static uint64_t finalize(uint64_t h)
+        {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        template <class T>
+        static uint64_t hash_range(const T* data, size_t length, uint64_t h)
+        {
+            for (size_t i = 0; i < length; ++i)
+            {
+                h = (h ^ static_cast<uint64_t>(data[i])) * 0x100000001b3ULL;
+            }
+            return h;
+        }
+
+        // Equal values have equal hashes. Numbers are hashed as doubles, 
+        // as they are compared, and object members in any order.
+        uint64_t hash(const Json& val)
+        {
+            if (val.is_array())
+            {
+                auto it = hashes_.find(std::addressof(val));
+                if (it != hashes_.end())
+                {
+                    return it->second;
+                }
+                uint64_t h = 6;
+                for (const auto& item : val.array_range())
+                {
+                    h = combine(h, hash(item));
+                }
+                hashes_.emplace(std::addressof(val), h);
+                return h;
+            }
+            else if (val.is_object())
+            {
+                auto it = hashes_.find(std::addressof(val));
+                if (it != hashes_.end())
+                {
+                    return it->second;
+                }
+                uint64_t sum = 0;
+                for (const auto& member : val.object_range())
+                {
+                    string_view_type key = member.key();
+                    sum += finalize(combine(hash_range(key.data(), key.length(), 0xcbf29ce484222325ULL), hash(member.value())));
+                }
+                uint64_t h = combine(combine(7, val.size()), sum);
+                hashes_.emplace(std::addressof(val), h);
+                return h;
+            }
+            else if (val.is_string())
+            {
+                string_view_type sv = val.as_string_view();
+                return hash_range(sv.data(), sv.length(), 4);
+            }
+            else if (val.is_number())
+            {
+                double d = val.template as<double>();
+                if (d == 0)
+                {
+                    d = 0; // -0 == 0
+                }
+                uint64_t bits;
+                std::memcpy(&bits, &d, sizeof(d));
+                return combine(3, bits);
+            }
+            else if (val.is_bool())
+            {
+                return val.template as<bool>() ? 21 : 20;
+            }
+            else if (val.is_byte_string())
+            {
+                byte_string_view bsv = val.as_byte_string_view();
+                return hash_range(bsv.data(), bsv.length(), 5);
+            }
+            else
+            {
+                return 1;
+            }
+        }
+
+        void push_index(size_t index)
+        {
+            char_type buf[32];
+            char_type* p = buf;
+            do
+            {
+                *p++ = static_cast<char_type>('0' + index % 10);
+            } while (index /= 10);
+            path_.push_back('/');
+            while (--p >= buf)
+            {
+                path_.push_back(*p);
+            }
+        }
+
+        void push_key(const string_view_type& key)
+        {
+            path_.push_back('/');
+            for (auto c : key)
+            {
+                if (c == '~')
+                {
+                    path_.push_back('~');
+                    path_.push_back('0');
+                }
+                else if (c == '/')
+                {
+                    path_.push_back('~');
+                    path_.push_back('1');
+                }
+                else
+                {
+                    path_.push_back(c);
+                }
+            }
+        }
+
+        void emit_add(const Json& value)
+        {
+            Json val = typename Json::object();
+            val.insert_or_assign(op_literal<char_type>(), add_literal<char_type>());
+            val.insert_or_assign(path_literal<char_type>(), path_);
+            val.insert_or_assign(value_literal<char_type>(), value);
+            result_.push_back(std::move(val));
+        }
+
+        void emit_remove()
+        {
+            Json val = typename Json::object();
+            val.insert_or_assign(op_literal<char_type>(), remove_literal<char_type>());
+            val.insert_or_assign(path_literal<char_type>(), path_);
+            result_.push_back(std::move(val));
+        }
+
+        void emit_replace(const Json& value)
+        {
+            Json val = typename Json::object();
+            val.insert_or_assign(op_literal<char_type>(), replace_literal<char_type>());
+            val.insert_or_assign(path_literal<char_type>(), path_);
+            val.insert_or_assign(value_literal<char_type>(), value);
+            result_.push_back(std::move(val));
+        }
+
+        void emit_move(const string_type& from)
+        {
+            Json val = typename Json::object();
+            val.insert_or_assign(op_literal<char_type>(), move_literal<char_type>());
+            val.insert_or_assign(from_literal<char_type>(), from);
+            val.insert_or_assign(path_literal<char_type>(), path_);
+            result_.push_back(std::move(val));
+        }
+
+        void diff_value(const Json& source, const Json& target)
+        {
+            if (hash(source) == hash(target) && source == target)
+            {
+                return;
+            }
+            if (source.is_array() && target.is_array())
+            {
+                diff_array(source, target);
+            }
+            else if (source.is_object() && target.is_object())
+            {
+                diff_object(source, target);
+            }
+            else
+            {
+                emit_replace(target);
+            }
+        }
+
+        void diff_object(const Json& source, const Json& target)
+        {
+            const size_t length = path_.size();
+
+            // Members that change name, removed members matched to added ones with the same value
+            struct added_member
+            {
+                string_view_type key;
+                const Json* value;
+            };
+            std::unordered_map<uint64_t,std::vector<added_member>> added;
+            for (const auto& member : target.object_range())
+            {
+                if (source.find(member.key()) == source.object_range().end())
+                {
+                    added[hash(member.value())].push_back(added_member{member.key(), std::addressof(member.value())});
+                }
+            }
+            std::unordered_map<const Json*,string_view_type> moves;
+            std::unordered_set<const Json*> moved_to;
+            if (!added.empty())
+            {
+                for (const auto& member : source.object_range())
+                {
+                    if (target.find(member.key()) == target.object_range().end())
+                    {
+                        auto it = added.find(hash(member.value()));
+                        if (it != added.end())
+                        {
+                            for (auto& candidate : it->second)
+                            {
+                                if (candidate.value != nullptr && *candidate.value == member.value())
+                                {
+                                    moves.emplace(std::addressof(member.value()), candidate.key);
+                                    moved_to.insert(candidate.value);
+                                    candidate.value = nullptr;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            string_type from;
+            for (const auto& member : source.object_range())
+            {
+                push_key(member.key());
+                auto it = target.find(member.key());
+                if (it != target.object_range().end())
+                {
+                    diff_value(member.value(), it->value());
+                }
+                else
+                {
+                    auto m = moves.find(std::addressof(member.value()));
+                    if (m != moves.end())
+                    {
+                        from = path_;
+                        path_.resize(length);
+                        push_key(m->second);
+                        emit_move(from);
+                    }
+                    else
+                    {
+                        emit_remove();
+                    }
+                }
+                path_.resize(length);
+            }
+            for (const auto& member : target.object_range())
+            {
+                if (source.find(member.key()) == source.object_range().end() 
+                    && moved_to.find(std::addressof(member.value())) == moved_to.end())
+                {
+                    push_key(member.key());
+                    emit_add(member.value());
+                    path_.resize(length);
+                }
+            }
+        }
+
+        // Appends the edits that turn a[0,n) into b[0,m) with Myers' algorithm, or returns false 
+        // if more than max_edit_distance insertions and removals are needed
+        static bool myers(const uint64_t* a, size_t n, const uint64_t* b, size_t m, 
+                          size_t a_offset, size_t b_offset, std::vector<edit>& edits)
         {
-            op_type op;
-            string_type path;
-            Json value;
-        };
-
-        Json& target;
-        state_type state;
-        std::vector<entry> stack;
+            const ptrdiff_t max_d = static_cast<ptrdiff_t>((std::min)(n + m, max_edit_distance));
+            const ptrdiff_t sn = static_cast<ptrdiff_t>(n);
+            const ptrdiff_t sm = static_cast<ptrdiff_t>(m);
 
-        operation_unwinder(Json& j)
-            : target(j), state(state_type::begin)
-        {
-        }
+            // v[k + max_d + 1] is the furthest x reached on diagonal k, trace[d] keeps v[-d,d] after step d
+            std::vector<ptrdiff_t> v(2*max_d + 3, 0);
+            std::vector<std::vector<ptrdiff_t>> trace;
 
-        ~operation_unwinder()
-        {
-            std::error_code ec;
-            //std::cout << "state: " << std::boolalpha << (state == state_type::commit) << ", stack size: " << stack.size() << std::endl;
-            if (state != state_type::commit)
+            ptrdiff_t found = -1;
+            for (ptrdiff_t d = 0; d <= max_d && found < 0; ++d)
             {
-                for (auto it = stack.rbegin(); it != stack.rend(); ++it)
+                for (ptrdiff_t k = -d; k <= d; k += 2)
                 {
-                    if (it->op == op_type::add)
+                    ptrdiff_t x;
+                    if (k == -d || (k != d && v[k - 1 + max_d + 1] < v[k + 1 + max_d + 1]))
                     {
-                        jsonpointer::insert_or_assign(target,it->path,it->value,ec);
-                        if (ec)
-                        {
-                            //std::cout << "add: " << it->path << std::endl;
-                            break;
-                        }
+                        x = v[k + 1 + max_d + 1];
                     }
-                    else if (it->op == op_type::remove)
+                    else
                     {
-                        jsonpointer::remove(target,it->path,ec);
-                        if (ec)
-                        {
-                            //std::cout << "remove: " << it->path << std::endl;
-                            break;
-                        }
+                        x = v[k - 1 + max_d + 1] + 1;
                     }
-                    else if (it->op == op_type::replace)
+                    ptrdiff_t y = x - k;
+                    while (x < sn && y < sm && a[x] == b[y])
                     {
-                        jsonpointer::replace(target,it->path,it->value,ec);
-                        if (ec)
-                        {
-                            //std::cout << "replace: " << it->path << std::endl;
-                            break;
-                        }
+                        ++x;
+                        ++y;
+                    }
+                    v[k + max_d + 1] = x;
+                    if (x >= sn && y >= sm)
+                    {
+                        found = d;
                     }
                 }
+                trace.emplace_back(v.begin() + (max_d + 1 - d), v.begin() + (max_d + 2 + d));
+            }
+            if (found < 0)
+            {
+                return false;
             }
-        }
-    };
-
-    template <class Json>
-    Json from_diff(const Json& source, const Json& target, const typename Json::string_type& path)
-    {
-        typedef typename Json::char_type char_type;
-
-        Json result = typename Json::array();
 
-        if (source == target)
-        {
-            return result;
+            // Walk back from (n,m), collecting edits in reverse
+            std::vector<edit> reversed;
+            ptrdiff_t x = sn;
+            ptrdiff_t y = sm;
+            for (ptrdiff_t d = found; d > 0; --d)
+            {
+                const std::vector<ptrdiff_t>& prev = trace[d-1];
+                ptrdiff_t k = x - y;
+                ptrdiff_t prev_k;
+                if (k == -d || (k != d && prev[k - 1 + d - 1] < prev[k + 1 + d - 1]))
+                {
+                    prev_k = k + 1;
+                }
+                else
+                {
+                    prev_k = k - 1;
+                }
+                ptrdiff_t prev_x = prev[prev_k + d - 1];
+                ptrdiff_t prev_y = prev_x - prev_k;
+                while (x > prev_x && y > prev_y)
+                {
+                    --x;
+                    --y;
+                    reversed.push_back(edit{edit_kind::keep, static_cast<size_t>(x)});
+                }
+                if (x == prev_x)
+                {
+                    --y;
+                    reversed.push_back(edit{edit_kind::insert, static_cast<size_t>(y)});
+                }
+                else
+                {
+                    --x;
+                    reversed.push_back(edit{edit_kind::remove, static_cast<size_t>(x)});
+                }
+            }
+            while (x > 0 && y > 0)
+            {
+                --x;
+                --y;
+                reversed.push_back(edit{edit_kind::keep, static_cast<size_t>(x)});
+            }
+            for (auto it = reversed.rbegin(); it != reversed.rend(); ++it)
+            {
+                edits.push_back(edit{it->kind, it->index + (it->kind == edit_kind::insert ? b_offset : a_offset)});
+            }
+            return true;
         }
 
-        if (source.is_array() && target.is_array())
+        // Appends the edits that turn a[a_first,a_last) into b[b_first,b_last), keeping
+        // the common prefix and suffix. If the rest is too far apart, its elements are
+        // all removed and inserted, to be paired in place.
+        static void align_range(const std::vector<uint64_t>& a, size_t a_first, size_t a_last, 
+                                const std::vector<uint64_t>& b, size_t b_first, size_t b_last, 
+                                std::vector<edit>& edits)
         {
-            size_t common = (std::min)(source.size(),target.size());
-            for (size_t i = 0; i < common; ++i)
+            size_t prefix = 0;
+            while (a_first + prefix < a_last && b_first + prefix < b_last && a[a_first + prefix] == b[b_first + prefix])
+            {
+                edits.push_back(edit{edit_kind::keep, a_first + prefix});
+                ++prefix;
+            }
+            a_first += prefix;
+            b_first += prefix;
+            size_t suffix = 0;
+            while (a_first < a_last - suffix && b_first < b_last - suffix && a[a_last - 1 - suffix] == b[b_last - 1 - suffix])
             {
-                std::basic_ostringstream<char_type> ss; 
-                ss << path << '/' << i;
-                auto temp_diff = from_diff(source[i],target[i],ss.str());
-                result.insert(result.array_range().end(),temp_diff.array_range().begin(),temp_diff.array_range().end());
+                ++suffix;
             }
-            // Element in source, not in target - remove
-            for (size_t i = target.size(); i < source.size(); ++i)
+            a_last -= suffix;
+            b_last -= suffix;
+
+            if (!myers(a.data() + a_first, a_last - a_first, b.data() + b_first, b_last - b_first, a_first, b_first, edits))
             {
-                std::basic_ostringstream<char_type> ss; 
-                ss << path << '/' << i;
-                Json val = typename Json::object();
-                val.insert_or_assign(op_literal<char_type>(), remove_literal<char_type>());
-                val.insert_or_assign(path_literal<char_type>(), ss.str());
-                result.push_back(std::move(val));
+                for (size_t i = a_first; i < a_last; ++i)
+                {
+                    edits.push_back(edit{edit_kind::remove, i});
+                }
+                for (size_t j = b_first; j < b_last; ++j)
+                {
+                    edits.push_back(edit{edit_kind::insert, j});
+                }
             }
-            // Element in target, not in source - add, 
-            // Fix contributed by Alexander rog13
-            for (size_t i = source.size(); i < target.size(); ++i)
+            for (size_t i = a_last; i < a_last + suffix; ++i)
             {
-                const auto& a = target[i];
-                std::basic_ostringstream<char_type> ss; 
-                ss << path << '/' << i;
-                Json val = typename Json::object();
-                val.insert_or_assign(op_literal<char_type>(), add_literal<char_type>());
-                val.insert_or_assign(path_literal<char_type>(), ss.str());
-                val.insert_or_assign(value_literal<char_type>(), a);
-                result.push_back(std::move(val));
+                edits.push_back(edit{edit_kind::keep, i});
             }
         }
-        else if (source.is_object() && target.is_object())
+
+        // Appends the edits that turn a into b. Large arrays are first split at 
+        // anchors, elements that occur once in each array, taking the longest 
+        // sequence of anchors in the same order in both (as patience diff does),
+        // and the ranges between anchors are aligned separately.
+        static void align(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b, std::vector<edit>& edits)
         {
-            for (const auto& a : source.object_range())
+            const size_t n = a.size();
+            const size_t m = b.size();
+            if (n + m <= max_edit_distance)
             {
-                std::basic_ostringstream<char_type> ss; 
-                ss << path << '/';
-                jsonpointer::escape(a.key(),ss);
-                auto it = target.find(a.key());
-                if (it != target.object_range().end())
+                align_range(a, 0, n, b, 0, m, edits);
+                return;
+            }
+
+            struct occurrence
+            {
+                size_t count_a;
+                size_t count_b;
+                size_t index_a;
+                size_t index_b;
+            };
+            std::unordered_map<uint64_t,occurrence> occurrences;
+            occurrences.reserve(n);
+            for (size_t i = 0; i < n; ++i)
+            {
+                auto& o = occurrences.emplace(a[i], occurrence{0,0,0,0}).first->second;
+                ++o.count_a;
+                o.index_a = i;
+            }
+            for (size_t j = 0; j < m; ++j)
+            {
+                auto it = occurrences.find(b[j]);
+                if (it != occurrences.end())
                 {
-                    auto temp_diff = from_diff(a.value(),it->value(),ss.str());
-                    result.insert(result.array_range().end(),temp_diff.array_range().begin(),temp_diff.array_range().end());
+                    ++it->second.count_b;
+                    it->second.index_b = j;
                 }
-                else
+            }
+
+            // Candidate anchors in source order, and the longest increasing 
+            // subsequence of their target indices
+            std::vector<std::pair<size_t,size_t>> candidates;
+            for (size_t i = 0; i < n; ++i)
+            {
+                const auto& o = occurrences[a[i]];
+                if (o.count_a == 1 && o.count_b == 1)
                 {
-                    Json val = typename Json::object();
-                    val.insert_or_assign(op_literal<char_type>(), remove_literal<char_type>());
-                    val.insert_or_assign(path_literal<char_type>(), ss.str());
-                    result.push_back(std::move(val));
+                    candidates.emplace_back(i, o.index_b);
                 }
             }
-            for (const auto& a : target.object_range())
+            std::vector<size_t> tails; // tails[l] is the candidate ending the best subsequence of length l+1
+            std::vector<size_t> previous(candidates.size(), npos);
+            for (size_t c = 0; c < candidates.size(); ++c)
             {
-                auto it = source.find(a.key());
-                if (it == source.object_range().end())
+                auto it = std::lower_bound(tails.begin(), tails.end(), candidates[c].second,
+                                           [&candidates](size_t t, size_t value){return candidates[t].second < value;});
+                if (it != tails.begin())
+                {
+                    previous[c] = *(it - 1);
+                }
+                if (it == tails.end())
                 {
-                    std::basic_ostringstream<char_type> ss; 
-                    ss << path << '/';
-                    jsonpointer::escape(a.key(),ss);
-                    Json val = typename Json::object();
-                    val.insert_or_assign(op_literal<char_type>(), add_literal<char_type>());
-                    val.insert_or_assign(path_literal<char_type>(), ss.str());
-                    val.insert_or_assign(value_literal<char_type>(), a.value());
-                    result.push_back(std::move(val));
+                    tails.push_back(c);
+                }
+                else
+                {
+                    *it = c;
                 }
             }
-        }
-        else
-        {
-            Json val = typename Json::object();
-            val.insert_or_assign(op_literal<char_type>(), replace_literal<char_type>());
-            val.insert_or_assign(path_literal<char_type>(), path);
-            val.insert_or_assign(value_literal<char_type>(), target);
-            result.push_back(std::move(val));
-        }
+            std::vector<size_t> anchors;
+            for (size_t c = tails.empty() ? npos : tails.back(); c != npos; c = previous[c])
+            {
+                anchors.push_back(c);
+            }
 
-        return result;
-    }
-}
+            size_t a_first = 0;
+            size_t b_first = 0;
+            for (auto it = anchors.rbegin(); it != anchors.rend(); ++it)
+            {
+                const auto& anchor = candidates[*it];
+                align_range(a, a_first, anchor.first, b, b_first, anchor.second, edits);
+                edits.push_back(edit{edit_kind::keep, anchor.first});
+                a_first = anchor.first + 1;
+                b_first = anchor.second + 1;
+            }
+            align_range(a, a_first, n, b, b_first, m, edits);
+        }
 
-template <class Json>
-void apply_patch(Json& target, const Json& patch, std::error_code& patch_ec)
-{
-    typedef typename Json::char_type char_type;
-    typedef typename Json::string_type string_type;
-    typedef typename Json::string_view_type string_view_type;
+        void diff_array(const Json& source, const Json& target)
+        {
+            const size_t length = path_.size();
+            const size_t n = source.size();
+            const size_t m = target.size();
 
-   jsoncons::jsonpatch::detail::operation_unwinder<Json> unwinder(target);
+            std::vector<uint64_t> a;
+            a.reserve(n);
+            for (const auto& item : source.array_range())
+            {
+                a.push_back(hash(item));
+            }
+            std::vector<uint64_t> b;
+            b.reserve(m);
+            for (const auto& item : target.array_range())
+            {
+                b.push_back(hash(item));
+            }
 
-    // Validate
-    
-    string_type bad_path;
-    for (const auto& operation : patch.array_range())
-    {
-        unwinder.state =jsoncons::jsonpatch::detail::state_type::begin;
+            std::vector<edit> edits;
+            edits.reserve(n + m);
+            align(a, b, edits);
 
-        if (operation.count(detail::op_literal<char_type>()) != 1 || operation.count(detail::path_literal<char_type>()) != 1)
-        {
-            patch_ec = jsonpatch_errc::invalid_patch;
-            unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-        }
-        else
-        {
-            string_view_type op = operation.at(detail::op_literal<char_type>()).as_string_view();
-            string_view_type path = operation.at(detail::path_literal<char_type>()).as_string_view();
+            // For each target element, whether it is inserted, kept (or diffed in place), 
+            // or moved, and the source element it comes from
+            std::vector<element_kind> kinds(m, element_kind::insert);
+            std::vector<size_t> sources(m, npos);
+            std::vector<bool> removed(n, false);
 
-            if (op ==jsoncons::jsonpatch::detail::test_literal<char_type>())
+            // Removed elements that are equal to inserted elements are moved
+            std::unordered_map<uint64_t,std::vector<size_t>> removals;
             {
-                std::error_code ec;
-                Json val = jsonpointer::get(target,path,ec);
-                if (ec)
-                {
-                    patch_ec = jsonpatch_errc::test_failed;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                }
-                else if (operation.count(detail::value_literal<char_type>()) != 1)
-                {
-                    patch_ec = jsonpatch_errc::invalid_patch;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                }
-                else if (val != operation.at(detail::value_literal<char_type>()))
+                size_t j = 0;
+                for (const auto& e : edits)
                 {
-                    patch_ec = jsonpatch_errc::test_failed;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                    switch (e.kind)
+                    {
+                        case edit_kind::keep:
+                            kinds[j] = element_kind::keep;
+                            sources[j] = e.index;
+                            ++j;
+                            break;
+                        case edit_kind::remove:
+                            removed[e.index] = true;
+                            removals[a[e.index]].push_back(e.index);
+                            break;
+                        case edit_kind::insert:
+                            ++j;
+                            break;
+                    }
                 }
             }
-            else if (op ==jsoncons::jsonpatch::detail::add_literal<char_type>())
+            if (!removals.empty())
             {
-                if (operation.count(detail::value_literal<char_type>()) != 1)
+                for (size_t j = 0; j < m; ++j)
                 {
-                    patch_ec = jsonpatch_errc::invalid_patch;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                    if (kinds[j] == element_kind::insert)
+                    {
+                        auto it = removals.find(b[j]);
+                        if (it != removals.end())
+                        {
+                            for (auto& i : it->second)
+                            {
+                                if (i != npos && source[i] == target[j])
+                                {
+                                    kinds[j] = element_kind::move;
+                                    sources[j] = i;
+                                    removed[i] = false;
+                                    i = npos;
+                                    break;
+                                }
+                            }
+                        }
+                    }
                 }
-                else
+            }
+
+            // Between kept elements, pair the elements still removed with those still 
+            // inserted, in order, and diff them in place
+            {
+                size_t j = 0;
+                size_t k = 0;
+                while (k < edits.size())
                 {
-                    std::error_code insert_ec;
-                    Json val = operation.at(detail::value_literal<char_type>());
-                    auto npath = jsonpointer::normalized_path(target,path);
-                    jsonpointer::insert(target,npath,val,insert_ec); // try insert without replace
-                    if (insert_ec) // try a replace
+                    if (edits[k].kind == edit_kind::keep)
+                    {
+                        ++j;
+                        ++k;
+                        continue;
+                    }
+                    std::vector<size_t> run_removed;
+                    std::vector<size_t> run_inserted;
+                    while (k < edits.size() && edits[k].kind != edit_kind::keep)
                     {
-                        std::error_code select_ec;
-                        Json orig_val = jsonpointer::get(target,npath,select_ec);
-                        if (select_ec) // shouldn't happen
+                        if (edits[k].kind == edit_kind::remove)
                         {
-                            patch_ec = jsonpatch_errc::add_failed;
-                            unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                            if (removed[edits[k].index])
+                            {
+                                run_removed.push_back(edits[k].index);
+                            }
                         }
                         else
                         {
-                            std::error_code replace_ec;
-                            jsonpointer::replace(target,npath,val,replace_ec);
-                            if (replace_ec)
-                            {
-                                patch_ec = jsonpatch_errc::add_failed;
-                                unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                            }
-                            else
+                            if (kinds[j] == element_kind::insert)
                             {
-                                unwinder.stack.push_back({detail::op_type::replace,npath,orig_val});
+                                run_inserted.push_back(j);
                             }
+                            ++j;
                         }
+                        ++k;
                     }
-                    else // insert without replace succeeded
+                    size_t pairs = (std::min)(run_removed.size(), run_inserted.size());
+                    for (size_t p = 0; p < pairs; ++p)
                     {
-                        unwinder.stack.push_back({detail::op_type::remove,npath,Json::null()});
+                        kinds[run_inserted[p]] = element_kind::keep;
+                        sources[run_inserted[p]] = run_removed[p];
+                        removed[run_removed[p]] = false;
                     }
                 }
             }
-            else if (op ==jsoncons::jsonpatch::detail::remove_literal<char_type>())
+
+            // Remove from the back, so that the indices of the elements before are unchanged
+            for (size_t i = n; i-- > 0; )
             {
-                std::error_code ec;
-                Json val = jsonpointer::get(target,path,ec);
-                if (ec)
-                {
-                    patch_ec = jsonpatch_errc::remove_failed;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                }
-                else
+                if (removed[i])
                 {
-                    jsonpointer::remove(target,path,ec);
-                    if (ec)
-                    {
-                        patch_ec = jsonpatch_errc::remove_failed;
-                        unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                    }
-                    else
-                    {
-                        unwinder.stack.push_back({detail::op_type::add,string_type(path),val});
-                    }
+                    push_index(i);
+                    emit_remove();
+                    path_.resize(length);
                 }
             }
-            else if (op ==jsoncons::jsonpatch::detail::replace_literal<char_type>())
+
+            // The anchor of a target position is the next kept element after it
+            std::vector<size_t> anchors(m + 1, n);
+            for (size_t j = m; j-- > 0; )
             {
-                std::error_code ec;
-                Json val = jsonpointer::get(target,path,ec);
-                if (ec)
-                {
-                    patch_ec = jsonpatch_errc::replace_failed;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                }
-                else if (operation.count(detail::value_literal<char_type>()) != 1)
-                {
-                    patch_ec = jsonpatch_errc::invalid_patch;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                }
-                else
+                anchors[j] = (kinds[j] == element_kind::keep) ? sources[j] : anchors[j+1];
+            }
+
+            // Target elements are put in place from the front. The elements not yet 
+            // in place follow them, in source order, at key 2*i+1 for source element i.
+            // A moved element that is in the way of a kept element is parked before the 
+            // kept element that will follow it, at key 2*anchor (2*n for the end).
+            fenwick_tree present(2*n + 1);
+            std::vector<size_t> keys(n, npos);
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (!removed[i])
                 {
-                    jsonpointer::replace(target,path,operation.at(detail::value_literal<char_type>()),ec);
-                    if (ec)
-                    {
-                        patch_ec = jsonpatch_errc::replace_failed;
-                        unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                    }
-                    else
-                    {
-                        unwinder.stack.push_back({detail::op_type::replace,string_type(path),val});
-                    }
+                    keys[i] = 2*i + 1;
+                    present.add(keys[i], 1);
                 }
             }
-            else if (op ==jsoncons::jsonpatch::detail::move_literal<char_type>())
+            std::vector<size_t> targets(n, npos);
+            for (size_t j = 0; j < m; ++j)
             {
-                if (operation.count(detail::from_literal<char_type>()) != 1)
+                if (sources[j] != npos)
                 {
-                    patch_ec = jsonpatch_errc::invalid_patch;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                    targets[sources[j]] = j;
                 }
-                else
+            }
+            std::unordered_map<size_t,std::vector<size_t>> parked;
+            size_t num_present = present.count_less(2*n + 1);
+
+            // The index of source element i, which is not in place, when j elements are
+            auto index_of = [&](size_t i, size_t j) -> size_t
+            {
+                size_t index = j + present.count_less(keys[i]);
+                if (keys[i] % 2 == 0)
                 {
-                    string_view_type from = operation.at(detail::from_literal<char_type>()).as_string_view();
-                    std::error_code ec;
-                    Json val = jsonpointer::get(target,from,ec);
-                    if (ec)
-                    {
-                        patch_ec = jsonpatch_errc::move_failed;
-                        unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                    }
-                    else 
+                    for (size_t other : parked[keys[i] / 2])
                     {
-                        jsonpointer::remove(target,from,ec);
-                        if (ec)
+                        if (other == i)
                         {
-                            patch_ec = jsonpatch_errc::move_failed;
-                            unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
+                            break;
                         }
-                        else
+                        if (keys[other] != npos)
                         {
-                            unwinder.stack.push_back({detail::op_type::add,string_type(from),val});
-                            // add
-                            std::error_code insert_ec;
-                            auto npath = jsonpointer::normalized_path(target,path);
-                            jsonpointer::insert(target,npath,val,insert_ec); // try insert without replace
-                            if (insert_ec) // try a replace
-                            {
-                                std::error_code select_ec;
-                                Json orig_val = jsonpointer::get(target,npath,select_ec);
-                                if (select_ec) // shouldn't happen
-                                {
-                                    patch_ec = jsonpatch_errc::copy_failed;
-                                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                                }
-                                else
-                                {
-                                    std::error_code replace_ec;
-                                    jsonpointer::replace(target, npath, val, replace_ec);
-                                    if (replace_ec)
-                                    {
-                                        patch_ec = jsonpatch_errc::copy_failed;
-                                        unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-
-                                    }
-                                    else
-                                    {
-                                        unwinder.stack.push_back({jsoncons::jsonpatch::detail::op_type::replace,npath,orig_val });
-                                    }
-                                    
-                                }
-                            }
-                            else
-                            {
-                                unwinder.stack.push_back({detail::op_type::remove,npath,Json::null()});
-                            }
-                        }           
+                            ++index;
+                        }
                     }
                 }
-            }
-            else if (op ==jsoncons::jsonpatch::detail::copy_literal<char_type>())
+                return index;
+            };
+
+            string_type from;
+            for (size_t j = 0; j < m; ++j)
             {
-                if (operation.count(detail::from_literal<char_type>()) != 1)
-                {
-                    patch_ec = jsonpatch_errc::invalid_patch;
-                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                }
-                else
+                switch (kinds[j])
                 {
-                    std::error_code ec;
-                    string_view_type from = operation.at(detail::from_literal<char_type>()).as_string_view();
-                    Json val = jsonpointer::get(target,from,ec);
-                    if (ec)
-                    {
-                        patch_ec = jsonpatch_errc::copy_failed;
-                        unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                    }
-                    else
+                    case element_kind::insert:
+                        push_index(j);
+                        emit_add(target[j]);
+                        path_.resize(length);
+                        break;
+                    case element_kind::keep:
                     {
-                        // add
-                        auto npath = jsonpointer::normalized_path(target,path);
-                        std::error_code insert_ec;
-                        jsonpointer::insert(target,npath,val,insert_ec); // try insert without replace
-                        if (insert_ec) // Failed, try a replace
+                        const size_t i = sources[j];
+                        while (present.count_less(keys[i]) > 0)
                         {
-                            std::error_code select_ec;
-                            Json orig_val = jsonpointer::get(target,npath, select_ec);
-                            if (select_ec) // shouldn't happen
+                            const size_t blocker = (present.first() - 1) / 2;
+                            const size_t anchor = anchors[targets[blocker]];
+                            // Parked elements are kept in target order
+                            auto& group = parked[anchor];
+                            auto pos = std::upper_bound(group.begin(), group.end(), targets[blocker],
+                                                        [&targets](size_t t, size_t other){return t < targets[other];});
+                            size_t after = 0;
+                            for (auto it = pos; it != group.end(); ++it)
                             {
-                                patch_ec = jsonpatch_errc::copy_failed;
-                                unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                            }
-                            else 
-                            {
-                                std::error_code replace_ec;
-                                jsonpointer::replace(target, npath, val,replace_ec);
-                                if (replace_ec)
-                                {
-                                    patch_ec = jsonpatch_errc::copy_failed;
-                                    unwinder.state =jsoncons::jsonpatch::detail::state_type::abort;
-                                }
-                                else
+                                if (keys[*it] != npos)
                                 {
-                                    unwinder.stack.push_back({jsoncons::jsonpatch::detail::op_type::replace,npath,orig_val });
+                                    ++after;
                                 }
                             }
+                            const size_t dest = (anchor == n ? j + num_present : index_of(anchor, j)) - 1 - after;
+                            if (dest != j)
+                            {
+                                push_index(j);
+                                from = path_;
+                                path_.resize(length);
+                                push_index(dest);
+                                emit_move(from);
+                                path_.resize(length);
+                            }
+                            present.add(keys[blocker], -1);
+                            keys[blocker] = 2*anchor;
+                            present.add(keys[blocker], 1);
+                            group.insert(pos, blocker);
                         }
-                        else
+                        present.add(keys[i], -1);
+                        keys[i] = npos;
+                        --num_present;
+                        push_index(j);
+                        diff_value(source[i], target[j]);
+                        path_.resize(length);
+                        break;
+                    }
+                    case element_kind::move:
+                    {
+                        const size_t i = sources[j];
+                        const size_t index = index_of(i, j);
+                        if (index != j)
                         {
-                            unwinder.stack.push_back({detail::op_type::remove,npath,Json::null()});
+                            push_index(index);
+                            from = path_;
+                            path_.resize(length);
+                            push_index(j);
+                            emit_move(from);
+                            path_.resize(length);
                         }
+                        present.add(keys[i], -1);
+                        keys[i] = npos;
+                        --num_present;
+                        break;
                     }
                 }
             }
-            if (unwinder.state !=jsoncons::jsonpatch::detail::state_type::begin)
+        }
+    };
+
+    template <class Json>
+    const size_t diff_engine<Json>::max_edit_distance;
+
+    template <class Json>
+    const size_t diff_engine<Json>::npos;
+
+    template <class Json>
+    Json from_diff(const Json& source, const Json& target)
+    {
+        diff_engine<Json> engine;
+        return engine.diff(source, target);
+    }
+}
+
+class jsonpatch_options
+{
+    bool rollback_;
+public:
+    jsonpatch_options()
+        : rollback_(true)
+    {
+    }
+
+    // Whether a patch that fails leaves the target unchanged (the default). If false,
+    // no undo log is kept, and the operations before the one that failed stay applied.
+    bool rollback() const
+    {
+        return rollback_;
+    }
+
+    jsonpatch_options& rollback(bool value)
+    {
+        rollback_ = value;
+        return *this;
+    }
+};
+
+template <class Json>
+class jsonpatch_expression
+{
+    Json patch_;
+    std::vector<detail::operation<Json>> operations_;
+
+    explicit jsonpatch_expression(Json&& patch)
+        : patch_(std::move(patch))
+    {
+    }
+
+    // Compiles patch_, the operations point into it
+    void compile(std::error_code& ec)
+    {
+        if (!detail::compile_operations(patch_, operations_))
+        {
+            ec = jsonpatch_errc::invalid_patch;
+            return;
+        }
+        for (const auto& op : operations_)
+        {
+            if (!op.valid)
             {
-                bad_path = string_type(path);
+                ec = op.failure;
+                return;
             }
         }
-        if (unwinder.state !=jsoncons::jsonpatch::detail::state_type::begin)
+    }
+public:
+    jsonpatch_expression(const jsonpatch_expression& other)
+        : patch_(other.patch_)
+    {
+        std::error_code ec;
+        compile(ec);
+    }
+
+    jsonpatch_expression(jsonpatch_expression&&) = default;
+
+    jsonpatch_expression& operator=(const jsonpatch_expression& other)
+    {
+        if (this != &other)
+        {
+            patch_ = other.patch_;
+            std::error_code ec;
+            compile(ec);
+        }
+        return *this;
+    }
+
+    jsonpatch_expression& operator=(jsonpatch_expression&&) = default;
+
+    static jsonpatch_expression compile(const Json& patch)
+    {
+        std::error_code ec;
+        jsonpatch_expression expr = compile(Json(patch), ec);
+        if (ec)
+        {
+            JSONCONS_THROW(jsonpatch_error(ec));
+        }
+        return expr;
+    }
+
+    static jsonpatch_expression compile(Json&& patch)
+    {
+        std::error_code ec;
+        jsonpatch_expression expr = compile(std::move(patch), ec);
+        if (ec)
+        {
+            JSONCONS_THROW(jsonpatch_error(ec));
+        }
+        return expr;
+    }
+
+    static jsonpatch_expression compile(const Json& patch, std::error_code& ec)
+    {
+        return compile(Json(patch), ec);
+    }
+
+    static jsonpatch_expression compile(Json&& patch, std::error_code& ec)
+    {
+        jsonpatch_expression expr(std::move(patch));
+        expr.compile(ec);
+        return expr;
+    }
+
+    void apply(Json& target, const jsonpatch_options& options = jsonpatch_options()) const
+    {
+        std::error_code ec;
+        apply(target, options, ec);
+        if (ec)
         {
-            break;
+            JSONCONS_THROW(jsonpatch_error(ec));
         }
     }
-    if (unwinder.state ==jsoncons::jsonpatch::detail::state_type::begin)
+
+    void apply(Json& target, std::error_code& ec) const
+    {
+        apply(target, jsonpatch_options(), ec);
+    }
+
+    void apply(Json& target, const jsonpatch_options& options, std::error_code& ec) const
+    {
+        detail::operation_applier<Json> applier(target, options.rollback());
+        applier.apply(operations_, ec);
+    }
+};
+
+template <class Json>
+void apply_patch(Json& target, const Json& patch, std::error_code& patch_ec)
+{
+    std::vector<detail::operation<Json>> operations;
+    if (!detail::compile_operations(patch, operations))
     {
-        unwinder.state =jsoncons::jsonpatch::detail::state_type::commit;
+        patch_ec = jsonpatch_errc::invalid_patch;
+        return;
     }
+    detail::operation_applier<Json> applier(target, true);
+    applier.apply(operations, patch_ec);
 }
 
 template <class Json>
 Json from_diff(const Json& source, const Json& target)
 {
-    typename Json::string_type path;
-    return jsoncons::jsonpatch::detail::from_diff(source, target, path);
+    return jsoncons::jsonpatch::detail::from_diff(source, target);
 }
 
 template <class Json>
@@ -15,9 +15,16 @@
 #include <limits> // std::numeric_limits
 #include <utility> // std::move
 #include <regex>
-#include <set> // std::set
+#include <unordered_set> // std::unordered_set
+#include <unordered_map> // std::unordered_map
+#include <map> // std::map
+#include <algorithm> // std::stable_sort
 #include <iterator> // std::make_move_iterator
+#include <mutex>
+#include <condition_variable>
+#include <exception> // std::exception_ptr
 #include <jsoncons/json.hpp>
+#include <jsoncons/detail/worker_pool.hpp>
 #include <jsoncons_ext/jsonpath/jsonpath_filter.hpp>
 #include <jsoncons_ext/jsonpath/jsonpath_error.hpp>
 #include <jsoncons_ext/jsonpath/jsonpath_function.hpp>
@@ -86,18 +93,61 @@ std::unique_ptr<T> make_unique_ptr(Args&&... args)
 
 enum class result_type {value,path};
 
+// jsonpath_options
+
+class jsonpath_options
+{
+    size_t num_threads_;
+    size_t parallel_threshold_;
+public:
+    static const size_t default_parallel_threshold = 10000;
+
+    jsonpath_options()
+        : num_threads_(1), parallel_threshold_(default_parallel_threshold)
+    {
+    }
+
+    // The number of evaluation threads, 1 to evaluate serially (the default),
+    // 0 for one per hardware thread
+    size_t num_threads() const
+    {
+        return num_threads_;
+    }
+
+    jsonpath_options& num_threads(size_t value)
+    {
+        num_threads_ = value;
+        return *this;
+    }
+
+    // The number of elements or members an array or object, or the number
+    // of nodes a step, must have before selecting from them is split 
+    // across threads
+    size_t parallel_threshold() const
+    {
+        return parallel_threshold_;
+    }
+
+    jsonpath_options& parallel_threshold(size_t value)
+    {
+        parallel_threshold_ = value > 0 ? value : 1;
+        return *this;
+    }
+};
+
 template<class Json>
-Json json_query(const Json& root, const typename Json::string_view_type& path, result_type result_t = result_type::value)
+Json json_query(const Json& root, const typename Json::string_view_type& path, result_type result_t = result_type::value,
+                const jsonpath_options& options = jsonpath_options())
 {
     if (result_t == result_type::value)
     {
-        jsoncons::jsonpath::detail::jsonpath_evaluator<Json,const Json&,detail::VoidPathConstructor<Json>> evaluator;
+        jsoncons::jsonpath::detail::jsonpath_evaluator<Json,const Json&,detail::VoidPathConstructor<Json>> evaluator(options);
         evaluator.evaluate(root, path);
         return evaluator.get_values();
     }
     else
     {
-        jsoncons::jsonpath::detail::jsonpath_evaluator<Json,const Json&,detail::PathConstructor<Json>> evaluator;
+        jsoncons::jsonpath::detail::jsonpath_evaluator<Json,const Json&,detail::PathConstructor<Json>> evaluator(options);
         evaluator.evaluate(root, path);
         return evaluator.get_normalized_paths();
     }
@@ -113,6 +163,28 @@ void json_replace(Json& root, const typename Json::string_view_type& path, T&& n
 
 namespace detail {
 
+// The pools that parallel evaluations run on, one for each number of threads, 
+// created on first use and shared by all evaluations. Tasks submitted from 
+// several threads queue on the same pool.
+inline
+jsoncons::detail::worker_pool& shared_worker_pool(size_t num_threads)
+{
+    static std::mutex mutex;
+    static std::map<size_t,std::unique_ptr<jsoncons::detail::worker_pool>> pools;
+
+    if (num_threads == 0)
+    {
+        num_threads = jsoncons::detail::worker_pool::default_num_threads();
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& pool = pools[num_threads];
+    if (!pool)
+    {
+        pool.reset(new jsoncons::detail::worker_pool(num_threads));
+    }
+    return *pool;
+}
+
 template<class CharT>
 bool try_string_to_index(const CharT *s, size_t length, size_t* value, bool* positive)
 {
@@ -235,319 +307,125 @@ struct state_item
 
 JSONCONS_STRING_LITERAL(length, 'l', 'e', 'n', 'g', 't', 'h')
 
-template<class Json,
-         class JsonReference,
-         class PathCons>
-class jsonpath_evaluator : public ser_context
+template <class Json>
+struct path_expression;
+
+enum class selector_kind {name, array_slice, expr, filter, path};
+
+template <class Json>
+struct path_selector
 {
     typedef typename Json::char_type char_type;
     typedef typename Json::char_traits_type char_traits_type;
     typedef std::basic_string<char_type,char_traits_type> string_type;
-    typedef typename Json::string_view_type string_view_type;
-    typedef JsonReference reference;
-    using pointer = typename std::conditional<std::is_const<typename std::remove_reference<JsonReference>::type>::value,typename Json::const_pointer,typename Json::pointer>::type;
-    typedef typename Json::const_pointer const_pointer;
-
-    struct node_type
-    {
-        string_type path;
-        pointer val_ptr;
-
-        node_type() = default;
-        node_type(const string_type& p, const pointer& valp)
-            : path(p),val_ptr(valp)
-        {
-        }
-        node_type(string_type&& p, pointer&& valp)
-            : path(std::move(p)),val_ptr(valp)
-        {
-        }
-        node_type(const node_type&) = default;
-        node_type(node_type&& other)
-            : path(std::move(other.path)), val_ptr(other.val_ptr)
-        {
-
-        }
-        node_type& operator=(const node_type&) = default;
-        node_type& operator=(node_type&& other) 
-        {
-            path.swap(other.path);
-            val_ptr = other.val_ptr;
-        }
 
-    };
-    typedef std::vector<node_type> node_set;
+    selector_kind kind;
+    string_type name;
+    array_slice slice;
+    jsonpath_filter_expr<Json> expr;
+    std::shared_ptr<const path_expression<Json>> path;
 
-    struct node_less
+    path_selector(const string_type& name)
+        : kind(selector_kind::name), name(name)
     {
-        bool operator()(const node_type& a, const node_type& b) const
-        {
-            return *(a.val_ptr) < *(b.val_ptr);
-        }
-    };
+    }
 
-    class selector_base
+    path_selector(const array_slice& slice)
+        : kind(selector_kind::array_slice), slice(slice)
     {
-    public:
-        virtual ~selector_base()
-        {
-        }
-        virtual void select(jsonpath_evaluator& evaluator,
-                            const string_type& path, reference val, node_set& nodes) = 0;
-
-        virtual bool is_filter() const
-        {
-            return false;
-        }
-    };
+    }
 
-    class path_selector final : public selector_base
+    path_selector(selector_kind kind, const jsonpath_filter_expr<Json>& expr)
+        : kind(kind), expr(expr)
     {
-    private:
-         std::basic_string<char_type> path_;
-    public:
-        path_selector(const std::basic_string<char_type>& path)
-            : path_(path)
-        {
-        }
-
-        void select(jsonpath_evaluator&,
-                    const string_type& path, reference val, 
-                    node_set& nodes) override
-        {
-            std::error_code ec;
-            jsonpath_evaluator<Json,JsonReference,PathCons> e;
-            e.evaluate(val, path_, ec);
-            if (!ec)
-            {
-                for (auto ptr : e.get_pointers())
-                {
-                    nodes.emplace_back(PathCons()(path,path_),ptr);
-                }
-            }
-        }
-    };
+    }
 
-    class expr_selector final : public selector_base
+    // A relative path, name holds its text for normalized paths, 
+    // path is null if the text could not be compiled 
+    path_selector(const string_type& text, std::shared_ptr<const path_expression<Json>> path)
+        : kind(selector_kind::path), name(text), path(path)
     {
-    private:
-         jsonpath_filter_expr<Json> result_;
-    public:
-        expr_selector(const jsonpath_filter_expr<Json>& result)
-            : result_(result)
-        {
-        }
+    }
+};
 
-        void select(jsonpath_evaluator& evaluator,
-                    const string_type& path, reference val, 
-                    node_set& nodes) override
-        {
-            auto index = result_.eval(val);
-            if (index.template is<size_t>())
-            {
-                size_t start = index.template as<size_t>();
-                if (val.is_array() && start < val.size())
-                {
-                    nodes.emplace_back(PathCons()(path,start),std::addressof(val[start]));
-                }
-            }
-            else if (index.is_string())
-            {
-                name_selector selector(index.as_string_view());
-                selector.select(evaluator, path, val, nodes);
-            }
-        }
-    };
+template <class Json>
+struct function_argument
+{
+    std::shared_ptr<const path_expression<Json>> path;
+    Json value;
 
-    class filter_selector final : public selector_base
+    // A path argument, or a literal value if path is null
+    function_argument(std::shared_ptr<const path_expression<Json>> path, Json&& value)
+        : path(path), value(std::move(value))
     {
-    private:
-         jsonpath_filter_expr<Json> result_;
-    public:
-        filter_selector(const jsonpath_filter_expr<Json>& result)
-            : result_(result)
-        {
-        }
-
-        bool is_filter() const override
-        {
-            return true;
-        }
-
-        void select(jsonpath_evaluator&,
-                    const string_type& path, reference val, 
-                    node_set& nodes) override
-        {
-            //std::cout << "filter_selector select ";
-            if (val.is_array())
-            {
-                //std::cout << "from array \n";
-                for (size_t i = 0; i < val.size(); ++i)
-                {
-                    if (result_.exists(val[i]))
-                    {
-                        nodes.emplace_back(PathCons()(path,i),std::addressof(val[i]));
-                    }
-                }
-            }
-            else if (val.is_object())
-            {
-                //std::cout << "from object \n";
-                if (result_.exists(val))
-                {
-                    nodes.emplace_back(path, std::addressof(val));
-                }
-            }
-        }
-    };
+    }
+};
 
-    class name_selector final : public selector_base
-    {
-    private:
-        string_type name_;
-    public:
-        name_selector(const string_view_type& name)
-            : name_(name)
-        {
-        }
+enum class step_kind {select, all, function};
 
-        void select(jsonpath_evaluator& evaluator,
-                    const string_type& path, reference val,
-                    node_set& nodes) override
-        {
-            bool is_start_positive = true;
+// select:   applies selectors to the current nodes
+// all:      selects the members or elements of the current nodes
+// function: calls function_name with arguments and makes the result the current node
+// Select steps, and all steps with transfer set, end with the selected nodes
+// becoming the current nodes, without duplicates if is_union.
 
-            if (val.is_object() && val.contains(name_))
-            {
-                nodes.emplace_back(PathCons()(path,name_),std::addressof(val.at(name_)));
-            }
-            else if (val.is_array())
-            {
-                size_t pos = 0;
-                if (try_string_to_index(name_.data(), name_.size(), &pos, &is_start_positive))
-                {
-                    size_t index = is_start_positive ? pos : val.size() - pos;
-                    if (index < val.size())
-                    {
-                        nodes.emplace_back(PathCons()(path,index),std::addressof(val[index]));
-                    }
-                }
-                else if (name_ == length_literal<char_type>() && val.size() > 0)
-                {
-                    pointer ptr = evaluator.create_temp(val.size());
-                    nodes.emplace_back(PathCons()(path, name_), ptr);
-                }
-            }
-            else if (val.is_string())
-            {
-                size_t pos = 0;
-                string_view_type sv = val.as_string_view();
-                if (try_string_to_index(name_.data(), name_.size(), &pos, &is_start_positive))
-                {
-                    size_t index = is_start_positive ? pos : sv.size() - pos;
-                    auto sequence = unicons::sequence_at(sv.data(), sv.data() + sv.size(), index);
-                    if (sequence.length() > 0)
-                    {
-                        pointer ptr = evaluator.create_temp(sequence.begin(),sequence.length());
-                        nodes.emplace_back(PathCons()(path, index), ptr);
-                    }
-                }
-                else if (name_ == length_literal<char_type>() && sv.size() > 0)
-                {
-                    size_t count = unicons::u32_length(sv.begin(),sv.end());
-                    pointer ptr = evaluator.create_temp(count);
-                    nodes.emplace_back(PathCons()(path, name_), ptr);
-                }
-            }
-        }
-    };
+template <class Json>
+struct path_step
+{
+    typedef typename Json::char_type char_type;
+    typedef typename Json::char_traits_type char_traits_type;
+    typedef std::basic_string<char_type,char_traits_type> string_type;
 
-    class array_slice_selector final : public selector_base
+    step_kind kind;
+    bool is_recursive_descent;
+    bool is_union;
+    bool transfer;
+    std::vector<path_selector<Json>> selectors;
+    string_type function_name;
+    std::vector<function_argument<Json>> arguments;
+    size_t line;
+    size_t column;
+
+    path_step(step_kind kind, size_t line, size_t column)
+        : kind(kind), is_recursive_descent(false), is_union(false), transfer(true), 
+          line(line), column(column)
     {
-    private:
-        array_slice slice_;
-    public:
-        array_slice_selector(const array_slice& slice)
-            : slice_(slice) 
-        {
-        }
-
-        void select(jsonpath_evaluator&,
-                    const string_type& path, reference val,
-                    node_set& nodes) override
-        {
-            if (slice_.is_step_positive)
-            {
-                end_array_slice1(path, val, nodes);
-            }
-            else
-            {
-                end_array_slice2(path, val, nodes);
-            }
-        }
-
-        void end_array_slice1(const string_type& path, reference val, node_set& nodes)
-        {
-            if (val.is_array())
-            {
-                size_t start = slice_.get_start(val.size());
-                size_t end = slice_.get_end(val.size());
-                for (size_t j = start; j < end; j += slice_.step())
-                {
-                    if (j < val.size())
-                    {
-                        nodes.emplace_back(PathCons()(path,j),std::addressof(val[j]));
-                    }
-                }
-            }
-        }
-
-        void end_array_slice2(const string_type& path, reference val, node_set& nodes)
-        {
-            if (val.is_array())
-            {
-                size_t start = slice_.get_start(val.size());
-                size_t end = slice_.get_end(val.size());
+    }
+};
 
-                size_t j = end + slice_.step() - 1;
-                while (j > (start+slice_.step()-1))
-                {
-                    j -= slice_.step();
-                    if (j < val.size())
-                    {
-                        nodes.emplace_back(PathCons()(path,j),std::addressof(val[j]));
-                    }
-                }
-            }
-        }
-    };
+template <class Json>
+struct path_expression
+{
+    std::vector<path_step<Json>> steps;
+};
 
-    function_table<Json,pointer> functions_;
+template<class Json>
+class jsonpath_compiler : public ser_context
+{
+    typedef typename Json::char_type char_type;
+    typedef typename Json::char_traits_type char_traits_type;
+    typedef std::basic_string<char_type,char_traits_type> string_type;
+    typedef typename Json::string_view_type string_view_type;
 
-    default_parse_error_handler default_err_handler_;
-    node_set nodes_;
-    std::vector<node_set> stack_;
     size_t line_;
     size_t column_;
     const char_type* begin_input_;
     const char_type* end_input_;
     const char_type* p_;
-    std::vector<std::unique_ptr<selector_base>> selectors_;
-    std::vector<std::unique_ptr<Json>> temp_json_values_;
-
-    typedef std::vector<pointer> argument_type;
-    std::vector<argument_type> function_stack_;
+    std::vector<path_step<Json>> steps_;
+    std::vector<path_selector<Json>> selectors_;
+    std::vector<function_argument<Json>> arguments_;
     std::vector<state_item> state_stack_;
 
 public:
-    jsonpath_evaluator()
+    jsonpath_compiler()
         : line_(1), column_(1),
           begin_input_(nullptr), end_input_(nullptr),
           p_(nullptr)
     {
     }
 
-    jsonpath_evaluator(size_t line, size_t column)
+    jsonpath_compiler(size_t line, size_t column)
         : line_(line), column_(column),
           begin_input_(nullptr), end_input_(nullptr),
           p_(nullptr)
@@ -564,137 +442,51 @@ public:
         return column_;
     }
 
-    Json get_values() const
+    void compile(const string_view_type& path, path_expression<Json>& expr)
     {
-        Json result = typename Json::array();
-
-        if (stack_.size() > 0)
+        std::error_code ec;
+        compile(path.data(), path.length(), expr, ec);
+        if (ec)
         {
-            result.reserve(stack_.back().size());
-            for (const auto& p : stack_.back())
-            {
-                result.push_back(*(p.val_ptr));
-            }
+            throw jsonpath_error(ec, line_, column_);
         }
-        return result;
     }
 
-    std::vector<pointer> get_pointers() const
+    void compile(const string_view_type& path, path_expression<Json>& expr, std::error_code& ec)
     {
-        std::vector<pointer> result;
-
-        if (stack_.size() > 0)
+        try
         {
-            result.reserve(stack_.back().size());
-            for (const auto& p : stack_.back())
-            {
-                result.push_back(p.val_ptr);
-            }
+            compile(path.data(), path.length(), expr, ec);
         }
-        return result;
-    }
-
-    void call_function(const string_type& function_name, std::error_code& ec)
-    {
-        auto f = functions_.get(function_name, ec);
-        if (ec)
+        catch (const jsonpath_error& e)
         {
-            return;
+            ec = e.code();
         }
-        auto result = f(function_stack_, ec);
-        if (ec)
+        catch (...)
         {
-            return;
+            ec = jsonpath_errc::unidentified_error;
         }
-
-        string_type s = {'$'};
-        node_set v;
-        pointer ptr = create_temp(std::move(result));
-        v.emplace_back(s,ptr);
-        stack_.push_back(v);
     }
 
-    template <typename... Args>
-    pointer create_temp(Args&& ... args)
+    void compile(const char_type* path, 
+                 size_t length,
+                 path_expression<Json>& expr,
+                 std::error_code& ec)
     {
-        auto temp = make_unique_ptr<Json>(std::forward<Args>(args)...);
-        pointer ptr = temp.get();
-        temp_json_values_.emplace_back(std::move(temp));
-        return ptr;
-    }
+        state_stack_.emplace_back(path_state::start);
 
-    Json get_normalized_paths() const
-    {
-        Json result = typename Json::array();
-        if (stack_.size() > 0)
+        string_type function_name;
+        string_type buffer;
+
+        begin_input_ = path;
+        end_input_ = path + length;
+        p_ = begin_input_;
+
+        array_slice slice;
+
+        while (p_ < end_input_)
         {
-            result.reserve(stack_.back().size());
-            for (const auto& p : stack_.back())
-            {
-                result.push_back(p.path);
-            }
-        }
-        return result;
-    }
-
-    template <class T>
-    void replace(T&& new_value)
-    {
-        if (stack_.size() > 0)
-        {
-            for (size_t i = 0; i < stack_.back().size(); ++i)
-            {
-                *(stack_.back()[i].val_ptr) = new_value;
-            }
-        }
-    }
-
-    void evaluate(reference root, const string_view_type& path)
-    {
-        std::error_code ec;
-        evaluate(root, path.data(), path.length(), ec);
-        if (ec)
-        {
-            throw jsonpath_error(ec, line_, column_);
-        }
-    }
-
-    void evaluate(reference root, const string_view_type& path, std::error_code& ec)
-    {
-        try
-        {
-            evaluate(root, path.data(), path.length(), ec);
-        }
-        catch (...)
-        {
-            ec = jsonpath_errc::unidentified_error;
-        }
-    }
- 
-    void evaluate(reference root, 
-                  const char_type* path, 
-                  size_t length,
-                  std::error_code& ec)
-    {
-        state_stack_.emplace_back(path_state::start);
-
-        string_type function_name;
-        string_type buffer;
-
-        begin_input_ = path;
-        end_input_ = path + length;
-        p_ = begin_input_;
-
-        string_type s = {'$'};
-        node_set v;
-        v.emplace_back(std::move(s),std::addressof(root));
-        stack_.push_back(v);
-
-        array_slice slice;
-
-        while (p_ < end_input_)
-        {
-            switch (state_stack_.back().state)
+            switch (state_stack_.back().state)
             {
                 case path_state::start: 
                 {
@@ -735,8 +527,8 @@ public:
                     {
                         case ' ':case '\t':case '\r':case '\n':
                         {
-                            selectors_.push_back(make_unique_ptr<name_selector>(buffer));
-                            apply_selectors();
+                            selectors_.emplace_back(buffer);
+                            push_select_step();
                             buffer.clear();
                             state_stack_.pop_back();
                             advance_past_space_character();
@@ -753,8 +545,8 @@ public:
                         {
                             if (buffer.size() > 0)
                             {
-                                selectors_.push_back(make_unique_ptr<name_selector>(buffer));
-                                apply_selectors();
+                                selectors_.emplace_back(buffer);
+                                push_select_step();
                                 buffer.clear();
                             }
                             slice.start_ = 0;
@@ -768,8 +560,8 @@ public:
                         {
                             if (buffer.size() > 0)
                             {
-                                selectors_.push_back(make_unique_ptr<name_selector>(buffer));
-                                apply_selectors();
+                                selectors_.emplace_back(buffer);
+                                push_select_step();
                                 buffer.clear();
                             }
                             state_stack_.back().state = path_state::dot;
@@ -779,8 +571,7 @@ public:
                         }
                         case '*':
                         {
-                            end_all();
-                            transfer_nodes();
+                            push_all_step(true);
                             state_stack_.back().state = path_state::dot;
                             ++p_;
                             ++column_;
@@ -840,19 +631,12 @@ public:
                             break;
                         case ')':
                         {
-                            jsonpath_evaluator<Json,JsonReference,PathCons> evaluator;
-                            evaluator.evaluate(root, buffer, ec);
-                            if (ec)
-                            {
-                                return;
-                            }
-                            function_stack_.push_back(evaluator.get_pointers());
-
-                            call_function(function_name, ec);
+                            push_path_argument(buffer, ec);
                             if (ec)
                             {
                                 return;
                             }
+                            push_function_step(function_name);
                             state_stack_.pop_back();
                             ++p_;
                             ++column_;
@@ -872,13 +656,11 @@ public:
                     {
                         case ',':
                         {
-                            jsonpath_evaluator<Json, JsonReference, PathCons> evaluator;
-                            evaluator.evaluate(root, buffer, ec);
+                            push_path_argument(buffer, ec);
                             if (ec)
                             {
                                 return;
                             }
-                            function_stack_.push_back(evaluator.get_pointers());
                             state_stack_.pop_back();
                             ++p_;
                             ++column_;
@@ -902,9 +684,7 @@ public:
                         case ',':
                             try
                             {
-                                auto val = Json::parse(buffer);
-                                auto temp = create_temp(val);
-                                function_stack_.push_back(std::vector<pointer>{temp});
+                                arguments_.emplace_back(nullptr, Json::parse(buffer));
                             }
                             catch (const ser_error&)
                             {
@@ -919,20 +699,14 @@ public:
                         {
                             try
                             {
-                                auto val = Json::parse(buffer);
-                                auto temp = create_temp(val);
-                                function_stack_.push_back(std::vector<pointer>{temp});
+                                arguments_.emplace_back(nullptr, Json::parse(buffer));
                             }
                             catch (const ser_error&)
                             {
                                 ec = jsonpath_errc::argument_parse_error;
                                 return;
                             }
-                            call_function(function_name, ec);
-                            if (ec)
-                            {
-                                return;
-                            }
+                            push_function_step(function_name);
                             state_stack_.pop_back();
                             break;
                         }
@@ -985,9 +759,7 @@ public:
                         case ',':
                             try
                             {
-                                auto val = Json::parse(buffer);
-                                auto temp = create_temp(val);
-                                function_stack_.push_back(std::vector<pointer>{temp});
+                                arguments_.emplace_back(nullptr, Json::parse(buffer));
                             }
                             catch (const ser_error&)
                             {
@@ -1004,20 +776,14 @@ public:
                         {
                             try
                             {
-                                auto val = Json::parse(buffer);
-                                auto temp = create_temp(val);
-                                function_stack_.push_back(std::vector<pointer>{temp});
+                                arguments_.emplace_back(nullptr, Json::parse(buffer));
                             }
                             catch (const ser_error&)
                             {
                                 ec = jsonpath_errc::argument_parse_error;
                                 return;
                             }
-                            call_function(function_name, ec);
-                            if (ec)
-                            {
-                                return;
-                            }
+                            push_function_step(function_name);
                             state_stack_.pop_back();
                             ++p_;
                             ++column_;
@@ -1066,8 +832,7 @@ public:
                             advance_past_space_character();
                             break;
                         case '*':
-                            end_all();
-                            transfer_nodes();
+                            push_all_step(true);
                             state_stack_.pop_back();
                             ++p_;
                             ++column_;
@@ -1137,15 +902,15 @@ public:
                             advance_past_space_character();
                             break;
                         case '[':
-                            selectors_.push_back(make_unique_ptr<name_selector>(buffer));
-                            apply_selectors();
+                            selectors_.emplace_back(buffer);
+                            push_select_step();
                             buffer.clear();
                             slice.start_ = 0;
                             state_stack_.pop_back();
                             break;
                         case '.':
-                            selectors_.push_back(make_unique_ptr<name_selector>(buffer));
-                            apply_selectors();
+                            selectors_.emplace_back(buffer);
+                            push_select_step();
                             buffer.clear();
                             state_stack_.pop_back();
                             break;
@@ -1158,8 +923,8 @@ public:
                     switch (*p_)
                     {
                         case '\'':
-                            selectors_.push_back(make_unique_ptr<name_selector>(buffer));
-                            apply_selectors();
+                            selectors_.emplace_back(buffer);
+                            push_select_step();
                             buffer.clear();
                             state_stack_.pop_back();
                             break;
@@ -1187,8 +952,8 @@ public:
                     switch (*p_)
                     {
                         case '\"':
-                            selectors_.push_back(make_unique_ptr<name_selector>(buffer));
-                            apply_selectors();
+                            selectors_.emplace_back(buffer);
+                            push_select_step();
                             buffer.clear();
                             state_stack_.pop_back();
                             break;
@@ -1225,7 +990,7 @@ public:
                             ++column_;
                             break;
                         case ']':
-                            apply_selectors();
+                            push_select_step();
                             state_stack_.pop_back();
                             ++p_;
                             ++column_;
@@ -1244,20 +1009,20 @@ public:
                         case '(':
                         {
                             jsonpath_filter_parser<Json> parser(line_,column_);
-                            auto result = parser.parse(root, p_,end_input_,&p_);
+                            auto result = parser.parse(p_,end_input_,&p_);
                             line_ = parser.line();
                             column_ = parser.column();
-                            selectors_.push_back(make_unique_ptr<expr_selector>(result));
+                            selectors_.emplace_back(selector_kind::expr, result);
                             state_stack_.back().state = path_state::comma_or_right_bracket;
                             break;
                         }
                         case '?':
                         {
                             jsonpath_filter_parser<Json> parser(line_,column_);
-                            auto result = parser.parse(root,p_,end_input_,&p_);
+                            auto result = parser.parse(p_,end_input_,&p_);
                             line_ = parser.line();
                             column_ = parser.column();
-                            selectors_.push_back(make_unique_ptr<filter_selector>(result));
+                            selectors_.emplace_back(selector_kind::filter, result);
                             state_stack_.back().state = path_state::comma_or_right_bracket;
                             break;                   
                         }
@@ -1346,7 +1111,7 @@ public:
                         case ']': 
                             if (!buffer.empty())
                             {
-                                selectors_.push_back(make_unique_ptr<name_selector>(buffer));
+                                selectors_.emplace_back(buffer);
                                 buffer.clear();
                             }
                             state_stack_.pop_back();
@@ -1378,7 +1143,7 @@ public:
                             break;
                         case ',': 
                         case ']': 
-                            end_all();
+                            push_all_step(false);
                             state_stack_.pop_back();
                             break;
                         default:
@@ -1405,7 +1170,7 @@ public:
                         case ']': 
                             if (!buffer.empty())
                             {
-                                selectors_.push_back(make_unique_ptr<path_selector>(buffer));
+                                push_path_selector(buffer);
                                 buffer.clear();
                             }
                             state_stack_.pop_back();
@@ -1509,7 +1274,7 @@ public:
                             break;
                         case ',':
                         case ']':
-                            selectors_.push_back(make_unique_ptr<array_slice_selector>(slice));
+                            selectors_.emplace_back(slice);
                             state_stack_.pop_back();
                             break;
                         default:
@@ -1539,7 +1304,7 @@ public:
                                 ec = jsonpath_errc::expected_slice_end;
                                 return;
                             }
-                            selectors_.push_back(make_unique_ptr<array_slice_selector>(slice));
+                            selectors_.emplace_back(slice);
                             state_stack_.pop_back();
                             break;
                         default:
@@ -1578,7 +1343,7 @@ public:
                                 ec = jsonpath_errc::expected_slice_step;
                                 return;
                             }
-                            selectors_.push_back(make_unique_ptr<array_slice_selector>(slice));
+                            selectors_.emplace_back(slice);
                             state_stack_.pop_back();
                             break;
                         default:
@@ -1650,8 +1415,8 @@ public:
             case path_state::unquoted_name: 
             case path_state::unquoted_name2: 
             {
-                selectors_.push_back(make_unique_ptr<name_selector>(buffer));
-                apply_selectors();
+                selectors_.emplace_back(buffer);
+                push_select_step();
                 buffer.clear();
                 state_stack_.pop_back(); // unquoted_name
                 break;
@@ -1671,108 +1436,66 @@ public:
 
         JSONCONS_ASSERT(state_stack_.back().state == path_state::start);
         state_stack_.pop_back();
+        expr.steps = std::move(steps_);
     }
 
-    void end_all()
+private:
+    void push_select_step()
     {
-        for (const auto& node : stack_.back())
-        {
-            const auto& path = node.path;
-            pointer p = node.val_ptr;
-
-            if (p->is_array())
-            {
-                for (auto it = p->array_range().begin(); it != p->array_range().end(); ++it)
-                {
-                    nodes_.emplace_back(PathCons()(path,it - p->array_range().begin()),std::addressof(*it));
-                }
-            }
-            else if (p->is_object())
-            {
-                for (auto it = p->object_range().begin(); it != p->object_range().end(); ++it)
-                {
-                    nodes_.emplace_back(PathCons()(path,it->key()),std::addressof(it->value()));
-                }
-            }
-
-        }
+        steps_.emplace_back(step_kind::select, line_, column_);
+        steps_.back().selectors = std::move(selectors_);
+        selectors_.clear();
+        end_step();
     }
 
-    void apply_selectors()
+    void push_all_step(bool transfer)
     {
-        //std::cout << "apply_selectors count: " << selectors_.size() << "\n";
-        if (selectors_.size() > 0)
+        steps_.emplace_back(step_kind::all, line_, column_);
+        steps_.back().transfer = transfer;
+        if (transfer)
         {
-            for (auto& node : stack_.back())
-            {
-                //std::cout << "apply selector to:\n" << pretty_print(*(node.val_ptr)) << "\n";
-                for (auto& selector : selectors_)
-                {
-                    apply_selector(node.path, *(node.val_ptr), *selector, true);
-                }
-            }
-            selectors_.clear();
+            end_step();
         }
-        transfer_nodes();
     }
 
-    void apply_selector(const string_type& path, reference val, selector_base& selector, bool process)
+    void push_function_step(const string_type& function_name)
     {
-        if (process)
-        {
-            selector.select(*this, path, val, nodes_);
-        }
-        //std::cout << "*it: " << val << "\n";
-        //std::cout << "apply_selectors 1 done\n";
-        if (state_stack_.back().is_recursive_descent)
-        {
-            //std::cout << "is_recursive_descent\n";
-            if (val.is_object())
-            {
-                //std::cout << "is_object\n";
-                for (auto& nvp : val.object_range())
-                {
-                    if (nvp.value().is_array() || nvp.value().is_object())
-                    {                        
-                        apply_selector(PathCons()(path,nvp.key()), nvp.value(), selector, true);
-                    } 
-                }
-            }
-            else if (val.is_array())
-            {
-                //std::cout << "is_array\n";
-                auto first = val.array_range().begin();
-                auto last = val.array_range().end();
-                for (auto it = first; it != last; ++it)
-                {
-                    if (it->is_array())
-                    {
-                        apply_selector(PathCons()(path,it - first), *it,selector, true);
-                        //std::cout << "*it: " << *it << "\n";
-                    }
-                    else if (it->is_object())
-                    {
-                        apply_selector(PathCons()(path,it - first), *it, selector, !selector.is_filter());
-                    }
-                }
-            }
-        }
+        steps_.emplace_back(step_kind::function, line_, column_);
+        steps_.back().function_name = function_name;
+        steps_.back().arguments = std::move(arguments_);
+        arguments_.clear();
+    }
+
+    void end_step()
+    {
+        steps_.back().is_recursive_descent = state_stack_.back().is_recursive_descent;
+        steps_.back().is_union = state_stack_.back().is_union;
+        state_stack_.back().is_recursive_descent = false;
+        state_stack_.back().is_union = false;
     }
 
-    void transfer_nodes()
+    void push_path_argument(const string_type& path, std::error_code& ec)
     {
-        if (state_stack_.back().is_union)
+        auto expr = std::make_shared<path_expression<Json>>();
+        jsonpath_compiler<Json> compiler;
+        compiler.compile(path, *expr, ec);
+        if (!ec)
         {
-            std::set<node_type, node_less> temp(nodes_.begin(), nodes_.end());
-            stack_.push_back(std::vector<node_type>(temp.begin(),temp.end()));
+            arguments_.emplace_back(expr, Json());
         }
-        else
+    }
+
+    void push_path_selector(const string_type& path)
+    {
+        auto expr = std::make_shared<path_expression<Json>>();
+        std::error_code ec;
+        jsonpath_compiler<Json> compiler;
+        compiler.compile(path, *expr, ec);
+        if (ec)
         {
-            stack_.push_back(std::move(nodes_));
+            expr.reset();
         }
-        nodes_.clear();
-        state_stack_.back().is_recursive_descent = false;
-        state_stack_.back().is_union = false;
+        selectors_.emplace_back(path, expr);
     }
 
     void advance_past_space_character()
@@ -1801,7 +1524,799 @@ public:
     }
 };
 
-}
+template<class Json,
+         class JsonReference,
+         class PathCons>
+class jsonpath_evaluator : public ser_context
+{
+    typedef typename Json::char_type char_type;
+    typedef typename Json::char_traits_type char_traits_type;
+    typedef std::basic_string<char_type,char_traits_type> string_type;
+    typedef typename Json::string_view_type string_view_type;
+    typedef JsonReference reference;
+    using pointer = typename std::conditional<std::is_const<typename std::remove_reference<JsonReference>::type>::value,typename Json::const_pointer,typename Json::pointer>::type;
+    typedef typename Json::const_pointer const_pointer;
+
+    typedef typename PathCons::path_type path_type;
+
+    struct node_type
+    {
+        path_type path;
+        pointer val_ptr;
+
+        node_type(path_type p, pointer valp)
+            : path(p),val_ptr(valp)
+        {
+        }
+    };
+    typedef std::vector<node_type> node_set;
+
+    typedef std::vector<pointer> argument_type;
+
+    const_pointer root_;
+    PathCons path_cons_;
+    path_expression<Json> expr_;
+    node_set nodes_;
+    std::vector<node_set> stack_;
+    size_t line_;
+    size_t column_;
+    std::vector<std::unique_ptr<Json>> temp_json_values_;
+    jsonpath_options options_;
+    // Evaluators that selected nodes in parallel, kept for the temporaries
+    // and path steps the nodes refer to
+    std::vector<std::unique_ptr<jsonpath_evaluator>> workers_;
+
+public:
+    jsonpath_evaluator()
+        : root_(nullptr), line_(1), column_(1)
+    {
+    }
+
+    jsonpath_evaluator(size_t line, size_t column)
+        : root_(nullptr), line_(line), column_(column)
+    {
+    }
+
+    explicit jsonpath_evaluator(const jsonpath_options& options)
+        : root_(nullptr), line_(1), column_(1), options_(options)
+    {
+    }
+
+    size_t line() const
+    {
+        return line_;
+    }
+
+    size_t column() const
+    {
+        return column_;
+    }
+
+    Json get_values() const
+    {
+        Json result = typename Json::array();
+
+        if (stack_.size() > 0)
+        {
+            result.reserve(stack_.back().size());
+            for (const auto& p : stack_.back())
+            {
+                result.push_back(*(p.val_ptr));
+            }
+        }
+        return result;
+    }
+
+    std::vector<pointer> get_pointers() const
+    {
+        std::vector<pointer> result;
+
+        if (stack_.size() > 0)
+        {
+            result.reserve(stack_.back().size());
+            for (const auto& p : stack_.back())
+            {
+                result.push_back(p.val_ptr);
+            }
+        }
+        return result;
+    }
+
+    void call_function(const string_type& function_name, 
+                       const std::vector<argument_type>& args, 
+                       std::error_code& ec)
+    {
+        auto f = functions().get(function_name, ec);
+        if (ec)
+        {
+            return;
+        }
+        auto result = f(args, ec);
+        if (ec)
+        {
+            return;
+        }
+
+        node_set v;
+        pointer ptr = create_temp(std::move(result));
+        v.emplace_back(nullptr,ptr);
+        stack_.push_back(std::move(v));
+    }
+
+    template <typename... Args>
+    pointer create_temp(Args&& ... args)
+    {
+        auto temp = make_unique_ptr<Json>(std::forward<Args>(args)...);
+        pointer ptr = temp.get();
+        temp_json_values_.emplace_back(std::move(temp));
+        return ptr;
+    }
+
+    Json get_normalized_paths() const
+    {
+        Json result = typename Json::array();
+        if (stack_.size() > 0)
+        {
+            result.reserve(stack_.back().size());
+            for (const auto& p : stack_.back())
+            {
+                result.push_back(PathCons::to_string(p.path));
+            }
+        }
+        return result;
+    }
+
+    template <class T>
+    void replace(T&& new_value)
+    {
+        if (stack_.size() > 0)
+        {
+            for (size_t i = 0; i < stack_.back().size(); ++i)
+            {
+                *(stack_.back()[i].val_ptr) = new_value;
+            }
+        }
+    }
+
+    void evaluate(reference root, const string_view_type& path)
+    {
+        // Paths refer to names in the expression, it is kept with the results
+        jsonpath_compiler<Json> compiler(line_, column_);
+        std::error_code ec;
+        compiler.compile(path.data(), path.length(), expr_, ec);
+        line_ = compiler.line();
+        column_ = compiler.column();
+        if (!ec)
+        {
+            run(root, expr_, ec);
+        }
+        if (ec)
+        {
+            throw jsonpath_error(ec, line_, column_);
+        }
+    }
+
+    void evaluate(reference root, const string_view_type& path, std::error_code& ec)
+    {
+        try
+        {
+            jsonpath_compiler<Json> compiler(line_, column_);
+            compiler.compile(path.data(), path.length(), expr_, ec);
+            line_ = compiler.line();
+            column_ = compiler.column();
+            if (!ec)
+            {
+                run(root, expr_, ec);
+            }
+        }
+        catch (...)
+        {
+            ec = jsonpath_errc::unidentified_error;
+        }
+    }
+
+    void evaluate(reference root, const path_expression<Json>& expr)
+    {
+        std::error_code ec;
+        run(root, expr, ec);
+        if (ec)
+        {
+            throw jsonpath_error(ec, line_, column_);
+        }
+    }
+
+    void evaluate(reference root, const path_expression<Json>& expr, std::error_code& ec)
+    {
+        try
+        {
+            run(root, expr, ec);
+        }
+        catch (...)
+        {
+            ec = jsonpath_errc::unidentified_error;
+        }
+    }
+
+private:
+    static const function_table<Json,pointer>& functions()
+    {
+        static const function_table<Json,pointer> table;
+        return table;
+    }
+
+    void run(reference root, const path_expression<Json>& expr, std::error_code& ec)
+    {
+        root_ = std::addressof(root);
+
+        node_set v;
+        v.emplace_back(nullptr,std::addressof(root));
+        stack_.push_back(std::move(v));
+
+        for (const auto& step : expr.steps)
+        {
+            switch (step.kind)
+            {
+                case step_kind::select:
+                {
+                    const node_set& input = stack_.back();
+                    if (is_parallel(input.size()))
+                    {
+                        in_parallel(input.size(), nodes_, 
+                                    [&input,&step](jsonpath_evaluator& worker, size_t first, size_t last)
+                        {
+                            worker.select_step(input, first, last, step);
+                        });
+                    }
+                    else
+                    {
+                        select_step(input, 0, input.size(), step);
+                    }
+                    transfer_nodes(step.is_union);
+                    break;
+                }
+                case step_kind::all:
+                    end_all();
+                    if (step.transfer)
+                    {
+                        transfer_nodes(step.is_union);
+                    }
+                    break;
+                case step_kind::function:
+                {
+                    std::vector<argument_type> args;
+                    args.reserve(step.arguments.size());
+                    for (const auto& arg : step.arguments)
+                    {
+                        if (arg.path)
+                        {
+                            jsonpath_evaluator<Json,JsonReference,PathCons> evaluator;
+                            evaluator.evaluate(root, *arg.path, ec);
+                            if (ec)
+                            {
+                                break;
+                            }
+                            args.push_back(evaluator.get_pointers());
+                            adopt_temps(evaluator);
+                        }
+                        else
+                        {
+                            args.push_back(argument_type{create_temp(arg.value)});
+                        }
+                    }
+                    if (!ec)
+                    {
+                        call_function(step.function_name, args, ec);
+                    }
+                    if (ec)
+                    {
+                        line_ = step.line;
+                        column_ = step.column;
+                        return;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    void select_step(const node_set& input, size_t first, size_t last, const path_step<Json>& step)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            for (const auto& selector : step.selectors)
+            {
+                apply_selector(input[i].path, *(input[i].val_ptr), selector, true, step.is_recursive_descent);
+            }
+        }
+    }
+
+    bool is_parallel(size_t count) const
+    {
+        return options_.num_threads() != 1 && count >= options_.parallel_threshold();
+    }
+
+    // Splits [0,count) into ranges, calls f(worker, first, last) for each range 
+    // on the shared pool with an evaluator of its own, and appends the nodes selected 
+    // by the workers to nodes in range order, so that the result is the same 
+    // as that of a serial evaluation. Workers evaluate serially.
+    template <class F>
+    void in_parallel(size_t count, node_set& nodes, F f)
+    {
+        jsoncons::detail::worker_pool& pool = shared_worker_pool(options_.num_threads());
+        // Several ranges per thread, to even out uneven subtrees
+        const size_t num_tasks = (std::min)(count, 4*pool.size());
+        const size_t range_size = (count + num_tasks - 1) / num_tasks;
+
+        std::vector<std::unique_ptr<jsonpath_evaluator>> workers;
+        std::vector<std::exception_ptr> exceptions(num_tasks);
+        size_t remaining = num_tasks;
+        std::mutex mutex;
+        std::condition_variable cv;
+
+        for (size_t k = 0; k < num_tasks; ++k)
+        {
+            std::unique_ptr<jsonpath_evaluator> worker(new jsonpath_evaluator(line_, column_));
+            worker->root_ = root_;
+            jsonpath_evaluator* w = worker.get();
+            workers.push_back(std::move(worker));
+
+            size_t first = k*range_size;
+            size_t last = (std::min)(count, first + range_size);
+            pool.submit([w,first,last,k,&f,&exceptions,&remaining,&mutex,&cv]()
+            {
+                try
+                {
+                    f(*w, first, last);
+                }
+                catch (...)
+                {
+                    exceptions[k] = std::current_exception();
+                }
+                // Notified under the lock, the waiting thread may destroy cv
+                // as soon as it sees remaining reach zero
+                std::lock_guard<std::mutex> lock(mutex);
+                --remaining;
+                cv.notify_all();
+            });
+        }
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&remaining](){return remaining == 0;});
+        }
+
+        for (size_t k = 0; k < num_tasks; ++k)
+        {
+            if (exceptions[k])
+            {
+                std::rethrow_exception(exceptions[k]);
+            }
+            nodes.insert(nodes.end(), workers[k]->nodes_.begin(), workers[k]->nodes_.end());
+            workers[k]->nodes_.clear();
+            workers_.push_back(std::move(workers[k]));
+        }
+    }
+
+    // Keeps values created by a nested evaluation, such as a length, alive 
+    // for as long as the pointers to them
+    void adopt_temps(jsonpath_evaluator& evaluator)
+    {
+        temp_json_values_.insert(temp_json_values_.end(),
+                                 std::make_move_iterator(evaluator.temp_json_values_.begin()),
+                                 std::make_move_iterator(evaluator.temp_json_values_.end()));
+        evaluator.temp_json_values_.clear();
+    }
+
+    void select(path_type path, reference val,
+                const path_selector<Json>& selector,
+                node_set& nodes)
+    {
+        switch (selector.kind)
+        {
+            case selector_kind::name:
+                select_name(selector.name, path, val, nodes);
+                break;
+            case selector_kind::array_slice:
+                if (selector.slice.is_step_positive)
+                {
+                    end_array_slice1(selector.slice, path, val, nodes);
+                }
+                else
+                {
+                    end_array_slice2(selector.slice, path, val, nodes);
+                }
+                break;
+            case selector_kind::expr:
+            {
+                auto index = selector.expr.eval(val, *root_);
+                if (index.template is<size_t>())
+                {
+                    size_t start = index.template as<size_t>();
+                    if (val.is_array() && start < val.size())
+                    {
+                        nodes.emplace_back(path_cons_(path,start),std::addressof(val[start]));
+                    }
+                }
+                else if (index.is_string())
+                {
+                    // The name is kept for as long as the paths that refer to it
+                    pointer name = create_temp(std::move(index));
+                    select_name(name->as_string_view(), path, val, nodes);
+                }
+                break;
+            }
+            case selector_kind::filter:
+                if (val.is_array())
+                {
+                    auto expr = selector.expr.bind_root(*root_);
+                    if (is_parallel(val.size()))
+                    {
+                        in_parallel(val.size(), nodes, 
+                                    [&expr,path,&val](jsonpath_evaluator& worker, size_t first, size_t last)
+                        {
+                            worker.filter_elements(expr, path, val, first, last, worker.nodes_);
+                        });
+                    }
+                    else
+                    {
+                        filter_elements(expr, path, val, 0, val.size(), nodes);
+                    }
+                }
+                else if (val.is_object())
+                {
+                    if (selector.expr.exists(val, *root_))
+                    {
+                        nodes.emplace_back(path, std::addressof(val));
+                    }
+                }
+                break;
+            case selector_kind::path:
+                if (selector.path)
+                {
+                    std::error_code ec;
+                    jsonpath_evaluator<Json,JsonReference,PathCons> e;
+                    e.evaluate(val, *selector.path, ec);
+                    if (!ec)
+                    {
+                        for (auto ptr : e.get_pointers())
+                        {
+                            nodes.emplace_back(path_cons_(path,selector.name),ptr);
+                        }
+                        adopt_temps(e);
+                    }
+                }
+                break;
+        }
+    }
+
+    void filter_elements(const jsonpath_filter_expr<Json>& expr, path_type path, reference val, 
+                         size_t first, size_t last, node_set& nodes)
+    {
+        for (size_t i = first; i < last; ++i)
+        {
+            if (expr.exists(val[i], *root_))
+            {
+                nodes.emplace_back(path_cons_(path,i),std::addressof(val[i]));
+            }
+        }
+    }
+
+    void select_name(const string_view_type& name, 
+                     path_type path, reference val,
+                     node_set& nodes)
+    {
+        bool is_start_positive = true;
+
+        if (val.is_object() && val.contains(name))
+        {
+            nodes.emplace_back(path_cons_(path,name),std::addressof(val.at(name)));
+        }
+        else if (val.is_array())
+        {
+            size_t pos = 0;
+            if (try_string_to_index(name.data(), name.size(), &pos, &is_start_positive))
+            {
+                size_t index = is_start_positive ? pos : val.size() - pos;
+                if (index < val.size())
+                {
+                    nodes.emplace_back(path_cons_(path,index),std::addressof(val[index]));
+                }
+            }
+            else if (name == length_literal<char_type>() && val.size() > 0)
+            {
+                pointer ptr = create_temp(val.size());
+                nodes.emplace_back(path_cons_(path, name), ptr);
+            }
+        }
+        else if (val.is_string())
+        {
+            size_t pos = 0;
+            string_view_type sv = val.as_string_view();
+            if (try_string_to_index(name.data(), name.size(), &pos, &is_start_positive))
+            {
+                size_t index = is_start_positive ? pos : sv.size() - pos;
+                auto sequence = unicons::sequence_at(sv.data(), sv.data() + sv.size(), index);
+                if (sequence.length() > 0)
+                {
+                    pointer ptr = create_temp(sequence.begin(),sequence.length());
+                    nodes.emplace_back(path_cons_(path, index), ptr);
+                }
+            }
+            else if (name == length_literal<char_type>() && sv.size() > 0)
+            {
+                size_t count = unicons::u32_length(sv.begin(),sv.end());
+                pointer ptr = create_temp(count);
+                nodes.emplace_back(path_cons_(path, name), ptr);
+            }
+        }
+    }
+
+    void end_array_slice1(const array_slice& slice, path_type path, reference val, node_set& nodes)
+    {
+        if (val.is_array())
+        {
+            size_t start = slice.get_start(val.size());
+            size_t end = slice.get_end(val.size());
+            for (size_t j = start; j < end; j += slice.step())
+            {
+                if (j < val.size())
+                {
+                    nodes.emplace_back(path_cons_(path,j),std::addressof(val[j]));
+                }
+            }
+        }
+    }
+
+    void end_array_slice2(const array_slice& slice, path_type path, reference val, node_set& nodes)
+    {
+        if (val.is_array())
+        {
+            size_t start = slice.get_start(val.size());
+            size_t end = slice.get_end(val.size());
+
+            size_t j = end + slice.step() - 1;
+            while (j > (start+slice.step()-1))
+            {
+                j -= slice.step();
+                if (j < val.size())
+                {
+                    nodes.emplace_back(path_cons_(path,j),std::addressof(val[j]));
+                }
+            }
+        }
+    }
+
+    void end_all()
+    {
+        for (const auto& node : stack_.back())
+        {
+            path_type path = node.path;
+            pointer p = node.val_ptr;
+
+            if (p->is_array())
+            {
+                for (auto it = p->array_range().begin(); it != p->array_range().end(); ++it)
+                {
+                    nodes_.emplace_back(path_cons_(path,it - p->array_range().begin()),std::addressof(*it));
+                }
+            }
+            else if (p->is_object())
+            {
+                for (auto it = p->object_range().begin(); it != p->object_range().end(); ++it)
+                {
+                    nodes_.emplace_back(path_cons_(path,it->key()),std::addressof(it->value()));
+                }
+            }
+
+        }
+    }
+
+    void apply_selector(path_type path, reference val, const path_selector<Json>& selector, 
+                        bool process, bool is_recursive_descent)
+    {
+        if (process)
+        {
+            select(path, val, selector, nodes_);
+        }
+        if (is_recursive_descent && (val.is_object() || val.is_array()))
+        {
+            size_t count = val.size();
+            if (is_parallel(count))
+            {
+                in_parallel(count, nodes_, 
+                            [path,&val,&selector](jsonpath_evaluator& worker, size_t first, size_t last)
+                {
+                    worker.descend(path, val, selector, first, last);
+                });
+            }
+            else
+            {
+                descend(path, val, selector, 0, count);
+            }
+        }
+    }
+
+    // Applies selector recursively to the elements or members of val in [first,last)
+    void descend(path_type path, reference val, const path_selector<Json>& selector, 
+                 size_t first, size_t last)
+    {
+        if (val.is_object())
+        {
+            auto it = val.object_range().begin();
+            std::advance(it, first);
+            for (size_t i = first; i < last; ++i, ++it)
+            {
+                if (it->value().is_array() || it->value().is_object())
+                {                        
+                    apply_selector(path_cons_(path,it->key()), it->value(), selector, true, true);
+                } 
+            }
+        }
+        else if (val.is_array())
+        {
+            auto it = val.array_range().begin();
+            std::advance(it, first);
+            for (size_t i = first; i < last; ++i, ++it)
+            {
+                if (it->is_array())
+                {
+                    apply_selector(path_cons_(path,i), *it,selector, true, true);
+                }
+                else if (it->is_object())
+                {
+                    apply_selector(path_cons_(path,i), *it, selector, selector.kind != selector_kind::filter, true);
+                }
+            }
+        }
+    }
+
+    // Orders nodes by a pre-order walk of the root that stops once all of them
+    // have been seen. Values that are not in the document, such as the result
+    // of a function, follow in the order selected.
+    void sort_in_document_order(node_set& nodes) const
+    {
+        if (nodes.size() < 2)
+        {
+            return;
+        }
+        const size_t not_found = (std::numeric_limits<size_t>::max)();
+        std::unordered_map<const_pointer,size_t> positions;
+        positions.reserve(nodes.size());
+        for (const auto& node : nodes)
+        {
+            positions.emplace(node.val_ptr, not_found);
+        }
+
+        size_t remaining = positions.size();
+        size_t position = 0;
+        std::vector<const_pointer> stack;
+        stack.push_back(root_);
+        while (!stack.empty() && remaining > 0)
+        {
+            const_pointer val = stack.back();
+            stack.pop_back();
+            auto it = positions.find(val);
+            if (it != positions.end())
+            {
+                it->second = position;
+                --remaining;
+            }
+            ++position;
+            if (val->is_array())
+            {
+                for (size_t i = val->size(); i-- > 0;)
+                {
+                    stack.push_back(std::addressof(val->at(i)));
+                }
+            }
+            else if (val->is_object())
+            {
+                auto range = val->object_range();
+                size_t first = stack.size();
+                for (const auto& member : range)
+                {
+                    stack.push_back(std::addressof(member.value()));
+                }
+                std::reverse(stack.begin() + first, stack.end());
+            }
+        }
+
+        std::stable_sort(nodes.begin(), nodes.end(), 
+                         [&positions](const node_type& a, const node_type& b)
+                         {
+                             return positions.find(a.val_ptr)->second < positions.find(b.val_ptr)->second;
+                         });
+    }
+
+    void transfer_nodes(bool is_union)
+    {
+        if (is_union)
+        {
+            // A node selected by more than one selector of a union is kept once,
+            // nodes are the same if they refer to the same value, distinct values
+            // that compare equal are all kept, in document order
+            std::unordered_set<const_pointer> seen;
+            seen.reserve(nodes_.size());
+            node_set temp;
+            temp.reserve(nodes_.size());
+            for (auto& node : nodes_)
+            {
+                if (seen.insert(node.val_ptr).second)
+                {
+                    temp.push_back(std::move(node));
+                }
+            }
+            sort_in_document_order(temp);
+            stack_.push_back(std::move(temp));
+        }
+        else
+        {
+            stack_.push_back(std::move(nodes_));
+        }
+        nodes_.clear();
+    }
+};
+
+}
+
+template <class Json>
+class jsonpath_expression
+{
+public:
+    typedef typename Json::string_view_type string_view_type;
+private:
+    detail::path_expression<Json> expr_;
+
+    jsonpath_expression(detail::path_expression<Json>&& expr)
+        : expr_(std::move(expr))
+    {
+    }
+public:
+    jsonpath_expression(const jsonpath_expression&) = default;
+    jsonpath_expression(jsonpath_expression&&) = default;
+    jsonpath_expression& operator=(const jsonpath_expression&) = default;
+    jsonpath_expression& operator=(jsonpath_expression&&) = default;
+
+    static jsonpath_expression compile(const string_view_type& path)
+    {
+        detail::path_expression<Json> expr;
+        detail::jsonpath_compiler<Json> compiler;
+        compiler.compile(path, expr);
+        return jsonpath_expression(std::move(expr));
+    }
+
+    static jsonpath_expression compile(const string_view_type& path, std::error_code& ec)
+    {
+        detail::path_expression<Json> expr;
+        detail::jsonpath_compiler<Json> compiler;
+        compiler.compile(path, expr, ec);
+        return jsonpath_expression(std::move(expr));
+    }
+
+    Json evaluate(const Json& root, result_type result_t = result_type::value,
+                  const jsonpath_options& options = jsonpath_options()) const
+    {
+        if (result_t == result_type::value)
+        {
+            detail::jsonpath_evaluator<Json,const Json&,detail::VoidPathConstructor<Json>> evaluator(options);
+            evaluator.evaluate(root, expr_);
+            return evaluator.get_values();
+        }
+        else
+        {
+            detail::jsonpath_evaluator<Json,const Json&,detail::PathConstructor<Json>> evaluator(options);
+            evaluator.evaluate(root, expr_);
+            return evaluator.get_normalized_paths();
+        }
+    }
+
+    template <class T>
+    void replace(Json& root, T&& new_value) const
+    {
+        detail::jsonpath_evaluator<Json,Json&,detail::VoidPathConstructor<Json>> evaluator;
+        evaluator.evaluate(root, expr_);
+        evaluator.replace(std::forward<T>(new_value));
+    }
+};
 
 }}
 
@@ -0,0 +1,637 @@
+// Copyright 2019 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSONPATH_JSON_QUERY_DECODER_HPP
+#define JSONCONS_JSONPATH_JSON_QUERY_DECODER_HPP
+
+#include <string>
+#include <vector>
+#include <memory> // std::unique_ptr, std::shared_ptr
+#include <istream> // std::basic_istream
+#include <utility> // std::move
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_content_handler.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/staj_reader.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+#include <jsoncons_ext/jsonpath/jsonpath_error.hpp>
+
+namespace jsoncons { namespace jsonpath {
+
+namespace detail {
+
+// A step of a path that can be taken while the document is read:
+// selects children by name, index, slice or wildcard, or, if filter
+// is set, tests nodes that are then searched with the rest of the path
+
+template <class Json>
+struct stream_segment
+{
+    typedef typename Json::char_type char_type;
+    typedef typename Json::char_traits_type char_traits_type;
+    typedef std::basic_string<char_type,char_traits_type> string_type;
+
+    bool is_recursive_descent;
+    bool is_wildcard;
+    bool is_filter;
+    std::vector<string_type> names;
+    std::vector<array_slice> slices;
+    jsonpath_filter_expr<Json> filter;
+    std::shared_ptr<const path_expression<Json>> rest;
+
+    stream_segment()
+        : is_recursive_descent(false), is_wildcard(false), is_filter(false)
+    {
+    }
+
+    bool matches(const string_type& name) const
+    {
+        if (is_wildcard)
+        {
+            return true;
+        }
+        for (const auto& s : names)
+        {
+            if (s == name)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool matches(size_t index) const
+    {
+        if (is_wildcard)
+        {
+            return true;
+        }
+        for (const auto& s : names)
+        {
+            size_t pos = 0;
+            bool is_positive = true;
+            if (try_string_to_index(s.data(), s.size(), &pos, &is_positive) && pos == index)
+            {
+                return true;
+            }
+        }
+        for (const auto& slice : slices)
+        {
+            if (index >= slice.start_ && (!slice.is_end_defined || index < slice.end_) && (index - slice.start_) % slice.step() == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Converts compiled steps to stream segments, or fails with
+// unsupported_stream_selector if a step needs more than the nodes on
+// the way to a value, e.g. a negative index needs the size of the array
+
+template <class Json>
+void make_stream_segments(const path_expression<Json>& expr,
+                          std::vector<stream_segment<Json>>& segments,
+                          std::error_code& ec)
+{
+    bool is_wildcard = false;
+    for (auto it = expr.steps.begin(); it != expr.steps.end(); ++it)
+    {
+        const auto& step = *it;
+        switch (step.kind)
+        {
+            case step_kind::all:
+                if (!step.transfer)
+                {
+                    is_wildcard = true;
+                }
+                else
+                {
+                    stream_segment<Json> segment;
+                    segment.is_recursive_descent = step.is_recursive_descent;
+                    segment.is_wildcard = true;
+                    segments.push_back(std::move(segment));
+                }
+                break;
+            case step_kind::select:
+            {
+                stream_segment<Json> segment;
+                segment.is_recursive_descent = step.is_recursive_descent;
+                segment.is_wildcard = is_wildcard;
+                is_wildcard = false;
+                for (const auto& selector : step.selectors)
+                {
+                    switch (selector.kind)
+                    {
+                        case selector_kind::name:
+                        {
+                            size_t pos = 0;
+                            bool is_positive = true;
+                            if (try_string_to_index(selector.name.data(), selector.name.size(), &pos, &is_positive) && !is_positive)
+                            {
+                                ec = jsonpath_errc::unsupported_stream_selector;
+                                return;
+                            }
+                            segment.names.push_back(selector.name);
+                            break;
+                        }
+                        case selector_kind::array_slice:
+                            if (!selector.slice.is_start_positive || !selector.slice.is_end_positive || !selector.slice.is_step_positive)
+                            {
+                                ec = jsonpath_errc::unsupported_stream_selector;
+                                return;
+                            }
+                            segment.slices.push_back(selector.slice);
+                            break;
+                        case selector_kind::filter:
+                        {
+                            // $ in a filter is the document root, which is not 
+                            // available while the document is read
+                            if (step.selectors.size() != 1 || segment.is_wildcard || selector.expr.has_root_path())
+                            {
+                                ec = jsonpath_errc::unsupported_stream_selector;
+                                return;
+                            }
+                            segment.is_filter = true;
+                            segment.filter = selector.expr;
+                            auto rest = std::make_shared<path_expression<Json>>();
+                            rest->steps.assign(it + 1, expr.steps.end());
+                            segment.rest = rest;
+                            segments.push_back(std::move(segment));
+                            return;
+                        }
+                        default:
+                            ec = jsonpath_errc::unsupported_stream_selector;
+                            return;
+                    }
+                }
+                segments.push_back(std::move(segment));
+                break;
+            }
+            default:
+                ec = jsonpath_errc::unsupported_stream_selector;
+                return;
+        }
+    }
+}
+
+}
+
+template <class Json>
+class json_query_decoder final : public basic_json_content_handler<typename Json::char_type>
+{
+public:
+    typedef typename Json::char_type char_type;
+    typedef typename Json::char_traits_type char_traits_type;
+    typedef std::basic_string<char_type,char_traits_type> string_type;
+    using typename basic_json_content_handler<char_type>::string_view_type;
+private:
+    // An array or object being read, states are the segments
+    // to apply to its children
+    struct frame
+    {
+        bool is_object;
+        size_t index;
+        std::vector<size_t> states;
+
+        frame(bool is_object, std::vector<size_t>&& states)
+            : is_object(is_object), index(0), states(std::move(states))
+        {
+        }
+    };
+
+    // A value being materialized, for each consumer a result slot and
+    // the filter segment to test it with, if any
+    struct consumer
+    {
+        size_t slot;
+        size_t filter;
+    };
+
+    struct capture
+    {
+        size_t depth;
+        std::unique_ptr<json_decoder<Json>> decoder;
+        std::vector<consumer> consumers;
+
+        capture(size_t depth)
+            : depth(depth), decoder(new json_decoder<Json>())
+        {
+        }
+    };
+
+    static const size_t npos = (size_t)-1;
+
+    std::vector<detail::stream_segment<Json>> segments_;
+    std::vector<frame> frames_;
+    std::vector<capture> captures_;
+    std::vector<Json> slots_;
+    string_type name_;
+    std::vector<size_t> child_states_;
+    bool done_;
+public:
+    json_query_decoder(const string_view_type& path)
+        : done_(false)
+    {
+        detail::path_expression<Json> expr;
+        detail::jsonpath_compiler<Json> compiler;
+        compiler.compile(path, expr);
+
+        std::error_code ec;
+        detail::make_stream_segments(expr, segments_, ec);
+        if (ec)
+        {
+            JSONCONS_THROW(jsonpath_error(ec));
+        }
+    }
+
+    json_query_decoder(const json_query_decoder&) = delete;
+    json_query_decoder& operator=(const json_query_decoder&) = delete;
+
+    // Returns an array of the values selected, in document order
+    Json get_result()
+    {
+        Json result = typename Json::array();
+        for (auto& slot : slots_)
+        {
+            if (slot.is_array())
+            {
+                for (auto& val : slot.array_range())
+                {
+                    result.push_back(std::move(val));
+                }
+            }
+        }
+        slots_.clear();
+        done_ = false;
+        return result;
+    }
+
+private:
+    void begin_value(bool is_object, bool is_container)
+    {
+        child_states_.clear();
+        bool is_match = false;
+        size_t num_consumers = 0;
+
+        if (frames_.empty())
+        {
+            if (segments_.empty())
+            {
+                is_match = true;
+            }
+            else
+            {
+                child_states_.push_back(0);
+            }
+        }
+        else
+        {
+            frame& parent = frames_.back();
+            for (size_t i : parent.states)
+            {
+                const auto& segment = segments_[i];
+                if (segment.is_recursive_descent && is_container)
+                {
+                    add_state(i);
+                }
+                if (segment.is_filter)
+                {
+                    // Elements of an array are tested by the filter
+                    if (!parent.is_object)
+                    {
+                        add_consumer(i, num_consumers);
+                    }
+                }
+                else if (parent.is_object ? segment.matches(name_) : segment.matches(parent.index))
+                {
+                    if (i+1 == segments_.size())
+                    {
+                        is_match = true;
+                    }
+                    else if (is_container)
+                    {
+                        add_state(i+1);
+                    }
+                }
+            }
+            if (!parent.is_object)
+            {
+                ++parent.index;
+            }
+        }
+
+        // An object is tested by the filter itself
+        if (is_object)
+        {
+            for (size_t i : child_states_)
+            {
+                if (segments_[i].is_filter)
+                {
+                    add_consumer(i, num_consumers);
+                }
+            }
+        }
+        if (is_match)
+        {
+            add_consumer(npos, num_consumers);
+        }
+        if (is_container)
+        {
+            frames_.emplace_back(is_object, std::move(child_states_));
+            child_states_ = std::vector<size_t>();
+        }
+    }
+
+    void add_state(size_t i)
+    {
+        for (size_t j : child_states_)
+        {
+            if (j == i)
+            {
+                return;
+            }
+        }
+        child_states_.push_back(i);
+    }
+
+    void add_consumer(size_t filter, size_t& num_consumers)
+    {
+        if (num_consumers == 0)
+        {
+            captures_.emplace_back(frames_.size());
+        }
+        auto& consumers = captures_.back().consumers;
+        for (const auto& c : consumers)
+        {
+            if (c.filter == filter)
+            {
+                return;
+            }
+        }
+        consumers.push_back(consumer{slots_.size(), filter});
+        slots_.emplace_back(); // null until the value is read
+        ++num_consumers;
+    }
+
+    void end_value()
+    {
+        while (!captures_.empty() && captures_.back().depth == frames_.size())
+        {
+            capture c = std::move(captures_.back());
+            captures_.pop_back();
+
+            Json val = c.decoder->get_result();
+            for (const auto& consumer : c.consumers)
+            {
+                Json result = typename Json::array();
+                if (consumer.filter == npos)
+                {
+                    result.push_back(val);
+                }
+                else
+                {
+                    const auto& segment = segments_[consumer.filter];
+                    if (segment.filter.exists(val, val))
+                    {
+                        detail::jsonpath_evaluator<Json,const Json&,detail::VoidPathConstructor<Json>> evaluator;
+                        evaluator.evaluate(val, *segment.rest);
+                        result = evaluator.get_values();
+                    }
+                }
+                slots_[consumer.slot] = std::move(result);
+            }
+            // Results are kept in document order, by the slot taken when a value 
+            // begins. Slots after this value's first one are its own and those of 
+            // values inside it, all read now, so the empty ones at the end, e.g. 
+            // for array elements a filter rejected, can be dropped
+            const size_t first_slot = c.consumers.front().slot;
+            while (slots_.size() > first_slot && slots_.back().empty())
+            {
+                slots_.pop_back();
+            }
+        }
+        // Events following the top level value, e.g. the rest of a document
+        // when reading from a staj reader positioned inside it, are ignored
+        done_ = frames_.empty();
+    }
+
+    void end_container()
+    {
+        frames_.pop_back();
+        end_value();
+    }
+
+    void do_flush() override
+    {
+    }
+
+    bool do_begin_object(semantic_tag tag, const ser_context& context) override
+    {
+        if (done_)
+        {
+            return true;
+        }
+        begin_value(true, true);
+        for (auto& c : captures_)
+        {
+            c.decoder->begin_object(tag, context);
+        }
+        return true;
+    }
+
+    bool do_end_object(const ser_context& context) override
+    {
+        if (done_)
+        {
+            return true;
+        }
+        for (auto& c : captures_)
+        {
+            c.decoder->end_object(context);
+        }
+        end_container();
+        return true;
+    }
+
+    bool do_begin_array(semantic_tag tag, const ser_context& context) override
+    {
+        if (done_)
+        {
+            return true;
+        }
+        begin_value(false, true);
+        for (auto& c : captures_)
+        {
+            c.decoder->begin_array(tag, context);
+        }
+        return true;
+    }
+
+    bool do_end_array(const ser_context& context) override
+    {
+        if (done_)
+        {
+            return true;
+        }
+        for (auto& c : captures_)
+        {
+            c.decoder->end_array(context);
+        }
+        end_container();
+        return true;
+    }
+
+    bool do_name(const string_view_type& name, const ser_context& context) override
+    {
+        if (done_)
+        {
+            return true;
+        }
+        if (!frames_.back().states.empty())
+        {
+            name_.assign(name.data(), name.size());
+        }
+        for (auto& c : captures_)
+        {
+            c.decoder->name(name, context);
+        }
+        return true;
+    }
+
+    bool do_string_value(const string_view_type& sv, semantic_tag tag, const ser_context& context) override
+    {
+        if (done_)
+        {
+            return true;
+        }
+        begin_value(false, false);
+        for (auto& c : captures_)
+        {
+            c.decoder->string_value(sv, tag, context);
+        }
+        end_value();
+        return true;
+    }
+
+    bool do_byte_string_value(const byte_string_view& b, semantic_tag tag, const ser_context& context) override
+    {
+        if (done_)
+        {
+            return true;
+        }
+        begin_value(false, false);
+        for (auto& c : captures_)
+        {
+            c.decoder->byte_string_value(b, tag, context);
+        }
+        end_value();
+        return true;
+    }
+
+    bool do_int64_value(int64_t value, semantic_tag tag, const ser_context& context) override
+    {
+        if (done_)
+        {
+            return true;
+        }
+        begin_value(false, false);
+        for (auto& c : captures_)
+        {
+            c.decoder->int64_value(value, tag, context);
+        }
+        end_value();
+        return true;
+    }
+
+    bool do_uint64_value(uint64_t value, semantic_tag tag, const ser_context& context) override
+    {
+        if (done_)
+        {
+            return true;
+        }
+        begin_value(false, false);
+        for (auto& c : captures_)
+        {
+            c.decoder->uint64_value(value, tag, context);
+        }
+        end_value();
+        return true;
+    }
+
+    bool do_double_value(double value, semantic_tag tag, const ser_context& context) override
+    {
+        if (done_)
+        {
+            return true;
+        }
+        begin_value(false, false);
+        for (auto& c : captures_)
+        {
+            c.decoder->double_value(value, tag, context);
+        }
+        end_value();
+        return true;
+    }
+
+    bool do_bool_value(bool value, semantic_tag tag, const ser_context& context) override
+    {
+        if (done_)
+        {
+            return true;
+        }
+        begin_value(false, false);
+        for (auto& c : captures_)
+        {
+            c.decoder->bool_value(value, tag, context);
+        }
+        end_value();
+        return true;
+    }
+
+    bool do_null_value(semantic_tag tag, const ser_context& context) override
+    {
+        if (done_)
+        {
+            return true;
+        }
+        begin_value(false, false);
+        for (auto& c : captures_)
+        {
+            c.decoder->null_value(tag, context);
+        }
+        end_value();
+        return true;
+    }
+};
+
+template <class Json>
+Json decode_json_query(std::basic_istream<typename Json::char_type>& is,
+                       const typename Json::string_view_type& path,
+                       const basic_json_decode_options<typename Json::char_type>& options = basic_json_options<typename Json::char_type>::default_options())
+{
+    typedef typename Json::char_type char_type;
+
+    json_query_decoder<Json> decoder(path);
+    basic_json_reader<char_type,stream_source<char_type>> reader(is, decoder, options);
+    reader.read();
+    return decoder.get_result();
+}
+
+template <class Json>
+Json decode_json_query(basic_staj_reader<typename Json::char_type>& reader,
+                       const typename Json::string_view_type& path)
+{
+    json_query_decoder<Json> decoder(path);
+    reader.accept(decoder);
+    return decoder.get_result();
+}
+
+}}
+
+#endif
@@ -108,7 +108,8 @@ enum class jsonpath_errc
     parse_error_in_filter,
     argument_parse_error,
     unidentified_error,
-    unexpected_end_of_input
+    unexpected_end_of_input,
+    unsupported_stream_selector
 };
 
 class jsonpath_error_category_impl
@@ -175,6 +176,8 @@ public:
                 return "Unidentified error";
             case jsonpath_errc::unexpected_end_of_input:
                 return "Unexpected end of jsonpath input";
+            case jsonpath_errc::unsupported_stream_selector:
+                return "Selector not supported when querying a stream of events";
             default:
                 return "Unknown jsonpath parser error";
         }
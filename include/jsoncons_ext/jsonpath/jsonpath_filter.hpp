@@ -10,6 +10,7 @@
 #include <string>
 #include <map> // std::map
 #include <vector>
+#include <deque> // std::deque
 #include <memory>
 #include <regex>
 #include <functional>
@@ -34,59 +35,102 @@ JSONCONS_STRING_LITERAL(ne,'!', '=')
 JSONCONS_STRING_LITERAL(ampamp,'&','&')
 JSONCONS_STRING_LITERAL(pipepipe,'|','|')
 
+// A step in a normalized path. The path of a node is the chain of steps
+// back to the root, nodes below a node share its steps. Names refer to
+// member names in the document or names in the compiled expression.
 template<class Json>
-struct PathConstructor
+struct path_component
 {
+    typedef typename Json::string_view_type string_view_type;
+
+    const path_component* parent;
+    string_view_type name;
+    size_t index;
+    bool is_index;
+};
+
+// Builds normalized paths. Steps are appended to a chain and only
+// converted to strings for the nodes in the result.
+template<class Json>
+class PathConstructor
+{
+public:
     typedef typename Json::char_type char_type;
     typedef typename Json::string_view_type string_view_type;
     typedef typename Json::string_type string_type;
+    typedef const path_component<Json>* path_type;
+private:
+    std::deque<path_component<Json>> components_;
+public:
+    path_type operator()(path_type parent, size_t index)
+    {
+        components_.push_back(path_component<Json>{parent, string_view_type(), index, true});
+        return &components_.back();
+    }
 
-    string_type operator()(const string_type& path, size_t index) const
+    path_type operator()(path_type parent, const string_view_type& sv)
     {
-        char_type buf[255];
-        char_type* p = buf;
-        do
-        {
-            *p++ = static_cast<char_type>(48 + index % 10);
-        } while (index /= 10);
+        components_.push_back(path_component<Json>{parent, sv, 0, false});
+        return &components_.back();
+    }
 
-        string_type s;
-        s.append(path);
-        s.push_back('[');
-        while (--p >= buf)
+    static string_type to_string(path_type path)
+    {
+        std::vector<path_type> steps;
+        for (path_type p = path; p != nullptr; p = p->parent)
         {
-            s.push_back(*p);
+            steps.push_back(p);
         }
-        s.push_back(']');
-        return s;
-    }
 
-    string_type operator()(const string_type& path, const string_view_type& sv) const
-    {
-        string_type s;
-        s.append(path);
-        s.push_back('[');
-        s.push_back('\'');
-        s.append(sv.data(),sv.length());
-        s.push_back('\'');
-        s.push_back(']');
+        string_type s = {'$'};
+        for (auto it = steps.rbegin(); it != steps.rend(); ++it)
+        {
+            s.push_back('[');
+            if ((*it)->is_index)
+            {
+                char_type buf[255];
+                char_type* p = buf;
+                size_t index = (*it)->index;
+                do
+                {
+                    *p++ = static_cast<char_type>(48 + index % 10);
+                } while (index /= 10);
+                while (--p >= buf)
+                {
+                    s.push_back(*p);
+                }
+            }
+            else
+            {
+                s.push_back('\'');
+                s.append((*it)->name.data(),(*it)->name.length());
+                s.push_back('\'');
+            }
+            s.push_back(']');
+        }
         return s;
     }
 };
 
+// Used when only values are wanted, no paths are built
 template<class Json>
 struct VoidPathConstructor
 {
-    typedef typename Json::char_type char_type;
     typedef typename Json::string_view_type string_view_type;
     typedef typename Json::string_type string_type;
+    typedef const path_component<Json>* path_type;
 
-    string_type operator()(const string_type&, size_t) const
+    path_type operator()(path_type, size_t) const
     {
-        return string_type{};
+        return nullptr;
     }
 
-    string_type operator()(const string_type&, string_view_type) const
+    path_type operator()(path_type, const string_view_type&) const
+    {
+        return nullptr;
+    }
+
+    static string_type to_string(path_type)
     {
         return string_type{};
     }
@@ -97,6 +141,12 @@ template <class Json,
           class PathCons>
 class jsonpath_evaluator;
 
+template <class Json>
+class jsonpath_compiler;
+
+template <class Json>
+struct path_expression;
+
 enum class filter_path_mode
 {
     path,
@@ -145,7 +195,25 @@ public:
 
     virtual ~term() {}
 
-    virtual void initialize(const Json&) = 0;
+    // Returns the term evaluated against the current node and root, 
+    // or null if the term does not depend on them
+    virtual std::shared_ptr<term<Json>> bind(const Json&, const Json&) const
+    {
+        return nullptr;
+    }
+
+    // Returns the term evaluated against the root,
+    // or null if the term does not depend on it
+    virtual std::shared_ptr<term<Json>> bind_root(const Json&) const
+    {
+        return nullptr;
+    }
+
+    // True if the term is a path from the root, $
+    virtual bool is_root_path() const
+    {
+        return false;
+    }
 
     virtual bool accept_single_node() const
     {
@@ -323,12 +391,12 @@ public:
         return type_;
     }
 
-    Json operator()(const term<Json>& a)
+    Json operator()(const term<Json>& a) const
     {
         return unary_operator_(a);
     }
 
-    Json operator()(const term<Json>& a, const term<Json>& b)
+    Json operator()(const term<Json>& a, const term<Json>& b) const
     {
         return operator_(a,b);
     }
@@ -375,18 +443,41 @@ public:
         return is_right_associative_;
     }
 
-    const term<Json>& operand()
+    const term<Json>& operand() const
     {
         JSONCONS_ASSERT(type_ == token_type::operand && operand_ptr_ != nullptr);
         return *operand_ptr_;
     }
 
-    void initialize(const Json& current_node)
+    token<Json> bind(const Json& current_node, const Json& root) const
     {
         if (operand_ptr_.get() != nullptr)
         {
-            operand_ptr_->initialize(current_node);
+            auto ptr = operand_ptr_->bind(current_node, root);
+            if (ptr != nullptr)
+            {
+                return token<Json>(token_type::operand, ptr);
+            }
         }
+        return *this;
+    }
+
+    bool is_root_path() const
+    {
+        return operand_ptr_.get() != nullptr && operand_ptr_->is_root_path();
+    }
+
+    token<Json> bind_root(const Json& root) const
+    {
+        if (operand_ptr_.get() != nullptr)
+        {
+            auto ptr = operand_ptr_->bind_root(root);
+            if (ptr != nullptr)
+            {
+                return token<Json>(token_type::operand, ptr);
+            }
+        }
+        return *this;
     }
 };
 
@@ -536,10 +627,6 @@ public:
     {
     }
 
-    void initialize(const Json&) override
-    {
-    }
-
     bool accept_single_node() const override
     {
         return value_.as_bool();
@@ -677,10 +764,6 @@ public:
     {
     }
 
-    void initialize(const Json&) override
-    {
-    }
-
     bool regex2(const string_type& subject) const override
     {
         return std::regex_match(subject, pattern_);
@@ -692,21 +775,61 @@ class path_term final : public term<Json>
 {
     typedef typename Json::string_type string_type;
 
-    string_type path_;
+    std::shared_ptr<const path_expression<Json>> expr_;
+    bool is_root_path_;
     size_t line_;
     size_t column_;
     Json nodes_;
 public:
-    path_term(const string_type& path, size_t line, size_t column)
-        : path_(path), line_(line), column_(column)
+    path_term(const string_type& path, size_t line, size_t column, bool is_root_path = false)
+        : is_root_path_(is_root_path), line_(line), column_(column)
     {
+        auto expr = std::make_shared<path_expression<Json>>();
+        jsonpath_compiler<Json> compiler(line,column);
+        compiler.compile(path, *expr);
+        expr_ = expr;
     }
 
-    void initialize(const Json& current_node) override
+    explicit path_term(Json&& nodes)
+        : is_root_path_(false), line_(1), column_(1), nodes_(std::move(nodes))
     {
+    }
+
+    std::shared_ptr<term<Json>> bind(const Json& current_node, const Json& root) const override
+    {
+        if (expr_ == nullptr)
+        {
+            return nullptr;
+        }
+        if (is_root_path_)
+        {
+            return bind_root(root);
+        }
+        jsonpath_evaluator<Json,const Json&,VoidPathConstructor<Json>> evaluator(line_,column_);
+        evaluator.evaluate(current_node, *expr_);
+        return std::make_shared<path_term<Json>>(evaluator.get_values());
+    }
+
+    // A root path stands for its first value
+    std::shared_ptr<term<Json>> bind_root(const Json& root) const override
+    {
+        if (expr_ == nullptr || !is_root_path_)
+        {
+            return nullptr;
+        }
         jsonpath_evaluator<Json,const Json&,VoidPathConstructor<Json>> evaluator(line_,column_);
-        evaluator.evaluate(current_node, path_);
-        nodes_ = evaluator.get_values();
+        evaluator.evaluate(root, *expr_);
+        auto result = evaluator.get_values();
+        if (result.size() > 0)
+        {
+            return std::make_shared<value_term<Json>>(std::move(result[0]));
+        }
+        return std::make_shared<path_term<Json>>(std::move(result));
+    }
+
+    bool is_root_path() const override
+    {
+        return expr_ != nullptr && is_root_path_;
     }
 
     bool accept_single_node() const override
@@ -963,18 +1086,14 @@ public:
 };
 
 template <class Json>
-token<Json> evaluate(const Json& context, std::vector<token<Json>>& tokens)
+token<Json> evaluate(const Json& current_node, const Json& root, const std::vector<token<Json>>& tokens)
 {
-    for (auto it= tokens.begin(); it != tokens.end(); ++it)
-    {
-        it->initialize(context);
-    }
     std::vector<token<Json>> stack;
-    for (auto t : tokens)
+    for (const auto& t : tokens)
     {
         if (t.is_operand())
         {
-            stack.push_back(t);
+            stack.push_back(t.bind(current_node, root));
         }
         else if (t.is_unary_operator())
         {
@@ -1016,17 +1135,47 @@ public:
     {
     }
 
-    Json eval(const Json& current_node)
+    jsonpath_filter_expr(std::vector<token<Json>>&& tokens)
+        : tokens_(std::move(tokens))
     {
-        auto t = evaluate(current_node, tokens_);
+    }
+
+    Json eval(const Json& current_node, const Json& root) const
+    {
+        auto t = evaluate(current_node, root, tokens_);
         return t.operand().get_single_node();
     }
 
-    bool exists(const Json& current_node)
+    bool exists(const Json& current_node, const Json& root) const
     {
-        auto t = evaluate(current_node,tokens_);
+        auto t = evaluate(current_node, root, tokens_);
         return t.operand().accept_single_node();
     }
+
+    bool has_root_path() const
+    {
+        for (const auto& t : tokens_)
+        {
+            if (t.is_root_path())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Evaluates the root paths in the expression once, 
+    // for evaluating it against many nodes of the same document
+    jsonpath_filter_expr bind_root(const Json& root) const
+    {
+        std::vector<token<Json>> tokens;
+        tokens.reserve(tokens_.size());
+        for (const auto& t : tokens_)
+        {
+            tokens.push_back(t.bind_root(root));
+        }
+        return jsonpath_filter_expr(std::move(tokens));
+    }
 };
 
 template <class Json>
@@ -1172,7 +1321,7 @@ public:
         }
     }
 
-    jsonpath_filter_expr<Json> parse(const Json& root, const char_type* p, const char_type* end_expr, const char_type** end_ptr)
+    jsonpath_filter_expr<Json> parse(const char_type* p, const char_type* end_expr, const char_type** end_ptr)
     {
         output_stack_.clear();
         operator_stack_.clear();
@@ -1787,13 +1936,7 @@ public:
                             {
                                 if (path_mode_stack_[0] == filter_path_mode::root_path)
                                 {
-                                    jsonpath_evaluator<Json,const Json&,detail::VoidPathConstructor<Json>> evaluator(buffer_line,buffer_column);
-                                    evaluator.evaluate(root, buffer);
-                                    auto result = evaluator.get_values();
-                                    if (result.size() > 0)
-                                    {
-                                        push_token(token<Json>(token_type::operand,std::make_shared<value_term<Json>>(std::move(result[0]))));
-                                    }
+                                    push_token(token<Json>(token_type::operand,std::make_shared<path_term<Json>>(buffer, buffer_line, buffer_column, true)));
                                 }
                                 else
                                 {
@@ -1818,13 +1961,7 @@ public:
                         {
                             if (path_mode_stack_[0] == filter_path_mode::root_path)
                             {
-                                jsonpath_evaluator<Json,const Json&,detail::VoidPathConstructor<Json>> evaluator(buffer_line,buffer_column);
-                                evaluator.evaluate(root, buffer);
-                                auto result = evaluator.get_values();
-                                if (result.size() > 0)
-                                {
-                                    push_token(token<Json>(token_type::operand,std::make_shared<value_term<Json>>(std::move(result[0]))));
-                                }
+                                push_token(token<Json>(token_type::operand,std::make_shared<path_term<Json>>(buffer, buffer_line, buffer_column, true)));
                                 push_token(token<Json>(token_type::rparen));
                             }
                             else
@@ -42,6 +42,32 @@ enum class pointer_state
     delim
 };
 
+// A reference token of an address, unescaped, with the array index it denotes
+template <class CharT>
+struct address_token
+{
+    std::basic_string<CharT> name;
+    bool is_index;
+    size_t index;
+
+    explicit address_token(std::basic_string<CharT>&& s)
+        : name(std::move(s)), is_index(false), index(0)
+    {
+        if (!name.empty() && name[0] >= '0' && name[0] <= '9' 
+            && jsoncons::detail::is_integer(name.data(), name.length()))
+        {
+            auto result = jsoncons::detail::to_integer<size_t>(name.data(), name.length());
+            is_index = !result.overflow;
+            index = result.value;
+        }
+    }
+
+    bool is_append() const
+    {
+        return name.size() == 1 && name[0] == '-';
+    }
+};
+
 } // detail
 
 // address_iterator
@@ -60,6 +86,9 @@ class address_iterator
     size_t line_;
     size_t column_;
     std::basic_string<char_type> buffer_;
+    // A '/' at the end of the input is followed by an empty token
+    bool trailing_delim_;
+    bool empty_token_;
 public:
     typedef string_type value_type;
     typedef std::ptrdiff_t difference_type;
@@ -75,7 +104,8 @@ public:
     }
 
     address_iterator(base_iterator first, base_iterator last, base_iterator current)
-        : path_ptr_(first), end_input_(last), p_(current), q_(current), state_(jsonpointer::detail::pointer_state::start)
+        : path_ptr_(first), end_input_(last), p_(current), q_(current), state_(jsonpointer::detail::pointer_state::start),
+          trailing_delim_(false), empty_token_(false)
     {
     }
 
@@ -102,6 +132,8 @@ public:
     {
         q_ = p_;
         buffer_.clear();
+        empty_token_ = trailing_delim_;
+        trailing_delim_ = false;
 
         bool done = false;
         while (p_ != end_input_ && !done)
@@ -159,6 +191,7 @@ public:
             ++p_;
             ++column_;
         }
+        trailing_delim_ = done && !ec && p_ == end_input_;
         return *this;
     }
 
@@ -176,7 +209,7 @@ public:
 
     friend bool operator==(const address_iterator& it1, const address_iterator& it2)
     {
-        return it1.q_ == it2.q_;
+        return it1.q_ == it2.q_ && it1.empty_token_ == it2.empty_token_;
     }
     friend bool operator!=(const address_iterator& it1, const address_iterator& it2)
     {
@@ -215,8 +248,6 @@ std::basic_string<CharT> escape_string(const std::basic_string<CharT>& s)
 template <class CharT>
 class basic_address
 {
-public:
-    std::basic_string<CharT> path_;
 public:
     // Member types
     typedef CharT char_type;
@@ -224,22 +255,33 @@ public:
     typedef basic_string_view<char_type> string_view_type;
     typedef address_iterator<typename string_type::const_iterator> const_iterator;
     typedef const_iterator iterator;
+    typedef jsonpointer::detail::address_token<CharT> token_type;
+private:
+    std::basic_string<CharT> path_;
+    // The tokens are parsed once, when the address is built
+    std::vector<token_type> tokens_;
+    bool valid_;
+public:
 
     // Constructors
     basic_address()
+        : valid_(true)
     {
     }
     explicit basic_address(const string_type& s)
         : path_(s)
     {
+        parse();
     }
     explicit basic_address(string_type&& s)
         : path_(std::move(s))
     {
+        parse();
     }
     explicit basic_address(const CharT* s)
         : path_(s)
     {
+        parse();
     }
 
     basic_address(const basic_address&) = default;
@@ -256,12 +298,15 @@ public:
     void clear()
     {
         path_.clear();
+        tokens_.clear();
+        valid_ = true;
     }
 
     basic_address& operator/=(const string_type& s)
     {
         path_.push_back('/');
         path_.append(escape_string(s));
+        tokens_.emplace_back(string_type(s));
 
         return *this;
     }
@@ -269,6 +314,8 @@ public:
     basic_address& operator+=(const basic_address& p)
     {
         path_.append(p.path_);
+        tokens_.insert(tokens_.end(), p.tokens_.begin(), p.tokens_.end());
+        valid_ = valid_ && p.valid_;
         return *this;
     }
 
@@ -278,6 +325,18 @@ public:
       return path_.empty();
     }
 
+    // Whether the path is a valid JSON Pointer
+    bool valid() const
+    {
+        return valid_;
+    }
+
+    // The reference tokens, unescaped
+    const std::vector<token_type>& tokens() const
+    {
+        return tokens_;
+    }
+
     const string_type& string() const
     {
         return path_;
@@ -329,6 +388,58 @@ public:
         os << p.path_;
         return os;
     }
+private:
+    // An invalid path keeps no tokens
+    void parse()
+    {
+        valid_ = parse_tokens();
+        if (!valid_)
+        {
+            tokens_.clear();
+        }
+    }
+
+    bool parse_tokens()
+    {
+        auto p = path_.begin();
+        while (p != path_.end())
+        {
+            if (*p != '/')
+            {
+                return false;
+            }
+            ++p;
+            string_type name;
+            while (p != path_.end() && *p != '/')
+            {
+                if (*p == '~')
+                {
+                    if (++p == path_.end())
+                    {
+                        return false;
+                    }
+                    switch (*p)
+                    {
+                        case '0':
+                            name.push_back('~');
+                            break;
+                        case '1':
+                            name.push_back('/');
+                            break;
+                        default:
+                            return false;
+                    }
+                }
+                else
+                {
+                    name.push_back(*p);
+                }
+                ++p;
+            }
+            tokens_.emplace_back(std::move(name));
+        }
+        return true;
+    }
 };
 
 typedef basic_address<char> address;
@@ -759,6 +870,145 @@ public:
     }
 };
 
+// Resolution of a parsed address, JPointer is J* or const J*
+
+template <class JPointer,class Token>
+JPointer find_child(JPointer parent, const Token& token, std::error_code& ec)
+{
+    if (parent->is_array())
+    {
+        if (token.is_append())
+        {
+            ec = jsonpointer_errc::index_exceeds_array_size;
+        }
+        else if (!token.is_index)
+        {
+            ec = jsonpointer_errc::invalid_index;
+        }
+        else if (token.index >= parent->size())
+        {
+            ec = jsonpointer_errc::index_exceeds_array_size;
+        }
+        else
+        {
+            return std::addressof(parent->at(token.index));
+        }
+    }
+    else if (parent->is_object())
+    {
+        auto it = parent->find(token.name);
+        if (it == parent->object_range().end())
+        {
+            ec = jsonpointer_errc::name_not_found;
+        }
+        else
+        {
+            return std::addressof(it->value());
+        }
+    }
+    else
+    {
+        ec = jsonpointer_errc::expected_object_or_array;
+    }
+    return nullptr;
+}
+
+// Resolves the first count tokens, returns the last value resolved, 
+// and sets ec if not all could be
+template <class JPointer,class Token>
+JPointer find(JPointer root, const std::vector<Token>& tokens, size_t count, std::error_code& ec)
+{
+    JPointer current = root;
+    for (size_t i = 0; i < count; ++i)
+    {
+        JPointer child = find_child(current, tokens[i], ec);
+        if (child == nullptr)
+        {
+            return current;
+        }
+        current = child;
+    }
+    return current;
+}
+
+template <class J,class Token>
+void insert(J& parent, const Token& token, const J& value, bool assign, std::error_code& ec)
+{
+    if (parent.is_array())
+    {
+        if (token.is_append())
+        {
+            parent.push_back(value);
+        }
+        else if (!token.is_index)
+        {
+            ec = jsonpointer_errc::invalid_index;
+        }
+        else if (token.index > parent.size())
+        {
+            ec = jsonpointer_errc::index_exceeds_array_size;
+        }
+        else
+        {
+            parent.insert(parent.array_range().begin() + token.index, value);
+        }
+    }
+    else if (parent.is_object())
+    {
+        if (!assign && parent.contains(token.name))
+        {
+            ec = jsonpointer_errc::key_already_exists;
+        }
+        else
+        {
+            parent.insert_or_assign(token.name, value);
+        }
+    }
+    else
+    {
+        ec = jsonpointer_errc::expected_object_or_array;
+    }
+}
+
+template <class J,class Token>
+void remove(J& parent, const Token& token, std::error_code& ec)
+{
+    if (parent.is_array())
+    {
+        if (token.is_append())
+        {
+            ec = jsonpointer_errc::index_exceeds_array_size;
+        }
+        else if (!token.is_index)
+        {
+            ec = jsonpointer_errc::invalid_index;
+        }
+        else if (token.index >= parent.size())
+        {
+            ec = jsonpointer_errc::index_exceeds_array_size;
+        }
+        else
+        {
+            parent.erase(parent.array_range().begin() + token.index);
+        }
+    }
+    else if (parent.is_object())
+    {
+        if (!parent.contains(token.name))
+        {
+            ec = jsonpointer_errc::name_not_found;
+        }
+        else
+        {
+            parent.erase(token.name);
+        }
+    }
+    else
+    {
+        ec = jsonpointer_errc::expected_object_or_array;
+    }
+}
+
 }
 
 template<class J>
@@ -932,6 +1182,210 @@ void replace(J& root, const typename J::string_view_type& path, const J& value,
     evaluator.replace(root, path, value, ec);
 }
 
+// Overloads for addresses, which use the tokens parsed when the address was built. 
+// Addresses that are not valid JSON Pointers, and operations on the root, take the 
+// same path as strings, and fail or succeed in the same way. For types that are not
+// accessible by reference, addresses convert to strings.
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value,J&>::type
+get(J& root, const basic_address<typename J::char_type>& location, std::error_code& ec)
+{
+    if (!location.valid())
+    {
+        return get(root, typename J::string_view_type(location), ec);
+    }
+    return *jsoncons::jsonpointer::detail::find(std::addressof(root), location.tokens(), location.tokens().size(), ec);
+}
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value,const J&>::type
+get(const J& root, const basic_address<typename J::char_type>& location, std::error_code& ec)
+{
+    if (!location.valid())
+    {
+        return get(root, typename J::string_view_type(location), ec);
+    }
+    return *jsoncons::jsonpointer::detail::find(std::addressof(root), location.tokens(), location.tokens().size(), ec);
+}
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value,J&>::type
+get(J& root, const basic_address<typename J::char_type>& location)
+{
+    std::error_code ec;
+    J& result = get(root, location, ec);
+    if (ec)
+    {
+        JSONCONS_THROW(jsonpointer_error(ec));
+    }
+    return result;
+}
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value,const J&>::type
+get(const J& root, const basic_address<typename J::char_type>& location)
+{
+    std::error_code ec;
+    const J& result = get(root, location, ec);
+    if (ec)
+    {
+        JSONCONS_THROW(jsonpointer_error(ec));
+    }
+    return result;
+}
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value,bool>::type
+contains(const J& root, const basic_address<typename J::char_type>& location)
+{
+    if (!location.valid())
+    {
+        return false;
+    }
+    std::error_code ec;
+    jsoncons::jsonpointer::detail::find(std::addressof(root), location.tokens(), location.tokens().size(), ec);
+    return !ec;
+}
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value>::type
+insert_or_assign(J& root, const basic_address<typename J::char_type>& location, const J& value, std::error_code& ec)
+{
+    if (!location.valid() || location.tokens().empty())
+    {
+        insert_or_assign(root, typename J::string_view_type(location), value, ec);
+        return;
+    }
+    const auto& tokens = location.tokens();
+    std::error_code local_ec;
+    J* parent = jsoncons::jsonpointer::detail::find(std::addressof(root), tokens, tokens.size() - 1, local_ec);
+    if (local_ec)
+    {
+        ec = local_ec;
+        return;
+    }
+    jsoncons::jsonpointer::detail::insert(*parent, tokens.back(), value, true, ec);
+}
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value>::type
+insert_or_assign(J& root, const basic_address<typename J::char_type>& location, const J& value)
+{
+    std::error_code ec;
+    insert_or_assign(root, location, value, ec);
+    if (ec)
+    {
+        JSONCONS_THROW(jsonpointer_error(ec));
+    }
+}
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value>::type
+insert(J& root, const basic_address<typename J::char_type>& location, const J& value, std::error_code& ec)
+{
+    if (!location.valid() || location.tokens().empty())
+    {
+        insert(root, typename J::string_view_type(location), value, ec);
+        return;
+    }
+    const auto& tokens = location.tokens();
+    std::error_code local_ec;
+    J* parent = jsoncons::jsonpointer::detail::find(std::addressof(root), tokens, tokens.size() - 1, local_ec);
+    if (local_ec)
+    {
+        ec = local_ec;
+        return;
+    }
+    jsoncons::jsonpointer::detail::insert(*parent, tokens.back(), value, false, ec);
+}
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value>::type
+insert(J& root, const basic_address<typename J::char_type>& location, const J& value)
+{
+    std::error_code ec;
+    insert(root, location, value, ec);
+    if (ec)
+    {
+        JSONCONS_THROW(jsonpointer_error(ec));
+    }
+}
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value>::type
+remove(J& root, const basic_address<typename J::char_type>& location, std::error_code& ec)
+{
+    if (!location.valid() || location.tokens().empty())
+    {
+        remove(root, typename J::string_view_type(location), ec);
+        return;
+    }
+    const auto& tokens = location.tokens();
+    std::error_code local_ec;
+    J* parent = jsoncons::jsonpointer::detail::find(std::addressof(root), tokens, tokens.size() - 1, local_ec);
+    if (local_ec)
+    {
+        ec = local_ec;
+        return;
+    }
+    jsoncons::jsonpointer::detail::remove(*parent, tokens.back(), ec);
+}
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value>::type
+remove(J& root, const basic_address<typename J::char_type>& location)
+{
+    std::error_code ec;
+    remove(root, location, ec);
+    if (ec)
+    {
+        JSONCONS_THROW(jsonpointer_error(ec));
+    }
+}
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value>::type
+replace(J& root, const basic_address<typename J::char_type>& location, const J& value, std::error_code& ec)
+{
+    if (!location.valid() || location.tokens().empty())
+    {
+        replace(root, typename J::string_view_type(location), value, ec);
+        return;
+    }
+    const auto& tokens = location.tokens();
+    std::error_code local_ec;
+    J* parent = jsoncons::jsonpointer::detail::find(std::addressof(root), tokens, tokens.size() - 1, local_ec);
+    if (local_ec)
+    {
+        ec = local_ec;
+        return;
+    }
+    if (parent->is_object() && !parent->contains(tokens.back().name))
+    {
+        // As for strings
+        ec = jsonpointer_errc::key_already_exists;
+        return;
+    }
+    J* target = jsoncons::jsonpointer::detail::find_child(parent, tokens.back(), ec);
+    if (target != nullptr)
+    {
+        *target = value;
+    }
+}
+
+template<class J>
+typename std::enable_if<is_accessible_by_reference<J>::value>::type
+replace(J& root, const basic_address<typename J::char_type>& location, const J& value)
+{
+    std::error_code ec;
+    replace(root, location, value, ec);
+    if (ec)
+    {
+        JSONCONS_THROW(jsonpointer_error(ec));
+    }
+}
+
 template <class String>
 void escape(const String& s, std::basic_ostringstream<typename String::value_type>& os)
 {
@@ -16,6 +16,7 @@
 #include <jsoncons/config/binary_detail.hpp>
 #include <jsoncons_ext/msgpack/msgpack_encoder.hpp>
 #include <jsoncons_ext/msgpack/msgpack_reader.hpp>
+#include <jsoncons_ext/msgpack/msgpack_pull_reader.hpp>
 
 namespace jsoncons { namespace msgpack {
 
@@ -37,6 +38,7 @@ encode_msgpack(const T& val, std::vector<uint8_t>& v)
 {
     msgpack_bytes_encoder encoder(v);
     write_to(json(), val, encoder);
+    encoder.flush();
 }
 
 template<class T>
@@ -55,6 +57,7 @@ encode_msgpack(const T& val, std::ostream& os)
 {
     msgpack_encoder encoder(os);
     write_to(json(), val, encoder);
+    encoder.flush();
 }
 
 // decode_msgpack
@@ -79,10 +82,10 @@ template<class T>
 typename std::enable_if<!is_basic_json_class<T>::value,T>::type 
 decode_msgpack(const std::vector<uint8_t>& v)
 {
-    jsoncons::json_decoder<json> decoder;
-    basic_msgpack_reader<jsoncons::bytes_source> reader(v, decoder);
-    reader.read();
-    return decoder.get_result().template as<T>();
+    msgpack_bytes_pull_reader reader(v);
+    T val;
+    read_from(json(), reader, val);
+    return val;
 }
 
 template<class T>
@@ -105,10 +108,10 @@ template<class T>
 typename std::enable_if<!is_basic_json_class<T>::value,T>::type 
 decode_msgpack(std::istream& is)
 {
-    jsoncons::json_decoder<json> decoder;
-    msgpack_reader reader(is, decoder);
-    reader.read();
-    return decoder.get_result();
+    msgpack_pull_reader reader(is);
+    T val;
+    read_from(json(), reader, val);
+    return val;
 }
   
 #if !defined(JSONCONS_NO_DEPRECATED)
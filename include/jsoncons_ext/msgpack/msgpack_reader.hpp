@@ -20,19 +20,40 @@
 
 namespace jsoncons { namespace msgpack {
 
+enum class parse_mode {root,before_done,array,map_key,map_value};
+
+struct parse_state 
+{
+    parse_mode mode; 
+    size_t length;
+    size_t index;
+
+    parse_state(parse_mode mode, size_t length)
+        : mode(mode), length(length), index(0)
+    {
+    }
+
+    parse_state(const parse_state&) = default;
+    parse_state(parse_state&&) = default;
+};
+
 template <class Source>
 class basic_msgpack_reader : public ser_context
 {
     Source source_;
     json_content_handler& handler_;
-    size_t nesting_depth_;
+    bool more_;
+    bool done_;
     std::string buffer_;
+    std::vector<parse_state> state_stack_;
 public:
     basic_msgpack_reader(Source source, json_content_handler& handler)
        : source_(std::move(source)),
          handler_(handler), 
-         nesting_depth_(0)
+         more_(true),
+         done_(false)
     {
+        state_stack_.emplace_back(parse_mode::root,0);
     }
 
     void read()
@@ -45,8 +66,34 @@ public:
         }
     }
 
+    // Reads a whole data item, each call reads the next one
     void read(std::error_code& ec)
     {
+        if (done_)
+        {
+            state_stack_.emplace_back(parse_mode::root,0);
+            done_ = false;
+        }
+        while (!done_)
+        {
+            restart();
+            read_some(ec);
+            if (ec)
+            {
+                return;
+            }
+        }
+    }
+
+    // Reads until the handler returns false or the data item is done,
+    // so that a pull reader can read one event at a time
+    void read_some(std::error_code& ec)
+    {
+        if (source_.is_error())
+        {
+            ec = msgpack_errc::source_error;
+            return;
+        }   
         try
         {
             read_internal(ec);
@@ -57,6 +104,21 @@ public:
         }
     }
 
+    void restart()
+    {
+        more_ = true;
+    }
+
+    bool stopped() const
+    {
+        return !more_;
+    }
+
+    bool done() const
+    {
+        return done_;
+    }
+
     size_t line() const override
     {
         return 0;
@@ -70,74 +132,118 @@ private:
 
     void read_internal(std::error_code& ec)
     {
-        if (source_.is_error())
+        while (!done_ && more_)
         {
-            ec = msgpack_errc::source_error;
-            return;
-        }   
-        //const uint8_t* pos = input_ptr_++;
+            switch (state_stack_.back().mode)
+            {
+                case parse_mode::array:
+                {
+                    if (state_stack_.back().index < state_stack_.back().length)
+                    {
+                        ++state_stack_.back().index;
+                        read_item(ec);
+                        if (ec)
+                        {
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        end_array();
+                    }
+                    break;
+                }
+                case parse_mode::map_key:
+                {
+                    if (state_stack_.back().index < state_stack_.back().length)
+                    {
+                        ++state_stack_.back().index;
+                        state_stack_.back().mode = parse_mode::map_value;
+                        parse_name(ec);
+                        if (ec)
+                        {
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        end_object();
+                    }
+                    break;
+                }
+                case parse_mode::map_value:
+                {
+                    state_stack_.back().mode = parse_mode::map_key;
+                    read_item(ec);
+                    if (ec)
+                    {
+                        return;
+                    }
+                    break;
+                }
+                case parse_mode::root:
+                {
+                    state_stack_.back().mode = parse_mode::before_done;
+                    read_item(ec);
+                    if (ec)
+                    {
+                        return;
+                    }
+                    break;
+                }
+                case parse_mode::before_done:
+                {
+                    JSONCONS_ASSERT(state_stack_.size() == 1);
+                    state_stack_.clear();
+                    done_ = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    void read_item(std::error_code& ec)
+    {
 
         uint8_t type{};
         source_.get(type);
+        if (source_.eof())
+        {
+            ec = msgpack_errc::unexpected_eof;
+            return;
+        }
 
         if (type <= 0xbf)
         {
             if (type <= 0x7f) 
             {
                 // positive fixint
-                handler_.uint64_value(type, semantic_tag::none, *this);
+                more_ = handler_.uint64_value(type, semantic_tag::none, *this);
             }
             else if (type <= 0x8f) 
             {
                 // fixmap
                 const size_t len = type & 0x0f;
-                handler_.begin_object(len, semantic_tag::none, *this);
-                ++nesting_depth_;
-                for (size_t i = 0; i < len; ++i)
-                {
-                    parse_name(ec);
-                    if (ec)
-                    {
-                        return;
-                    }
-                    read(ec);
-                    if (ec)
-                    {
-                        return;
-                    }
-                }
-                handler_.end_object(*this);
-                --nesting_depth_;
+                begin_object(len);
             }
             else if (type <= 0x9f) 
             {
                 // fixarray
                 const size_t len = type & 0x0f;
-                handler_.begin_array(len, semantic_tag::none, *this);
-                ++nesting_depth_;
-                for (size_t i = 0; i < len; ++i)
-                {
-                    read(ec);
-                    if (ec)
-                    {
-                        return;
-                    }
-                }
-                handler_.end_array(*this);
-                --nesting_depth_;
+                begin_array(len);
             }
             else 
             {
                 // fixstr
                 const size_t len = type & 0x1f;
 
-                std::basic_string<char> s;
-                source_.read(std::back_inserter(s), len);
-                if (source_.eof())
+                const uint8_t* data;
+                if (source_reader<Source>::read_in_place(source_, buffer_, len, data) != len)
                 {
                     ec = msgpack_errc::unexpected_eof;
                     return;
                 }
+                basic_string_view<char> s(reinterpret_cast<const char*>(data), len);
 
                 auto result = unicons::validate(s.begin(),s.end());
                 if (result.ec != unicons::conv_errc())
@@ -145,13 +251,13 @@ private:
                     ec = msgpack_errc::invalid_utf8_text_string;
                     return;
                 }
-                handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::none, *this);
+                more_ = handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::none, *this);
             }
         }
         else if (type >= 0xe0) 
         {
             // negative fixint
-            handler_.int64_value(static_cast<int8_t>(type), semantic_tag::none, *this);
+            more_ = handler_.int64_value(static_cast<int8_t>(type), semantic_tag::none, *this);
         }
         else
         {
@@ -159,46 +265,40 @@ private:
             {
                 case jsoncons::msgpack::detail::msgpack_format ::nil_cd: 
                 {
-                    handler_.null_value(semantic_tag::none, *this);
+                    more_ = handler_.null_value(semantic_tag::none, *this);
                     break;
                 }
                 case jsoncons::msgpack::detail::msgpack_format ::true_cd:
                 {
-                    handler_.bool_value(true, semantic_tag::none, *this);
+                    more_ = handler_.bool_value(true, semantic_tag::none, *this);
                     break;
                 }
                 case jsoncons::msgpack::detail::msgpack_format ::false_cd:
                 {
-                    handler_.bool_value(false, semantic_tag::none, *this);
+                    more_ = handler_.bool_value(false, semantic_tag::none, *this);
                     break;
                 }
                 case jsoncons::msgpack::detail::msgpack_format ::float32_cd: 
                 {
-                    uint8_t buf[sizeof(float)];
-                    source_.read(buf, sizeof(float));
-                    if (source_.eof())
+                    float val{};
+                    if (!source_reader<Source>::read_big_endian(source_, val))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    float val = jsoncons::detail::from_big_endian<float>(buf,buf+sizeof(buf),&endp);
-                    handler_.double_value(val, semantic_tag::none, *this);
+                    more_ = handler_.double_value(val, semantic_tag::none, *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::float64_cd: 
                 {
-                    uint8_t buf[sizeof(double)];
-                    source_.read(buf, sizeof(double));
-                    if (source_.eof())
+                    double val{};
+                    if (!source_reader<Source>::read_big_endian(source_, val))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    double val = jsoncons::detail::from_big_endian<double>(buf,buf+sizeof(buf),&endp);
-                    handler_.double_value(val, semantic_tag::none, *this);
+                    more_ = handler_.double_value(val, semantic_tag::none, *this);
                     break;
                 }
 
@@ -206,163 +306,136 @@ private:
                 {
                     uint8_t val{};
                     source_.get(val);
-                    handler_.uint64_value(val, semantic_tag::none, *this);
+                    more_ = handler_.uint64_value(val, semantic_tag::none, *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::uint16_cd: 
                 {
-                    uint8_t buf[sizeof(uint16_t)];
-                    source_.read(buf, sizeof(uint16_t));
-                    if (source_.eof())
+                    uint16_t val{};
+                    if (!source_reader<Source>::read_big_endian(source_, val))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    uint16_t val = jsoncons::detail::from_big_endian<uint16_t>(buf,buf+sizeof(buf),&endp);
-                    handler_.uint64_value(val, semantic_tag::none, *this);
+                    more_ = handler_.uint64_value(val, semantic_tag::none, *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::uint32_cd: 
                 {
-                    uint8_t buf[sizeof(uint32_t)];
-                    source_.read(buf, sizeof(uint32_t));
-                    if (source_.eof())
+                    uint32_t val{};
+                    if (!source_reader<Source>::read_big_endian(source_, val))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    uint32_t val = jsoncons::detail::from_big_endian<uint32_t>(buf,buf+sizeof(buf),&endp);
-                    handler_.uint64_value(val, semantic_tag::none, *this);
+                    more_ = handler_.uint64_value(val, semantic_tag::none, *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::uint64_cd: 
                 {
-                    uint8_t buf[sizeof(uint64_t)];
-                    source_.read(buf, sizeof(uint64_t));
-                    if (source_.eof())
+                    uint64_t val{};
+                    if (!source_reader<Source>::read_big_endian(source_, val))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    uint64_t val = jsoncons::detail::from_big_endian<uint64_t>(buf,buf+sizeof(buf),&endp);
-                    handler_.uint64_value(val, semantic_tag::none, *this);
+                    more_ = handler_.uint64_value(val, semantic_tag::none, *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::int8_cd: 
                 {
-                    uint8_t buf[sizeof(int8_t)];
-                    source_.read(buf, sizeof(int8_t));
-                    if (source_.eof())
+                    int8_t val{};
+                    if (!source_reader<Source>::read_big_endian(source_, val))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int8_t val = jsoncons::detail::from_big_endian<int8_t>(buf,buf+sizeof(buf),&endp);
-                    handler_.int64_value(val, semantic_tag::none, *this);
+                    more_ = handler_.int64_value(val, semantic_tag::none, *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::int16_cd: 
                 {
-                    uint8_t buf[sizeof(int16_t)];
-                    source_.read(buf, sizeof(int16_t));
-                    if (source_.eof())
+                    int16_t val{};
+                    if (!source_reader<Source>::read_big_endian(source_, val))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int16_t val = jsoncons::detail::from_big_endian<int16_t>(buf,buf+sizeof(buf),&endp);
-                    handler_.int64_value(val, semantic_tag::none, *this);
+                    more_ = handler_.int64_value(val, semantic_tag::none, *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::int32_cd: 
                 {
-                    uint8_t buf[sizeof(int32_t)];
-                    source_.read(buf, sizeof(int32_t));
-                    if (source_.eof())
+                    int32_t val{};
+                    if (!source_reader<Source>::read_big_endian(source_, val))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int32_t val = jsoncons::detail::from_big_endian<int32_t>(buf,buf+sizeof(buf),&endp);
-                    handler_.int64_value(val, semantic_tag::none, *this);
+                    more_ = handler_.int64_value(val, semantic_tag::none, *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::int64_cd: 
                 {
-                    uint8_t buf[sizeof(int64_t)];
-                    source_.read(buf, sizeof(int64_t));
-                    if (source_.eof())
+                    int64_t val{};
+                    if (!source_reader<Source>::read_big_endian(source_, val))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int64_t val = jsoncons::detail::from_big_endian<int64_t>(buf,buf+sizeof(buf),&endp);
-                    handler_.int64_value(val, semantic_tag::none, *this);
+                    more_ = handler_.int64_value(val, semantic_tag::none, *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::str8_cd: 
                 {
-                    uint8_t buf[sizeof(int8_t)];
-                    source_.read(buf, sizeof(int8_t));
-                    if (source_.eof())
+                    uint8_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int8_t len = jsoncons::detail::from_big_endian<int8_t>(buf,buf+sizeof(buf),&endp);
 
-                    std::basic_string<char> s;
-                    source_.read(std::back_inserter(s), len);
-                    if (source_.eof())
+                    const uint8_t* data;
+                    if (source_reader<Source>::read_in_place(source_, buffer_, len, data) != len)
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
+                    basic_string_view<char> s(reinterpret_cast<const char*>(data), len);
                     auto result = unicons::validate(s.begin(),s.end());
                     if (result.ec != unicons::conv_errc())
                     {
                         ec = msgpack_errc::invalid_utf8_text_string;
                         return;
                     }
-                    handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::none, *this);
+                    more_ = handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::none, *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::str16_cd: 
                 {
-                    uint8_t buf[sizeof(int16_t)];
-                    source_.read(buf, sizeof(int16_t));
-                    if (source_.eof())
+                    uint16_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int16_t len = jsoncons::detail::from_big_endian<int16_t>(buf,buf+sizeof(buf),&endp);
 
-                    std::basic_string<char> s;
-                    source_.read(std::back_inserter(s), len);
-                    if (source_.eof())
+                    const uint8_t* data;
+                    if (source_reader<Source>::read_in_place(source_, buffer_, len, data) != len)
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
+                    basic_string_view<char> s(reinterpret_cast<const char*>(data), len);
 
                     auto result = unicons::validate(s.begin(),s.end());
                     if (result.ec != unicons::conv_errc())
@@ -370,29 +443,26 @@ private:
                         ec = msgpack_errc::invalid_utf8_text_string;
                         return;
                     }
-                    handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::none, *this);
+                    more_ = handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::none, *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::str32_cd: 
                 {
-                    uint8_t buf[sizeof(int32_t)];
-                    source_.read(buf, sizeof(int32_t));
-                    if (source_.eof())
+                    uint32_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int32_t len = jsoncons::detail::from_big_endian<int32_t>(buf,buf+sizeof(buf),&endp);
 
-                    std::basic_string<char> s;
-                    source_.read(std::back_inserter(s), len);
-                    if (source_.eof())
+                    const uint8_t* data;
+                    if (source_reader<Source>::read_in_place(source_, buffer_, len, data) != len)
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
+                    basic_string_view<char> s(reinterpret_cast<const char*>(data), len);
 
                     auto result = unicons::validate(s.begin(),s.end());
                     if (result.ec != unicons::conv_errc())
@@ -400,32 +470,27 @@ private:
                         ec = msgpack_errc::invalid_utf8_text_string;
                         return;
                     }
-                    handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::none, *this);
+                    more_ = handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::none, *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::bin8_cd: 
                 {
-                    uint8_t buf[sizeof(int8_t)];
-                    source_.read(buf, sizeof(int8_t));
-                    if (source_.eof())
+                    uint8_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int8_t len = jsoncons::detail::from_big_endian<int8_t>(buf,buf+sizeof(buf),&endp);
 
-                    std::vector<uint8_t> v;
-                    v.reserve(len);
-                    source_.read(std::back_inserter(v), len);
-                    if (source_.eof())
+                    const uint8_t* data;
+                    if (source_reader<Source>::read_in_place(source_, buffer_, len, data) != len)
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
 
-                    handler_.byte_string_value(byte_string_view(v.data(),v.size()), 
+                    more_ = handler_.byte_string_value(byte_string_view(data,len), 
                                                semantic_tag::none, 
                                                *this);
                     break;
@@ -433,26 +498,21 @@ private:
 
                 case jsoncons::msgpack::detail::msgpack_format ::bin16_cd: 
                 {
-                    uint8_t buf[sizeof(int16_t)];
-                    source_.read(buf, sizeof(int16_t));
-                    if (source_.eof())
+                    uint16_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int16_t len = jsoncons::detail::from_big_endian<int16_t>(buf,buf+sizeof(buf),&endp);
 
-                    std::vector<uint8_t> v;
-                    v.reserve(len);
-                    source_.read(std::back_inserter(v), len);
-                    if (source_.eof())
+                    const uint8_t* data;
+                    if (source_reader<Source>::read_in_place(source_, buffer_, len, data) != len)
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
 
-                    handler_.byte_string_value(byte_string_view(v.data(),v.size()), 
+                    more_ = handler_.byte_string_value(byte_string_view(data,len), 
                                                semantic_tag::none, 
                                                *this);
                     break;
@@ -460,26 +520,21 @@ private:
 
                 case jsoncons::msgpack::detail::msgpack_format ::bin32_cd: 
                 {
-                    uint8_t buf[sizeof(int32_t)];
-                    source_.read(buf, sizeof(int32_t));
-                    if (source_.eof())
+                    uint32_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int32_t len = jsoncons::detail::from_big_endian<int32_t>(buf,buf+sizeof(buf),&endp);
 
-                    std::vector<uint8_t> v;
-                    v.reserve(len);
-                    source_.read(std::back_inserter(v), len);
-                    if (source_.eof())
+                    const uint8_t* data;
+                    if (source_reader<Source>::read_in_place(source_, buffer_, len, data) != len)
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
 
-                    handler_.byte_string_value(byte_string_view(v.data(),v.size()), 
+                    more_ = handler_.byte_string_value(byte_string_view(data,len), 
                                                semantic_tag::none, 
                                                *this);
                     break;
@@ -487,122 +542,112 @@ private:
 
                 case jsoncons::msgpack::detail::msgpack_format ::array16_cd: 
                 {
-                    uint8_t buf[sizeof(int16_t)];
-                    source_.read(buf, sizeof(int16_t));
-                    if (source_.eof())
+                    uint16_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int16_t len = jsoncons::detail::from_big_endian<int16_t>(buf,buf+sizeof(buf),&endp);
 
-                    handler_.begin_array(len, semantic_tag::none, *this);
-                    ++nesting_depth_;
-                    for (int16_t i = 0; i < len; ++i)
-                    {
-                        read(ec);
-                        if (ec)
-                        {
-                            return;
-                        }
-                    }
-                    handler_.end_array(*this);
-                    --nesting_depth_;
+                    begin_array(len);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::array32_cd: 
                 {
-                    uint8_t buf[sizeof(int32_t)];
-                    source_.read(buf, sizeof(int32_t));
-                    if (source_.eof())
+                    uint32_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int32_t len = jsoncons::detail::from_big_endian<int32_t>(buf,buf+sizeof(buf),&endp);
 
-                    handler_.begin_array(len, semantic_tag::none, *this);
-                    ++nesting_depth_;
-                    for (int32_t i = 0; i < len; ++i)
+                    begin_array(len);
+                    break;
+                }
+
+                case jsoncons::msgpack::detail::msgpack_format ::map16_cd : 
+                {
+                    uint16_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
-                        read(ec);
-                        if (ec)
-                        {
-                            return;
-                        }
+                        ec = msgpack_errc::unexpected_eof;
+                        return;
                     }
-                    handler_.end_array(*this);
-                    --nesting_depth_;
+
+                    begin_object(len);
                     break;
                 }
 
-                case jsoncons::msgpack::detail::msgpack_format ::map16_cd : 
+                case jsoncons::msgpack::detail::msgpack_format ::map32_cd : 
                 {
-                    uint8_t buf[sizeof(int16_t)];
-                    source_.read(buf, sizeof(int16_t));
-                    if (source_.eof())
+                    uint32_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int16_t len = jsoncons::detail::from_big_endian<int16_t>(buf,buf+sizeof(buf),&endp);
 
-                    handler_.begin_object(len, semantic_tag::none, *this);
-                    ++nesting_depth_;
-                    for (int16_t i = 0; i < len; ++i)
+                    begin_object(len);
+                    break;
+                }
+
+                case jsoncons::msgpack::detail::msgpack_format ::ext8_cd: 
+                {
+                    uint8_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
-                        parse_name(ec);
-                        if (ec)
-                        {
-                            return;
-                        }
-                        read(ec);
-                        if (ec)
-                        {
-                            return;
-                        }
+                        ec = msgpack_errc::unexpected_eof;
+                        return;
                     }
-                    handler_.end_object(*this);
-                    --nesting_depth_;
+                    read_ext(len, ec);
                     break;
                 }
 
-                case jsoncons::msgpack::detail::msgpack_format ::map32_cd : 
+                case jsoncons::msgpack::detail::msgpack_format ::ext16_cd: 
                 {
-                    uint8_t buf[sizeof(int32_t)];
-                    source_.read(buf, sizeof(int32_t));
-                    if (source_.eof())
+                    uint16_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int32_t len = jsoncons::detail::from_big_endian<int32_t>(buf,buf+sizeof(buf),&endp);
+                    read_ext(len, ec);
+                    break;
+                }
 
-                    handler_.begin_object(len, semantic_tag::none, *this);
-                    ++nesting_depth_;
-                    for (int32_t i = 0; i < len; ++i)
+                case jsoncons::msgpack::detail::msgpack_format ::ext32_cd: 
+                {
+                    uint32_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
-                        parse_name(ec);
-                        if (ec)
-                        {
-                            return;
-                        }
-                        read(ec);
-                        if (ec)
-                        {
-                            return;
-                        }
+                        ec = msgpack_errc::unexpected_eof;
+                        return;
                     }
-                    handler_.end_object(*this);
-                    --nesting_depth_;
+                    read_ext(len, ec);
                     break;
                 }
 
+                case jsoncons::msgpack::detail::msgpack_format ::fixext1_cd: 
+                    read_ext(1, ec);
+                    break;
+
+                case jsoncons::msgpack::detail::msgpack_format ::fixext2_cd: 
+                    read_ext(2, ec);
+                    break;
+
+                case jsoncons::msgpack::detail::msgpack_format ::fixext4_cd: 
+                    read_ext(4, ec);
+                    break;
+
+                case jsoncons::msgpack::detail::msgpack_format ::fixext8_cd: 
+                    read_ext(8, ec);
+                    break;
+
+                case jsoncons::msgpack::detail::msgpack_format ::fixext16_cd: 
+                    read_ext(16, ec);
+                    break;
+
                 default:
                 {
                     //error
@@ -611,6 +656,53 @@ private:
         }
     }
 
+    // An extension type is reported as a byte string holding its data,
+    // the extension type code is not passed on
+    void read_ext(size_t len, std::error_code& ec)
+    {
+        uint8_t ext_type{};
+        if (!source_reader<Source>::read_big_endian(source_, ext_type))
+        {
+            ec = msgpack_errc::unexpected_eof;
+            return;
+        }
+
+        const uint8_t* data;
+        if (source_reader<Source>::read_in_place(source_, buffer_, len, data) != len)
+        {
+            ec = msgpack_errc::unexpected_eof;
+            return;
+        }
+
+        more_ = handler_.byte_string_value(byte_string_view(data,len), 
+                                   semantic_tag::none, 
+                                   *this);
+    }
+
+    void begin_array(size_t len)
+    {
+        state_stack_.emplace_back(parse_mode::array,len);
+        more_ = handler_.begin_array(len, semantic_tag::none, *this);
+    }
+
+    void end_array()
+    {
+        more_ = handler_.end_array(*this);
+        state_stack_.pop_back();
+    }
+
+    void begin_object(size_t len)
+    {
+        state_stack_.emplace_back(parse_mode::map_key,len);
+        more_ = handler_.begin_object(len, semantic_tag::none, *this);
+    }
+
+    void end_object()
+    {
+        more_ = handler_.end_object(*this);
+        state_stack_.pop_back();
+    }
+
     void parse_name(std::error_code& ec)
     {
         uint8_t type{};
@@ -627,20 +719,20 @@ private:
                 // fixstr
             const size_t len = type & 0x1f;
 
-            std::basic_string<char> s;
-            source_.read(std::back_inserter(s), len);
-            if (source_.eof())
+            const uint8_t* data;
+            if (source_reader<Source>::read_in_place(source_, buffer_, len, data) != len)
             {
                 ec = msgpack_errc::unexpected_eof;
                 return;
             }
+            basic_string_view<char> s(reinterpret_cast<const char*>(data), len);
             auto result = unicons::validate(s.begin(),s.end());
             if (result.ec != unicons::conv_errc())
             {
                 ec = msgpack_errc::invalid_utf8_text_string;
                 return;
             }
-            handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
+            more_ = handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
         }
         else
         {
@@ -648,23 +740,20 @@ private:
             {
                 case jsoncons::msgpack::detail::msgpack_format ::str8_cd: 
                 {
-                    uint8_t buf[sizeof(int8_t)];
-                    source_.read(buf, sizeof(int8_t));
-                    if (source_.eof())
+                    uint8_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int8_t len = jsoncons::detail::from_big_endian<int8_t>(buf,buf+sizeof(buf),&endp);
 
-                    std::basic_string<char> s;
-                    source_.read(std::back_inserter(s), len);
-                    if (source_.eof())
+                    const uint8_t* data;
+                    if (source_reader<Source>::read_in_place(source_, buffer_, len, data) != len)
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
+                    basic_string_view<char> s(reinterpret_cast<const char*>(data), len);
 
                     auto result = unicons::validate(s.begin(),s.end());
                     if (result.ec != unicons::conv_errc())
@@ -672,29 +761,26 @@ private:
                         ec = msgpack_errc::invalid_utf8_text_string;
                         return;
                     }
-                    handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
+                    more_ = handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::str16_cd: 
                 {
-                    uint8_t buf[sizeof(int16_t)];
-                    source_.read(buf, sizeof(int16_t));
-                    if (source_.eof())
+                    uint16_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int16_t len = jsoncons::detail::from_big_endian<int16_t>(buf,buf+sizeof(buf),&endp);
 
-                    std::basic_string<char> s;
-                    source_.read(std::back_inserter(s), len);
-                    if (source_.eof())
+                    const uint8_t* data;
+                    if (source_reader<Source>::read_in_place(source_, buffer_, len, data) != len)
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
+                    basic_string_view<char> s(reinterpret_cast<const char*>(data), len);
 
                     //std::basic_string<char> s;
                     //auto result = unicons::convert(
@@ -703,29 +789,26 @@ private:
                     //{
                     //    JSONCONS_THROW(json_runtime_error<std::runtime_error>("Illegal unicode"));
                     //}
-                    handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
+                    more_ = handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
                     break;
                 }
 
                 case jsoncons::msgpack::detail::msgpack_format ::str32_cd: 
                 {
-                    uint8_t buf[sizeof(int32_t)];
-                    source_.read(buf, sizeof(int32_t));
-                    if (source_.eof())
+                    uint32_t len{};
+                    if (!source_reader<Source>::read_big_endian(source_, len))
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
-                    const uint8_t* endp;
-                    int32_t len = jsoncons::detail::from_big_endian<int32_t>(buf,buf+sizeof(buf),&endp);
 
-                    std::basic_string<char> s;
-                    source_.read(std::back_inserter(s), len);
-                    if (source_.eof())
+                    const uint8_t* data;
+                    if (source_reader<Source>::read_in_place(source_, buffer_, len, data) != len)
                     {
                         ec = msgpack_errc::unexpected_eof;
                         return;
                     }
+                    basic_string_view<char> s(reinterpret_cast<const char*>(data), len);
 
                     //std::basic_string<char> s;
                     //auto result = unicons::convert(
@@ -734,7 +817,7 @@ private:
                     //{
                     //    JSONCONS_THROW(json_runtime_error<std::runtime_error>("Illegal unicode"));
                     //}
-                    handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
+                    more_ = handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
                     break;
                 }
             }
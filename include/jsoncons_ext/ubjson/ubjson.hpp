@@ -16,6 +16,7 @@
 #include <jsoncons/config/binary_detail.hpp>
 #include <jsoncons_ext/ubjson/ubjson_encoder.hpp>
 #include <jsoncons_ext/ubjson/ubjson_reader.hpp>
+#include <jsoncons_ext/ubjson/ubjson_pull_reader.hpp>
 
 namespace jsoncons { namespace ubjson {
 
@@ -37,6 +38,7 @@ encode_ubjson(const T& val, std::vector<uint8_t>& v)
 {
     ubjson_bytes_encoder encoder(v);
     write_to(json(), val, encoder);
+    encoder.flush();
 }
 
 template<class T>
@@ -55,6 +57,7 @@ encode_ubjson(const T& val, std::ostream& os)
 {
     ubjson_encoder encoder(os);
     write_to(json(), val, encoder);
+    encoder.flush();
 }
 
 // decode_ubjson
@@ -74,10 +77,10 @@ template<class T>
 typename std::enable_if<!is_basic_json_class<T>::value,T>::type 
 decode_ubjson(const std::vector<uint8_t>& v)
 {
-    jsoncons::json_decoder<json> decoder;
-    basic_ubjson_reader<jsoncons::bytes_source> reader(v, decoder);
-    reader.read();
-    return decoder.get_result().template as<T>();
+    ubjson_bytes_pull_reader reader(v);
+    T val;
+    read_from(json(), reader, val);
+    return val;
 }
 
 template<class T>
@@ -95,10 +98,10 @@ template<class T>
 typename std::enable_if<!is_basic_json_class<T>::value,T>::type 
 decode_ubjson(std::istream& is)
 {
-    jsoncons::json_decoder<json> decoder;
-    ubjson_reader reader(is, decoder);
-    reader.read();
-    return decoder.get_result();
+    ubjson_pull_reader reader(is);
+    T val;
+    read_from(json(), reader, val);
+    return val;
 }
 
 }}
@@ -0,0 +1,147 @@
+// Copyright 2019 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_UBJSON_UBJSON_PULL_READER_HPP
+#define JSONCONS_UBJSON_UBJSON_PULL_READER_HPP
+
+#include <system_error>
+#include <utility> // std::move
+#include <jsoncons/json_content_handler.hpp>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_pull_reader.hpp>
+#include <jsoncons/source.hpp>
+#include <jsoncons/staj_reader.hpp>
+#include <jsoncons_ext/ubjson/ubjson_reader.hpp>
+
+namespace jsoncons { namespace ubjson {
+
+// A pull reader over a UBJSON data item. The underlying ubjson reader is
+// stopped after each event, so memory use is bounded by the largest
+// string or byte string rather than by the size of the data item.
+template <class Source>
+class basic_ubjson_pull_reader : public basic_staj_reader<char>
+{
+    basic_staj_event_handler<char> event_handler_;
+    default_basic_staj_filter<char> default_filter_;
+    basic_staj_filter<char>& filter_;
+    basic_ubjson_reader<Source> reader_;
+
+    // Noncopyable and nonmoveable
+    basic_ubjson_pull_reader(const basic_ubjson_pull_reader&) = delete;
+    basic_ubjson_pull_reader& operator=(const basic_ubjson_pull_reader&) = delete;
+
+public:
+    // Constructors that throw parse exceptions
+    basic_ubjson_pull_reader(Source source)
+        : basic_ubjson_pull_reader(std::move(source), default_filter_)
+    {
+    }
+
+    basic_ubjson_pull_reader(Source source,
+                           basic_staj_filter<char>& filter)
+       : filter_(filter),
+         reader_(std::move(source), event_handler_)
+    {
+        if (!done())
+        {
+            next();
+        }
+    }
+
+    // Constructors that set parse error codes
+    basic_ubjson_pull_reader(Source source,
+                           std::error_code& ec)
+        : basic_ubjson_pull_reader(std::move(source), default_filter_, ec)
+    {
+    }
+
+    basic_ubjson_pull_reader(Source source,
+                           basic_staj_filter<char>& filter,
+                           std::error_code& ec)
+       : filter_(filter),
+         reader_(std::move(source), event_handler_)
+    {
+        if (!done())
+        {
+            next(ec);
+        }
+    }
+
+    bool done() const override
+    {
+        return reader_.done();
+    }
+
+    const basic_staj_event<char>& current() const override
+    {
+        return event_handler_.event();
+    }
+
+    void accept(basic_json_content_handler<char>& handler) override
+    {
+        std::error_code ec;
+        accept(handler, ec);
+        if (ec)
+        {
+            throw ser_error(ec,reader_.line(),reader_.column());
+        }
+    }
+
+    void accept(basic_json_content_handler<char>& handler,
+                std::error_code& ec) override
+    {
+        bool more = jsoncons::detail::send_staj_event(event_handler_.event(), handler, reader_);
+        while (more)
+        {
+            read_next(ec);
+            if (ec || done())
+            {
+                return;
+            }
+            more = jsoncons::detail::send_staj_event(event_handler_.event(), handler, reader_);
+        }
+    }
+
+    void next() override
+    {
+        std::error_code ec;
+        next(ec);
+        if (ec)
+        {
+            throw ser_error(ec,reader_.line(),reader_.column());
+        }
+    }
+
+    void next(std::error_code& ec) override
+    {
+        do
+        {
+            read_next(ec);
+        }
+        while (!ec && !done() && !filter_.accept(event_handler_.event(), reader_));
+    }
+
+    const ser_context& context() const override
+    {
+        return reader_;
+    }
+
+private:
+    void read_next(std::error_code& ec)
+    {
+        reader_.restart();
+        reader_.read_some(ec);
+    }
+};
+
+typedef basic_ubjson_pull_reader<jsoncons::binary_stream_source> ubjson_pull_reader;
+
+typedef basic_ubjson_pull_reader<jsoncons::bytes_source> ubjson_bytes_pull_reader;
+
+}}
+
+#endif
+
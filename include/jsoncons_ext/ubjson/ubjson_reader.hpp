@@ -8,6 +8,7 @@
 #define JSONCONS_UBJSON_UBJSON_READER_HPP
 
 #include <string>
+#include <vector>
 #include <memory>
 #include <utility> // std::move
 #include <jsoncons/json.hpp>
@@ -19,19 +20,42 @@
 
 namespace jsoncons { namespace ubjson {
 
+enum class parse_mode {root,before_done,array,indefinite_array,map_key,map_value,indefinite_map_key,indefinite_map_value};
+
+struct parse_state 
+{
+    parse_mode mode; 
+    size_t length;
+    size_t index;
+    uint8_t type;
+
+    parse_state(parse_mode mode, size_t length, uint8_t type = 0)
+        : mode(mode), length(length), index(0), type(type)
+    {
+    }
+
+    parse_state(const parse_state&) = default;
+    parse_state(parse_state&&) = default;
+};
+
 template <class Source>
 class basic_ubjson_reader : public ser_context
 {
     Source source_;
     json_content_handler& handler_;
-    size_t nesting_depth_;
+    bool more_;
+    bool done_;
     std::string buffer_;
+    std::string text_buffer_;
+    std::vector<parse_state> state_stack_;
 public:
     basic_ubjson_reader(Source source, json_content_handler& handler)
        : source_(std::move(source)),
          handler_(handler), 
-         nesting_depth_(0)
+         more_(true),
+         done_(false)
     {
+        state_stack_.emplace_back(parse_mode::root,0);
     }
 
     void read()
@@ -44,8 +68,34 @@ public:
         }
     }
 
+    // Reads a whole value, each call reads the next one
     void read(std::error_code& ec)
     {
+        if (done_)
+        {
+            state_stack_.emplace_back(parse_mode::root,0);
+            done_ = false;
+        }
+        while (!done_)
+        {
+            restart();
+            read_some(ec);
+            if (ec)
+            {
+                return;
+            }
+        }
+    }
+
+    // Reads until the handler returns false or the value is done,
+    // so that a pull reader can read one event at a time
+    void read_some(std::error_code& ec)
+    {
+        if (source_.is_error())
+        {
+            ec = ubjson_errc::source_error;
+            return;
+        }   
         try
         {
             read_internal(ec);
@@ -56,6 +106,21 @@ public:
         }
     }
 
+    void restart()
+    {
+        more_ = true;
+    }
+
+    bool stopped() const
+    {
+        return !more_;
+    }
+
+    bool done() const
+    {
+        return done_;
+    }
+
     size_t line() const override
     {
         return 0;
@@ -69,15 +134,126 @@ private:
 
     void read_internal(std::error_code& ec)
     {
-        if (source_.is_error())
+        while (!done_ && more_)
         {
-            ec = ubjson_errc::source_error;
-            return;
-        }   
-        //const uint8_t* pos = input_ptr_++;
+            switch (state_stack_.back().mode)
+            {
+                case parse_mode::array:
+                {
+                    if (state_stack_.back().index < state_stack_.back().length)
+                    {
+                        ++state_stack_.back().index;
+                        read_item(state_stack_.back().type, ec);
+                        if (ec)
+                        {
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        end_array();
+                    }
+                    break;
+                }
+                case parse_mode::indefinite_array:
+                {
+                    if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::end_array_marker)
+                    {
+                        source_.ignore(1);
+                        end_array();
+                    }
+                    else
+                    {
+                        read_item(0, ec);
+                        if (ec)
+                        {
+                            return;
+                        }
+                    }
+                    break;
+                }
+                case parse_mode::map_key:
+                {
+                    if (state_stack_.back().index < state_stack_.back().length)
+                    {
+                        ++state_stack_.back().index;
+                        state_stack_.back().mode = parse_mode::map_value;
+                        read_name(ec);
+                        if (ec)
+                        {
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        end_object();
+                    }
+                    break;
+                }
+                case parse_mode::map_value:
+                {
+                    state_stack_.back().mode = parse_mode::map_key;
+                    read_item(state_stack_.back().type, ec);
+                    if (ec)
+                    {
+                        return;
+                    }
+                    break;
+                }
+                case parse_mode::indefinite_map_key:
+                {
+                    if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::end_object_marker)
+                    {
+                        source_.ignore(1);
+                        end_object();
+                    }
+                    else
+                    {
+                        state_stack_.back().mode = parse_mode::indefinite_map_value;
+                        read_name(ec);
+                        if (ec)
+                        {
+                            return;
+                        }
+                    }
+                    break;
+                }
+                case parse_mode::indefinite_map_value:
+                {
+                    state_stack_.back().mode = parse_mode::indefinite_map_key;
+                    read_item(0, ec);
+                    if (ec)
+                    {
+                        return;
+                    }
+                    break;
+                }
+                case parse_mode::root:
+                {
+                    state_stack_.back().mode = parse_mode::before_done;
+                    read_item(0, ec);
+                    if (ec)
+                    {
+                        return;
+                    }
+                    break;
+                }
+                case parse_mode::before_done:
+                {
+                    JSONCONS_ASSERT(state_stack_.size() == 1);
+                    state_stack_.clear();
+                    done_ = true;
+                    break;
+                }
+            }
+        }
+    }
 
-        uint8_t type{};
-        if (source_.get(type) == 0)
+    // Reads a value, the type marker is read first unless the 
+    // container is strongly typed
+    void read_item(uint8_t type, std::error_code& ec)
+    {
+        if (type == 0 && source_.get(type) == 0)
         {
             ec = ubjson_errc::unexpected_eof;
             return;
@@ -91,7 +267,7 @@ private:
         {
             case jsoncons::ubjson::detail::ubjson_format::null_type: 
             {
-                handler_.null_value(semantic_tag::none, *this);
+                more_ = handler_.null_value(semantic_tag::none, *this);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::no_op_type: 
@@ -100,26 +276,23 @@ private:
             }
             case jsoncons::ubjson::detail::ubjson_format::true_type:
             {
-                handler_.bool_value(true, semantic_tag::none, *this);
+                more_ = handler_.bool_value(true, semantic_tag::none, *this);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::false_type:
             {
-                handler_.bool_value(false, semantic_tag::none, *this);
+                more_ = handler_.bool_value(false, semantic_tag::none, *this);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::int8_type: 
             {
-                uint8_t buf[sizeof(int8_t)];
-                source_.read(buf, sizeof(int8_t));
-                if (source_.eof())
+                int8_t val{};
+                if (!source_reader<Source>::read_big_endian(source_, val))
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return;
                 }
-                const uint8_t* endp;
-                int8_t val = jsoncons::detail::from_big_endian<int8_t>(buf,buf+sizeof(buf),&endp);
-                handler_.int64_value(val, semantic_tag::none, *this);
+                more_ = handler_.int64_value(val, semantic_tag::none, *this);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::uint8_type: 
@@ -130,97 +303,80 @@ private:
                     ec = ubjson_errc::unexpected_eof;
                     return;
                 }
-                handler_.uint64_value(val, semantic_tag::none, *this);
+                more_ = handler_.uint64_value(val, semantic_tag::none, *this);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::int16_type: 
             {
-                uint8_t buf[sizeof(int16_t)];
-                source_.read(buf, sizeof(int16_t));
-                if (source_.eof())
+                int16_t val{};
+                if (!source_reader<Source>::read_big_endian(source_, val))
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return;
                 }
-                const uint8_t* endp;
-                int16_t val = jsoncons::detail::from_big_endian<int16_t>(buf,buf+sizeof(buf),&endp);
-                handler_.int64_value(val, semantic_tag::none, *this);
+                more_ = handler_.int64_value(val, semantic_tag::none, *this);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::int32_type: 
             {
-                uint8_t buf[sizeof(int32_t)];
-                source_.read(buf, sizeof(int32_t));
-                if (source_.eof())
+                int32_t val{};
+                if (!source_reader<Source>::read_big_endian(source_, val))
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return;
                 }
-                const uint8_t* endp;
-                int32_t val = jsoncons::detail::from_big_endian<int32_t>(buf,buf+sizeof(buf),&endp);
-                handler_.int64_value(val, semantic_tag::none, *this);
+                more_ = handler_.int64_value(val, semantic_tag::none, *this);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::int64_type: 
             {
-                uint8_t buf[sizeof(int64_t)];
-                source_.read(buf, sizeof(int64_t));
-                if (source_.eof())
+                int64_t val{};
+                if (!source_reader<Source>::read_big_endian(source_, val))
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return;
                 }
-                const uint8_t* endp;
-                int64_t val = jsoncons::detail::from_big_endian<int64_t>(buf,buf+sizeof(buf),&endp);
-                handler_.int64_value(val, semantic_tag::none, *this);
+                more_ = handler_.int64_value(val, semantic_tag::none, *this);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::float32_type: 
             {
-                uint8_t buf[sizeof(float)];
-                source_.read(buf, sizeof(float));
-                if (source_.eof())
+                float val{};
+                if (!source_reader<Source>::read_big_endian(source_, val))
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return;
                 }
-                const uint8_t* endp;
-                float val = jsoncons::detail::from_big_endian<float>(buf,buf+sizeof(buf),&endp);
-                handler_.double_value(val, semantic_tag::none, *this);
+                more_ = handler_.double_value(val, semantic_tag::none, *this);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::float64_type: 
             {
-                uint8_t buf[sizeof(double)];
-                source_.read(buf, sizeof(double));
-                if (source_.eof())
+                double val{};
+                if (!source_reader<Source>::read_big_endian(source_, val))
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return;
                 }
-                const uint8_t* endp;
-                double val = jsoncons::detail::from_big_endian<double>(buf,buf+sizeof(buf),&endp);
-                handler_.double_value(val, semantic_tag::none, *this);
+                more_ = handler_.double_value(val, semantic_tag::none, *this);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::char_type: 
             {
-                uint8_t buf[sizeof(char)];
-                source_.read(buf, sizeof(char));
-                if (source_.eof())
+                char c{};
+                if (!source_reader<Source>::read_big_endian(source_, c))
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return;
                 }
-                const uint8_t* endp;
-                char c = jsoncons::detail::from_big_endian<char>(buf,buf+sizeof(buf),&endp);
                 auto result = unicons::validate(&c,&c+1);
                 if (result.ec != unicons::conv_errc())
                 {
                     ec = ubjson_errc::invalid_utf8_text_string;
                     return;
                 }
-                handler_.string_value(basic_string_view<char>(&c,1), semantic_tag::none, *this);
+                text_buffer_.assign(1, c);
+                more_ = handler_.string_value(basic_string_view<char>(text_buffer_.data(),text_buffer_.length()), semantic_tag::none, *this);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::string_type: 
@@ -230,20 +386,20 @@ private:
                 {
                     return;
                 }
-                std::string s;
-                source_.read(std::back_inserter(s), length);
-                if (source_.eof())
+                const uint8_t* data;
+                if (source_reader<Source>::read_in_place(source_, buffer_, length, data) != length)
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return;
                 }
+                basic_string_view<char> s(reinterpret_cast<const char*>(data), length);
                 auto result = unicons::validate(s.begin(),s.end());
                 if (result.ec != unicons::conv_errc())
                 {
                     ec = ubjson_errc::invalid_utf8_text_string;
                     return;
                 }
-                handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::none, *this);
+                more_ = handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::none, *this);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::high_precision_number_type: 
@@ -253,173 +409,143 @@ private:
                 {
                     return;
                 }
-                std::string s;
-                source_.read(std::back_inserter(s), length);
-                if (source_.eof())
+                const uint8_t* data;
+                if (source_reader<Source>::read_in_place(source_, buffer_, length, data) != length)
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return;
                 }
+                basic_string_view<char> s(reinterpret_cast<const char*>(data), length);
                 if (jsoncons::detail::is_integer(s.data(),s.length()))
                 {
-                    handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::big_integer, *this);
+                    more_ = handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::big_integer, *this);
                 }
                 else
                 {
-                    handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::big_decimal, *this);
+                    more_ = handler_.string_value(basic_string_view<char>(s.data(),s.length()), semantic_tag::big_decimal, *this);
                 }
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::start_array_marker: 
             {
-                if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::type_marker)
-                {
-                    source_.ignore(1);
-                    uint8_t item_type{};
-                    if (source_.get(item_type) == 0)
-                    {
-                        ec = ubjson_errc::unexpected_eof;
-                        return;
-                    }
-                    if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::count_marker)
-                    {
-                        source_.ignore(1);
-                        size_t length = get_length(ec);
-                        handler_.begin_array(length, semantic_tag::none, *this);
-                        for (size_t i = 0; i < length; ++i)
-                        {
-                            read_value(item_type, ec);
-                            if (ec)
-                            {
-                                return;
-                            }
-                        }
-                        handler_.end_array(*this);
-                    }
-                    else
-                    {
-                        ec = ubjson_errc::count_required_after_type;
-                        return;
-                    }
-                }
-                else if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::count_marker)
-                {
-                    source_.ignore(1);
-                    size_t length = get_length(ec);
-                    handler_.begin_array(length, semantic_tag::none, *this);
-                    for (size_t i = 0; i < length; ++i)
-                    {
-                        read(ec);
-                        if (ec)
-                        {
-                            return;
-                        }
-                    }
-                    handler_.end_array(*this);
-                }
-                else
-                {
-                    handler_.begin_array(semantic_tag::none, *this);
-                    while (source_.peek() != jsoncons::ubjson::detail::ubjson_format::end_array_marker)
-                    {
-                        read(ec);
-                        if (ec)
-                        {
-                            return;
-                        }
-                    }
-                    handler_.end_array(*this);
-                    source_.ignore(1);
-                }
+                begin_array(ec);
                 break;
             }
             case jsoncons::ubjson::detail::ubjson_format::start_object_marker: 
             {
-                if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::type_marker)
+                begin_object(ec);
+                break;
+            }
+            default:
+            {
+                ec = ubjson_errc::unknown_type;
+                return;
+            }
+        }
+    }
+
+    void begin_array(std::error_code& ec)
+    {
+        if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::type_marker)
+        {
+            source_.ignore(1);
+            uint8_t item_type{};
+            if (source_.get(item_type) == 0)
+            {
+                ec = ubjson_errc::unexpected_eof;
+                return;
+            }
+            if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::count_marker)
+            {
+                source_.ignore(1);
+                size_t length = get_length(ec);
+                if (ec)
                 {
-                    source_.ignore(1);
-                    uint8_t item_type{};
-                    if (source_.get(item_type) == 0)
-                    {
-                        ec = ubjson_errc::unexpected_eof;
-                        return;
-                    }
-                    if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::count_marker)
-                    {
-                        source_.ignore(1);
-                        size_t length = get_length(ec);
-                        handler_.begin_object(length, semantic_tag::none, *this);
-                        for (size_t i = 0; i < length; ++i)
-                        {
-                            read_name(ec);
-                            if (ec)
-                            {
-                                return;
-                            }
-                            read_value(item_type, ec);
-                            if (ec)
-                            {
-                                return;
-                            }
-                        }
-                        handler_.end_object(*this);
-                    }
-                    else
-                    {
-                        ec = ubjson_errc::count_required_after_type;
-                        return;
-                    }
+                    return;
                 }
-                else
+                state_stack_.emplace_back(parse_mode::array,length,item_type);
+                more_ = handler_.begin_array(length, semantic_tag::none, *this);
+            }
+            else
+            {
+                ec = ubjson_errc::count_required_after_type;
+                return;
+            }
+        }
+        else if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::count_marker)
+        {
+            source_.ignore(1);
+            size_t length = get_length(ec);
+            if (ec)
+            {
+                return;
+            }
+            state_stack_.emplace_back(parse_mode::array,length);
+            more_ = handler_.begin_array(length, semantic_tag::none, *this);
+        }
+        else
+        {
+            state_stack_.emplace_back(parse_mode::indefinite_array,0);
+            more_ = handler_.begin_array(semantic_tag::none, *this);
+        }
+    }
+
+    void end_array()
+    {
+        more_ = handler_.end_array(*this);
+        state_stack_.pop_back();
+    }
+
+    void begin_object(std::error_code& ec)
+    {
+        if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::type_marker)
+        {
+            source_.ignore(1);
+            uint8_t item_type{};
+            if (source_.get(item_type) == 0)
+            {
+                ec = ubjson_errc::unexpected_eof;
+                return;
+            }
+            if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::count_marker)
+            {
+                source_.ignore(1);
+                size_t length = get_length(ec);
+                if (ec)
                 {
-                    if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::count_marker)
-                    {
-                        source_.ignore(1);
-                        size_t length = get_length(ec);
-                        handler_.begin_object(length, semantic_tag::none, *this);
-                        for (size_t i = 0; i < length; ++i)
-                        {
-                            read_name(ec);
-                            if (ec)
-                            {
-                                return;
-                            }
-                            read(ec);
-                            if (ec)
-                            {
-                                return;
-                            }
-                        }
-                        handler_.end_object(*this);
-                    }
-                    else
-                    {
-                        handler_.begin_object(semantic_tag::none, *this);
-                        while (source_.peek() != jsoncons::ubjson::detail::ubjson_format::end_object_marker)
-                        {
-                            read_name(ec);
-                            if (ec)
-                            {
-                                return;
-                            }
-                            read(ec);
-                            if (ec)
-                            {
-                                return;
-                            }
-                        }
-                        handler_.end_object(*this);
-                        source_.ignore(1);
-                    }
+                    return;
                 }
-                break;
+                state_stack_.emplace_back(parse_mode::map_key,length,item_type);
+                more_ = handler_.begin_object(length, semantic_tag::none, *this);
             }
-            default:
+            else
             {
-                ec = ubjson_errc::unknown_type;
+                ec = ubjson_errc::count_required_after_type;
                 return;
             }
         }
+        else if (source_.peek() == jsoncons::ubjson::detail::ubjson_format::count_marker)
+        {
+            source_.ignore(1);
+            size_t length = get_length(ec);
+            if (ec)
+            {
+                return;
+            }
+            state_stack_.emplace_back(parse_mode::map_key,length);
+            more_ = handler_.begin_object(length, semantic_tag::none, *this);
+        }
+        else
+        {
+            state_stack_.emplace_back(parse_mode::indefinite_map_key,0);
+            more_ = handler_.begin_object(semantic_tag::none, *this);
+        }
+    }
+
+    void end_object()
+    {
+        more_ = handler_.end_object(*this);
+        state_stack_.pop_back();
     }
 
     size_t get_length(std::error_code& ec)
@@ -440,15 +566,12 @@ private:
         {
             case jsoncons::ubjson::detail::ubjson_format::int8_type: 
             {
-                uint8_t buf[sizeof(int8_t)];
-                source_.read(buf, sizeof(int8_t));
-                if (source_.eof())
+                int8_t val{};
+                if (!source_reader<Source>::read_big_endian(source_, val))
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return length;
                 }
-                const uint8_t* endp;
-                int8_t val = jsoncons::detail::from_big_endian<int8_t>(buf,buf+sizeof(buf),&endp);
                 if (val >= 0)
                 {
                     length = val;
@@ -473,15 +596,12 @@ private:
             }
             case jsoncons::ubjson::detail::ubjson_format::int16_type: 
             {
-                uint8_t buf[sizeof(int16_t)];
-                source_.read(buf, sizeof(int16_t));
-                if (source_.eof())
+                int16_t val{};
+                if (!source_reader<Source>::read_big_endian(source_, val))
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return length;
                 }
-                const uint8_t* endp;
-                int16_t val = jsoncons::detail::from_big_endian<int16_t>(buf,buf+sizeof(buf),&endp);
                 if (val >= 0)
                 {
                     length = val;
@@ -495,15 +615,12 @@ private:
             }
             case jsoncons::ubjson::detail::ubjson_format::int32_type: 
             {
-                uint8_t buf[sizeof(int32_t)];
-                source_.read(buf, sizeof(int32_t));
-                if (source_.eof())
+                int32_t val{};
+                if (!source_reader<Source>::read_big_endian(source_, val))
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return length;
                 }
-                const uint8_t* endp;
-                int32_t val = jsoncons::detail::from_big_endian<int32_t>(buf,buf+sizeof(buf),&endp);
                 if (val >= 0)
                 {
                     length = val;
@@ -517,15 +634,12 @@ private:
             }
             case jsoncons::ubjson::detail::ubjson_format::int64_type: 
             {
-                uint8_t buf[sizeof(int64_t)];
-                source_.read(buf, sizeof(int64_t));
-                if (source_.eof())
+                int64_t val{};
+                if (!source_reader<Source>::read_big_endian(source_, val))
                 {
                     ec = ubjson_errc::unexpected_eof;
                     return length;
                 }
-                const uint8_t* endp;
-                int64_t val = jsoncons::detail::from_big_endian<int64_t>(buf,buf+sizeof(buf),&endp);
                 if (val >= 0)
                 {
                     length = (size_t)val;
@@ -558,20 +672,20 @@ private:
         {
             return;
         }
-        std::string s;
-        source_.read(std::back_inserter(s), length);
-        if (source_.eof())
+        const uint8_t* data;
+        if (source_reader<Source>::read_in_place(source_, buffer_, length, data) != length)
         {
             ec = ubjson_errc::unexpected_eof;
             return;
         }
+        basic_string_view<char> s(reinterpret_cast<const char*>(data), length);
         auto result = unicons::validate(s.begin(),s.end());
         if (result.ec != unicons::conv_errc())
         {
             ec = ubjson_errc::invalid_utf8_text_string;
             return;
         }
-        handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
+        more_ = handler_.name(basic_string_view<char>(s.data(),s.length()), *this);
     }
 };
 
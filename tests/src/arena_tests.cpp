@@ -0,0 +1,179 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/arena.hpp>
+#include <catch/catch.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+using namespace jsoncons;
+
+typedef basic_json<char,sorted_policy,arena_allocator<char>> arena_json;
+typedef basic_json<char,preserve_order_policy,arena_allocator<char>> arena_ojson;
+
+TEST_CASE("arena tests")
+{
+    SECTION("alignment")
+    {
+        arena a(64);
+        void* p1 = a.allocate(1, 1);
+        void* p2 = a.allocate(sizeof(double), alignof(double));
+        void* p3 = a.allocate(3, 16);
+        CHECK(p1 != nullptr);
+        CHECK(reinterpret_cast<uintptr_t>(p2) % alignof(double) == 0);
+        CHECK(reinterpret_cast<uintptr_t>(p3) % 16 == 0);
+        CHECK(a.bytes_allocated() == 1 + sizeof(double) + 3);
+    }
+
+    SECTION("allocations larger than a chunk")
+    {
+        arena a(64);
+        char* p = static_cast<char*>(a.allocate(1000, 8));
+        std::fill(p, p+1000, 'a');
+        char* q = static_cast<char*>(a.allocate(10, 1));
+        std::fill(q, q+10, 'b');
+        CHECK(p[999] == 'a');
+        CHECK(a.bytes_allocated() == 1010);
+    }
+
+    SECTION("alignment past the end of a chunk")
+    {
+        // The end of the chunk is not 16 byte aligned, aligning up the
+        // next allocation moves it past the end
+        arena a(100);
+        char* p = static_cast<char*>(a.allocate(97, 1));
+        char* q = static_cast<char*>(a.allocate(8, 16));
+        uintptr_t past = (reinterpret_cast<uintptr_t>(p + 97) + 15) & ~static_cast<uintptr_t>(15);
+        CHECK(reinterpret_cast<uintptr_t>(q) % 16 == 0);
+        CHECK(reinterpret_cast<uintptr_t>(q) != past);
+        CHECK(a.bytes_allocated() == 105);
+    }
+
+    SECTION("reset reuses chunks")
+    {
+        arena a(128);
+        std::vector<void*> first;
+        for (size_t i = 0; i < 20; ++i)
+        {
+            first.push_back(a.allocate(32, 8));
+        }
+        a.reset();
+        CHECK(a.bytes_allocated() == 0);
+        for (size_t i = 0; i < 20; ++i)
+        {
+            CHECK(a.allocate(32, 8) == first[i]);
+        }
+    }
+
+    SECTION("release")
+    {
+        arena a;
+        a.allocate(100);
+        a.release();
+        CHECK(a.bytes_allocated() == 0);
+        CHECK(a.allocate(100) != nullptr);
+    }
+}
+
+TEST_CASE("arena_allocator tests")
+{
+    SECTION("default constructed uses the heap")
+    {
+        arena_allocator<int> alloc;
+        CHECK(alloc.get_arena() == nullptr);
+        int* p = alloc.allocate(10);
+        p[9] = 1;
+        alloc.deallocate(p, 10);
+    }
+
+    SECTION("rebind and compare")
+    {
+        arena a1;
+        arena a2;
+        arena_allocator<char> alloc1(a1);
+        arena_allocator<int> alloc2(alloc1);
+        CHECK(alloc2.get_arena() == &a1);
+        CHECK(arena_allocator<char>(alloc2) == alloc1);
+        CHECK(arena_allocator<char>(a2) != alloc1);
+    }
+
+    SECTION("std::vector")
+    {
+        arena a;
+        std::vector<int,arena_allocator<int>> v(a);
+        for (int i = 0; i < 1000; ++i)
+        {
+            v.push_back(i);
+        }
+        CHECK(v[999] == 999);
+        CHECK(a.bytes_allocated() >= 1000*sizeof(int));
+    }
+}
+
+TEST_CASE("decode json into an arena")
+{
+    std::string s = R"(
+    {
+        "a somewhat longer member name": [1, 2.5, "a string that does not fit in a short string", {"x": true}],
+        "b": {"c": null, "d": "another string that does not fit in a short string"}
+    }
+    )";
+
+    SECTION("decode_json from string")
+    {
+        arena a;
+        arena_json j = decode_json<arena_json>(s, arena_allocator<char>(a));
+        CHECK(a.bytes_allocated() > 0);
+
+        const arena_json& cj = j;
+        REQUIRE(cj.size() == 2);
+        const arena_json& arr = cj.at("a somewhat longer member name");
+        REQUIRE(arr.size() == 4);
+        CHECK(arr[0].as<int>() == 1);
+        CHECK(arr[1].as<double>() == 2.5);
+        CHECK(arr[2].as_string_view() == string_view("a string that does not fit in a short string"));
+        CHECK(arr[3].at("x").as<bool>());
+        CHECK(cj.at("b").at("c").is_null());
+        CHECK(cj.at("b").at("d").as_string_view() == string_view("another string that does not fit in a short string"));
+    }
+
+    SECTION("decode_json from stream")
+    {
+        arena a;
+        std::istringstream is(s);
+        arena_ojson j = decode_json<arena_ojson>(is, arena_allocator<char>(a));
+        CHECK(a.bytes_allocated() > 0);
+
+        const arena_ojson& cj = j;
+        REQUIRE(cj.size() == 2);
+        CHECK(cj.object_range().begin()->key() == "a somewhat longer member name");
+    }
+
+    SECTION("implicit object creation")
+    {
+        arena_json j;
+        j["a"] = 1;
+        CHECK(j.size() == 1);
+        CHECK(j["a"].as<int>() == 1);
+    }
+
+    SECTION("json_decoder with arena")
+    {
+        arena a(1024);
+        for (size_t i = 0; i < 10; ++i)
+        {
+            {
+                arena_allocator<char> alloc(a);
+                json_decoder<arena_json> decoder(alloc);
+                json_string_reader reader(s, decoder);
+                reader.read();
+                arena_json j = decoder.get_result();
+                CHECK(static_cast<const arena_json&>(j).at("b").at("d").as_string_view() == string_view("another string that does not fit in a short string"));
+            }
+            a.reset();
+        }
+    }
+}
@@ -245,3 +245,64 @@ TEST_CASE("serialize to bson")
     }
 }
 
+
+TEST_CASE("serialize integers to bson")
+{
+    SECTION("int32 and int64")
+    {
+        std::vector<uint8_t> v;
+        bson::bson_bytes_encoder encoder(v);
+
+        encoder.begin_object();
+        encoder.name("0");
+        encoder.int64_value(-5);
+        encoder.name("1");
+        encoder.uint64_value(5);
+        encoder.name("2");
+        encoder.int64_value((int64_t)(std::numeric_limits<int32_t>::max)()+1);
+        encoder.end_object();
+        encoder.flush();
+
+        std::vector<uint8_t> bson = {0x1e,0x00,0x00,0x00,
+                                     0x10, // int32
+                                     0x30, // '0'
+                                     0x00, // terminator
+                                     0xfb,0xff,0xff,0xff,
+                                     0x10, // int32
+                                     0x31, // '1'
+                                     0x00, // terminator
+                                     0x05,0x00,0x00,0x00,
+                                     0x12, // int64
+                                     0x32, // '2'
+                                     0x00, // terminator
+                                     0x00,0x00,0x00,0x80,0x00,0x00,0x00,0x00,
+                                     0x00 // terminator
+                                     };
+        jsoncons::bson::check_equal(v,bson);
+    }
+
+    SECTION("datetime")
+    {
+        std::vector<uint8_t> v;
+        bson::bson_bytes_encoder encoder(v);
+
+        encoder.begin_object();
+        encoder.name("0");
+        encoder.int64_value(1000, semantic_tag::timestamp);
+        encoder.end_object();
+        encoder.flush();
+
+        std::vector<uint8_t> bson = {0x10,0x00,0x00,0x00,
+                                     0x09, // datetime
+                                     0x30, // '0'
+                                     0x00, // terminator
+                                     0xe8,0x03,0x00,0x00,0x00,0x00,0x00,0x00,
+                                     0x00 // terminator
+                                     };
+        jsoncons::bson::check_equal(v,bson);
+
+        json j = bson::decode_bson<json>(v);
+        CHECK(j["0"].as<int64_t>() == 1000);
+        CHECK(j["0"].get_semantic_tag() == semantic_tag::timestamp);
+    }
+}
@@ -0,0 +1,171 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/bson/bson.hpp>
+#include <catch/catch.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace bson_pull_reader_tests {
+
+    struct book
+    {
+        std::string author;
+        std::string title;
+        double price;
+        std::vector<std::string> tags;
+    };
+
+} // namespace bson_pull_reader_tests
+
+JSONCONS_MEMBER_TRAITS_DECL(bson_pull_reader_tests::book, author, title, price, tags)
+
+// {"a" : int32 -5, "b" : int64 5000000000, "c" : datetime 1000, "d" : ["x", int32 1]}
+const std::vector<uint8_t> data = {0x3a,0x00,0x00,0x00,
+                                   0x10, // int32
+                                   'a',0x00,
+                                   0xfb,0xff,0xff,0xff,
+                                   0x12, // int64
+                                   'b',0x00,
+                                   0x00,0xf2,0x05,0x2a,0x01,0x00,0x00,0x00,
+                                   0x09, // datetime
+                                   'c',0x00,
+                                   0xe8,0x03,0x00,0x00,0x00,0x00,0x00,0x00,
+                                   0x04, // array
+                                   'd',0x00,
+                                   0x15,0x00,0x00,0x00,
+                                   0x02, // string
+                                   '0',0x00,
+                                   0x02,0x00,0x00,0x00,
+                                   'x',0x00,
+                                   0x10, // int32
+                                   '1',0x00,
+                                   0x01,0x00,0x00,0x00,
+                                   0x00, // end of array
+                                   0x00}; // end of document
+
+TEST_CASE("bson_pull_reader int32, int64 and datetime")
+{
+    bson::bson_bytes_pull_reader reader(data);
+
+    REQUIRE_FALSE(reader.done());
+    CHECK(reader.current().event_type() == staj_event_type::begin_object);
+    reader.next();
+    CHECK(reader.current().as<std::string>() == "a");
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::int64_value);
+    CHECK(reader.current().as<int>() == -5);
+    CHECK(reader.current().get_semantic_tag() == semantic_tag::none);
+    reader.next();
+    CHECK(reader.current().as<std::string>() == "b");
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::int64_value);
+    CHECK(reader.current().as<int64_t>() == 5000000000);
+    reader.next();
+    CHECK(reader.current().as<std::string>() == "c");
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::int64_value);
+    CHECK(reader.current().as<int64_t>() == 1000);
+    CHECK(reader.current().get_semantic_tag() == semantic_tag::timestamp);
+}
+
+TEST_CASE("bson_pull_reader array element names")
+{
+    bson::bson_bytes_pull_reader reader(data);
+
+    while (!reader.done() && reader.current().event_type() != staj_event_type::begin_array)
+    {
+        reader.next();
+    }
+    REQUIRE_FALSE(reader.done());
+
+    // The element names "0" and "1" are not reported
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::string_value);
+    CHECK(reader.current().as<std::string>() == "x");
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::int64_value);
+    CHECK(reader.current().as<int>() == 1);
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::end_array);
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::end_object);
+    reader.next();
+    CHECK(reader.done());
+}
+
+TEST_CASE("bson_pull_reader truncated document")
+{
+    // Cut off in the middle of the datetime
+    std::vector<uint8_t> v(data.begin(), data.begin() + 30);
+
+    std::error_code ec;
+    bson::bson_bytes_pull_reader reader(v, ec);
+    REQUIRE_FALSE(ec);
+
+    size_t count = 0;
+    while (!ec && !reader.done())
+    {
+        ++count;
+        reader.next(ec);
+    }
+    CHECK(ec == bson::bson_errc::unexpected_eof);
+    CHECK(count == 6); // begin_object, "a", -5, "b", 5000000000, "c"
+
+    CHECK_THROWS_AS(bson::decode_bson<json>(v), ser_error);
+}
+
+TEST_CASE("bson_pull_reader stops early on a stream")
+{
+    std::string s(data.begin(), data.end());
+    s.append("next");
+    std::istringstream is(s);
+
+    int64_t b = 0;
+    {
+        bson::bson_pull_reader reader(is);
+        while (!reader.done())
+        {
+            if (reader.current().event_type() == staj_event_type::name &&
+                reader.current().as<std::string>() == "b")
+            {
+                reader.next();
+                b = reader.current().as<int64_t>();
+                break;
+            }
+            reader.next();
+        }
+        CHECK_FALSE(reader.done());
+    }
+    CHECK(b == 5000000000);
+
+    // The reader does not need the rest of the document, and leaves the stream 
+    // at the end of what it read 
+    CHECK(is.tellg() == std::streampos(22));
+}
+
+TEST_CASE("decode_bson into types")
+{
+    bson_pull_reader_tests::book book{"Haruki Murakami", "Kafka on the Shore", 25.17,
+                                     {"fiction", "magical realism"}};
+    std::vector<uint8_t> v;
+    bson::encode_bson(book, v);
+
+    auto result = bson::decode_bson<bson_pull_reader_tests::book>(v);
+    CHECK(result.author == book.author);
+    CHECK(result.title == book.title);
+    CHECK(result.price == book.price);
+    CHECK(result.tags == book.tags);
+
+    std::string s(v.begin(), v.end());
+    std::istringstream is(s);
+    result = bson::decode_bson<bson_pull_reader_tests::book>(is);
+    CHECK(result.tags == book.tags);
+}
@@ -38,3 +38,29 @@ TEST_CASE("bson hello world")
                       },json::parse("{\"hello\":\"world\"}"));
 }
 
+
+TEST_CASE("bson round trip")
+{
+    json j = json::parse(R"(
+    {
+        "small" : -5,
+        "large" : 5000000000,
+        "array" : [1, "two", 3.5, [4], {"five" : 5}],
+        "objects" : [{"a" : 1}, {"b" : 2}]
+    }
+    )");
+
+    std::vector<uint8_t> v;
+    bson::encode_bson(j, v);
+
+    CHECK(bson::decode_bson<json>(v) == j);
+
+    std::vector<uint8_t> u;
+    bson::encode_bson(json::parse(R"({"a":-5})"), u);
+    std::vector<uint8_t> expected = {0x0c,0x00,0x00,0x00,
+                                     0x10, // int32
+                                     'a',0x00,
+                                     0xfb,0xff,0xff,0xff,
+                                     0x00};
+    CHECK(u == expected);
+}
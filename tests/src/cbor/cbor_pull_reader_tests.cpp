@@ -0,0 +1,205 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <catch/catch.hpp>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace cbor_pull_reader_tests {
+
+    struct book
+    {
+        std::string author;
+        std::string title;
+        double price;
+        std::vector<std::string> tags;
+        std::vector<uint8_t> isbn;
+    };
+
+} // namespace cbor_pull_reader_tests
+
+JSONCONS_MEMBER_TRAITS_DECL(cbor_pull_reader_tests::book, author, title, price, tags, isbn)
+
+std::vector<uint8_t> make_data()
+{
+    std::vector<uint8_t> v;
+    cbor::cbor_bytes_encoder encoder(v);
+    encoder.begin_object(3);
+    encoder.name("a");
+    encoder.begin_array(4);
+    encoder.uint64_value(1);
+    encoder.int64_value(-2);
+    encoder.string_value("x");
+    encoder.byte_string_value(byte_string({'f','o','o'}));
+    encoder.end_array();
+    encoder.name("b");
+    encoder.begin_array(); // indefinite length
+    encoder.bool_value(true);
+    encoder.null_value();
+    encoder.end_array();
+    encoder.name("c");
+    encoder.double_value(1.5);
+    encoder.end_object();
+    encoder.flush();
+    return v;
+}
+
+TEST_CASE("cbor_pull_reader tags")
+{
+    std::vector<uint8_t> v = {0x85, // array of 5
+                              0xc0, // tag 0, date/time string
+                              0x74,'2','0','1','3','-','0','3','-','2','1','T','2','0',':','0','4',':','0','0','Z',
+                              0xc1, // tag 1, epoch time
+                              0x1a,0x51,0x4b,0x67,0xb0,
+                              0xc2, // tag 2, positive bignum
+                              0x49,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+                              0xc4, // tag 4, decimal fraction
+                              0x82,0x21,0x19,0x6a,0xb3,
+                              0xd5, // tag 21, expected conversion to base64url
+                              0x43,'f','o','o'};
+
+    cbor::cbor_bytes_pull_reader reader(v);
+    REQUIRE_FALSE(reader.done());
+    CHECK(reader.current().event_type() == staj_event_type::begin_array);
+    CHECK(reader.current().size() == 5);
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::string_value);
+    CHECK(reader.current().get_semantic_tag() == semantic_tag::date_time);
+    CHECK(reader.current().as<std::string>() == "2013-03-21T20:04:00Z");
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::uint64_value);
+    CHECK(reader.current().get_semantic_tag() == semantic_tag::timestamp);
+    CHECK(reader.current().as<uint64_t>() == 1363896240);
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::string_value);
+    CHECK(reader.current().get_semantic_tag() == semantic_tag::big_integer);
+    CHECK(reader.current().as<std::string>() == "18446744073709551616");
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::string_value);
+    CHECK(reader.current().get_semantic_tag() == semantic_tag::big_decimal);
+    CHECK(reader.current().as<std::string>() == "273.15");
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::byte_string_value);
+    CHECK(reader.current().get_semantic_tag() == semantic_tag::base64url);
+    CHECK(reader.current().as<byte_string>() == byte_string({'f','o','o'}));
+    CHECK(reader.current().as<std::string>() == "Zm9v");
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::end_array);
+    reader.next();
+    CHECK(reader.done());
+
+    json expected = cbor::decode_cbor<json>(v);
+    cbor::cbor_bytes_pull_reader reader2(v);
+    json_decoder<json> decoder;
+    reader2.accept(decoder);
+    CHECK(decoder.get_result() == expected);
+}
+
+TEST_CASE("cbor_pull_reader truncated input")
+{
+    std::vector<uint8_t> v = make_data();
+    // Drop the end of the data, the first events are still read
+    v.resize(v.size() - 8);
+
+    std::error_code ec;
+    cbor::cbor_bytes_pull_reader reader(v, ec);
+    REQUIRE_FALSE(ec);
+    CHECK(reader.current().event_type() == staj_event_type::begin_object);
+    reader.next(ec);
+    REQUIRE_FALSE(ec);
+    CHECK(reader.current().as<std::string>() == "a");
+    CHECK_FALSE(reader.done());
+
+    while (!ec && !reader.done())
+    {
+        reader.next(ec);
+    }
+    CHECK(ec == cbor::cbor_errc::unexpected_eof);
+}
+
+TEST_CASE("decode_cbor into types")
+{
+    cbor_pull_reader_tests::book book{"Haruki Murakami", "Kafka on the Shore", 25.17,
+                                      {"fiction", "magical realism"}, {0x97,0x81,0x40}};
+    std::vector<uint8_t> v;
+    cbor::encode_cbor(book, v);
+
+    SECTION("struct")
+    {
+        auto result = cbor::decode_cbor<cbor_pull_reader_tests::book>(v);
+        CHECK(result.author == book.author);
+        CHECK(result.title == book.title);
+        CHECK(result.price == book.price);
+        CHECK(result.tags == book.tags);
+        CHECK(result.isbn == book.isbn);
+    }
+
+    SECTION("stream")
+    {
+        std::string s(v.begin(), v.end());
+        std::istringstream is(s);
+        auto result = cbor::decode_cbor<cbor_pull_reader_tests::book>(is);
+        CHECK(result.title == book.title);
+        CHECK(result.isbn == book.isbn);
+    }
+
+    SECTION("map")
+    {
+        std::vector<uint8_t> u;
+        cbor::encode_cbor(json::parse(R"({"first":[1,2],"second":[3]})"), u);
+        auto result = cbor::decode_cbor<std::map<std::string,std::vector<int>>>(u);
+        CHECK(result == (std::map<std::string,std::vector<int>>{{"first",{1,2}},{"second",{3}}}));
+    }
+
+    SECTION("byte string")
+    {
+        std::vector<uint8_t> u;
+        cbor::encode_cbor(json(byte_string({1,2,3})), u);
+        CHECK(cbor::decode_cbor<std::vector<uint8_t>>(u) == std::vector<uint8_t>({1,2,3}));
+        CHECK(cbor::decode_cbor<byte_string>(u) == byte_string({1,2,3}));
+    }
+}
+
+TEST_CASE("cbor_pull_reader skip")
+{
+    std::vector<uint8_t> v = make_data();
+    cbor::cbor_bytes_pull_reader reader(v);
+
+    reader.next();
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::begin_array);
+    reader.skip();
+    CHECK(reader.current().event_type() == staj_event_type::end_array);
+    reader.next();
+    CHECK(reader.current().as<std::string>() == "b");
+}
+
+TEST_CASE("cbor_pull_reader stops early on a stream")
+{
+    std::vector<uint8_t> v = make_data();
+    std::string s(v.begin(), v.end());
+    std::istringstream is(s);
+
+    {
+        cbor::cbor_pull_reader reader(is);
+        reader.next();
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::begin_array);
+        reader.next();
+        CHECK(reader.current().as<int>() == 1);
+    }
+
+    // The map header, "a", the array header and 1 were taken from the stream
+    CHECK(is.tellg() == std::streampos(5));
+    cbor::cbor_pull_reader reader(is);
+    CHECK(reader.current().as<int>() == -2);
+}
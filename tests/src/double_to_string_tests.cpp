@@ -167,4 +167,47 @@ TEST_CASE("test_double_to_wstring")
     CHECK(s == std::wstring(L"-11.0"));
 }
 
+std::string format_double(double val, chars_format format, int decimal_places)
+{
+    jsoncons::detail::print_double print(floating_point_options(format,0,static_cast<uint8_t>(decimal_places)));
+
+    std::string s;
+    jsoncons::string_result<std::string> writer(s);
+    print(val, writer);
+    writer.flush();
+    return s;
+}
 
+TEST_CASE("test fixed and scientific formats")
+{
+    SECTION("fixed")
+    {
+        CHECK(format_double(1234.5678, chars_format::fixed, 2) == std::string("1234.57"));
+        CHECK(format_double(-0.001, chars_format::fixed, 2) == std::string("-0.00"));
+        CHECK(format_double(0.125, chars_format::fixed, 2) == std::string("0.12")); // ties to even
+        CHECK(format_double(0.375, chars_format::fixed, 2) == std::string("0.38"));
+        CHECK(format_double(2.5, chars_format::fixed, 1) == std::string("2.5"));
+        CHECK(format_double(0.1, chars_format::fixed, 20) == std::string("0.10000000000000000555"));
+        CHECK(format_double(1e22, chars_format::fixed, 1) == std::string("10000000000000000000000.0"));
+        CHECK(format_double(1e-300, chars_format::fixed, 3) == std::string("0.000"));
+    }
+    SECTION("scientific")
+    {
+        CHECK(format_double(1234.5678, chars_format::scientific, 3) == std::string("1.235e+03"));
+        CHECK(format_double(-0.00012345, chars_format::scientific, 2) == std::string("-1.23e-04"));
+        CHECK(format_double(9.9999, chars_format::scientific, 2) == std::string("1.00e+01"));
+        CHECK(format_double(1e23, chars_format::scientific, 15) == std::string("9.999999999999999e+22"));
+        CHECK(format_double(5e-324, chars_format::scientific, 3) == std::string("4.941e-324"));
+        CHECK(format_double(1.7976931348623157e308, chars_format::scientific, 4) == std::string("1.7977e+308"));
+        CHECK(format_double(0, chars_format::scientific, 2) == std::string("0.00e+00"));
+    }
+    SECTION("general")
+    {
+        CHECK(float_to_string<char>(100, 3) == std::string("100.0"));
+        CHECK(float_to_string<char>(1e5, 3) == std::string("1e+05"));
+        CHECK(float_to_string<char>(0.0001234, 3) == std::string("0.000123"));
+        CHECK(float_to_string<char>(0.00001234, 3) == std::string("1.23e-05"));
+        CHECK(float_to_string<char>(999.96, 4) == std::string("1000.0"));
+        CHECK(float_to_string<char>(1e23, 16) == std::string("9.999999999999999e+22"));
+    }
+}
@@ -98,3 +98,15 @@ TEST_CASE("test grisu3")
     check_dtoa(0.000071, {"7.1e-05"}); 
 }
 
+TEST_CASE("test dtoa when grisu3 gives up")
+{
+    // grisu3 cannot decide the shortest digits for these, the exact fallback does
+    check_dtoa(0.0030548622050452132, {"0.003054862205045213"});
+    check_dtoa(0.90101483926793835, {"0.9010148392679383"});
+    check_dtoa(8049318.7766658235, {"8049318.7766658235"});
+    check_dtoa(3.5336080758221004e-09, {"3.5336080758221004e-09"});
+
+    check_dtoa(5e-324, {"5e-324"});
+    check_dtoa(1.7976931348623157e308, {"1.7976931348623157e+308"});
+    check_dtoa(9007199254740993.0, {"9007199254740992.0"});
+}
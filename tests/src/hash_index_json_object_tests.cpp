@@ -0,0 +1,164 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <catch/catch.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <utility>
+
+using namespace jsoncons;
+
+typedef basic_json<char,basic_hash_index_policy<4>,std::allocator<char>> hjson;
+
+std::string make_key(size_t i)
+{
+    return "key" + std::to_string(i);
+}
+
+TEST_CASE("hash index insert")
+{
+    json_object<hjson::string_type, hjson> o;
+
+    typedef std::pair<hjson::string_type,hjson> item_type;
+    std::vector<item_type> items;
+    for (size_t i = 0; i < 10; ++i)
+    {
+        items.emplace_back(make_key(i), i);
+    }
+    items.emplace_back("key3", 100);
+    items.emplace_back("key9", 100);
+
+    o.insert(std::make_move_iterator(items.begin()), std::make_move_iterator(items.end()),
+             [](item_type&& item){return hjson::key_value_type(std::forward<hjson::string_type>(item.first),std::forward<hjson>(item.second));});
+
+    REQUIRE(o.size() == 10);
+    size_t i = 0;
+    for (auto it = o.begin(); it != o.end(); ++it, ++i)
+    {
+        CHECK(it->key() == make_key(i));
+        CHECK(it->value().as<size_t>() == i);
+    }
+    auto it = o.find("key9");
+    REQUIRE(bool(it != o.end()));
+    CHECK(it->value().as<size_t>() == 9);
+    CHECK(bool(o.find("key10") == o.end()));
+}
+
+TEST_CASE("hash index insert_or_assign and try_emplace")
+{
+    const size_t count = 1000;
+
+    hjson j;
+    for (size_t i = 0; i < count; ++i)
+    {
+        j.insert_or_assign(make_key(i), i);
+    }
+    REQUIRE(j.size() == count);
+
+    SECTION("find")
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            REQUIRE(j.contains(make_key(i)));
+            CHECK(j.at(make_key(i)).as<size_t>() == i);
+        }
+        CHECK_FALSE(j.contains("key1000"));
+        CHECK_FALSE(j.contains(""));
+    }
+
+    SECTION("order")
+    {
+        size_t i = 0;
+        for (const auto& member : j.object_range())
+        {
+            CHECK(member.key() == make_key(i++));
+        }
+    }
+
+    SECTION("assign")
+    {
+        j.insert_or_assign("key500", "foo");
+        CHECK(j.size() == count);
+        CHECK(j["key500"].as<std::string>() == "foo");
+    }
+
+    SECTION("try_emplace")
+    {
+        j.try_emplace("key500", "foo");
+        j.try_emplace("key1000", "bar");
+        CHECK(j.size() == count+1);
+        CHECK(j["key500"].as<size_t>() == 500);
+        CHECK(j["key1000"].as<std::string>() == "bar");
+    }
+
+    SECTION("erase")
+    {
+        for (size_t i = 0; i < count; i += 2)
+        {
+            j.erase(make_key(i));
+        }
+        REQUIRE(j.size() == count/2);
+        for (size_t i = 0; i < count; ++i)
+        {
+            CHECK(j.contains(make_key(i)) == (i % 2 != 0));
+        }
+        j.erase(j.object_range().begin(), j.object_range().end());
+        CHECK(j.empty());
+        j.insert_or_assign("a", 1);
+        CHECK(j.at("a").as<int>() == 1);
+    }
+
+    SECTION("insert at hint")
+    {
+        auto it = j.find("key10");
+        j.insert_or_assign(it, "foo", "bar");
+        j.try_emplace(j.object_range().begin(), "baz", "qux");
+        REQUIRE(j.size() == count+2);
+        CHECK(j.object_range().begin()->key() == "baz");
+        CHECK(j.at("foo").as<std::string>() == "bar");
+        CHECK(j.at("key10").as<size_t>() == 10);
+        CHECK(j.at("key999").as<size_t>() == 999);
+    }
+
+    SECTION("copy and swap")
+    {
+        hjson j2(j);
+        hjson j3;
+        j3["a"] = 1;
+        j2.swap(j3);
+        CHECK(j3 == j);
+        CHECK(j3.at("key999").as<size_t>() == 999);
+        CHECK(j2.at("a").as<int>() == 1);
+        CHECK_FALSE(j2.contains("key999"));
+    }
+}
+
+TEST_CASE("hash index parse")
+{
+    std::ostringstream os;
+    os << "{";
+    for (size_t i = 0; i < 100; ++i)
+    {
+        if (i > 0)
+        {
+            os << ",";
+        }
+        os << "\"" << make_key(100-i) << "\":" << i;
+    }
+    os << ",\"key50\":-1}";
+
+    hjson j = hjson::parse(os.str());
+    ojson expected = ojson::parse(os.str());
+
+    REQUIRE(j.size() == expected.size());
+    CHECK(j.object_range().begin()->key() == "key100");
+    CHECK(j.at("key50").as<int>() == expected.at("key50").as<int>());
+
+    std::string s1;
+    std::string s2;
+    j.dump(s1);
+    expected.dump(s2);
+    CHECK(s1 == s2);
+}
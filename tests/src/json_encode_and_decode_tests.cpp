@@ -325,3 +325,43 @@ TEST_CASE("reputation_object")
 
 
 
+
+class flush_counting_filter : public json_filter
+{
+public:
+    size_t count;
+
+    flush_counting_filter(json_content_handler& handler)
+        : json_filter(handler), count(0)
+    {
+    }
+private:
+    void do_flush() override
+    {
+        ++count;
+        to_handler().flush();
+    }
+};
+
+TEST_CASE("encode_json flushes once")
+{
+    std::string s;
+    json_compressed_string_encoder encoder(s);
+    flush_counting_filter filter(encoder);
+
+    SECTION("nested containers")
+    {
+        std::map<std::string,std::vector<std::vector<int>>> val = {{"a",{{1,2},{3}}},{"b",{{4}}}};
+        encode_json(val, filter);
+        CHECK(filter.count == 1);
+        CHECK(s == R"({"a":[[1,2],[3]],"b":[[4]]})");
+    }
+
+    SECTION("elements encoded through json")
+    {
+        std::vector<std::pair<std::string,int>> val = {{"a",1},{"b",2}};
+        encode_json(val, filter);
+        CHECK(filter.count == 1);
+        CHECK(s == R"([["a",1],["b",2]])");
+    }
+}
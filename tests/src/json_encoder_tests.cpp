@@ -29,3 +29,44 @@ TEST_CASE("test_byte_string_serialization")
     CHECK(os.str() == expected);
 }
 
+
+TEST_CASE("json_encoder escape characters in long strings")
+{
+    // Place each character that needs escaping on either side of the 16 and 32 byte block boundaries
+    const std::pair<std::string,std::string> escapes[] = {{"\"","\\\""},{"\\","\\\\"},{"\n","\\n"},{"\x01","\\u0001"},
+                                                          {"\x7f","\\u007F"},{"/","/"},{"\xc3\xa9","\xc3\xa9"}};
+    for (const auto& e : escapes)
+    {
+        for (size_t pos : {0, 15, 16, 31, 32, 33, 63, 70})
+        {
+            std::string s(pos, 'a');
+            std::string expected = "[\"" + s + e.second;
+            s.append(e.first);
+            s.append(40, 'b');
+            expected.append(40, 'b');
+            expected.append("\"]");
+
+            json j = json::array();
+            j.push_back(s);
+            std::string output;
+            j.dump(output);
+            CHECK(output == expected);
+        }
+    }
+
+    SECTION("escape_solidus and escape_all_non_ascii")
+    {
+        std::string s(33, 'a');
+        s.append("/\xc3\xa9");
+        s.append(33, 'b');
+        json j = json::array();
+        j.push_back(s);
+
+        json_options options;
+        options.escape_solidus(true)
+               .escape_all_non_ascii(true);
+        std::string output;
+        j.dump(output, options);
+        CHECK(output == "[\"" + std::string(33, 'a') + "\\/\\u00E9" + std::string(33, 'b') + "\"]");
+    }
+}
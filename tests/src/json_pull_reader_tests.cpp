@@ -334,5 +334,135 @@ TEST_CASE("json_pull_reader object_value test")
     CHECK(reader.done());
 }
 
-
-
+TEST_CASE("json_pull_reader skip")
+{
+    std::string s = R"(
+{
+    "skipped": {"a": [1, 2, {"b": "]}"}], "c": "say \"}\" \\", "d": [[], {}]},
+    "kept": [true, "x"],
+    "last": 3
+}
+)";
+
+    SECTION("object")
+    {
+        std::istringstream is(s);
+        json_pull_reader reader(is);
+        reader.buffer_length(7); // strings and escapes cross buffer boundaries
+
+        reader.next();
+        CHECK(reader.current().as<std::string>() == "skipped");
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::begin_object);
+        reader.skip();
+        CHECK(reader.current().event_type() == staj_event_type::end_object);
+        reader.next();
+        CHECK(reader.current().as<std::string>() == "kept");
+        reader.next();
+        reader.skip();
+        CHECK(reader.current().event_type() == staj_event_type::end_array);
+        CHECK(reader.context().line() == 4);
+        reader.next();
+        CHECK(reader.current().as<std::string>() == "last");
+        reader.next();
+        reader.skip(); // a scalar stays put
+        CHECK(reader.current().as<int>() == 3);
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::end_object);
+        reader.next();
+        CHECK(reader.done());
+    }
+
+    SECTION("root")
+    {
+        json_pull_reader reader(s);
+        reader.skip();
+        CHECK(reader.current().event_type() == staj_event_type::end_object);
+        reader.next();
+        CHECK(reader.done());
+    }
+
+    SECTION("comments")
+    {
+        std::string t = R"(
+{"a":[1, /* ] */ 2, // ]
+      "a string longer than thirty two characters ]", /** } **/ 3],
+ "b":1}
+)";
+        std::istringstream is(t);
+        json_pull_reader reader(is);
+        reader.buffer_length(5); // comments cross buffer boundaries
+
+        reader.next();
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::begin_array);
+        reader.skip();
+        CHECK(reader.current().event_type() == staj_event_type::end_array);
+        CHECK(reader.context().line() == 3);
+        reader.next();
+        CHECK(reader.current().as<std::string>() == "b");
+    }
+
+    SECTION("comments not allowed")
+    {
+        std::istringstream is(R"({"a":[1, /* ] */ 2]})");
+        strict_parse_error_handler err_handler;
+        json_pull_reader reader(is, err_handler);
+
+        reader.next();
+        reader.next();
+        std::error_code ec;
+        reader.skip(ec);
+        CHECK(ec == json_errc::illegal_comment);
+    }
+
+    SECTION("filter")
+    {
+        // Rejects the end of arrays
+        class no_end_array_filter : public staj_filter
+        {
+        public:
+            size_t end_events = 0;
+
+            bool accept(const staj_event& event, const ser_context&) override
+            {
+                if (event.event_type() == staj_event_type::end_array)
+                {
+                    return false;
+                }
+                if (event.event_type() == staj_event_type::end_object)
+                {
+                    ++end_events;
+                }
+                return true;
+            }
+        };
+
+        std::istringstream is(s);
+        no_end_array_filter filter;
+        json_pull_reader reader(is, filter);
+
+        reader.next();
+        reader.next();
+        reader.skip();
+        CHECK(reader.current().event_type() == staj_event_type::end_object);
+        CHECK(filter.end_events == 1);
+        reader.next();
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::begin_array);
+        reader.skip();
+        CHECK(reader.current().event_type() == staj_event_type::name);
+        CHECK(reader.current().as<std::string>() == "last");
+    }
+
+    SECTION("unexpected eof")
+    {
+        std::string t = s.substr(0, s.find("kept"));
+        std::istringstream is(t);
+        json_pull_reader reader(is);
+
+        std::error_code ec;
+        reader.skip(ec);
+        CHECK(ec == json_errc::unexpected_eof);
+    }
+}
@@ -224,3 +224,69 @@ TEST_CASE("json_reader read from string test")
 
 
 
+
+class in_place_string_counter : public json_filter
+{
+    jsoncons::string_view input_;
+public:
+    size_t in_place_count;
+    size_t copied_count;
+
+    in_place_string_counter(json_content_handler& handler, const jsoncons::string_view& input)
+        : json_filter(handler), input_(input), in_place_count(0), copied_count(0)
+    {
+    }
+private:
+    void count(const string_view_type& s)
+    {
+        if (s.data() >= input_.data() && s.data() + s.size() <= input_.data() + input_.size())
+        {
+            ++in_place_count;
+        }
+        else
+        {
+            ++copied_count;
+        }
+    }
+
+    bool do_name(const string_view_type& name, const ser_context& context) override
+    {
+        count(name);
+        return to_handler().name(name, context);
+    }
+
+    bool do_string_value(const string_view_type& value, semantic_tag tag, const ser_context& context) override
+    {
+        count(value);
+        return to_handler().string_value(value, tag, context);
+    }
+};
+
+TEST_CASE("json_string_reader parses in place")
+{
+    std::string s = R"({"first":"Jane","last":"Roe","note":"say \"hi\""})";
+
+    json_decoder<json> decoder;
+    in_place_string_counter counter(decoder, s);
+    json_string_reader reader(s, counter);
+    reader.read();
+
+    CHECK(counter.in_place_count == 5);
+    CHECK(counter.copied_count == 1);
+
+    json j = decoder.get_result();
+    CHECK(j["note"].as<std::string>() == std::string("say \"hi\""));
+}
+
+TEST_CASE("json_string_reader with byte order mark")
+{
+    std::string s = "\xEF\xBB\xBF[\"one\",\"two\"]";
+
+    json_decoder<json> decoder;
+    json_string_reader reader(s, decoder);
+    reader.read();
+
+    json j = decoder.get_result();
+    REQUIRE(j.size() == 2);
+    CHECK(j[1].as<std::string>() == std::string("two"));
+}
@@ -371,3 +371,142 @@ TEST_CASE("own_vector json_type_traits")
     json j2 = v;
     CHECK(j2 == j);
 }
+
+// Replays recorded events, as a reader of a format that declares the 
+// lengths of arrays and objects would produce them
+class staj_event_replay : public staj_reader
+{
+    std::vector<staj_event> events_;
+    size_t index_;
+    null_ser_context context_;
+public:
+    staj_event_replay(std::vector<staj_event> events)
+        : events_(std::move(events)), index_(0)
+    {
+    }
+
+    bool done() const override
+    {
+        return index_ >= events_.size();
+    }
+
+    const staj_event& current() const override
+    {
+        return events_[index_];
+    }
+
+    void accept(json_content_handler&) override
+    {
+        throw std::runtime_error("Not expected");
+    }
+
+    void accept(json_content_handler&, std::error_code&) override
+    {
+        throw std::runtime_error("Not expected");
+    }
+
+    void next() override
+    {
+        ++index_;
+    }
+
+    void next(std::error_code&) override
+    {
+        ++index_;
+    }
+
+    const ser_context& context() const override
+    {
+        return context_;
+    }
+};
+
+TEST_CASE("decode containers with declared lengths")
+{
+    SECTION("vector")
+    {
+        std::vector<staj_event> events;
+        events.emplace_back(staj_event_type::begin_array, 1000);
+        for (int64_t i = 0; i < 1000; ++i)
+        {
+            events.emplace_back(i, semantic_tag::none);
+        }
+        events.emplace_back(staj_event_type::end_array);
+
+        staj_event_replay reader(std::move(events));
+        std::vector<int> v;
+        read_from(json(), reader, v);
+        REQUIRE(v.size() == 1000);
+        CHECK(v.capacity() == 1000);
+        CHECK(v[999] == 999);
+    }
+
+    SECTION("unordered_map of vectors")
+    {
+        std::vector<std::string> keys = {"a","b","c"};
+
+        std::vector<staj_event> events;
+        events.emplace_back(staj_event_type::begin_object, keys.size());
+        for (const auto& key : keys)
+        {
+            events.emplace_back(key.data(), key.size(), staj_event_type::name);
+            events.emplace_back(staj_event_type::begin_array, 2);
+            events.emplace_back(1.5, semantic_tag::none);
+            events.emplace_back(2.5, semantic_tag::none);
+            events.emplace_back(staj_event_type::end_array);
+        }
+        events.emplace_back(staj_event_type::end_object);
+
+        staj_event_replay reader(std::move(events));
+        std::unordered_map<std::string,std::vector<double>> m;
+        read_from(json(), reader, m);
+        REQUIRE(m.size() == 3);
+        CHECK(m["b"] == std::vector<double>{1.5,2.5});
+        CHECK(m["c"].capacity() == 2);
+    }
+
+    SECTION("json_pull_reader")
+    {
+        std::string s = R"({"a":[[1,2],[3]],"b":[]})";
+        auto m = decode_json<std::map<std::string,std::vector<std::vector<int>>>>(s);
+        REQUIRE(m.size() == 2);
+        CHECK(m["a"] == std::vector<std::vector<int>>{{1,2},{3}});
+        CHECK(m["b"].empty());
+    }
+
+    SECTION("std::array with more elements than N")
+    {
+        std::string s = R"([[1,2,3],[4]])";
+        auto v = decode_json<std::vector<std::array<int,2>>>(s);
+        REQUIRE(v.size() == 2);
+        CHECK(v[0] == (std::array<int,2>{{1,2}}));
+        CHECK(v[1] == (std::array<int,2>{{4,0}}));
+    }
+}
+
+TEST_CASE("decode containers from values of another shape")
+{
+    SECTION("converted as through json")
+    {
+        std::string s = R"({"a":["x",["y","z"]],"b":["w"]})";
+        auto m = decode_json<std::map<std::string,std::vector<std::string>>>(s);
+        REQUIRE(m.size() == 2);
+        REQUIRE(m["a"].size() == 2);
+        CHECK(m["a"][1] == json::parse(R"(["y","z"])").as<std::string>());
+        CHECK(m["b"] == std::vector<std::string>{"w"});
+    }
+
+    SECTION("rejected as through json")
+    {
+        std::string s1 = R"({"a":{"x":1},"b":[2]})";
+        CHECK_THROWS(decode_json<std::map<std::string,std::vector<int>>>(s1));
+        CHECK_THROWS(json::parse(s1).as<std::map<std::string,std::vector<int>>>());
+
+        std::string s2 = R"([[1,2],{"x":1}])";
+        CHECK_THROWS(decode_json<std::vector<std::array<int,2>>>(s2));
+
+        std::string s3 = R"([{"x":1},[2]])";
+        CHECK_THROWS(decode_json<std::vector<std::map<std::string,int>>>(s3));
+        CHECK_THROWS(json::parse(s3).as<std::vector<std::map<std::string,int>>>());
+    }
+}
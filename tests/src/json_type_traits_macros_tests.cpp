@@ -66,6 +66,39 @@ namespace json_type_traits_macros_tests {
         }
     };
 
+    struct shelf
+    {
+        std::string name;
+        std::vector<book> books;
+        std::map<std::string,book2> by_isbn;
+        book featured;
+    };
+
+    class ledger
+    {
+        std::string owner_;
+        std::vector<int64_t> entries_;
+    public:
+        ledger() = default;
+
+        ledger(const std::string& owner, const std::vector<int64_t>& entries)
+            : owner_(owner), entries_(entries)
+        {
+        }
+
+        const std::string& owner() const
+        {
+            return owner_;
+        }
+
+        const std::vector<int64_t>& entries() const
+        {
+            return entries_;
+        }
+
+        JSONCONS_TYPE_TRAITS_FRIEND;
+    };
+
 } // namespace jsoncons_member_traits_decl_tests
  
 namespace ns = json_type_traits_macros_tests;
@@ -73,6 +106,8 @@ namespace ns = json_type_traits_macros_tests;
 JSONCONS_GETTER_CTOR_TRAITS_DECL(ns::book3, author, title, price)
 JSONCONS_MEMBER_TRAITS_DECL(ns::book,author,title,price)
 JSONCONS_MEMBER_TRAITS_DECL(ns::book2,author,title,price,isbn)
+JSONCONS_MEMBER_TRAITS_DECL(ns::shelf,name,books,by_isbn,featured)
+JSONCONS_MEMBER_TRAITS_DECL(ns::ledger,owner_,entries_)
 
 TEST_CASE("JSONCONS_MEMBER_TRAITS_DECL tests")
 {
@@ -151,3 +186,103 @@ TEST_CASE("JSONCONS_GETTER_CTOR_TRAITS_DECL tests")
     }
 }
 
+
+TEST_CASE("JSONCONS_MEMBER_TRAITS_DECL encode and decode without json")
+{
+    ns::shelf shelf;
+    shelf.name = "Fiction";
+    shelf.books.push_back(ns::book{"Haruki Murakami", "Kafka on the Shore", 25.17});
+    shelf.books.push_back(ns::book{"Charles Bukowski", "Women: A Novel", 12.0});
+    shelf.by_isbn["0099448858"] = ns::book2{"Ivan Passer", "Cutter's Way", 10.99, "0099448858"};
+    shelf.featured = shelf.books[0];
+
+    SECTION("same output as through json")
+    {
+        std::string s;
+        encode_json(shelf, s);
+        CHECK(s == json(shelf).to_string());
+
+        std::string s2;
+        encode_json(ojson(), shelf, s2);
+        CHECK(s2 == ojson(shelf).to_string());
+    }
+
+    SECTION("round trip")
+    {
+        std::string s;
+        encode_json(shelf, s);
+        auto val = decode_json<ns::shelf>(s);
+
+        CHECK(val.name == shelf.name);
+        REQUIRE(val.books.size() == 2);
+        CHECK(val.books[1].title == shelf.books[1].title);
+        CHECK(val.books[1].price == Approx(shelf.books[1].price).epsilon(0.001));
+        REQUIRE(val.by_isbn.size() == 1);
+        CHECK(val.by_isbn["0099448858"].isbn == "0099448858");
+        CHECK(val.featured.author == shelf.featured.author);
+    }
+
+    SECTION("unknown members are skipped, missing members keep their defaults")
+    {
+        std::string s = R"(
+        {
+            "location" : {"floor" : 2, "aisles" : [[1,2],[3]]},
+            "books" : [{"title" : "Dune", "pages" : [412, {"preface" : []}]}],
+            "name" : "Science Fiction"
+        }
+        )";
+        auto val = decode_json<ns::shelf>(s);
+
+        CHECK(val.name == "Science Fiction");
+        REQUIRE(val.books.size() == 1);
+        CHECK(val.books[0].title == "Dune");
+        CHECK(val.books[0].author.empty());
+        CHECK(val.by_isbn.empty());
+    }
+
+    SECTION("private members")
+    {
+        ns::ledger ledger("Jane Roe", {100, -25, 40});
+
+        std::string s;
+        encode_json(ledger, s);
+        CHECK(s == R"({"entries_":[100,-25,40],"owner_":"Jane Roe"})");
+
+        auto val = decode_json<ns::ledger>(s);
+        CHECK(val.owner() == ledger.owner());
+        CHECK(val.entries() == ledger.entries());
+    }
+
+    SECTION("member of another type")
+    {
+        // Converted as through json, and the members after it are still read
+        std::string s = R"({"author":["x","y"],"title":"T","price":1.5})";
+        auto val = decode_json<ns::book>(s);
+        CHECK(val.author == json::parse(R"(["x","y"])").as<std::string>());
+        CHECK(val.title == "T");
+        CHECK(val.price == 1.5);
+
+        std::string s2 = R"({"author":"A","price":{"amount":1.5},"title":"T"})";
+        CHECK_THROWS(decode_json<ns::book>(s2));
+        CHECK_THROWS(json::parse(s2).as<ns::book>());
+    }
+}
+
+TEST_CASE("decode nested containers")
+{
+    SECTION("vector of vectors")
+    {
+        auto v = decode_json<std::vector<std::vector<int>>>(std::string("[[1,2],[],[3]]"));
+        REQUIRE(v.size() == 3);
+        CHECK(v[0] == std::vector<int>{1,2});
+        CHECK(v[1].empty());
+        CHECK(v[2] == std::vector<int>{3});
+    }
+    SECTION("map of objects")
+    {
+        auto m = decode_json<std::map<std::string,ns::book>>(std::string(R"({"a":{"title":"A"},"b":{"title":"B"}})"));
+        REQUIRE(m.size() == 2);
+        CHECK(m["a"].title == "A");
+        CHECK(m["b"].title == "B");
+    }
+}
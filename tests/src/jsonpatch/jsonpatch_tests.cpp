@@ -494,3 +494,249 @@ TEST_CASE("add_when_new_items_in_target_array2")
 
 
 
+
+TEST_CASE("from_diff_unchanged_documents")
+{
+    json source = R"(
+        {"a": [1, 2, {"b": "c"}], "d": 1.5}
+    )"_json;
+    json target = source;
+
+    json patch = jsonpatch::from_diff(source, target);
+    CHECK(patch == json::array());
+}
+
+TEST_CASE("from_diff_insert_at_front_of_array")
+{
+    json source = R"(
+        {"foo": [1, 2, 3, 4, 5]}
+    )"_json;
+    json target = R"(
+        {"foo": [0, 1, 2, 3, 4, 5]}
+    )"_json;
+
+    json patch = jsonpatch::from_diff(source, target);
+    CHECK(patch == json::parse(R"([{"op":"add","path":"/foo/0","value":0}])"));
+
+    check_patch(source,patch,std::error_code(),target);
+}
+
+TEST_CASE("from_diff_remove_from_middle_of_array")
+{
+    json source = R"(
+        ["a", "b", "c", "d", "e"]
+    )"_json;
+    json target = R"(
+        ["a", "b", "d", "e"]
+    )"_json;
+
+    json patch = jsonpatch::from_diff(source, target);
+    CHECK(patch == json::parse(R"([{"op":"remove","path":"/2"}])"));
+
+    check_patch(source,patch,std::error_code(),target);
+}
+
+TEST_CASE("from_diff_moved_array_element")
+{
+    json source = R"(
+        [{"id": 1}, {"id": 2}, {"id": 3}, {"id": 4}]
+    )"_json;
+    json target = R"(
+        [{"id": 2}, {"id": 3}, {"id": 4}, {"id": 1}]
+    )"_json;
+
+    json patch = jsonpatch::from_diff(source, target);
+    REQUIRE(patch.size() == 1);
+    CHECK(patch[0]["op"].as<std::string>() == "move");
+
+    check_patch(source,patch,std::error_code(),target);
+}
+
+TEST_CASE("from_diff_changed_array_element")
+{
+    json source = R"(
+        [{"id": 1, "on": true}, {"id": 2, "on": true}, {"id": 3, "on": true}]
+    )"_json;
+    json target = R"(
+        [{"id": 1, "on": true}, {"id": 2, "on": false}, {"id": 3, "on": true}]
+    )"_json;
+
+    json patch = jsonpatch::from_diff(source, target);
+    CHECK(patch == json::parse(R"([{"op":"replace","path":"/1/on","value":false}])"));
+
+    check_patch(source,patch,std::error_code(),target);
+}
+
+TEST_CASE("from_diff_renamed_object_member")
+{
+    json source = R"(
+        {"a/b": {"x": [1, 2, 3]}, "c": 1}
+    )"_json;
+    json target = R"(
+        {"d~e": {"x": [1, 2, 3]}, "c": 1}
+    )"_json;
+
+    json patch = jsonpatch::from_diff(source, target);
+    CHECK(patch == json::parse(R"([{"op":"move","from":"/a~1b","path":"/d~0e"}])"));
+
+    check_patch(source,patch,std::error_code(),target);
+}
+
+TEST_CASE("from_diff_large_array_with_scattered_changes")
+{
+    json source = json::array();
+    for (int i = 0; i < 5000; ++i)
+    {
+        json item;
+        item["id"] = i;
+        source.push_back(std::move(item));
+    }
+    json target = source;
+    target.erase(target.array_range().begin() + 4000);
+    target[3000]["id"] = -1;
+    target.insert(target.array_range().begin() + 2000, json(json::array()));
+    json moved = target[100];
+    target.erase(target.array_range().begin() + 100);
+    target.push_back(std::move(moved));
+    target.erase(target.array_range().begin());
+
+    json patch = jsonpatch::from_diff(source, target);
+    CHECK(patch.size() <= 5);
+
+    check_patch(source,patch,std::error_code(),target);
+}
+
+TEST_CASE("jsonpatch_expression_apply_to_many_documents")
+{
+    json patch = R"(
+        [
+            { "op": "test", "path": "/kind", "value": "order" },
+            { "op": "replace", "path": "/status", "value": "shipped" },
+            { "op": "move", "from": "/items/0", "path": "/items/-" },
+            { "op": "copy", "from": "/status", "path": "/history/-" },
+            { "op": "remove", "path": "/draft" }
+        ]
+    )"_json;
+
+    auto expr = jsonpatch::jsonpatch_expression<json>::compile(patch);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        json doc = json::parse(R"({"kind":"order","status":"new","items":[1,2,)" + std::to_string(i) + R"(],"history":[],"draft":true})");
+        json expected = json::parse(R"({"kind":"order","status":"shipped","items":[2,)" + std::to_string(i) + R"(,1],"history":["shipped"]})");
+
+        std::error_code ec;
+        expr.apply(doc, ec);
+        CHECK_FALSE(ec);
+        CHECK(doc == expected);
+    }
+}
+
+TEST_CASE("jsonpatch_expression_rollback")
+{
+    json patch = R"(
+        [
+            { "op": "add", "path": "/a/-", "value": 4 },
+            { "op": "move", "from": "/a/0", "path": "/b" },
+            { "op": "replace", "path": "/c", "value": {"d": 1} },
+            { "op": "remove", "path": "/e" },
+            { "op": "copy", "from": "/c", "path": "/f" },
+            { "op": "add", "path": "/g", "value": true },
+            { "op": "test", "path": "/h", "value": 1 }
+        ]
+    )"_json;
+    json original = R"(
+        {"a": [1, 2, 3], "b": 0, "c": 5, "e": [6], "g": false}
+    )"_json;
+
+    auto expr = jsonpatch::jsonpatch_expression<json>::compile(patch);
+
+    SECTION("rollback by default")
+    {
+        json doc = original;
+        std::error_code ec;
+        expr.apply(doc, ec);
+        CHECK(ec == jsonpatch::jsonpatch_errc::test_failed);
+        CHECK(doc == original);
+    }
+
+    SECTION("no rollback")
+    {
+        json doc = original;
+        std::error_code ec;
+        expr.apply(doc, jsonpatch::jsonpatch_options().rollback(false), ec);
+        CHECK(ec == jsonpatch::jsonpatch_errc::test_failed);
+        CHECK(doc == json::parse(R"({"a":[2,3,4],"b":1,"c":{"d":1},"f":{"d":1},"g":true})"));
+    }
+
+    SECTION("throws")
+    {
+        json doc = original;
+        REQUIRE_THROWS_AS(expr.apply(doc), jsonpatch::jsonpatch_error);
+        CHECK(doc == original);
+    }
+}
+
+TEST_CASE("jsonpatch_expression_compile_errors")
+{
+    std::vector<std::string> patches = {
+        R"({"op": "add", "path": "/a", "value": 1})",
+        R"([{"op": "add", "path": "/a"}])",
+        R"([{"op": "move", "path": "/a"}])",
+        R"([{"path": "/a", "value": 1}])",
+        R"([{"op": "frobnicate", "path": "/a"}])"
+    };
+    for (const auto& s : patches)
+    {
+        std::error_code ec;
+        jsonpatch::jsonpatch_expression<json>::compile(json::parse(s), ec);
+        CHECK(ec == jsonpatch::jsonpatch_errc::invalid_patch);
+
+        REQUIRE_THROWS_AS(jsonpatch::jsonpatch_expression<json>::compile(json::parse(s)), jsonpatch::jsonpatch_error);
+    }
+
+    std::error_code ec;
+    jsonpatch::jsonpatch_expression<json>::compile(json::parse(R"([{"op": "remove", "path": "/a~2"}])"), ec);
+    CHECK(ec == jsonpatch::jsonpatch_errc::remove_failed);
+}
+
+TEST_CASE("jsonpatch_expression_copies")
+{
+    auto expr = jsonpatch::jsonpatch_expression<ojson>::compile(ojson::parse(R"([{"op": "add", "path": "/b", "value": [1,2]}])"));
+    auto copy = expr;
+    auto moved = std::move(expr);
+
+    ojson doc1 = ojson::parse(R"({"a":1})");
+    copy.apply(doc1);
+    CHECK(doc1 == ojson::parse(R"({"a":1,"b":[1,2]})"));
+
+    ojson doc2 = ojson::parse(R"({"a":1})");
+    moved.apply(doc2);
+    CHECK(doc2 == doc1);
+}
+
+TEST_CASE("move_into_own_child")
+{
+    json target = R"(
+        {"a": {"b": 1}}
+    )"_json;
+    json patch = R"(
+        [{"op": "move", "from": "/a", "path": "/a/c"}]
+    )"_json;
+
+    json expected = target;
+    check_patch(target,patch,jsonpatch::jsonpatch_errc::move_failed,expected);
+}
+
+TEST_CASE("replace_the_whole_document")
+{
+    json target = R"(
+        {"a": 1}
+    )"_json;
+    json patch = R"(
+        [{"op": "replace", "path": "", "value": [1, 2]}, {"op": "add", "path": "/-", "value": 3}]
+    )"_json;
+
+    json expected = R"([1, 2, 3])"_json;
+    check_patch(target,patch,std::error_code(),expected);
+}
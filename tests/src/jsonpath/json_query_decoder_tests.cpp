@@ -0,0 +1,158 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_pull_reader.hpp>
+#include <jsoncons_ext/jsonpath/json_query_decoder.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <catch/catch.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+using namespace jsoncons;
+
+const std::string store_text = R"(
+{
+    "store": {
+        "book": [
+            {
+                "category": "reference",
+                "author": "Nigel Rees",
+                "title": "Sayings of the Century",
+                "price": 8.95
+            },
+            {
+                "category": "fiction",
+                "author": "Evelyn Waugh",
+                "title": "Sword of Honour",
+                "price": 12.99
+            },
+            {
+                "category": "fiction",
+                "author": "Herman Melville",
+                "title": "Moby Dick",
+                "isbn": "0-553-21311-3",
+                "price": 8.99
+            },
+            {
+                "category": "fiction",
+                "author": "J. R. R. Tolkien",
+                "title": "The Lord of the Rings",
+                "isbn": "0-395-19395-8",
+                "price": 22.99
+            }
+        ],
+        "bicycle": {
+            "color": "red",
+            "price": 19.95
+        }
+    }
+}
+)";
+
+json sorted(json a)
+{
+    std::sort(a.array_range().begin(), a.array_range().end());
+    return a;
+}
+
+TEST_CASE("decode_json_query selects the same values as json_query")
+{
+    json store = json::parse(store_text);
+
+    std::vector<std::string> paths = {"$", "$.store.book[0].title", "$..price", "$.store.*", "$..book[1:3].title",
+                                      "$.store.book[:2].author", "$.store.book[0:4:2].title", "$.store.book[*].author",
+                                      "$.store.book[0,2]['title','price']", "$..book[?(@.price < 10)].title",
+                                      "$..book[?(@.isbn)]", "$.store.book[?(@.author =~ /.*Tolkien/)].price",
+                                      "store.bicycle.color", "$.store.book.1.title", "$.nothing"};
+    for (const auto& path : paths)
+    {
+        std::istringstream is(store_text);
+        json result = jsonpath::decode_json_query<json>(is, path);
+
+        json expected = jsonpath::json_query(store, path);
+        CHECK(sorted(result) == sorted(expected));
+    }
+}
+
+TEST_CASE("decode_json_query returns values in document order")
+{
+    std::istringstream is(store_text);
+    json result = jsonpath::decode_json_query<json>(is, "$..price");
+    CHECK(result == json::parse("[8.95,12.99,8.99,22.99,19.95]"));
+}
+
+TEST_CASE("decode_json_query with nested matches")
+{
+    std::string text = R"({"a":{"a":{"a":1}},"b":[{"a":2}]})";
+    std::istringstream is(text);
+    json result = jsonpath::decode_json_query<json>(is, "$..a");
+    CHECK(result == json::parse(R"([{"a":{"a":1}},{"a":1},1,2])"));
+}
+
+TEST_CASE("decode_json_query with staj reader")
+{
+    json_pull_reader reader(store_text);
+    json result = jsonpath::decode_json_query<json>(reader, "$.store.book[?(@.price > 10)].title");
+    CHECK(result == json::parse(R"(["Sword of Honour","The Lord of the Rings"])"));
+}
+
+TEST_CASE("decode_json_query from the current event of a staj reader")
+{
+    json_pull_reader reader(store_text);
+    while (!reader.done() && reader.current().event_type() != staj_event_type::begin_array)
+    {
+        reader.next();
+    }
+    REQUIRE_FALSE(reader.done());
+    json result = jsonpath::decode_json_query<json>(reader, "$[1:].author");
+    CHECK(result == json::parse(R"(["Evelyn Waugh","Herman Melville","J. R. R. Tolkien"])"));
+}
+
+TEST_CASE("json_query_decoder with cbor reader")
+{
+    std::vector<uint8_t> data;
+    cbor::encode_cbor(json::parse(store_text), data);
+
+    jsonpath::json_query_decoder<json> decoder("$.store.bicycle");
+    cbor::cbor_bytes_reader reader(data, decoder);
+    reader.read();
+    CHECK(decoder.get_result() == json::parse(R"([{"color":"red","price":19.95}])"));
+}
+
+TEST_CASE("decode_json_query unsupported selectors")
+{
+    std::vector<std::string> paths = {"$.store.book[-1]", "$.store.book[-2:]", "$.store.book[(@.length-1)]",
+                                      "$.store.book[::-1]", "count($.store.book)",
+                                      "$.store.book[?(@.price < $.store.bicycle.price)].title"};
+    for (const auto& path : paths)
+    {
+        std::istringstream is(store_text);
+        REQUIRE_THROWS_AS(jsonpath::decode_json_query<json>(is, path), jsonpath::jsonpath_error);
+    }
+}
+
+
+TEST_CASE("json_query_decoder filter over many elements")
+{
+    std::string s = R"({"a":[{"x":1,"c":[{"x":2},{"y":3}]},{"y":4},{"x":5}]})";
+    std::istringstream is(s);
+    json result = jsonpath::decode_json_query<json>(is, "$..[?(@.x)]");
+    CHECK(result == json::parse(R"([{"x":1,"c":[{"x":2},{"y":3}]},{"x":2},{"x":5}])"));
+
+    std::string items = "[";
+    for (int i = 0; i < 1000; ++i)
+    {
+        items += (i == 0 ? "" : ",");
+        items += "{\"v\":" + std::to_string(i) + (i % 100 == 0 ? ",\"keep\":true}" : "}");
+    }
+    items += "]";
+    std::istringstream is2(items);
+    json result2 = jsonpath::decode_json_query<json>(is2, "$[?(@.keep)].v");
+    CHECK(result2 == json::parse("[0,100,200,300,400,500,600,700,800,900]"));
+}
@@ -0,0 +1,117 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+#include <catch/catch.hpp>
+#include <thread>
+#include <vector>
+#include <string>
+
+using namespace jsoncons;
+
+json make_store(double limit, size_t count)
+{
+    json store;
+    store["limit"] = limit;
+    store["book"] = json::array();
+    for (size_t i = 0; i < count; ++i)
+    {
+        json book;
+        book["title"] = "Book " + std::to_string(i);
+        book["author"] = (i % 2 == 0) ? "Evelyn Waugh" : "Herman Melville";
+        book["price"] = 5.0 + static_cast<double>(i);
+        store["book"].push_back(std::move(book));
+    }
+    return store;
+}
+
+TEST_CASE("jsonpath_expression evaluated against several documents")
+{
+    auto expr = jsonpath::jsonpath_expression<json>::compile("$.book[?(@.price < max($.limit) && @.author =~ /evelyn.*/i)].title");
+
+    json store1 = make_store(8.0, 4);
+    json store2 = make_store(100.0, 6);
+
+    CHECK(expr.evaluate(store1) == json::parse(R"(["Book 0","Book 2"])"));
+    CHECK(expr.evaluate(store2) == json::parse(R"(["Book 0","Book 2","Book 4"])"));
+    CHECK(expr.evaluate(store1) == json::parse(R"(["Book 0","Book 2"])"));
+
+    CHECK(expr.evaluate(store1, jsonpath::result_type::path) == json::parse(R"(["$['book'][0]['title']","$['book'][2]['title']"])"));
+}
+
+TEST_CASE("jsonpath_expression agrees with json_query")
+{
+    json store = make_store(7.0, 5);
+
+    std::vector<std::string> paths = {"$..price", "$.book[1:3].title", "$.book[-1:]", "$.book[(@.length-1)].title",
+                                      "$.book[0,2].price", "$..book[?(@.price > 6)].author", "max($.book[*].price)",
+                                      "$.book[*]['title','price']", "$.book.length"};
+    for (const auto& path : paths)
+    {
+        auto expr = jsonpath::jsonpath_expression<json>::compile(path);
+        CHECK(expr.evaluate(store) == jsonpath::json_query(store, path));
+        CHECK(expr.evaluate(store, jsonpath::result_type::path) == jsonpath::json_query(store, path, jsonpath::result_type::path));
+    }
+}
+
+TEST_CASE("jsonpath_expression replace")
+{
+    auto expr = jsonpath::jsonpath_expression<json>::compile("$.book[?(@.price > 5.5)].price");
+
+    json store = make_store(0.0, 3);
+    expr.replace(store, 10.0);
+
+    CHECK(store["book"][0]["price"].as<double>() == 5.0);
+    CHECK(store["book"][1]["price"].as<double>() == 10.0);
+    CHECK(store["book"][2]["price"].as<double>() == 10.0);
+}
+
+TEST_CASE("jsonpath_expression compile errors")
+{
+    SECTION("throws")
+    {
+        REQUIRE_THROWS_AS(jsonpath::jsonpath_expression<json>::compile("$.book[?(@.price > 6"), jsonpath::jsonpath_error);
+    }
+    SECTION("error code")
+    {
+        std::error_code ec;
+        jsonpath::jsonpath_expression<json>::compile("$.book[1", ec);
+        CHECK(ec == jsonpath::jsonpath_errc::unexpected_end_of_input);
+    }
+}
+
+TEST_CASE("jsonpath_expression evaluated concurrently")
+{
+    const auto expr = jsonpath::jsonpath_expression<json>::compile("$.book[?(@.price < max($.limit) && @.author =~ /.*Waugh/)].title");
+
+    const size_t num_threads = 4;
+    std::vector<json> results(num_threads);
+    std::vector<json> expected(num_threads);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < num_threads; ++i)
+    {
+        json store = make_store(5.0 + 10.0*static_cast<double>(i), 40);
+        expected[i] = jsonpath::json_query(store, "$.book[?(@.price < max($.limit) && @.author =~ /.*Waugh/)].title");
+        threads.emplace_back([&expr,&results,i](json doc)
+        {
+            for (size_t k = 0; k < 50; ++k)
+            {
+                results[i] = expr.evaluate(doc);
+            }
+        }, std::move(store));
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    for (size_t i = 0; i < num_threads; ++i)
+    {
+        CHECK(results[i] == expected[i]);
+        CHECK(results[i].size() == (i == 0 ? 0 : 5*i));
+    }
+}
+
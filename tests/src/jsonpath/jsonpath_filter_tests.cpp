@@ -54,28 +54,28 @@ TEST_CASE("test_div")
     context.push_back(3);
 
     std::string s1 = "(3/1)";
-    auto expr1 = parser.parse(context,s1.c_str(), s1.c_str()+ s1.length(), &pend);
-    auto result1 = expr1.eval(context);
+    auto expr1 = parser.parse(s1.c_str(), s1.c_str()+ s1.length(), &pend);
+    auto result1 = expr1.eval(context, context);
     CHECK(json(3) == result1);
 
     std::string s2 = "(3/@.length)";
-    auto expr2 = parser.parse(context,s2.c_str(), s2.c_str()+ s2.length(), &pend);
-    auto result2 = expr2.eval(context);
+    auto expr2 = parser.parse(s2.c_str(), s2.c_str()+ s2.length(), &pend);
+    auto result2 = expr2.eval(context, context);
     CHECK(json(3) == result2);
 
     std::string s3 = "(5/2)";
-    auto expr3 = parser.parse(context,s3.c_str(), s3.c_str()+ s3.length(), &pend);
-    auto result3 = expr3.eval(context);
+    auto expr3 = parser.parse(s3.c_str(), s3.c_str()+ s3.length(), &pend);
+    auto result3 = expr3.eval(context, context);
     CHECK(json(2.5) == result3);
 
     std::string s4 = "(@.length/3)";
-    auto expr4 = parser.parse(context,s4.c_str(), s4.c_str()+ s4.length(), &pend);
-    auto result4 = expr4.eval(context);
+    auto expr4 = parser.parse(s4.c_str(), s4.c_str()+ s4.length(), &pend);
+    auto result4 = expr4.eval(context, context);
     CHECK(0.333333 == Approx(result4.as<double>()).epsilon(0.001));
 
     std::string s5 = "(@.0/@.length)";
-    auto expr5 = parser.parse(context,s5.c_str(), s5.c_str()+ s5.length(), &pend);
-    auto result5 = expr5.eval(context);
+    auto expr5 = parser.parse(s5.c_str(), s5.c_str()+ s5.length(), &pend);
+    auto result5 = expr5.eval(context, context);
     CHECK(json(3) == result5);
 }
 
@@ -89,28 +89,28 @@ TEST_CASE("test_mult")
     context.push_back(2);
 
     std::string s1 = "(3*1)";
-    auto expr1 = parser.parse(context, s1.c_str(), s1.c_str()+ s1.length(), &pend);
-    auto result1 = expr1.eval(context);
+    auto expr1 = parser.parse(s1.c_str(), s1.c_str()+ s1.length(), &pend);
+    auto result1 = expr1.eval(context, context);
     CHECK(json(3) == result1);
 
     std::string s2 = "(3*@.length)";
-    auto expr2 = parser.parse(context, s2.c_str(), s2.c_str()+ s2.length(), &pend);
-    auto result2 = expr2.eval(context);
+    auto expr2 = parser.parse(s2.c_str(), s2.c_str()+ s2.length(), &pend);
+    auto result2 = expr2.eval(context, context);
     CHECK(json(6) == result2);
 
     std::string s3 = "(5*2)";
-    auto expr3 = parser.parse(context, s3.c_str(), s3.c_str()+ s3.length(), &pend);
-    auto result3 = expr3.eval(context);
+    auto expr3 = parser.parse(s3.c_str(), s3.c_str()+ s3.length(), &pend);
+    auto result3 = expr3.eval(context, context);
     CHECK(json(10) == result3);
 
     std::string s4 = "(@.length*3)";
-    auto expr4 = parser.parse(context, s4.c_str(), s4.c_str()+ s4.length(), &pend);
-    auto result4 = expr4.eval(context);
+    auto expr4 = parser.parse(s4.c_str(), s4.c_str()+ s4.length(), &pend);
+    auto result4 = expr4.eval(context, context);
     CHECK(json(6) == result4);
 
     std::string s5 = "(@.length*@.1)";
-    auto expr5 = parser.parse(context, s5.c_str(), s5.c_str()+ s5.length(), &pend);
-    auto result5 = expr5.eval(context);
+    auto expr5 = parser.parse(s5.c_str(), s5.c_str()+ s5.length(), &pend);
+    auto result5 = expr5.eval(context, context);
     CHECK(json(4) == result5);
 }
 
@@ -123,28 +123,28 @@ TEST_CASE("test_minus")
     context.push_back(10.0);
 
     std::string s1 = "(3-1)";
-    auto expr1 = parser.parse(context, s1.c_str(), s1.c_str()+ s1.length(), &pend);
-    auto result1 = expr1.eval(context);
+    auto expr1 = parser.parse(s1.c_str(), s1.c_str()+ s1.length(), &pend);
+    auto result1 = expr1.eval(context, context);
     CHECK(json(2) == result1);
 
     std::string s2 = "(3-@.length)";
-    auto expr2 = parser.parse(context, s2.c_str(), s2.c_str()+ s2.length(), &pend);
-    auto result2 = expr2.eval(context);
+    auto expr2 = parser.parse(s2.c_str(), s2.c_str()+ s2.length(), &pend);
+    auto result2 = expr2.eval(context, context);
     CHECK(json(2) == result2);
 
     std::string s3 = "(3.5-1.0)";
-    auto expr3 = parser.parse(context, s3.c_str(), s3.c_str()+ s3.length(), &pend);
-    auto result3 = expr3.eval(context);
+    auto expr3 = parser.parse(s3.c_str(), s3.c_str()+ s3.length(), &pend);
+    auto result3 = expr3.eval(context, context);
     CHECK(json(2.5) == result3);
 
     std::string s4 = "(@.length-3)";
-    auto expr4 = parser.parse(context, s4.c_str(), s4.c_str()+ s4.length(), &pend);
-    auto result4 = expr4.eval(context);
+    auto expr4 = parser.parse(s4.c_str(), s4.c_str()+ s4.length(), &pend);
+    auto result4 = expr4.eval(context, context);
     CHECK(json(-2) ==result4);
 
     std::string s5 = "(@.length-@.0)";
-    auto expr5 = parser.parse(context, s5.c_str(), s5.c_str()+ s5.length(), &pend);
-    auto result5 = expr5.eval(context);
+    auto expr5 = parser.parse(s5.c_str(), s5.c_str()+ s5.length(), &pend);
+    auto result5 = expr5.eval(context, context);
     CHECK(json(-9) ==result5);
 }
 
@@ -158,33 +158,33 @@ TEST_CASE("test_lt")
     context.push_back(1);
 
     std::string s1 = "(3 < 1)";
-    auto expr1 = parser.parse(context, s1.c_str(), s1.c_str()+ s1.length(), &pend);
-    auto result1 = expr1.eval(context);
+    auto expr1 = parser.parse(s1.c_str(), s1.c_str()+ s1.length(), &pend);
+    auto result1 = expr1.eval(context, context);
     CHECK(result1 == json(false));
 
     std::string s2 = "(3 < @.length)";
-    auto expr2 = parser.parse(context, s2.c_str(), s2.c_str()+ s2.length(), &pend);
-    auto result2 = expr2.eval(context);
+    auto expr2 = parser.parse(s2.c_str(), s2.c_str()+ s2.length(), &pend);
+    auto result2 = expr2.eval(context, context);
     CHECK(result2 == json(false));
 
     std::string s3 = "(@.length < 3)";
-    auto expr3 = parser.parse(context, s3.c_str(), s3.c_str()+ s3.length(), &pend);
-    auto result3 = expr3.eval(context);
+    auto expr3 = parser.parse(s3.c_str(), s3.c_str()+ s3.length(), &pend);
+    auto result3 = expr3.eval(context, context);
     CHECK(result3 == json(true));
 
     std::string s4 = "(@.length < @.length)";
-    auto expr4 = parser.parse(context, s4.c_str(), s4.c_str()+ s4.length(), &pend);
-    auto result4 = expr4.eval(context);
+    auto expr4 = parser.parse(s4.c_str(), s4.c_str()+ s4.length(), &pend);
+    auto result4 = expr4.eval(context, context);
     CHECK(result4 == json(false));
 
     std::string s5 = "(@.length < @.0)";
-    auto expr5 = parser.parse(context, s5.c_str(), s5.c_str()+ s5.length(), &pend);
-    auto result5 = expr5.eval(context);
+    auto expr5 = parser.parse(s5.c_str(), s5.c_str()+ s5.length(), &pend);
+    auto result5 = expr5.eval(context, context);
     CHECK(json(true) == result5);
 
     std::string s6 = "(@.length < @.1)";
-    auto expr6 = parser.parse(context, s6.c_str(), s6.c_str()+ s6.length(), &pend);
-    auto result6 = expr6.eval(context);
+    auto expr6 = parser.parse(s6.c_str(), s6.c_str()+ s6.length(), &pend);
+    auto result6 = expr6.eval(context, context);
     CHECK(json(false) == result6);
 }
 
@@ -197,13 +197,13 @@ TEST_CASE("test_lte")
     context.push_back(1);
 
     std::string s1 = "(3 <= 1)";
-    auto expr1 = parser.parse(context, s1.c_str(), s1.c_str()+ s1.length(), &pend);
-    auto result1 = expr1.eval(context);
+    auto expr1 = parser.parse(s1.c_str(), s1.c_str()+ s1.length(), &pend);
+    auto result1 = expr1.eval(context, context);
     CHECK(result1 == json(false));
 
     std::string s2 = "(3 <= @.length)";
-    auto expr2 = parser.parse(context, s2.c_str(), s2.c_str()+ s2.length(), &pend);
-    auto result2 = expr2.eval(context);
+    auto expr2 = parser.parse(s2.c_str(), s2.c_str()+ s2.length(), &pend);
+    auto result2 = expr2.eval(context, context);
     CHECK(result2 == json(false));
 }
 
@@ -216,13 +216,13 @@ TEST_CASE("test_gt")
     context.push_back(1);
 
     std::string s1 = "(3 > 1)";
-    auto expr1 = parser.parse(context, s1.c_str(), s1.c_str()+ s1.length(), &pend);
-    auto result1 = expr1.eval(context);
+    auto expr1 = parser.parse(s1.c_str(), s1.c_str()+ s1.length(), &pend);
+    auto result1 = expr1.eval(context, context);
     CHECK(result1 == json(true));
 
     std::string s2 = "(3 > @.length)";
-    auto expr2 = parser.parse(context, s2.c_str(), s2.c_str()+ s2.length(), &pend);
-    auto result2 = expr2.eval(context);
+    auto expr2 = parser.parse(s2.c_str(), s2.c_str()+ s2.length(), &pend);
+    auto result2 = expr2.eval(context, context);
     CHECK(result2 == json(true));
 }
 
@@ -235,13 +235,13 @@ TEST_CASE("test_gte")
     context.push_back(1);
 
     std::string s1 = "(3 >= 1)";
-    auto expr1 = parser.parse(context, s1.c_str(), s1.c_str()+ s1.length(), &pend);
-    auto result1 = expr1.eval(context);
+    auto expr1 = parser.parse(s1.c_str(), s1.c_str()+ s1.length(), &pend);
+    auto result1 = expr1.eval(context, context);
     CHECK(result1 == json(true));
 
     std::string s2 = "(3 >= @.length)";
-    auto expr2 = parser.parse(context, s2.c_str(), s2.c_str()+ s2.length(), &pend);
-    auto result2 = expr2.eval(context);
+    auto expr2 = parser.parse(s2.c_str(), s2.c_str()+ s2.length(), &pend);
+    auto result2 = expr2.eval(context, context);
     CHECK(result2 == json(true));
 }
 
@@ -254,23 +254,23 @@ TEST_CASE("test_eq")
     context.push_back(1);
 
     std::string s1 = "(3 == 1)";
-    auto expr1 = parser.parse(context, s1.c_str(), s1.c_str()+ s1.length(), &pend);
-    auto result1 = expr1.eval(context);
+    auto expr1 = parser.parse(s1.c_str(), s1.c_str()+ s1.length(), &pend);
+    auto result1 = expr1.eval(context, context);
     CHECK(result1 == json(false));
 
     std::string s2 = "(3 == @.length)";
-    auto expr2 = parser.parse(context, s2.c_str(), s2.c_str()+ s2.length(), &pend);
-    auto result2 = expr2.eval(context);
+    auto expr2 = parser.parse(s2.c_str(), s2.c_str()+ s2.length(), &pend);
+    auto result2 = expr2.eval(context, context);
     CHECK(result2 == json(false));
 
     std::string s3 = "(1 == 1)";
-    auto expr3 = parser.parse(context, s3.c_str(), s3.c_str()+ s3.length(), &pend);
-    auto result3 = expr3.eval(context);
+    auto expr3 = parser.parse(s3.c_str(), s3.c_str()+ s3.length(), &pend);
+    auto result3 = expr3.eval(context, context);
     CHECK(result3 == json(true));
 
     std::string s4 = "(1 == @.length)";
-    auto expr4 = parser.parse(context, s4.c_str(), s4.c_str()+ s4.length(), &pend);
-    auto result4 = expr4.eval(context);
+    auto expr4 = parser.parse(s4.c_str(), s4.c_str()+ s4.length(), &pend);
+    auto result4 = expr4.eval(context, context);
     CHECK(result4 == json(true));
 }
 
@@ -284,23 +284,23 @@ TEST_CASE("test_precedence")
     context.push_back(2);
 
     std::string s1 = "(@.0 == 1 && @.1 == 2)";
-    auto expr1 = parser.parse(context, s1.c_str(), s1.c_str()+ s1.length(), &pend);
-    auto result1 = expr1.eval(context);
+    auto expr1 = parser.parse(s1.c_str(), s1.c_str()+ s1.length(), &pend);
+    auto result1 = expr1.eval(context, context);
     CHECK(result1 == json(true));
 
     std::string s2 = "((@.0 == 1) && (@.1 == 2))";
-    auto expr2 = parser.parse(context, s2.c_str(), s2.c_str()+ s2.length(), &pend);
-    auto result2 = expr2.eval(context);
+    auto expr2 = parser.parse(s2.c_str(), s2.c_str()+ s2.length(), &pend);
+    auto result2 = expr2.eval(context, context);
     CHECK(result2 == json(true));
 
     std::string s3 = "(@.0 == 2 && @.1 == 2)";
-    auto expr3 = parser.parse(context, s3.c_str(), s3.c_str()+ s3.length(), &pend);
-    auto result3 = expr3.eval(context);
+    auto expr3 = parser.parse(s3.c_str(), s3.c_str()+ s3.length(), &pend);
+    auto result3 = expr3.eval(context, context);
     CHECK(result3 == json(false));
 
     std::string s4 = "((@.0 == 1) && (@.1 == 1))";
-    auto expr4 = parser.parse(context, s4.c_str(), s4.c_str()+ s4.length(), &pend);
-    auto result4 = expr4.eval(context);
+    auto expr4 = parser.parse(s4.c_str(), s4.c_str()+ s4.length(), &pend);
+    auto result4 = expr4.eval(context, context);
     CHECK(result4 == json(false));
 }
 
@@ -313,23 +313,23 @@ TEST_CASE("test_ne")
     context.push_back(1);
 
     std::string s1 = "(3 != 1)";
-    auto expr1 = parser.parse(context, s1.c_str(), s1.c_str()+ s1.length(), &pend);
-    auto result1 = expr1.eval(context);
+    auto expr1 = parser.parse(s1.c_str(), s1.c_str()+ s1.length(), &pend);
+    auto result1 = expr1.eval(context, context);
     CHECK(result1 == json(true));
 
     std::string s2 = "(3 != @.length)";
-    auto expr2 = parser.parse(context, s2.c_str(), s2.c_str()+ s2.length(), &pend);
-    auto result2 = expr2.eval(context);
+    auto expr2 = parser.parse(s2.c_str(), s2.c_str()+ s2.length(), &pend);
+    auto result2 = expr2.eval(context, context);
     CHECK(result2 == json(true));
 
     std::string s3 = "(1 != 1)";
-    auto expr3 = parser.parse(context, s3.c_str(), s3.c_str()+ s3.length(), &pend);
-    auto result3 = expr3.eval(context);
+    auto expr3 = parser.parse(s3.c_str(), s3.c_str()+ s3.length(), &pend);
+    auto result3 = expr3.eval(context, context);
     CHECK(result3 == json(false));
 
     std::string s4 = "(1 != @.length)";
-    auto expr4 = parser.parse(context, s4.c_str(), s4.c_str()+ s4.length(), &pend);
-    auto result4 = expr4.eval(context);
+    auto expr4 = parser.parse(s4.c_str(), s4.c_str()+ s4.length(), &pend);
+    auto result4 = expr4.eval(context, context);
     CHECK(result4 == json(false));
 }
 
@@ -342,18 +342,18 @@ TEST_CASE("test_jsonpath_filter")
     parent.push_back(2);
 
     std::string expr1 = "(1 + 1)";
-    auto res1 = parser.parse(parent, expr1.c_str(), expr1.c_str()+ expr1.length(), &pend);
-    auto result1 = res1.eval(parent);
+    auto res1 = parser.parse(expr1.c_str(), expr1.c_str()+ expr1.length(), &pend);
+    auto result1 = res1.eval(parent, parent);
     CHECK(json(2) == result1);
 
     std::string expr2 = "(1 - 1)";
-    auto res2 = parser.parse(parent, expr2.c_str(), expr2.c_str()+ expr2.length(), &pend);
-    auto result2 = res2.eval(parent);
+    auto res2 = parser.parse(expr2.c_str(), expr2.c_str()+ expr2.length(), &pend);
+    auto result2 = res2.eval(parent, parent);
     CHECK(json(0) == result2);
 
     std::string expr3 = "(@.length - 1)";
-    auto res3 = parser.parse(parent, expr3.c_str(), expr3.c_str()+ expr3.length(), &pend);
-    auto result3 = res3.eval(parent);
+    auto res3 = parser.parse(expr3.c_str(), expr3.c_str()+ expr3.length(), &pend);
+    auto result3 = res3.eval(parent, parent);
     CHECK(json(1) == result3);
 
 }
@@ -367,13 +367,13 @@ TEST_CASE("test_jsonpath_filter_exclaim")
     parent.push_back(2);
 
     std::string expr1 = "(!(1 + 1))";
-    auto res1 = parser.parse(parent, expr1.c_str(), expr1.c_str()+ expr1.length(), &pend);
-    auto result1 = res1.eval(parent);
+    auto res1 = parser.parse(expr1.c_str(), expr1.c_str()+ expr1.length(), &pend);
+    auto result1 = res1.eval(parent, parent);
     CHECK(result1 == json(false));
 
     std::string expr2 = "(!0)";
-    auto res2 = parser.parse(parent, expr2.c_str(), expr2.c_str()+ expr2.length(), &pend);
-    auto result2= res2.eval(parent);
+    auto res2 = parser.parse(expr2.c_str(), expr2.c_str()+ expr2.length(), &pend);
+    auto result2= res2.eval(parent, parent);
     CHECK(result2 == json(true));
 }
 
@@ -401,43 +401,43 @@ TEST_CASE("test_jsonpath_filter_negative_numbers")
     parent.push_back(2);
 
     std::string expr1 = "(-1 + 1)";
-    auto res1 = parser.parse(parent, expr1.c_str(), expr1.c_str()+ expr1.length(), &pend);
-    auto result1 = res1.eval(parent);
+    auto res1 = parser.parse(expr1.c_str(), expr1.c_str()+ expr1.length(), &pend);
+    auto result1 = res1.eval(parent, parent);
     CHECK(json(0) == result1);
 
     std::string expr2 = "(1 + -1)";
-    auto res2 = parser.parse(parent, expr2.c_str(), expr2.c_str()+ expr2.length(), &pend);
-    auto result2 = res2.eval(parent);
+    auto res2 = parser.parse(expr2.c_str(), expr2.c_str()+ expr2.length(), &pend);
+    auto result2 = res2.eval(parent, parent);
     CHECK(json(0) == result2);
 
     std::string expr3 = "(-1 - -1)";
-    auto res3 = parser.parse(parent, expr3.c_str(), expr3.c_str()+ expr3.length(), &pend);
-    auto result3 = res3.eval(parent);
+    auto res3 = parser.parse(expr3.c_str(), expr3.c_str()+ expr3.length(), &pend);
+    auto result3 = res3.eval(parent, parent);
     CHECK(json(0) == result3);
 
     std::string expr4 = "(-1 - -3)";
-    auto res4 = parser.parse(parent, expr4.c_str(), expr4.c_str()+ expr4.length(), &pend);
-    auto result4 = res4.eval(parent);
+    auto res4 = parser.parse(expr4.c_str(), expr4.c_str()+ expr4.length(), &pend);
+    auto result4 = res4.eval(parent, parent);
     CHECK(json(2) == result4);
 
     std::string expr5 = "((-2 < -1) && (-3 > -4))";
-    auto res5 = parser.parse(parent, expr5.c_str(), expr5.c_str()+ expr5.length(), &pend);
-    auto result5 = res5.eval(parent);
+    auto res5 = parser.parse(expr5.c_str(), expr5.c_str()+ expr5.length(), &pend);
+    auto result5 = res5.eval(parent, parent);
     CHECK(json(true) == result5);
 
     std::string expr6 = "((-2 < -1) || (-4 > -3))";
-    auto res6 = parser.parse(parent, expr6.c_str(), expr6.c_str()+ expr6.length(), &pend);
-    auto result6 = res6.eval(parent);
+    auto res6 = parser.parse(expr6.c_str(), expr6.c_str()+ expr6.length(), &pend);
+    auto result6 = res6.eval(parent, parent);
     CHECK(json(true) == result6);
 
     std::string expr7 = "(-2 < -1 && -3 > -4)";
-    auto res7 = parser.parse(parent, expr7.c_str(), expr7.c_str()+ expr7.length(), &pend);
-    auto result7 = res7.eval(parent);
+    auto res7 = parser.parse(expr7.c_str(), expr7.c_str()+ expr7.length(), &pend);
+    auto result7 = res7.eval(parent, parent);
     CHECK(json(true) == result7);
 
     std::string expr8 = "(-2 < -1 || -4 > -3)";
-    auto res8 = parser.parse(parent, expr8.c_str(), expr8.c_str()+ expr8.length(), &pend);
-    auto result8 = res8.eval(parent);
+    auto res8 = parser.parse(expr8.c_str(), expr8.c_str()+ expr8.length(), &pend);
+    auto result8 = res8.eval(parent, parent);
     CHECK(json(true) == result8);
 }
 
@@ -450,8 +450,8 @@ TEST_CASE("test_jsonpath_filter_uni")
     parent.push_back(2);
 
     std::string expr1 = "(0)";
-    auto res = parser.parse(parent, expr1.c_str(), expr1.c_str()+ expr1.length(), &pend);
-    auto result1 = res.eval(parent);
+    auto res = parser.parse(expr1.c_str(), expr1.c_str()+ expr1.length(), &pend);
+    auto result1 = res.eval(parent, parent);
 
     //std::cout << (int)result1.data_type() << std::endl;
     CHECK(result1 == json(0));
@@ -470,18 +470,18 @@ TEST_CASE("test_jsonpath_filter_regex")
     parent.push_back(2);
 
     std::string expr1 = "('today I go' =~ /today.*?/)";
-    auto res1 = parser.parse(parent, expr1.c_str(), expr1.c_str()+ expr1.length(), &pend);
-    auto result1 = res1.eval(parent);
+    auto res1 = parser.parse(expr1.c_str(), expr1.c_str()+ expr1.length(), &pend);
+    auto result1 = res1.eval(parent, parent);
     CHECK(result1 == json(true));
 
     std::string expr2 = "('today I go' =~ /Today.*?/)";
-    auto res2 = parser.parse(parent, expr2.c_str(), expr2.c_str()+ expr2.length(), &pend);
-    auto result2 = res2.eval(parent);
+    auto res2 = parser.parse(expr2.c_str(), expr2.c_str()+ expr2.length(), &pend);
+    auto result2 = res2.eval(parent, parent);
     CHECK(result2 == json(false));
 
     std::string expr3 = "('today I go' =~ /Today.*?/i)";
-    auto res3 = parser.parse(parent, expr3.c_str(), expr3.c_str()+ expr3.length(), &pend);
-    auto result3 = res3.eval(parent);
+    auto res3 = parser.parse(expr3.c_str(), expr3.c_str()+ expr3.length(), &pend);
+    auto result3 = res3.eval(parent, parent);
     CHECK(result3 == json(true));
 }
 #endif
@@ -224,8 +224,8 @@ TEST_CASE("jsonpath array union normalized path test")
 
     SECTION("$[0,1,2]")
     {
-        json expected = json::parse(R"([[0,1,2,3,4,5,6,7,8,9],[1,2,3,4,1,2,3,4]])");
-        json expected_path = json::parse(R"( ["$[1]","$[0]"])"); 
+        json expected = json::parse(R"([[1,2,3,4,1,2,3,4],[0,1,2,3,4,5,6,7,8,9],[0,1,2,3,4,5,6,7,8,9]])");
+        json expected_path = json::parse(R"( ["$[0]","$[1]","$[2]"])"); 
 
         std::string path = "$[0,1,2]";
         json result = json_query(root, path);
@@ -237,8 +237,8 @@ TEST_CASE("jsonpath array union normalized path test")
 
     SECTION("$[0][0:4,2:8]")
     {
-        json expected = json::parse(R"([1,2,3,4])");
-        json expected_path = json::parse(R"(["$[0][0]","$[0][1]","$[0][2]","$[0][3]"])"); 
+        json expected = json::parse(R"([1,2,3,4,1,2,3,4])");
+        json expected_path = json::parse(R"(["$[0][0]","$[0][1]","$[0][2]","$[0][3]","$[0][4]","$[0][5]","$[0][6]","$[0][7]"])"); 
 
         std::string path = "$[0][0:4,2:8]";
         json result = json_query(root, path);
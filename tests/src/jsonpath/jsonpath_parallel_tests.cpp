@@ -0,0 +1,81 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+#include <catch/catch.hpp>
+#include <vector>
+#include <string>
+
+using namespace jsoncons;
+
+json make_records(size_t count)
+{
+    json records = json::array();
+    for (size_t i = 0; i < count; ++i)
+    {
+        json record;
+        record["id"] = i % 7;
+        record["name"] = "record " + std::to_string(i);
+        record["values"] = json::array();
+        record["values"].push_back(i);
+        record["values"].push_back(i+1);
+        records.push_back(std::move(record));
+    }
+    json root;
+    root["records"] = std::move(records);
+    return root;
+}
+
+TEST_CASE("jsonpath parallel evaluation gives the serial result")
+{
+    json root = make_records(2000);
+
+    jsonpath::jsonpath_options options;
+    options.num_threads(4).parallel_threshold(100);
+
+    std::vector<std::string> paths = {"$..id", "$..values[1]", "$.records[?(@.id == 3)].name", "$.records[*].values[0]",
+                                      "$..[?(@.id == 1)]", "$.records[*]['id','name']", "$.records[*].*", 
+                                      "$..[?(@ > 1990)]", "max($.records[*].values[1])"};
+    for (const auto& path : paths)
+    {
+        json expected = jsonpath::json_query(root, path);
+        CHECK(jsonpath::json_query(root, path, jsonpath::result_type::value, options) == expected);
+
+        json expected_paths = jsonpath::json_query(root, path, jsonpath::result_type::path);
+        CHECK(jsonpath::json_query(root, path, jsonpath::result_type::path, options) == expected_paths);
+    }
+}
+
+TEST_CASE("jsonpath_expression parallel evaluation")
+{
+    json root = make_records(1000);
+
+    auto expr = jsonpath::jsonpath_expression<json>::compile("$..values[?(@ < 10)]");
+
+    jsonpath::jsonpath_options options;
+    options.num_threads(0).parallel_threshold(1);
+
+    json result = expr.evaluate(root, jsonpath::result_type::value, options);
+    CHECK(result == json::parse("[0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9]"));
+    CHECK(result == expr.evaluate(root));
+}
+
+TEST_CASE("jsonpath parallel evaluations share a pool")
+{
+    json root = make_records(200);
+
+    jsonpath::jsonpath_options options;
+    options.num_threads(3).parallel_threshold(10);
+
+    jsoncons::detail::worker_pool& pool = jsonpath::detail::shared_worker_pool(3);
+    CHECK(pool.size() == 3);
+    for (int i = 0; i < 3; ++i)
+    {
+        CHECK(jsonpath::json_query(root, "$.records[*].id", jsonpath::result_type::value, options).size() == 200);
+    }
+    CHECK(std::addressof(jsonpath::detail::shared_worker_pool(3)) == std::addressof(pool));
+}
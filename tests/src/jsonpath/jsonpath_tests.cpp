@@ -1645,7 +1645,7 @@ TEST_CASE("jsonpath array union test")
     SECTION("Test 1")
     {
         json expected = json::parse(R"(
-[[0,1,2,3,4,5,6,7,8,9],[1,2,3,4,1,2,3,4]]
+[[1,2,3,4,1,2,3,4],[0,1,2,3,4,5,6,7,8,9],[0,1,2,3,4,5,6,7,8,9]]
 )");
         json result = jsonpath::json_query(root,"$[0,1,2]");
         CHECK(result == expected);
@@ -1654,7 +1654,7 @@ TEST_CASE("jsonpath array union test")
     SECTION("Test 2")
     {
         json expected = json::parse(R"(
-[1,2,3,4]
+[1,2,3,4,1,2,3,4]
 )");
         json result = jsonpath::json_query(root, "$[0][0:4,2:8]");
         CHECK(result == expected);
@@ -1672,7 +1672,7 @@ TEST_CASE("jsonpath array union test")
     SECTION("Test 4")
     {
         json expected = json::parse(R"(
-[1,2]
+[1,1,2]
 )");
         //json result1 = jsonpath::json_query(root,"$[0.0,1.1,2.2]");
         json result2 = jsonpath::json_query(root,"$[0[0],1[1],2[2]]");
@@ -1680,10 +1680,28 @@ TEST_CASE("jsonpath array union test")
         //CHECK(result1 == expected);
         CHECK(result2 == expected);
     }
+
+    SECTION("Distinct values that compare equal")
+    {
+        json a = json::parse("[1,1,{\"b\":1}]");
+        CHECK(jsonpath::json_query(a, "$[1,0,1]") == json::parse("[1,1]"));
+        CHECK(jsonpath::json_query(a, "$[1,0,1]", jsonpath::result_type::path) == json::parse(R"(["$[0]","$[1]"])"));
+        CHECK(jsonpath::json_query(a, "$..[0,b]") == json::parse("[1,1]"));
+    }
+
+    SECTION("Document order")
+    {
+        json a = json::parse("[10,11,12]");
+        CHECK(jsonpath::json_query(a, "$[2,0,1]") == json::parse("[10,11,12]"));
+
+        ojson o = ojson::parse(R"({"b":1,"a":{"c":2}})");
+        CHECK(jsonpath::json_query(o, "$[a.c,b]") == ojson::parse("[1,2]"));
+    }
 }
 
 TEST_CASE("jsonpath object union test 1")
 {
+    // Results are in document order, the members of a json are sorted by name
     const json root = json::parse(R"(
 [{
   "firstName": "John",
@@ -1730,70 +1748,70 @@ TEST_CASE("jsonpath object union test 1")
 
     SECTION("$..[firstName,address.city]")
     {
-        json expected = json::parse(R"(["John","Nara"])");
+        json expected = json::parse(R"(["Nara","John","Nara","John"])");
         std::string path = "$..[firstName,address.city]";
         json result = jsonpath::json_query(root,path);
         CHECK(result == expected);
     }
     SECTION("$..[firstName,*.city]")
     {
-        json expected = json::parse(R"(["John","Nara"])");
+        json expected = json::parse(R"(["Nara","John","Nara","John"])");
         std::string path = "$..[firstName,*.city]";
         json result = jsonpath::json_query(root,path);
         CHECK(result == expected);
     }
     SECTION("$..[firstName,address[city]]")
     {
-        json expected = json::parse(R"(["John","Nara"])");
+        json expected = json::parse(R"(["Nara","John","Nara","John"])");
         std::string path = "$..[firstName,address[city]]";
         json result = jsonpath::json_query(root,path);
         CHECK(result == expected);
     }
     SECTION("$..[firstName,address['city']]")
     {
-        json expected = json::parse(R"(["John","Nara"])");
+        json expected = json::parse(R"(["Nara","John","Nara","John"])");
         std::string path = "$..[firstName,address['city']]";
         json result = jsonpath::json_query(root,path);
         CHECK(result == expected);
     }
     SECTION("$..[firstName,address.'city']")
     {
-        json expected = json::parse(R"(["John","Nara"])");
+        json expected = json::parse(R"(["Nara","John","Nara","John"])");
         std::string path = "$..[firstName,address.'city']";
         json result = jsonpath::json_query(root,path);
         CHECK(result == expected);
     }
     SECTION(R"($..[firstName,address."city"])")
     {
-        json expected = json::parse(R"(["John","Nara"])");
+        json expected = json::parse(R"(["Nara","John","Nara","John"])");
         std::string path = R"($..[firstName,address."city"])";
         json result = jsonpath::json_query(root,path);
         CHECK(result == expected);
     }
     SECTION(R"($..[firstName,address["city"]])")
     {
-        json expected = json::parse(R"(["John","Nara"])");
+        json expected = json::parse(R"(["Nara","John","Nara","John"])");
         std::string path = R"($..[firstName,address["city"]])";
         json result = jsonpath::json_query(root,path);
         CHECK(result == expected);
     }
     SECTION(R"($..['firstName','address'["city"]])")
     {
-        json expected = json::parse(R"(["John","Nara"])");
+        json expected = json::parse(R"(["Nara","John","Nara","John"])");
         std::string path = R"($..['firstName','address'["city"]])";
         json result = jsonpath::json_query(root,path);
         CHECK(result == expected);
     }
     SECTION(R"($..["firstName","address"["city"]])")
     {
-        json expected = json::parse(R"(["John","Nara"])");
+        json expected = json::parse(R"(["Nara","John","Nara","John"])");
         std::string path = R"($..["firstName","address"["city"]])";
         json result = jsonpath::json_query(root,path);
         CHECK(result == expected);
     }
     SECTION(R"($..["firstName","address"["city"]])")
     {
-        json expected = json::parse(R"(["John","Nara"])");
+        json expected = json::parse(R"(["Nara","John","Nara","John"])");
         std::string path = R"($..[?(@.firstName == 'John')])";
         json result = jsonpath::json_query(root,path);
         //std::cout << pretty_print(result) << "\n\n";
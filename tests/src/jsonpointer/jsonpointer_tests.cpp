@@ -314,3 +314,129 @@ TEST_CASE("jsonpointer concatenation")
     }
 }
 
+
+TEST_CASE("jsonpointer address tokens")
+{
+    jsonpointer::address p("/a~1b/m~0n/12/-");
+    CHECK(p.valid());
+    REQUIRE(p.tokens().size() == 4);
+    CHECK(p.tokens()[0].name == "a/b");
+    CHECK_FALSE(p.tokens()[0].is_index);
+    CHECK(p.tokens()[1].name == "m~n");
+    CHECK(p.tokens()[2].is_index);
+    CHECK(p.tokens()[2].index == 12);
+    CHECK(p.tokens()[3].is_append());
+
+    p /= "x/y";
+    REQUIRE(p.tokens().size() == 5);
+    CHECK(p.tokens()[4].name == "x/y");
+
+    CHECK_FALSE(jsonpointer::address("a/b").valid());
+    CHECK_FALSE(jsonpointer::address("/a~2").valid());
+    CHECK(jsonpointer::address("/a/b~2").tokens().empty());
+    CHECK(jsonpointer::address().tokens().empty());
+
+    jsonpointer::address q("/a/");
+    REQUIRE(q.tokens().size() == 2);
+    CHECK(q.tokens()[1].name.empty());
+    std::vector<std::string> names(q.begin(), q.end());
+    CHECK(names == (std::vector<std::string>{"a", ""}));
+}
+
+TEST_CASE("jsonpointer trailing empty token")
+{
+    json example = json::parse(R"({"a": {"": 1, "b": 2}, "c": [3]})");
+
+    CHECK(jsonpointer::get(example, "/a/") == json(1));
+    CHECK(jsonpointer::get(example, jsonpointer::address("/a/")) == json(1));
+    CHECK(jsonpointer::contains(example, "/a/"));
+
+    std::error_code ec1;
+    jsonpointer::get(example, "/c/", ec1);
+    CHECK(ec1 == jsonpointer::jsonpointer_errc::invalid_index);
+    std::error_code ec2;
+    jsonpointer::get(example, jsonpointer::address("/c/"), ec2);
+    CHECK(ec2 == jsonpointer::jsonpointer_errc::invalid_index);
+
+    jsonpointer::insert_or_assign(example, "/a/", json(4));
+    CHECK(example["a"][""] == json(4));
+}
+
+TEST_CASE("jsonpointer operations with address")
+{
+    json example = json::parse(R"(
+       {
+          "a/b": ["bar", "baz"],
+          "m~n": ["foo", "qux"],
+          "o": {"p": 1}
+       }
+    )");
+
+    SECTION("get")
+    {
+        const json& cexample = example;
+        CHECK(jsonpointer::get(cexample, jsonpointer::address("/a~1b/1")) == json("baz"));
+        CHECK(jsonpointer::get(example, jsonpointer::address("/m~0n/0")) == json("foo"));
+        CHECK(jsonpointer::get(example, jsonpointer::address()) == example);
+
+        std::error_code ec1;
+        jsonpointer::get(example, jsonpointer::address("/a~1b/2"), ec1);
+        CHECK(ec1 == jsonpointer::jsonpointer_errc::index_exceeds_array_size);
+        std::error_code ec2;
+        jsonpointer::get(example, jsonpointer::address("/a~1b/x"), ec2);
+        CHECK(ec2 == jsonpointer::jsonpointer_errc::invalid_index);
+        std::error_code ec3;
+        jsonpointer::get(example, jsonpointer::address("/o/q"), ec3);
+        CHECK(ec3 == jsonpointer::jsonpointer_errc::name_not_found);
+        std::error_code ec4;
+        jsonpointer::get(example, jsonpointer::address("/o/p/q"), ec4);
+        CHECK(ec4 == jsonpointer::jsonpointer_errc::expected_object_or_array);
+        std::error_code ec5;
+        jsonpointer::get(example, jsonpointer::address("/o/~2"), ec5);
+        CHECK(ec5 == jsonpointer::jsonpointer_errc::expected_0_or_1);
+
+        REQUIRE_THROWS_AS(jsonpointer::get(example, jsonpointer::address("/x")), jsonpointer::jsonpointer_error);
+    }
+
+    SECTION("contains")
+    {
+        CHECK(jsonpointer::contains(example, jsonpointer::address("/o/p")));
+        CHECK_FALSE(jsonpointer::contains(example, jsonpointer::address("/o/q")));
+        CHECK_FALSE(jsonpointer::contains(example, jsonpointer::address("/o~")));
+    }
+
+    SECTION("insert and remove")
+    {
+        std::error_code ec;
+        jsonpointer::insert(example, jsonpointer::address("/a~1b/-"), json("end"), ec);
+        CHECK_FALSE(ec);
+        jsonpointer::insert(example, jsonpointer::address("/a~1b/0"), json("start"), ec);
+        CHECK_FALSE(ec);
+        CHECK(example["a/b"] == json::parse(R"(["start","bar","baz","end"])"));
+
+        jsonpointer::insert(example, jsonpointer::address("/o/p"), json(2), ec);
+        CHECK(ec == jsonpointer::jsonpointer_errc::key_already_exists);
+
+        jsonpointer::insert_or_assign(example, jsonpointer::address("/o/p"), json(2));
+        CHECK(example["o"]["p"] == json(2));
+
+        jsonpointer::remove(example, jsonpointer::address("/a~1b/1"));
+        CHECK(example["a/b"] == json::parse(R"(["start","baz","end"])"));
+        jsonpointer::remove(example, jsonpointer::address("/o/p"));
+        CHECK(example["o"] == json::object());
+
+        std::error_code remove_ec;
+        jsonpointer::remove(example, jsonpointer::address("/o/p"), remove_ec);
+        CHECK(remove_ec == jsonpointer::jsonpointer_errc::name_not_found);
+    }
+
+    SECTION("replace")
+    {
+        jsonpointer::replace(example, jsonpointer::address("/m~0n/1"), json("quux"));
+        CHECK(example["m~n"] == json::parse(R"(["foo","quux"])"));
+
+        std::error_code ec;
+        jsonpointer::replace(example, jsonpointer::address("/m~0n/2"), json("x"), ec);
+        CHECK(ec == jsonpointer::jsonpointer_errc::index_exceeds_array_size);
+    }
+}
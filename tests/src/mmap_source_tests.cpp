@@ -0,0 +1,132 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/mmap_source.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <jsoncons_ext/bson/bson.hpp>
+#include <jsoncons_ext/ubjson/ubjson.hpp>
+#include <jsoncons_ext/csv/csv.hpp>
+#include <catch/catch.hpp>
+#include <cstdio> // std::remove
+#include <fstream>
+#include <vector>
+#include <string>
+
+using namespace jsoncons;
+
+void write_file(const std::string& path, const std::vector<uint8_t>& v)
+{
+    std::ofstream os(path, std::ios::binary);
+    os.write(reinterpret_cast<const char*>(v.data()), v.size());
+}
+
+template <class Reader>
+json read_mapped_file(const std::string& path)
+{
+    json_decoder<json> decoder;
+    Reader reader(binary_mmap_source(path), decoder);
+    reader.read();
+    return decoder.get_result();
+}
+
+TEST_CASE("mmap_source json")
+{
+    std::ifstream is("./input/countries.json");
+    json expected = json::parse(is);
+
+    json_decoder<json> decoder;
+    basic_json_reader<char,mmap_source> reader(mmap_source("./input/countries.json"), decoder);
+    reader.read();
+    CHECK(decoder.get_result() == expected);
+}
+
+TEST_CASE("mmap_source csv")
+{
+    csv::csv_options options;
+    options.assume_header(true);
+
+    std::ifstream is("./input/countries.csv");
+    json_decoder<ojson> decoder1;
+    csv::csv_reader reader1(is, decoder1, options);
+    reader1.read();
+
+    json_decoder<ojson> decoder2;
+    csv::basic_csv_reader<char,mmap_source> reader2(mmap_source("./input/countries.csv"), decoder2, options);
+    reader2.read();
+
+    ojson expected = decoder1.get_result();
+    CHECK(expected.size() > 0);
+    CHECK(decoder2.get_result() == expected);
+}
+
+TEST_CASE("mmap_source binary formats")
+{
+    std::ifstream is("./input/address-book.json");
+    json expected = json::parse(is);
+
+    SECTION("cbor")
+    {
+        std::vector<uint8_t> v;
+        cbor::encode_cbor(expected, v);
+        write_file("./output/mmap_source.cbor", v);
+        CHECK(read_mapped_file<cbor::basic_cbor_reader<binary_mmap_source>>("./output/mmap_source.cbor") == expected);
+        std::remove("./output/mmap_source.cbor");
+    }
+
+    SECTION("msgpack")
+    {
+        std::vector<uint8_t> v;
+        msgpack::encode_msgpack(expected, v);
+        write_file("./output/mmap_source.msgpack", v);
+        CHECK(read_mapped_file<msgpack::basic_msgpack_reader<binary_mmap_source>>("./output/mmap_source.msgpack") == expected);
+        std::remove("./output/mmap_source.msgpack");
+    }
+
+    SECTION("bson")
+    {
+        json doc = json::parse(R"({"name":"John","address":{"city":"Toronto","street":"Queen St W"}})");
+        std::vector<uint8_t> v;
+        bson::encode_bson(doc, v);
+        write_file("./output/mmap_source.bson", v);
+        CHECK(read_mapped_file<bson::basic_bson_reader<binary_mmap_source>>("./output/mmap_source.bson") == doc);
+        std::remove("./output/mmap_source.bson");
+    }
+
+    SECTION("ubjson")
+    {
+        std::vector<uint8_t> v;
+        ubjson::encode_ubjson(expected, v);
+        write_file("./output/mmap_source.ubj", v);
+        CHECK(read_mapped_file<ubjson::basic_ubjson_reader<binary_mmap_source>>("./output/mmap_source.ubj") == expected);
+        std::remove("./output/mmap_source.ubj");
+    }
+}
+
+TEST_CASE("mmap_source errors")
+{
+    SECTION("missing file")
+    {
+        std::error_code ec;
+        mmap_source source("./input/no-such-file.json", ec);
+        CHECK(ec);
+        CHECK(source.is_error());
+        REQUIRE_THROWS_AS(mmap_source("./input/no-such-file.json"), std::system_error);
+    }
+
+    SECTION("empty file")
+    {
+        write_file("./output/mmap_source_empty.json", std::vector<uint8_t>());
+        mmap_source source("./output/mmap_source_empty.json");
+        CHECK(source.eof());
+        CHECK(source.size() == 0);
+
+        json_decoder<json> decoder;
+        std::error_code ec;
+        basic_json_reader<char,mmap_source> reader(std::move(source), decoder);
+        reader.read(ec);
+        CHECK(ec == json_errc::unexpected_eof);
+        std::remove("./output/mmap_source_empty.json");
+    }
+}
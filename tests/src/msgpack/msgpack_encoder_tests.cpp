@@ -106,3 +106,14 @@ TEST_CASE("Too many and too few items in MessagePack object or array")
         encoder.flush();
     }
 }
+
+TEST_CASE("serialize byte string to msgpack")
+{
+    std::vector<uint8_t> v;
+    msgpack::msgpack_bytes_encoder encoder(v);
+    encoder.byte_string_value(byte_string({'h','i'}));
+    encoder.flush();
+
+    std::vector<uint8_t> expected = {0xc4,0x02,'h','i'}; // bin 8
+    CHECK(v == expected);
+}
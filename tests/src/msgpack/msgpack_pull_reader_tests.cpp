@@ -0,0 +1,124 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <catch/catch.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace msgpack_pull_reader_tests {
+
+    struct book
+    {
+        std::string author;
+        std::string title;
+        double price;
+        std::vector<std::string> tags;
+    };
+
+} // namespace msgpack_pull_reader_tests
+
+JSONCONS_MEMBER_TRAITS_DECL(msgpack_pull_reader_tests::book, author, title, price, tags)
+
+TEST_CASE("msgpack_pull_reader ext types")
+{
+    std::vector<uint8_t> v = {0x95, // fixarray of 5
+                              0xd4,0x01,0xaa, // fixext 1, type 1
+                              0xd6,0xff,0x00,0x00,0x00,0x01, // fixext 4, type -1 (timestamp)
+                              0xc7,0x03,0x05,'f','o','o', // ext 8, type 5
+                              0xc4,0x02,'h','i', // bin 8
+                              0xc3}; // true
+
+    msgpack::msgpack_bytes_pull_reader reader(v);
+    REQUIRE_FALSE(reader.done());
+    CHECK(reader.current().event_type() == staj_event_type::begin_array);
+    CHECK(reader.current().size() == 5);
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::byte_string_value);
+    CHECK(reader.current().as<byte_string>() == byte_string({0xaa}));
+    reader.next();
+    CHECK(reader.current().as<byte_string>() == byte_string({0x00,0x00,0x00,0x01}));
+    reader.next();
+    CHECK(reader.current().as<byte_string>() == byte_string({'f','o','o'}));
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::byte_string_value);
+    CHECK(reader.current().as<byte_string>() == byte_string({'h','i'}));
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::bool_value);
+    reader.next();
+    CHECK(reader.current().event_type() == staj_event_type::end_array);
+    reader.next();
+    CHECK(reader.done());
+}
+
+TEST_CASE("msgpack_pull_reader truncated input")
+{
+    SECTION("array")
+    {
+        std::vector<uint8_t> v = {0x93,0x01,0x02}; // fixarray of 3 with 2 items
+
+        std::error_code ec;
+        msgpack::msgpack_bytes_pull_reader reader(v, ec);
+        REQUIRE_FALSE(ec);
+        reader.next(ec);
+        reader.next(ec);
+        CHECK(reader.current().as<int>() == 2);
+        reader.next(ec);
+        CHECK(ec == msgpack::msgpack_errc::unexpected_eof);
+    }
+
+    SECTION("ext")
+    {
+        std::vector<uint8_t> v = {0xc7,0x03,0x05,'f','o'};
+
+        std::error_code ec;
+        msgpack::msgpack_bytes_pull_reader reader(v, ec);
+        CHECK(ec == msgpack::msgpack_errc::unexpected_eof);
+
+        CHECK_THROWS_AS(msgpack::decode_msgpack<byte_string>(v), ser_error);
+    }
+}
+
+TEST_CASE("msgpack_pull_reader stops early on a stream")
+{
+    std::vector<uint8_t> v;
+    msgpack::encode_msgpack(json::parse(R"({"a":1,"b":[2,3]})"), v);
+    std::string s(v.begin(), v.end());
+    std::istringstream is(s);
+
+    {
+        msgpack::msgpack_pull_reader reader(is);
+        reader.next();
+        reader.next();
+        CHECK(reader.current().as<int>() == 1);
+    }
+
+    // fixmap, "a" and 1 were taken from the stream, the rest is left
+    CHECK(is.tellg() == std::streampos(4));
+}
+
+TEST_CASE("decode_msgpack into types")
+{
+    msgpack_pull_reader_tests::book book{"Haruki Murakami", "Kafka on the Shore", 25.17,
+                                     {"fiction", "magical realism"}};
+    std::vector<uint8_t> v;
+    msgpack::encode_msgpack(book, v);
+
+    auto result = msgpack::decode_msgpack<msgpack_pull_reader_tests::book>(v);
+    CHECK(result.author == book.author);
+    CHECK(result.title == book.title);
+    CHECK(result.price == book.price);
+    CHECK(result.tags == book.tags);
+
+    std::string s(v.begin(), v.end());
+    std::istringstream is(s);
+    result = msgpack::decode_msgpack<msgpack_pull_reader_tests::book>(is);
+    CHECK(result.tags == book.tags);
+}
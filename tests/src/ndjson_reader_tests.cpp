@@ -0,0 +1,169 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/ndjson_reader.hpp>
+#include <catch/catch.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+using namespace jsoncons;
+
+std::string make_ndjson(size_t count)
+{
+    std::string s;
+    for (size_t i = 0; i < count; ++i)
+    {
+        s += "{\"id\":" + std::to_string(i) + ",\"name\":\"item" + std::to_string(i) + "\",\"tags\":[1,2,3]}\n";
+        if (i % 7 == 3)
+        {
+            s += "\n";
+        }
+    }
+    return s;
+}
+
+std::vector<int64_t> read_ids(ndjson_reader& reader)
+{
+    std::vector<int64_t> ids;
+    reader.read_documents([&ids](json&& val){ids.push_back(val["id"].as<int64_t>());});
+    return ids;
+}
+
+class begin_object_counter : public json_filter
+{
+public:
+    size_t count;
+
+    begin_object_counter(json_content_handler& handler)
+        : json_filter(handler), count(0)
+    {
+    }
+private:
+    bool do_begin_object(semantic_tag tag, const ser_context& context) override
+    {
+        ++count;
+        return to_handler().begin_object(tag, context);
+    }
+
+    bool do_begin_object(size_t length, semantic_tag tag, const ser_context& context) override
+    {
+        ++count;
+        return to_handler().begin_object(length, tag, context);
+    }
+};
+
+TEST_CASE("ndjson_reader ordered")
+{
+    const size_t count = 1000;
+    std::string input = make_ndjson(count);
+
+    std::vector<int64_t> expected;
+    for (size_t i = 0; i < count; ++i)
+    {
+        expected.push_back(static_cast<int64_t>(i));
+    }
+
+    SECTION("string, one thread")
+    {
+        ndjson_reader reader(input, ndjson_options().num_threads(1).chunk_size(100));
+        CHECK(read_ids(reader) == expected);
+    }
+
+    SECTION("string, four threads")
+    {
+        ndjson_reader reader(input, ndjson_options().num_threads(4).chunk_size(100));
+        CHECK(read_ids(reader) == expected);
+    }
+
+    SECTION("stream, four threads")
+    {
+        std::istringstream is(input);
+        ndjson_reader reader(is, ndjson_options().num_threads(4).chunk_size(100));
+        CHECK(read_ids(reader) == expected);
+    }
+
+    SECTION("stream, chunks shorter than a line")
+    {
+        std::istringstream is(input);
+        ndjson_reader reader(is, ndjson_options().num_threads(3).chunk_size(7));
+        CHECK(read_ids(reader) == expected);
+    }
+}
+
+TEST_CASE("ndjson_reader unordered")
+{
+    const size_t count = 1000;
+    std::string input = make_ndjson(count);
+
+    std::istringstream is(input);
+    ndjson_reader reader(is, ndjson_options().num_threads(4).ordered(false).chunk_size(256));
+    std::vector<int64_t> ids = read_ids(reader);
+    REQUIRE(ids.size() == count);
+    std::sort(ids.begin(), ids.end());
+    for (size_t i = 0; i < count; ++i)
+    {
+        CHECK(ids[i] == static_cast<int64_t>(i));
+    }
+}
+
+TEST_CASE("ndjson_reader without final newline")
+{
+    std::string input = "[1,2]\r\n  \r\n{\"a\":true}";
+
+    std::vector<json> documents;
+    ndjson_reader reader(input, ndjson_options().num_threads(2));
+    reader.read_documents([&documents](json&& val){documents.push_back(std::move(val));});
+
+    REQUIRE(documents.size() == 2);
+    CHECK(documents[0] == json::parse("[1,2]"));
+    CHECK(documents[1] == json::parse("{\"a\":true}"));
+}
+
+TEST_CASE("ndjson_reader content handler")
+{
+    std::string input = make_ndjson(100);
+
+    null_json_content_handler handler;
+    begin_object_counter counter(handler);
+    ndjson_reader reader(input, ndjson_options().num_threads(2).chunk_size(64));
+    reader.read(counter);
+    CHECK(counter.count == 100);
+}
+
+TEST_CASE("ndjson_reader errors")
+{
+    std::string input = "{\"a\":1}\n{\"a\":2}\n\n{\"a\":3\n{\"a\":4}\n";
+
+    SECTION("error code")
+    {
+        for (size_t num_threads = 1; num_threads <= 3; ++num_threads)
+        {
+            std::vector<json> documents;
+            std::error_code ec;
+            ndjson_reader reader(input, ndjson_options().num_threads(num_threads).chunk_size(4));
+            reader.read_documents([&documents](json&& val){documents.push_back(std::move(val));}, ec);
+            CHECK(ec == json_errc::unexpected_eof);
+            CHECK(reader.line() == 4);
+            CHECK(documents.size() == 2);
+        }
+    }
+
+    SECTION("exception")
+    {
+        std::istringstream is(input);
+        ndjson_reader reader(is, ndjson_options().num_threads(2).chunk_size(4));
+        REQUIRE_THROWS_AS(reader.read_documents([](json&&){}), ser_error);
+    }
+
+    SECTION("extra character")
+    {
+        std::error_code ec;
+        ndjson_reader reader("1\n2 3\n", ndjson_options().num_threads(1));
+        reader.read_documents([](json&&){}, ec);
+        CHECK(ec == json_errc::extra_character);
+        CHECK(reader.line() == 2);
+    }
+}
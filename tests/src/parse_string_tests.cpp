@@ -131,3 +131,105 @@ TEST_CASE("test_parse_big_string2")
 }
 
 
+TEST_CASE("test_parse_long_strings")
+{
+    // Places escapes, quotes and control characters at every offset of
+    // strings spanning several 16 and 32 byte blocks
+    SECTION("escape at each offset")
+    {
+        for (size_t n = 0; n < 70; ++n)
+        {
+            std::string expected(n, 'a');
+            expected.push_back('\"');
+            expected.append(70-n, 'b');
+
+            std::string input = "\"";
+            input.append(n, 'a');
+            input.append("\\\"");
+            input.append(70-n, 'b');
+            input.push_back('\"');
+
+            json j = json::parse(input);
+            CHECK(j.as<std::string>() == expected);
+        }
+    }
+
+    SECTION("non-ascii at each offset")
+    {
+        for (size_t n = 0; n < 70; ++n)
+        {
+            std::string expected(n, 'a');
+            expected.append("\xD0\x96"); // Cyrillic Zhe
+            expected.append(70-n, 'b');
+
+            json j = json::parse("\"" + expected + "\"");
+            CHECK(j.as<std::string>() == expected);
+        }
+    }
+
+    SECTION("control character at each offset")
+    {
+        for (size_t n = 0; n < 70; ++n)
+        {
+            std::string input = "\"";
+            input.append(n, 'a');
+            input.push_back('\x01');
+            input.append(70-n, 'b');
+            input.push_back('\"');
+
+            std::error_code ec;
+            json_decoder<json> decoder;
+            json_string_reader reader(input, decoder);
+            reader.read(ec);
+            CHECK(ec == json_errc::illegal_control_character);
+        }
+    }
+
+    SECTION("split across buffers")
+    {
+        std::string expected;
+        for (size_t i = 0; i < 100; ++i)
+        {
+            expected.push_back(static_cast<char>('a' + i % 26));
+        }
+        std::string input = "[\"" + expected + "\",\"" + expected + "\"]";
+
+        for (size_t i = 1; i < input.length(); ++i)
+        {
+            std::istringstream is(input);
+            json_decoder<json> decoder;
+            json_reader reader(is, decoder);
+            reader.buffer_length(i);
+            reader.read();
+            json j = decoder.get_result();
+            REQUIRE(j.size() == 2);
+            CHECK(j[0].as<std::string>() == expected);
+            CHECK(j[1].as<std::string>() == expected);
+        }
+    }
+}
+
+TEST_CASE("test_parse_whitespace_runs")
+{
+    for (size_t n = 0; n < 70; ++n)
+    {
+        std::string input = "{";
+        input.append(n, ' ');
+        input.append("\"a\"");
+        input.append(n, '\t');
+        input.append(":");
+        input.append(n, ' ');
+        input.append("1");
+        input.append(n, ' ');
+        input.append("}");
+
+        json_decoder<json> decoder;
+        json_string_reader reader(input, decoder);
+        reader.read();
+        json j = decoder.get_result();
+        CHECK(j["a"].as<int>() == 1);
+        CHECK(reader.line() == 1);
+        CHECK(reader.column() == input.length() + 1);
+    }
+}
+
@@ -0,0 +1,231 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_encoder.hpp>
+#include <jsoncons/result.hpp>
+#include <jsoncons/fd_result.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <jsoncons_ext/bson/bson.hpp>
+#include <jsoncons_ext/ubjson/ubjson.hpp>
+#include <jsoncons_ext/csv/csv.hpp>
+#include <catch/catch.hpp>
+#include <cstdio> // std::remove
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace jsoncons;
+
+std::string read_file(const std::string& path)
+{
+    std::ifstream is(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+}
+
+std::string to_string(const output_buffer& buf)
+{
+    return std::string(buf.data(), buf.size());
+}
+
+std::vector<uint8_t> to_bytes(const binary_output_buffer& buf)
+{
+    return std::vector<uint8_t>(buf.begin(), buf.end());
+}
+
+TEST_CASE("output_buffer")
+{
+    output_buffer buf;
+    CHECK(buf.empty());
+
+    std::string expected;
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        std::string s = std::to_string(i);
+        buf.append(s.data(), s.size());
+        buf.push_back(',');
+        expected.append(s);
+        expected.push_back(',');
+    }
+    CHECK(to_string(buf) == expected);
+
+    size_t capacity = buf.capacity();
+    buf.clear();
+    CHECK(buf.empty());
+    CHECK(buf.capacity() == capacity);
+
+    output_buffer other(std::move(buf));
+    CHECK(other.capacity() == capacity);
+    CHECK(buf.capacity() == 0);
+}
+
+TEST_CASE("buffer_result with encoders")
+{
+    std::ifstream is("./input/address-book.json");
+    json j = json::parse(is);
+
+    SECTION("json")
+    {
+        output_buffer buf;
+        basic_json_encoder<char,buffer_result<char>> encoder(buf);
+        j.dump(encoder);
+
+        std::string expected;
+        j.dump(expected, indenting::indent);
+        CHECK(to_string(buf) == expected);
+
+        buf.clear();
+        basic_json_compressed_encoder<char,buffer_result<char>> compressed(buf);
+        j.dump(compressed);
+        CHECK(to_string(buf) == j.to_string());
+    }
+
+    SECTION("cbor")
+    {
+        binary_output_buffer buf;
+        cbor::basic_cbor_encoder<binary_buffer_result> encoder(buf);
+        j.dump(encoder);
+
+        std::vector<uint8_t> expected;
+        cbor::encode_cbor(j, expected);
+        CHECK(to_bytes(buf) == expected);
+    }
+
+    SECTION("msgpack")
+    {
+        binary_output_buffer buf;
+        msgpack::basic_msgpack_encoder<binary_buffer_result> encoder(buf);
+        j.dump(encoder);
+
+        std::vector<uint8_t> expected;
+        msgpack::encode_msgpack(j, expected);
+        CHECK(to_bytes(buf) == expected);
+    }
+
+    SECTION("bson")
+    {
+        binary_output_buffer buf;
+        bson::basic_bson_encoder<binary_buffer_result> encoder(buf);
+        j.dump(encoder);
+
+        std::vector<uint8_t> expected;
+        bson::encode_bson(j, expected);
+        CHECK(to_bytes(buf) == expected);
+    }
+
+    SECTION("ubjson")
+    {
+        binary_output_buffer buf;
+        ubjson::basic_ubjson_encoder<binary_buffer_result> encoder(buf);
+        j.dump(encoder);
+
+        std::vector<uint8_t> expected;
+        ubjson::encode_ubjson(j, expected);
+        CHECK(to_bytes(buf) == expected);
+    }
+}
+
+TEST_CASE("buffer_result with csv_encoder")
+{
+    const std::string input = "name,age\nJohn,30\n\"Smith, Jane\",25\n";
+    csv::csv_options options;
+    options.assume_header(true);
+    ojson j = csv::decode_csv<ojson>(input, options);
+
+    output_buffer buf;
+    csv::basic_csv_encoder<char,buffer_result<char>> encoder(buf);
+    j.dump(encoder);
+
+    std::string expected;
+    csv::encode_csv(j, expected);
+    CHECK(to_string(buf) == expected);
+}
+
+#if !defined(_WIN32)
+
+TEST_CASE("fd_result")
+{
+    std::ifstream is("./input/address-book.json");
+    json j = json::parse(is);
+
+    std::string expected;
+    j.dump(expected, indenting::indent);
+
+    const std::string path = "./output/fd_result.json";
+
+    // Small buffers exercise writing whole buffers and appends longer than the buffer
+    for (size_t buflen : {1, 7, 64, 16384})
+    {
+        for (bool use_writev : {true, false})
+        {
+            int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            REQUIRE(fd >= 0);
+            {
+                basic_json_encoder<char,fd_result> encoder(fd_result(fd, buflen, use_writev));
+                j.dump(encoder);
+            }
+            ::close(fd);
+            CHECK(read_file(path) == expected);
+        }
+    }
+    std::remove(path.c_str());
+}
+
+TEST_CASE("binary_fd_result")
+{
+    std::ifstream is("./input/address-book.json");
+    json j = json::parse(is);
+
+    std::vector<uint8_t> expected;
+    cbor::encode_cbor(j, expected);
+
+    const std::string path = "./output/fd_result.cbor";
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    REQUIRE(fd >= 0);
+    {
+        cbor::basic_cbor_encoder<binary_fd_result> encoder(binary_fd_result(fd, 16));
+        j.dump(encoder);
+    }
+    ::close(fd);
+
+    std::string s = read_file(path);
+    CHECK(std::vector<uint8_t>(s.begin(), s.end()) == expected);
+    std::remove(path.c_str());
+}
+
+TEST_CASE("fd_result write error")
+{
+    int fd = ::open("./input/address-book.json", O_RDONLY);
+    REQUIRE(fd >= 0);
+    fd_result result(fd, 4);
+    result.append("abc", 3);
+    CHECK_THROWS_AS(result.flush(), std::system_error);
+    ::close(fd);
+}
+
+#endif
+
+TEST_CASE("stream_result appends")
+{
+    std::string expected;
+    std::ostringstream os;
+    {
+        stream_result<char> result(os, 8);
+        for (size_t i = 0; i < 100; ++i)
+        {
+            std::string s(i % 20, static_cast<char>('a' + i % 26));
+            result.append(s.data(), s.size());
+            result.push_back(',');
+            expected.append(s);
+            expected.push_back(',');
+        }
+    }
+    CHECK(os.str() == expected);
+}
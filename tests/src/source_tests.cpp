@@ -0,0 +1,204 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#include <jsoncons/json.hpp>
+#include <jsoncons/source.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <jsoncons_ext/msgpack/msgpack.hpp>
+#include <jsoncons_ext/ubjson/ubjson.hpp>
+#include <catch/catch.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+
+using namespace jsoncons;
+
+std::string to_string(const std::vector<uint8_t>& v)
+{
+    return std::string(reinterpret_cast<const char*>(v.data()), v.size());
+}
+
+json make_document()
+{
+    json doc;
+    doc["short"] = "abc";
+    doc["str8"] = std::string(200, 'a');
+    doc["str16"] = std::string(40000, 'b');
+    doc["bytes"] = json(byte_string(std::vector<uint8_t>(30000, 0x7f).data(), 30000));
+    doc["integers"] = json::array{1, -1, 255, -200, 65535, -40000, 4294967295, -3000000000, 9223372036854775807LL};
+    doc["doubles"] = json::array{1.5, -0.25, 1.0e300};
+    return doc;
+}
+
+TEST_CASE("binary_stream_source peek and consume")
+{
+    std::vector<uint8_t> v;
+    for (size_t i = 0; i < 3*binary_stream_source::default_buffer_length; ++i)
+    {
+        v.push_back(static_cast<uint8_t>(i));
+    }
+    std::istringstream is(to_string(v));
+    binary_stream_source source(is);
+
+    SECTION("spans")
+    {
+        auto s = source.peek(4);
+        REQUIRE(s.size() == 4);
+        CHECK(s[0] == 0);
+        CHECK(s[3] == 3);
+        CHECK(source.position() == 0);
+        source.consume(4);
+        CHECK(source.position() == 4);
+        CHECK(source.get() == 4);
+
+        // Larger than the buffer
+        s = source.peek(2*binary_stream_source::default_buffer_length);
+        REQUIRE(s.size() == 2*binary_stream_source::default_buffer_length);
+        CHECK(s[0] == 5);
+        source.consume(s.size());
+
+        s = source.peek(v.size());
+        CHECK(s.size() == v.size() - source.position());
+        CHECK_FALSE(source.eof());
+        source.consume(s.size());
+        CHECK(source.get() == binary_stream_source::traits_type::eof());
+        CHECK(source.eof());
+    }
+
+    SECTION("read across refills")
+    {
+        std::vector<uint8_t> u;
+        source.ignore(10);
+        CHECK(source.read(std::back_inserter(u), v.size()) == v.size() - 10);
+        CHECK(source.eof());
+        CHECK(std::equal(u.begin(), u.end(), v.begin() + 10));
+    }
+}
+
+TEST_CASE("binary_stream_source returns unconsumed bytes to the stream")
+{
+    std::istringstream is("abcdef");
+    {
+        binary_stream_source source(is);
+        CHECK(source.get() == 'a');
+        CHECK(source.get() == 'b');
+    }
+    CHECK(is.get() == 'c');
+}
+
+// A stream buffer over a string that, like a pipe, cannot seek
+class unseekable_buf : public std::streambuf
+{
+    std::string s_;
+public:
+    unseekable_buf(const std::string& s)
+        : s_(s)
+    {
+        setg(&s_[0], &s_[0], &s_[0] + s_.size());
+    }
+protected:
+    pos_type seekoff(off_type, std::ios_base::seekdir, std::ios_base::openmode) override
+    {
+        return pos_type(off_type(-1));
+    }
+};
+
+TEST_CASE("binary_stream_source does not read ahead on a stream that cannot seek")
+{
+    std::vector<uint8_t> v;
+    cbor::encode_cbor(json::parse(R"({"a":[1,2,3],"b":"x"})"), v);
+    std::vector<uint8_t> u;
+    cbor::encode_cbor(json("second"), u);
+
+    unseekable_buf buf(to_string(v) + to_string(u));
+    std::istream is(&buf);
+
+    json first = cbor::decode_cbor<json>(is);
+    CHECK(first["a"].size() == 3);
+    CHECK(is.good());
+    json second = cbor::decode_cbor<json>(is);
+    CHECK(second.as<std::string>() == "second");
+}
+
+TEST_CASE("source_reader")
+{
+    std::vector<uint8_t> v = {0x01,0x02,0x03,0x04,0x05};
+
+    SECTION("bytes_source")
+    {
+        bytes_source source(v);
+        uint32_t val{};
+        CHECK(source_reader<bytes_source>::read_big_endian(source, val));
+        CHECK(val == 0x01020304);
+        CHECK_FALSE(source_reader<bytes_source>::read_big_endian(source, val));
+        CHECK(source.eof());
+    }
+
+    SECTION("binary_stream_source")
+    {
+        std::istringstream is(to_string(v));
+        binary_stream_source source(is);
+        std::string buffer;
+        const uint8_t* data = nullptr;
+        CHECK(source_reader<binary_stream_source>::read_in_place(source, buffer, 3, data) == 3);
+        CHECK(data[0] == 0x01);
+        CHECK(data[2] == 0x03);
+        CHECK(source_reader<binary_stream_source>::read(source, buffer, 4) == 2);
+        CHECK(source.eof());
+    }
+}
+
+TEST_CASE("binary readers with stream and bytes sources")
+{
+    json expected = make_document();
+
+    SECTION("cbor")
+    {
+        std::vector<uint8_t> v;
+        cbor::encode_cbor(expected, v);
+        CHECK(cbor::decode_cbor<json>(v) == expected);
+        std::istringstream is(to_string(v));
+        CHECK(cbor::decode_cbor<json>(is) == expected);
+
+        v.pop_back();
+        std::error_code ec;
+        json_decoder<json> decoder;
+        cbor::cbor_bytes_reader reader(v, decoder);
+        reader.read(ec);
+        CHECK(ec == cbor::cbor_errc::unexpected_eof);
+    }
+
+    SECTION("msgpack")
+    {
+        std::vector<uint8_t> v;
+        msgpack::encode_msgpack(expected, v);
+        CHECK(msgpack::decode_msgpack<json>(v) == expected);
+        std::istringstream is(to_string(v));
+        CHECK(msgpack::decode_msgpack<json>(is) == expected);
+
+        v.pop_back();
+        std::error_code ec;
+        json_decoder<json> decoder;
+        msgpack::msgpack_bytes_reader reader(v, decoder);
+        reader.read(ec);
+        CHECK(ec == msgpack::msgpack_errc::unexpected_eof);
+    }
+
+    SECTION("ubjson")
+    {
+        json doc = expected;
+        doc.erase("bytes");
+        std::vector<uint8_t> v;
+        ubjson::encode_ubjson(doc, v);
+        CHECK(ubjson::decode_ubjson<json>(v) == doc);
+        std::istringstream is(to_string(v));
+        CHECK(ubjson::decode_ubjson<json>(is) == doc);
+
+        v.pop_back();
+        std::error_code ec;
+        json_decoder<json> decoder;
+        ubjson::ubjson_bytes_reader reader(v, decoder);
+        reader.read(ec);
+        CHECK(ec == ubjson::ubjson_errc::unexpected_eof);
+    }
+}
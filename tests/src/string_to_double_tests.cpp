@@ -9,6 +9,8 @@
 #include <utility>
 #include <ctime>
 #include <cwchar>
+#include <cstring>
+#include <cmath>
 #include <catch/catch.hpp>
 
 using namespace jsoncons;
@@ -53,3 +55,57 @@ TEST_CASE("test_exponent")
 
 }
 
+
+TEST_CASE("decimal_to_double")
+{
+    auto to_double = [](const char* s) -> double
+    {
+        double val = 0;
+        bool ok = jsoncons::detail::decimal_to_double(s, std::strlen(s), '.', val);
+        CHECK(ok);
+        return val;
+    };
+
+    SECTION("fast path")
+    {
+        CHECK(to_double("0") == 0.0);
+        CHECK(std::signbit(to_double("-0.0")));
+        CHECK(to_double("1.5") == 1.5);
+        CHECK(to_double("-1.5e-3") == -1.5e-3);
+        CHECK(to_double("1E22") == 1e22);
+        CHECK(to_double("123456789.123456789") == 123456789.123456789);
+    }
+
+    SECTION("eisel-lemire")
+    {
+        CHECK(to_double("1e23") == 1e23);
+        CHECK(to_double("1.15507e-173") == 1.15507e-173);
+        CHECK(to_double("1.7976931348623157e308") == (std::numeric_limits<double>::max)());
+        CHECK(to_double("2.2250738585072014e-308") == (std::numeric_limits<double>::min)());
+        CHECK(to_double("4.9406564584124654e-324") == std::numeric_limits<double>::denorm_min());
+        CHECK(to_double("1e-400") == 0.0);
+        CHECK(to_double("2e308") == std::numeric_limits<double>::infinity());
+    }
+
+    SECTION("halfway and truncated significands")
+    {
+        // 2^53 + 1 lies halfway between 2^53 and 2^53 + 2, rounds to even
+        CHECK(to_double("9007199254740993") == 9007199254740992.0);
+        CHECK(to_double("9007199254740993.0000000000000000000001") == 9007199254740994.0);
+        CHECK(to_double("1.7976931348623158e308") == (std::numeric_limits<double>::max)());
+        CHECK(to_double("1.7976931348623159e308") == std::numeric_limits<double>::infinity());
+        CHECK(to_double("2.4703282292062327e-324") == 0.0);
+        CHECK(to_double("2.4703282292062328e-324") == std::numeric_limits<double>::denorm_min());
+        CHECK(to_double("3.14159265358979323846264338327950288419716939937510") == 3.141592653589793);
+        CHECK(to_double("123456789012345678901234567890") == 1.2345678901234568e29);
+    }
+
+    SECTION("not decimal")
+    {
+        double val;
+        CHECK_FALSE(jsoncons::detail::decimal_to_double("", 0, '.', val));
+        CHECK_FALSE(jsoncons::detail::decimal_to_double("1e", 2, '.', val));
+        CHECK_FALSE(jsoncons::detail::decimal_to_double("inf", 3, '.', val));
+        CHECK_FALSE(jsoncons::detail::decimal_to_double("1.5x", 4, '.', val));
+    }
+}
@@ -0,0 +1,167 @@
+// Copyright 2019 Daniel Parker
+// Distributed under Boost license
+
+#if defined(_MSC_VER)
+#include "windows.h" // test no inadvertant macro expansions
+#endif
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/ubjson/ubjson.hpp>
+#include <catch/catch.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+
+namespace ubjson_pull_reader_tests {
+
+    struct book
+    {
+        std::string author;
+        std::string title;
+        double price;
+        std::vector<std::string> tags;
+    };
+
+} // namespace ubjson_pull_reader_tests
+
+JSONCONS_MEMBER_TRAITS_DECL(ubjson_pull_reader_tests::book, author, title, price, tags)
+
+TEST_CASE("ubjson_pull_reader typed and counted containers")
+{
+    SECTION("typed array")
+    {
+        std::vector<uint8_t> v = {'[','$','U','#','i',0x03,0x01,0x02,0xff};
+
+        ubjson::ubjson_bytes_pull_reader reader(v);
+        REQUIRE_FALSE(reader.done());
+        CHECK(reader.current().event_type() == staj_event_type::begin_array);
+        CHECK(reader.current().size() == 3);
+        reader.next();
+        CHECK(reader.current().as<int>() == 1);
+        reader.next();
+        CHECK(reader.current().as<int>() == 2);
+        reader.next();
+        CHECK(reader.current().as<int>() == 255);
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::end_array);
+        reader.next();
+        CHECK(reader.done());
+    }
+
+    SECTION("typed object")
+    {
+        std::vector<uint8_t> v = {'{','$','S','#','i',0x02,
+                                  'i',0x01,'a','i',0x01,'x',
+                                  'i',0x01,'b','i',0x02,'y','z'};
+
+        ubjson::ubjson_bytes_pull_reader reader(v);
+        CHECK(reader.current().event_type() == staj_event_type::begin_object);
+        CHECK(reader.current().size() == 2);
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::name);
+        CHECK(reader.current().as<std::string>() == "a");
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::string_value);
+        CHECK(reader.current().as<std::string>() == "x");
+        reader.next();
+        CHECK(reader.current().as<std::string>() == "b");
+        reader.next();
+        CHECK(reader.current().as<std::string>() == "yz");
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::end_object);
+        reader.next();
+        CHECK(reader.done());
+    }
+
+    SECTION("counted array of mixed types")
+    {
+        std::vector<uint8_t> v = {'[','#','i',0x03,'T','Z','[',']'};
+
+        ubjson::ubjson_bytes_pull_reader reader(v);
+        CHECK(reader.current().size() == 3);
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::bool_value);
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::null_value);
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::begin_array);
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::end_array);
+        reader.next();
+        CHECK(reader.current().event_type() == staj_event_type::end_array);
+        reader.next();
+        CHECK(reader.done());
+    }
+
+    SECTION("accept typed array")
+    {
+        std::vector<uint8_t> v = {'[','$','i','#','i',0x02,0x01,0xfe};
+
+        ubjson::ubjson_bytes_pull_reader reader(v);
+        json_decoder<json> decoder;
+        reader.accept(decoder);
+        CHECK(decoder.get_result() == json::parse("[1,-2]"));
+    }
+
+    SECTION("type without count")
+    {
+        std::vector<uint8_t> v = {'[','$','i',0x01,']'};
+
+        std::error_code ec;
+        ubjson::ubjson_bytes_pull_reader reader(v, ec);
+        CHECK(ec == ubjson::ubjson_errc::count_required_after_type);
+    }
+}
+
+TEST_CASE("ubjson_pull_reader truncated input")
+{
+    // Three items are counted but only two are present
+    std::vector<uint8_t> v = {'[','$','i','#','i',0x03,0x01,0x02};
+
+    std::error_code ec;
+    ubjson::ubjson_bytes_pull_reader reader(v, ec);
+    REQUIRE_FALSE(ec);
+    reader.next(ec);
+    CHECK(reader.current().as<int>() == 1);
+    reader.next(ec);
+    CHECK(reader.current().as<int>() == 2);
+    reader.next(ec);
+    CHECK(ec == ubjson::ubjson_errc::unexpected_eof);
+
+    CHECK_THROWS_AS(ubjson::decode_ubjson<std::vector<int>>(v), ser_error);
+}
+
+TEST_CASE("ubjson_pull_reader stops early on a stream")
+{
+    std::string s = {'[','#','i',0x03,'i',0x01,'i',0x02,'i',0x03};
+    std::istringstream is(s);
+
+    {
+        ubjson::ubjson_pull_reader reader(is);
+        reader.next();
+        CHECK(reader.current().as<int>() == 1);
+    }
+
+    // Only the array header and the first element were taken from the stream
+    CHECK(is.tellg() == std::streampos(6));
+}
+
+TEST_CASE("decode_ubjson into types")
+{
+    ubjson_pull_reader_tests::book book{"Haruki Murakami", "Kafka on the Shore", 25.17,
+                                     {"fiction", "magical realism"}};
+    std::vector<uint8_t> v;
+    ubjson::encode_ubjson(book, v);
+
+    auto result = ubjson::decode_ubjson<ubjson_pull_reader_tests::book>(v);
+    CHECK(result.author == book.author);
+    CHECK(result.title == book.title);
+    CHECK(result.price == book.price);
+    CHECK(result.tags == book.tags);
+
+    std::string s(v.begin(), v.end());
+    std::istringstream is(s);
+    result = ubjson::decode_ubjson<ubjson_pull_reader_tests::book>(is);
+    CHECK(result.tags == book.tags);
+}